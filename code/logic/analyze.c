@@ -23,14 +23,44 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/image/analyze.h"
+#include "fossil/image/filter.h"
+#include "fossil/image/parallel.h"
 #include <math.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // ======================================================
 // Fossil Image — Analyze Sub-Library Implementation
 // ======================================================
 
+/*
+ * (Re)shape a single-channel output image, reusing its buffer when it already
+ * owns one of the right size and releasing it otherwise.
+ */
+static bool analyze_prepare_dst(fossil_image_t *dst, uint32_t w, uint32_t h, fossil_pixel_format_t format) {
+    size_t size = (size_t)w * h * fossil_image_bytes_per_pixel(format);
+    if (!(dst->owns_data && dst->data && dst->size == size)) {
+        uint8_t *data = (uint8_t *)calloc(size, 1);
+        if (!data)
+            return false;
+        if (dst->owns_data)
+            free(dst->data);
+        dst->data = data;
+    }
+    dst->width = w;
+    dst->height = h;
+    dst->channels = 1;
+    dst->format = format;
+    dst->size = size;
+    dst->owns_data = true;
+    return true;
+}
+
 bool fossil_image_analyze_histogram(const fossil_image_t *image, uint32_t *out_hist) {
     if (!image || !out_hist)
         return false;
@@ -313,91 +343,6 @@ bool fossil_image_analyze_contrast(const fossil_image_t *image, double *out_cont
     return true;
 }
 
-bool fossil_image_analyze_edge_sobel(const fossil_image_t *src, fossil_image_t *dst) {
-    if (!src || !dst)
-        return false;
-
-    uint32_t w = src->width, h = src->height;
-    if (w < 3 || h < 3)
-        return false;
-
-    dst->width = w;
-    dst->height = h;
-    dst->channels = 1;
-    dst->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-    dst->size = (size_t)w * h;
-    dst->data = (uint8_t *)calloc(dst->size, 1);
-    dst->owns_data = true;
-
-    if (!dst->data)
-        return false;
-
-    const int gx[3][3] = { {-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1} };
-    const int gy[3][3] = { {-1,-2,-1}, { 0, 0, 0}, { 1, 2, 1} };
-
-    for (uint32_t y = 1; y < h - 1; ++y) {
-        for (uint32_t x = 1; x < w - 1; ++x) {
-            float sumx = 0, sumy = 0;
-            for (int ky = -1; ky <= 1; ++ky) {
-                for (int kx = -1; kx <= 1; ++kx) {
-                    float pixel = 0.0f;
-                    size_t idx = ((y + ky) * w + (x + kx));
-                    switch (src->format) {
-                        case FOSSIL_PIXEL_FORMAT_GRAY8:
-                        case FOSSIL_PIXEL_FORMAT_INDEXED8:
-                        case FOSSIL_PIXEL_FORMAT_YUV24:
-                            pixel = (float)src->data[idx];
-                            break;
-                        case FOSSIL_PIXEL_FORMAT_RGB24:
-                        case FOSSIL_PIXEL_FORMAT_RGBA32: {
-                            uint8_t r = src->data[idx * src->channels + 0];
-                            uint8_t g = src->data[idx * src->channels + 1];
-                            uint8_t b = src->data[idx * src->channels + 2];
-                            pixel = 0.299f * r + 0.587f * g + 0.114f * b;
-                            break;
-                        }
-                        case FOSSIL_PIXEL_FORMAT_GRAY16: {
-                            uint16_t *idata = (uint16_t *)src->data;
-                            pixel = (float)(idata[idx]) / 65535.0f * 255.0f;
-                            break;
-                        }
-                        case FOSSIL_PIXEL_FORMAT_RGB48:
-                        case FOSSIL_PIXEL_FORMAT_RGBA64: {
-                            uint16_t *idata = (uint16_t *)src->data;
-                            uint16_t r = idata[idx * src->channels + 0];
-                            uint16_t g = idata[idx * src->channels + 1];
-                            uint16_t b = idata[idx * src->channels + 2];
-                            pixel = (0.299f * r + 0.587f * g + 0.114f * b) / 65535.0f * 255.0f;
-                            break;
-                        }
-                        case FOSSIL_PIXEL_FORMAT_FLOAT32: {
-                            pixel = fmaxf(0.0f, fminf(src->fdata[idx], 1.0f)) * 255.0f;
-                            break;
-                        }
-                        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
-                        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA: {
-                            float r = src->fdata[idx * src->channels + 0];
-                            float g = src->fdata[idx * src->channels + 1];
-                            float b = src->fdata[idx * src->channels + 2];
-                            pixel = (0.299f * r + 0.587f * g + 0.114f * b) * 255.0f;
-                            break;
-                        }
-                        default:
-                            pixel = 0.0f;
-                            break;
-                    }
-                    sumx += gx[ky + 1][kx + 1] * pixel;
-                    sumy += gy[ky + 1][kx + 1] * pixel;
-                }
-            }
-            float mag = sqrtf(sumx * sumx + sumy * sumy);
-            dst->data[y * w + x] = (uint8_t)fminf(mag, 255.0f);
-        }
-    }
-
-    return true;
-}
-
 bool fossil_image_analyze_entropy(const fossil_image_t *image, double *out_entropy) {
     if (!image || !out_entropy)
         return false;
@@ -489,3 +434,1886 @@ bool fossil_image_analyze_entropy(const fossil_image_t *image, double *out_entro
     *out_entropy = entropy;
     return true;
 }
+
+// ------------------------------------------------------
+// Gradients
+// ------------------------------------------------------
+
+/*
+ * Each band converts one source row at a time to 8-bit integer luma in a
+ * ring of three padded int16 rows (edge pixels replicated), so every source
+ * pixel is read and converted once per band. Gx/Gy are then separable
+ * differences of those rows, eight lanes at a time with SSE2.
+ */
+typedef struct gradient_ctx {
+    const fossil_image_t *src;
+    int16_t *scratch;                  // per band: 3 luma rows + gx/gy rows
+    size_t scratch_per_band;
+    int16_t *gx;
+    int16_t *gy;
+    uint16_t *magnitude;
+    uint8_t *magnitude8;               // saturated L2, for edge_sobel
+    float *orientation;
+    fossil_gradient_norm_t norm;
+    int16_t side;                      // outer kernel weight
+    int16_t center;                    // middle kernel weight
+} gradient_ctx_t;
+
+static inline int16_t luma8(uint32_t r, uint32_t g, uint32_t b) {
+    return (int16_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+static inline int16_t luma_unit(float v) {
+    v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+    return (int16_t)(v * 255.0f + 0.5f);
+}
+
+/* Fill out[1..width] with row y's luma and replicate both edge pixels. */
+static void gradient_luma_row(const fossil_image_t *src, uint32_t y, int16_t *out) {
+    const uint32_t w = src->width;
+    const uint32_t c = src->channels;
+    const size_t base = (size_t)y * w;
+    int16_t *o = out + 1;
+
+    switch (src->format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8: {
+            const uint8_t *p = src->data + base;
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = p[x];
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_YUV24: {
+            const uint8_t *p = src->data + base * c;
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = p[(size_t)x * c];
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32: {
+            const uint8_t *p = src->data + base * c;
+            for (uint32_t x = 0; x < w; ++x, p += c)
+                o[x] = luma8(p[0], p[1], p[2]);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_GRAY16: {
+            const uint16_t *p = (const uint16_t *)src->data + base;
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = (int16_t)((p[x] + 128u) / 257u);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64: {
+            const uint16_t *p = (const uint16_t *)src->data + base * c;
+            for (uint32_t x = 0; x < w; ++x, p += c)
+                o[x] = (int16_t)((((77u * p[0] + 150u * p[1] + 29u * p[2] + 128u) >> 8) + 128u) / 257u);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_FLOAT32: {
+            const float *p = src->fdata + base;
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = luma_unit(p[x]);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA: {
+            const float *p = src->fdata + base * c;
+            for (uint32_t x = 0; x < w; ++x, p += c)
+                o[x] = luma_unit(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+            break;
+        }
+        default:
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = 0;
+            break;
+    }
+    out[0] = out[1];
+    out[w + 1] = out[w];
+}
+
+static void gradient_kernel_row(
+    const int16_t *r0,
+    const int16_t *r1,
+    const int16_t *r2,
+    int16_t *gx,
+    int16_t *gy,
+    uint32_t w,
+    int16_t side,
+    int16_t center
+) {
+    uint32_t x = 0;
+#if defined(__SSE2__)
+    const __m128i vs = _mm_set1_epi16(side);
+    const __m128i vc = _mm_set1_epi16(center);
+    for (; x + 8 <= w; x += 8) {
+        __m128i a0 = _mm_loadu_si128((const __m128i *)(r0 + x));
+        __m128i b0 = _mm_loadu_si128((const __m128i *)(r0 + x + 1));
+        __m128i c0 = _mm_loadu_si128((const __m128i *)(r0 + x + 2));
+        __m128i a1 = _mm_loadu_si128((const __m128i *)(r1 + x));
+        __m128i c1 = _mm_loadu_si128((const __m128i *)(r1 + x + 2));
+        __m128i a2 = _mm_loadu_si128((const __m128i *)(r2 + x));
+        __m128i b2 = _mm_loadu_si128((const __m128i *)(r2 + x + 1));
+        __m128i c2 = _mm_loadu_si128((const __m128i *)(r2 + x + 2));
+        __m128i dx = _mm_add_epi16(_mm_mullo_epi16(_mm_add_epi16(_mm_sub_epi16(c0, a0), _mm_sub_epi16(c2, a2)), vs),
+                                   _mm_mullo_epi16(_mm_sub_epi16(c1, a1), vc));
+        __m128i dy = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_add_epi16(a2, c2), _mm_add_epi16(a0, c0)), vs),
+                                   _mm_mullo_epi16(_mm_sub_epi16(b2, b0), vc));
+        _mm_storeu_si128((__m128i *)(gx + x), dx);
+        _mm_storeu_si128((__m128i *)(gy + x), dy);
+    }
+#endif
+    for (; x < w; ++x) {
+        gx[x] = (int16_t)(side * ((r0[x + 2] - r0[x]) + (r2[x + 2] - r2[x])) + center * (r1[x + 2] - r1[x]));
+        gy[x] = (int16_t)(side * ((r2[x] + r2[x + 2]) - (r0[x] + r0[x + 2])) + center * (r2[x + 1] - r0[x + 1]));
+    }
+}
+
+static void gradient_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    gradient_ctx_t *g = (gradient_ctx_t *)arg;
+    const fossil_image_t *src = g->src;
+    const uint32_t w = src->width, h = src->height;
+    const size_t stride = (size_t)w + 2;
+    int16_t *scratch = g->scratch + band * g->scratch_per_band;
+    int16_t *ring[3] = { scratch, scratch + stride, scratch + 2 * stride };
+    int16_t *tmp_gx = scratch + 3 * stride;
+    int16_t *tmp_gy = tmp_gx + w;
+
+    gradient_luma_row(src, begin > 0 ? begin - 1 : 0, ring[0]);
+    gradient_luma_row(src, begin, ring[1]);
+    gradient_luma_row(src, begin + 1 < h ? begin + 1 : h - 1, ring[2]);
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const size_t row = (size_t)y * w;
+        int16_t *gx = g->gx ? g->gx + row : tmp_gx;
+        int16_t *gy = g->gy ? g->gy + row : tmp_gy;
+        gradient_kernel_row(ring[0], ring[1], ring[2], gx, gy, w, g->side, g->center);
+
+        if (g->magnitude && g->norm == FOSSIL_GRADIENT_L1) {
+            uint16_t *m = g->magnitude + row;
+            uint32_t x = 0;
+#if defined(__SSE2__)
+            const __m128i zero = _mm_setzero_si128();
+            for (; x + 8 <= w; x += 8) {
+                __m128i dx = _mm_loadu_si128((const __m128i *)(gx + x));
+                __m128i dy = _mm_loadu_si128((const __m128i *)(gy + x));
+                dx = _mm_max_epi16(dx, _mm_sub_epi16(zero, dx));
+                dy = _mm_max_epi16(dy, _mm_sub_epi16(zero, dy));
+                _mm_storeu_si128((__m128i *)(m + x), _mm_add_epi16(dx, dy));
+            }
+#endif
+            for (; x < w; ++x)
+                m[x] = (uint16_t)(abs(gx[x]) + abs(gy[x]));
+        } else if (g->magnitude) {
+            uint16_t *m = g->magnitude + row;
+            for (uint32_t x = 0; x < w; ++x) {
+                float dx = gx[x], dy = gy[x];
+                m[x] = (uint16_t)(sqrtf(dx * dx + dy * dy) + 0.5f);
+            }
+        }
+        if (g->magnitude8) {
+            uint8_t *m = g->magnitude8 + row;
+            for (uint32_t x = 0; x < w; ++x) {
+                float dx = gx[x], dy = gy[x];
+                float v = sqrtf(dx * dx + dy * dy);
+                m[x] = (uint8_t)(v < 255.0f ? v : 255.0f);
+            }
+        }
+        if (g->orientation) {
+            float *o = g->orientation + row;
+            for (uint32_t x = 0; x < w; ++x)
+                o[x] = atan2f((float)gy[x], (float)gx[x]);
+        }
+
+        if (y + 1 < end) {
+            int16_t *recycled = ring[0];
+            ring[0] = ring[1];
+            ring[1] = ring[2];
+            ring[2] = recycled;
+            gradient_luma_row(src, y + 2 < h ? y + 2 : h - 1, ring[2]);
+        }
+    }
+}
+
+static bool gradient_run(gradient_ctx_t *g) {
+    const fossil_image_t *src = g->src;
+    uint32_t bands = fossil_image_parallel_bands(src->height, 32);
+    g->scratch_per_band = 3 * ((size_t)src->width + 2) + 2 * (size_t)src->width;
+    g->scratch = (int16_t *)malloc(bands * g->scratch_per_band * sizeof(int16_t));
+    if (!g->scratch)
+        return false;
+    bool ok = fossil_image_parallel_for_bands(bands, src->height, gradient_band, g);
+    free(g->scratch);
+    g->scratch = NULL;
+    return ok;
+}
+
+static bool gradient_format_supported(fossil_pixel_format_t format) {
+    switch (format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8:
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool fossil_image_analyze_gradient(
+    const fossil_image_t *src,
+    fossil_gradient_op_t op,
+    fossil_gradient_norm_t norm,
+    int16_t *gx,
+    int16_t *gy,
+    fossil_image_t *magnitude,
+    fossil_image_t *orientation
+) {
+    if (!src || !src->data || src->width == 0 || src->height == 0)
+        return false;
+    if (!gradient_format_supported(src->format))
+        return false;
+    if (op != FOSSIL_GRADIENT_SOBEL && op != FOSSIL_GRADIENT_SCHARR)
+        return false;
+    if (norm != FOSSIL_GRADIENT_L1 && norm != FOSSIL_GRADIENT_L2)
+        return false;
+    if (!gx && !gy && !magnitude && !orientation)
+        return false;
+    if (magnitude && magnitude == orientation)
+        return false;
+
+    gradient_ctx_t g = { 0 };
+    g.src = src;
+    g.gx = gx;
+    g.gy = gy;
+    g.norm = norm;
+    g.side = op == FOSSIL_GRADIENT_SCHARR ? 3 : 1;
+    g.center = op == FOSSIL_GRADIENT_SCHARR ? 10 : 2;
+    if (magnitude) {
+        if (!analyze_prepare_dst(magnitude, src->width, src->height, FOSSIL_PIXEL_FORMAT_GRAY16))
+            return false;
+        g.magnitude = (uint16_t *)magnitude->data;
+    }
+    if (orientation) {
+        if (!analyze_prepare_dst(orientation, src->width, src->height, FOSSIL_PIXEL_FORMAT_FLOAT32))
+            return false;
+        g.orientation = orientation->fdata;
+    }
+    return gradient_run(&g);
+}
+
+bool fossil_image_analyze_edge_sobel(const fossil_image_t *src, fossil_image_t *dst) {
+    if (!src || !dst || !src->data)
+        return false;
+
+    uint32_t w = src->width, h = src->height;
+    if (w < 3 || h < 3 || !gradient_format_supported(src->format))
+        return false;
+    if (!analyze_prepare_dst(dst, w, h, FOSSIL_PIXEL_FORMAT_GRAY8))
+        return false;
+
+    gradient_ctx_t g = { 0 };
+    g.src = src;
+    g.side = 1;
+    g.center = 2;
+    g.magnitude8 = dst->data;
+    if (!gradient_run(&g))
+        return false;
+
+    // Border pixels have no full neighbourhood and stay zero
+    memset(dst->data, 0, w);
+    memset(dst->data + (size_t)(h - 1) * w, 0, w);
+    for (uint32_t y = 1; y < h - 1; ++y) {
+        dst->data[(size_t)y * w] = 0;
+        dst->data[(size_t)y * w + w - 1] = 0;
+    }
+    return true;
+}
+
+// ------------------------------------------------------
+// Canny Edges
+// ------------------------------------------------------
+
+#define CANNY_MIN_ROWS 32
+#define CANNY_BINS 2048                // > sqrt(2) * 1020, the largest Sobel L2 magnitude
+#define CANNY_AUTO_HIGH 0.7            // fraction of non-zero gradients below the high threshold
+#define CANNY_AUTO_RATIO 0.4           // low / high for automatic thresholds
+
+enum {
+    CANNY_NONE = 0,
+    CANNY_WEAK = 1,
+    CANNY_STRONG = 2,
+    CANNY_EDGE = 255
+};
+
+typedef struct canny_stack {
+    size_t *items;
+    size_t count;
+    size_t capacity;
+} canny_stack_t;
+
+static bool canny_push(canny_stack_t *s, size_t v) {
+    if (s->count == s->capacity) {
+        size_t capacity = s->capacity ? s->capacity * 2 : 1024;
+        size_t *items = (size_t *)realloc(s->items, capacity * sizeof(size_t));
+        if (!items)
+            return false;
+        s->items = items;
+        s->capacity = capacity;
+    }
+    s->items[s->count++] = v;
+    return true;
+}
+
+typedef struct canny_ctx {
+    const int16_t *gx;
+    const int16_t *gy;
+    int32_t *mag2;                     // squared L2 magnitude
+    uint32_t *hist;                    // per band, CANNY_BINS each (automatic mode)
+    uint8_t *out;                      // classification, then the final edge map
+    canny_stack_t *stacks;             // per band
+    bool *failed;                      // per band
+    uint32_t width;
+    uint32_t height;
+    float low2;
+    float high2;
+} canny_ctx_t;
+
+static void canny_magnitude_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    canny_ctx_t *c = (canny_ctx_t *)arg;
+    uint32_t *hist = c->hist ? c->hist + (size_t)band * CANNY_BINS : NULL;
+    for (size_t i = (size_t)begin * c->width; i < (size_t)end * c->width; ++i) {
+        int32_t dx = c->gx[i], dy = c->gy[i];
+        int32_t m = dx * dx + dy * dy;
+        c->mag2[i] = m;
+        if (hist && m)
+            hist[(uint32_t)(sqrtf((float)m) + 0.5f)]++;
+    }
+}
+
+/*
+ * Non-maximum suppression along the gradient direction, quantized to four
+ * sectors with 22.5 degree boundaries (tan 22.5 = 13573 / 32768). Ties go to
+ * the first pixel in scan order so plateaus stay one pixel thick.
+ */
+static void canny_suppress_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    canny_ctx_t *c = (canny_ctx_t *)arg;
+    const uint32_t w = c->width, h = c->height;
+    const ptrdiff_t stride = (ptrdiff_t)w;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        uint8_t *out = c->out + (size_t)y * w;
+        memset(out, CANNY_NONE, w);
+        if (y == 0 || y == h - 1)
+            continue;
+        const size_t row = (size_t)y * w;
+        for (uint32_t x = 1; x + 1 < w; ++x) {
+            size_t i = row + x;
+            int32_t m = c->mag2[i];
+            if ((float)m <= c->low2)
+                continue;
+            int32_t dx = c->gx[i], dy = c->gy[i];
+            int32_t ax = abs(dx), ay = abs(dy);
+            ptrdiff_t step;
+            if (ay * 32768 <= ax * 13573)
+                step = 1;                                   // horizontal gradient
+            else if (ax * 32768 <= ay * 13573)
+                step = stride;                              // vertical gradient
+            else if ((dx < 0) == (dy < 0))
+                step = stride + 1;                          // down-right diagonal
+            else
+                step = stride - 1;                          // down-left diagonal
+            if (m > c->mag2[i - step] && m >= c->mag2[i + step])
+                out[x] = (float)m > c->high2 ? CANNY_STRONG : CANNY_WEAK;
+        }
+    }
+}
+
+/* Flood from strong pixels through weak ones, staying inside rows [begin, end). */
+static bool canny_flood(canny_ctx_t *c, canny_stack_t *stack, uint32_t begin, uint32_t end) {
+    const uint32_t w = c->width;
+    while (stack->count) {
+        size_t i = stack->items[--stack->count];
+        uint32_t y = (uint32_t)(i / w), x = (uint32_t)(i % w);
+        uint32_t y0 = y > begin ? y - 1 : begin, y1 = y + 1 < end ? y + 1 : end - 1;
+        uint32_t x0 = x > 0 ? x - 1 : 0, x1 = x + 1 < w ? x + 1 : w - 1;
+        for (uint32_t ny = y0; ny <= y1; ++ny) {
+            for (uint32_t nx = x0; nx <= x1; ++nx) {
+                size_t n = (size_t)ny * w + nx;
+                if (c->out[n] == CANNY_WEAK || c->out[n] == CANNY_STRONG) {
+                    c->out[n] = CANNY_EDGE;
+                    if (!canny_push(stack, n))
+                        return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void canny_trace_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    canny_ctx_t *c = (canny_ctx_t *)arg;
+    canny_stack_t *stack = &c->stacks[band];
+    for (size_t i = (size_t)begin * c->width; i < (size_t)end * c->width; ++i) {
+        if (c->out[i] != CANNY_STRONG)
+            continue;
+        c->out[i] = CANNY_EDGE;
+        if (!canny_push(stack, i) || !canny_flood(c, stack, begin, end)) {
+            c->failed[band] = true;
+            return;
+        }
+    }
+}
+
+static void canny_finish_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    canny_ctx_t *c = (canny_ctx_t *)arg;
+    for (size_t i = (size_t)begin * c->width; i < (size_t)end * c->width; ++i)
+        if (c->out[i] != CANNY_EDGE)
+            c->out[i] = CANNY_NONE;
+}
+
+/*
+ * Bands trace independently, so a weak chain that crosses a band boundary is
+ * only joined here: edge pixels on either side of each seam re-seed an
+ * unrestricted flood.
+ */
+static bool canny_join_seams(canny_ctx_t *c, uint32_t bands) {
+    const uint32_t w = c->width, h = c->height;
+    canny_stack_t *stack = &c->stacks[0];
+    for (uint32_t b = 1; b < bands; ++b) {
+        uint32_t seam = (uint32_t)((uint64_t)h * b / bands);
+        for (uint32_t y = seam - 1; y <= seam; ++y) {
+            for (uint32_t x = 0; x < w; ++x) {
+                size_t i = (size_t)y * w + x;
+                if (c->out[i] == CANNY_EDGE && !canny_push(stack, i))
+                    return false;
+            }
+        }
+        if (!canny_flood(c, stack, 0, h))
+            return false;
+    }
+    return true;
+}
+
+/* Thresholds from the merged per-band magnitude histograms. */
+static void canny_auto_thresholds(canny_ctx_t *c, uint32_t bands, float *low, float *high) {
+    uint64_t total = 0;
+    for (uint32_t b = 1; b < bands; ++b)
+        for (uint32_t k = 0; k < CANNY_BINS; ++k)
+            c->hist[k] += c->hist[(size_t)b * CANNY_BINS + k];
+    for (uint32_t k = 0; k < CANNY_BINS; ++k)
+        total += c->hist[k];
+    if (!total) {
+        *low = *high = (float)CANNY_BINS;
+        return;
+    }
+    uint64_t target = (uint64_t)ceil(CANNY_AUTO_HIGH * (double)total), cumulative = 0;
+    uint32_t k = 0;
+    while (k + 1 < CANNY_BINS && (cumulative += c->hist[k]) < target)
+        ++k;
+    // Bin k holds magnitudes from k - 0.5; starting there keeps the
+    // percentile bin strong even when every gradient has the same size
+    *high = (float)k - 0.5f;
+    *low = (float)(CANNY_AUTO_RATIO * *high);
+}
+
+bool fossil_image_analyze_canny(
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    float low_threshold,
+    float high_threshold
+) {
+    if (!src || !dst || !src->data || src->width == 0 || src->height == 0)
+        return false;
+    if (!gradient_format_supported(src->format))
+        return false;
+    bool automatic = !(high_threshold > 0.0f);
+    if (!automatic && !(low_threshold >= 0.0f && low_threshold <= high_threshold))
+        return false;
+
+    const uint32_t w = src->width, h = src->height;
+    const size_t pixels = (size_t)w * h;
+    uint32_t bands = fossil_image_parallel_bands(h, CANNY_MIN_ROWS);
+    canny_ctx_t c = { 0 };
+    c.width = w;
+    c.height = h;
+    int16_t *gx = (int16_t *)malloc(pixels * sizeof(int16_t));
+    int16_t *gy = (int16_t *)malloc(pixels * sizeof(int16_t));
+    c.mag2 = (int32_t *)malloc(pixels * sizeof(int32_t));
+    c.stacks = (canny_stack_t *)calloc(bands, sizeof(canny_stack_t));
+    c.failed = (bool *)calloc(bands, sizeof(bool));
+    if (automatic)
+        c.hist = (uint32_t *)calloc((size_t)bands * CANNY_BINS, sizeof(uint32_t));
+    bool ok = gx && gy && c.mag2 && c.stacks && c.failed && (!automatic || c.hist);
+    ok = ok && analyze_prepare_dst(dst, w, h, FOSSIL_PIXEL_FORMAT_GRAY8);
+
+    if (ok) {
+        gradient_ctx_t g = { 0 };
+        g.src = src;
+        g.gx = gx;
+        g.gy = gy;
+        g.side = 1;
+        g.center = 2;
+        ok = gradient_run(&g);
+    }
+    if (ok) {
+        c.gx = gx;
+        c.gy = gy;
+        c.out = dst->data;
+        ok = fossil_image_parallel_for_bands(bands, h, canny_magnitude_band, &c);
+    }
+    if (ok) {
+        if (automatic)
+            canny_auto_thresholds(&c, bands, &low_threshold, &high_threshold);
+        c.low2 = low_threshold * low_threshold;
+        c.high2 = high_threshold * high_threshold;
+        ok = fossil_image_parallel_for_bands(bands, h, canny_suppress_band, &c) &&
+             fossil_image_parallel_for_bands(bands, h, canny_trace_band, &c);
+        for (uint32_t b = 0; ok && b < bands; ++b)
+            ok = !c.failed[b];
+    }
+    ok = ok && canny_join_seams(&c, bands) &&
+         fossil_image_parallel_for_bands(bands, h, canny_finish_band, &c);
+
+    for (uint32_t b = 0; c.stacks && b < bands; ++b)
+        free(c.stacks[b].items);
+    free(c.stacks);
+    free(c.failed);
+    free(c.hist);
+    free(c.mag2);
+    free(gx);
+    free(gy);
+    return ok;
+}
+
+// ------------------------------------------------------
+// Connected Components
+// ------------------------------------------------------
+
+/*
+ * Two-pass union-find labeling over row bands. A pixel that starts a new
+ * provisional component takes its own index + 1 as label, so bands never
+ * collide and the parent table needs no per-band offsets. Unions always link
+ * to the smaller root, which makes every root the raster-first pixel of its
+ * component and lets one ascending sweep assign final labels in raster order.
+ */
+#define COMPONENT_MIN_ROWS 32
+
+typedef struct component_acc {
+    uint32_t area;
+    uint32_t left;
+    uint32_t top;
+    uint32_t right;
+    uint32_t bottom;
+    uint64_t sum_x;
+    uint64_t sum_y;
+} component_acc_t;
+
+typedef struct component_ctx {
+    const uint8_t *mask;
+    uint32_t *labels;
+    uint32_t *parent;                  // indexed by provisional label, 0 = unused
+    component_acc_t *acc;              // per band, tracked entries each
+    uint32_t tracked;                  // components with statistics
+    uint32_t width;
+    bool eight;
+} component_ctx_t;
+
+static inline uint32_t component_find(uint32_t *parent, uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+static inline void component_union(uint32_t *parent, uint32_t a, uint32_t b) {
+    a = component_find(parent, a);
+    b = component_find(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+static void component_scan_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    component_ctx_t *c = (component_ctx_t *)arg;
+    const uint32_t w = c->width;
+    uint32_t *parent = c->parent;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const size_t row = (size_t)y * w;
+        const uint8_t *m = c->mask + row;
+        uint32_t *lab = c->labels + row;
+        const uint32_t *up = y > begin ? lab - w : NULL;
+        for (uint32_t x = 0; x < w; ++x) {
+            if (!m[x]) {
+                lab[x] = 0;
+                continue;
+            }
+            uint32_t left = x > 0 ? lab[x - 1] : 0;
+            uint32_t above = up ? up[x] : 0;
+            uint32_t label;
+            if (c->eight) {
+                // Above touches all other candidates; otherwise left and
+                // upper-left touch each other and only upper-right can differ
+                uint32_t ul = up && x > 0 ? up[x - 1] : 0;
+                uint32_t ur = up && x + 1 < w ? up[x + 1] : 0;
+                if (above) {
+                    label = above;
+                } else {
+                    label = left ? left : ul;
+                    if (label && ur)
+                        component_union(parent, label, ur);
+                    else if (ur)
+                        label = ur;
+                }
+            } else {
+                label = left ? left : above;
+                if (left && above && left != above)
+                    component_union(parent, left, above);
+            }
+            if (!label) {
+                label = (uint32_t)(row + x + 1);
+                parent[label] = label;
+            }
+            lab[x] = label;
+        }
+    }
+}
+
+/* Join labels across the first row of every band but the first. */
+static void component_join_seams(component_ctx_t *c, uint32_t height, uint32_t bands) {
+    const uint32_t w = c->width;
+    for (uint32_t b = 1; b < bands; ++b) {
+        uint32_t seam = (uint32_t)((uint64_t)height * b / bands);
+        const uint32_t *lab = c->labels + (size_t)seam * w;
+        const uint32_t *up = lab - w;
+        for (uint32_t x = 0; x < w; ++x) {
+            if (!lab[x])
+                continue;
+            if (up[x])
+                component_union(c->parent, lab[x], up[x]);
+            if (c->eight) {
+                if (x > 0 && up[x - 1])
+                    component_union(c->parent, lab[x], up[x - 1]);
+                if (x + 1 < w && up[x + 1])
+                    component_union(c->parent, lab[x], up[x + 1]);
+            }
+        }
+    }
+}
+
+static void component_relabel_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    component_ctx_t *c = (component_ctx_t *)arg;
+    const uint32_t w = c->width;
+    component_acc_t *acc = c->acc ? c->acc + (size_t)band * c->tracked : NULL;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        uint32_t *lab = c->labels + (size_t)y * w;
+        for (uint32_t x = 0; x < w; ++x) {
+            if (!lab[x])
+                continue;
+            uint32_t id = c->parent[lab[x]];
+            lab[x] = id;
+            if (!acc || id > c->tracked)
+                continue;
+            component_acc_t *a = &acc[id - 1];
+            if (a->area == 0) {
+                a->left = a->right = x;
+                a->top = a->bottom = y;
+            } else {
+                if (x < a->left) a->left = x;
+                if (x > a->right) a->right = x;
+                a->bottom = y;
+            }
+            a->area++;
+            a->sum_x += x;
+            a->sum_y += y;
+        }
+    }
+}
+
+bool fossil_image_analyze_components(
+    const fossil_image_t *src,
+    fossil_connectivity_t connectivity,
+    uint32_t *labels,
+    fossil_image_component_t *components,
+    uint32_t max_components,
+    uint32_t *out_count
+) {
+    if (!src || !src->data || !out_count || src->format != FOSSIL_PIXEL_FORMAT_GRAY8)
+        return false;
+    if (connectivity != FOSSIL_CONNECTIVITY_4 && connectivity != FOSSIL_CONNECTIVITY_8)
+        return false;
+    if ((components == NULL) != (max_components == 0))
+        return false;
+    const uint32_t w = src->width, h = src->height;
+    const size_t pixels = (size_t)w * h;
+    if (pixels == 0 || pixels >= UINT32_MAX)
+        return false;
+
+    component_ctx_t c = { 0 };
+    c.mask = src->data;
+    c.width = w;
+    c.eight = connectivity == FOSSIL_CONNECTIVITY_8;
+    c.labels = labels ? labels : (uint32_t *)malloc(pixels * sizeof(uint32_t));
+    c.parent = (uint32_t *)calloc(pixels + 1, sizeof(uint32_t));
+    // The seam join and the per-band accumulators rely on the scan's bands
+    const uint32_t bands = fossil_image_parallel_bands(h, COMPONENT_MIN_ROWS);
+    bool ok = c.labels && c.parent &&
+              fossil_image_parallel_for_bands(bands, h, component_scan_band, &c);
+
+    uint32_t count = 0;
+    if (ok) {
+        component_join_seams(&c, h, bands);
+        // Parents always point to smaller labels, so they are final by the
+        // time a child reads them
+        for (uint32_t i = 1; i <= (uint32_t)pixels; ++i) {
+            uint32_t p = c.parent[i];
+            if (p)
+                c.parent[i] = p == i ? ++count : c.parent[p];
+        }
+        c.tracked = count < max_components ? count : max_components;
+        if (c.tracked) {
+            c.acc = (component_acc_t *)calloc((size_t)bands * c.tracked, sizeof(component_acc_t));
+            ok = c.acc != NULL;
+        }
+    }
+    ok = ok && fossil_image_parallel_for_bands(bands, h, component_relabel_band, &c);
+
+    if (ok) {
+        for (uint32_t k = 0; k < c.tracked; ++k) {
+            component_acc_t sum = { 0 };
+            for (uint32_t b = 0; b < bands; ++b) {
+                const component_acc_t *a = &c.acc[(size_t)b * c.tracked + k];
+                if (!a->area)
+                    continue;
+                if (!sum.area) {
+                    sum = *a;
+                    continue;
+                }
+                sum.area += a->area;
+                sum.sum_x += a->sum_x;
+                sum.sum_y += a->sum_y;
+                if (a->left < sum.left) sum.left = a->left;
+                if (a->right > sum.right) sum.right = a->right;
+                if (a->top < sum.top) sum.top = a->top;
+                if (a->bottom > sum.bottom) sum.bottom = a->bottom;
+            }
+            fossil_image_component_t *out = &components[k];
+            out->area = sum.area;
+            out->left = sum.left;
+            out->top = sum.top;
+            out->right = sum.right;
+            out->bottom = sum.bottom;
+            out->centroid_x = (double)sum.sum_x / sum.area;
+            out->centroid_y = (double)sum.sum_y / sum.area;
+        }
+        *out_count = count;
+    }
+
+    free(c.acc);
+    free(c.parent);
+    if (!labels)
+        free(c.labels);
+    return ok;
+}
+
+// ------------------------------------------------------
+// Distance Transform
+// ------------------------------------------------------
+
+/*
+ * Felzenszwalb-Huttenlocher exact EDT. The column pass only has to find the
+ * nearest zero above or below, so two sweeps suffice; they walk whole rows of
+ * a column range at a time to stay cache friendly. The row pass takes the
+ * lower envelope of parabolas rooted at each column distance. Column
+ * distances are kept as exact integers and squared in double precision, so
+ * results stay exact for any image size.
+ */
+#define EDT_INF UINT32_MAX
+
+typedef struct edt_ctx {
+    const uint8_t *mask;
+    uint32_t *column;                  // distance to the nearest zero in the column
+    int32_t *sites;                    // per band: width envelope sites
+    double *bounds;                    // per band: width + 1 envelope boundaries
+    fossil_image_t *dst;
+    uint32_t width;
+    uint32_t height;
+} edt_ctx_t;
+
+static void edt_column_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    edt_ctx_t *e = (edt_ctx_t *)arg;
+    const uint32_t w = e->width, h = e->height;
+
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t *m = e->mask + (size_t)y * w;
+        uint32_t *d = e->column + (size_t)y * w;
+        const uint32_t *prev = d - w;
+        for (uint32_t x = begin; x < end; ++x) {
+            if (!m[x])
+                d[x] = 0;
+            else
+                d[x] = (y == 0 || prev[x] == EDT_INF) ? EDT_INF : prev[x] + 1;
+        }
+    }
+    for (uint32_t y = h - 1; y-- > 0;) {
+        uint32_t *d = e->column + (size_t)y * w;
+        const uint32_t *next = d + w;
+        for (uint32_t x = begin; x < end; ++x)
+            if (next[x] != EDT_INF && next[x] + 1 < d[x])
+                d[x] = next[x] + 1;
+    }
+}
+
+static void edt_row_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    edt_ctx_t *e = (edt_ctx_t *)arg;
+    const uint32_t w = e->width;
+    int32_t *v = e->sites + (size_t)band * w;
+    double *z = e->bounds + (size_t)band * (w + 1);
+    const bool wide = e->dst->format == FOSSIL_PIXEL_FORMAT_FLOAT32;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const uint32_t *g = e->column + (size_t)y * w;
+        const size_t row = (size_t)y * w;
+
+        // Lower envelope of y = (x - q)^2 + g[q]^2 over columns with a zero
+        int32_t k = -1;
+        for (uint32_t q = 0; q < w; ++q) {
+            if (g[q] == EDT_INF)
+                continue;
+            double fq = (double)g[q] * g[q] + (double)q * q;
+            if (k < 0) {
+                k = 0;
+                v[0] = (int32_t)q;
+                z[0] = -HUGE_VAL;
+                z[1] = HUGE_VAL;
+                continue;
+            }
+            double s;
+            for (;;) {
+                int32_t p = v[k];
+                double fp = (double)g[p] * g[p] + (double)p * p;
+                s = (fq - fp) / (2.0 * ((double)q - p));
+                if (s > z[k])
+                    break;
+                --k;
+            }
+            ++k;
+            v[k] = (int32_t)q;
+            z[k] = s;
+            z[k + 1] = HUGE_VAL;
+        }
+
+        int32_t j = 0;
+        for (uint32_t q = 0; q < w; ++q) {
+            double dist;
+            if (k < 0) {
+                dist = HUGE_VAL;
+            } else {
+                while (z[j + 1] < (double)q)
+                    ++j;
+                double dx = (double)q - v[j], dy = g[v[j]];
+                dist = sqrt(dx * dx + dy * dy);
+            }
+            if (wide)
+                e->dst->fdata[row + q] = (float)dist;
+            else
+                ((uint16_t *)e->dst->data)[row + q] = dist < 65535.0 ? (uint16_t)(dist + 0.5) : 65535;
+        }
+    }
+}
+
+bool fossil_image_analyze_distance_transform(
+    const fossil_image_t *mask,
+    fossil_image_t *dst,
+    fossil_pixel_format_t format
+) {
+    if (!mask || !dst || !mask->data || mask->format != FOSSIL_PIXEL_FORMAT_GRAY8)
+        return false;
+    if (format != FOSSIL_PIXEL_FORMAT_FLOAT32 && format != FOSSIL_PIXEL_FORMAT_GRAY16)
+        return false;
+    const uint32_t w = mask->width, h = mask->height;
+    if (w == 0 || h == 0 || w > INT32_MAX)
+        return false;
+
+    edt_ctx_t e = { 0 };
+    e.mask = mask->data;
+    e.width = w;
+    e.height = h;
+    e.dst = dst;
+    uint32_t bands = fossil_image_parallel_bands(h, 16);
+    e.column = (uint32_t *)malloc((size_t)w * h * sizeof(uint32_t));
+    e.sites = (int32_t *)malloc((size_t)bands * w * sizeof(int32_t));
+    e.bounds = (double *)malloc((size_t)bands * (w + (size_t)1) * sizeof(double));
+    bool ok = e.column && e.sites && e.bounds && analyze_prepare_dst(dst, w, h, format) &&
+              fossil_image_parallel_for(w, 64, edt_column_band, &e) &&
+              fossil_image_parallel_for_bands(bands, h, edt_row_band, &e);
+
+    free(e.column);
+    free(e.sites);
+    free(e.bounds);
+    return ok;
+}
+
+// ------------------------------------------------------
+// Perceptual Hashing
+// ------------------------------------------------------
+
+/*
+ * All three hashes start from a small grid of luma area averages. Source rows
+ * are converted with the grayscale row kernels and folded straight into the
+ * grid with exact fractional coverage, so no resized copy is allocated and
+ * large images are averaged rather than point sampled.
+ */
+#define PHASH_SIZE 32
+#define PHASH_LOW 8
+
+typedef struct hash_grid {
+    uint32_t width;
+    uint32_t height;
+    double cells[PHASH_SIZE * PHASH_SIZE];
+} hash_grid_t;
+
+static float phash_cos[PHASH_LOW][PHASH_SIZE];
+static atomic_bool phash_cos_ready;
+static atomic_flag phash_cos_lock = ATOMIC_FLAG_INIT;
+
+/* cos(pi * (2x + 1) * u / 64) for the low-frequency DCT-II rows. */
+static const float (*phash_cos_table(void))[PHASH_SIZE] {
+    if (!atomic_load_explicit(&phash_cos_ready, memory_order_acquire)) {
+        while (atomic_flag_test_and_set_explicit(&phash_cos_lock, memory_order_acquire))
+            ;
+        if (!atomic_load_explicit(&phash_cos_ready, memory_order_relaxed)) {
+            for (int u = 0; u < PHASH_LOW; ++u)
+                for (int x = 0; x < PHASH_SIZE; ++x)
+                    phash_cos[u][x] = (float)cos(3.14159265358979323846 * (2 * x + 1) * u / (2.0 * PHASH_SIZE));
+            atomic_store_explicit(&phash_cos_ready, true, memory_order_release);
+        }
+        atomic_flag_clear_explicit(&phash_cos_lock, memory_order_release);
+    }
+    return (const float (*)[PHASH_SIZE])phash_cos;
+}
+
+/* Luma of row y on a 0-255 scale; line and tmp hold one row each. */
+static void analyze_luma_row(const fossil_image_t *image, uint32_t y, float *line, void *tmp) {
+    const uint32_t w = image->width;
+    const uint32_t c = image->channels;
+    const size_t base = (size_t)y * w;
+
+    switch (image->format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8:
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = image->data[base + x];
+            break;
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = image->data[(base + x) * c];
+            break;
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32: {
+            uint8_t *luma = (uint8_t *)tmp;
+            fossil_image_process_luma8_row(image->data + base * c, luma, w, c);
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = luma[x];
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_GRAY16: {
+            const uint16_t *p = (const uint16_t *)image->data + base;
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = p[x] * (1.0f / 257.0f);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64: {
+            uint16_t *luma = (uint16_t *)tmp;
+            fossil_image_process_luma16_row((const uint16_t *)image->data + base * c, luma, w, c);
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = luma[x] * (1.0f / 257.0f);
+            break;
+        }
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+            for (uint32_t x = 0; x < w; ++x)
+                line[x] = image->fdata[base + x] * 255.0f;
+            break;
+        default: {
+            const float *p = image->fdata + base * c;
+            for (uint32_t x = 0; x < w; ++x, p += c)
+                line[x] = (0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]) * 255.0f;
+            break;
+        }
+    }
+}
+
+/*
+ * Add v * (coverage of source span [i, i + 1) over each grid cell) to out,
+ * with the source axis of length n mapped onto cells grid cells.
+ */
+static inline void hash_spread(double *out, size_t stride, uint32_t i, uint32_t n, uint32_t cells, double v) {
+    double a = (double)i * cells / n, b = (double)(i + 1) * cells / n;
+    for (uint32_t k = (uint32_t)a; k < cells && k < b; ++k) {
+        double lo = a > k ? a : k;
+        double hi = b < k + 1 ? b : k + 1;
+        out[k * stride] += v * (hi - lo);
+    }
+}
+
+static bool hash_build_grid(const fossil_image_t *image, hash_grid_t *grid) {
+    const uint32_t w = image->width, h = image->height;
+    const uint32_t gw = grid->width, gh = grid->height;
+    float *line = (float *)malloc((size_t)w * sizeof(float));
+    void *tmp = malloc((size_t)w * sizeof(uint16_t));
+    if (!line || !tmp) {
+        free(line);
+        free(tmp);
+        return false;
+    }
+
+    memset(grid->cells, 0, sizeof(grid->cells));
+    for (uint32_t y = 0; y < h; ++y) {
+        double row[PHASH_SIZE] = { 0 };
+        analyze_luma_row(image, y, line, tmp);
+        for (uint32_t x = 0; x < w; ++x)
+            hash_spread(row, 1, x, w, gw, line[x]);
+        for (uint32_t c = 0; c < gw; ++c)
+            hash_spread(grid->cells + c, gw, y, h, gh, row[c]);
+    }
+
+    free(line);
+    free(tmp);
+    return true;
+}
+
+static int hash_compare_float(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t hash_from_grid(const hash_grid_t *g, fossil_hash_type_t type) {
+    uint64_t hash = 0;
+    switch (type) {
+        case FOSSIL_HASH_AVERAGE: {
+            double mean = 0.0;
+            for (int i = 0; i < 64; ++i)
+                mean += g->cells[i];
+            mean /= 64.0;
+            for (int i = 0; i < 64; ++i)
+                if (g->cells[i] > mean)
+                    hash |= 1ull << i;
+            break;
+        }
+        case FOSSIL_HASH_DIFFERENCE:
+            for (int y = 0; y < 8; ++y)
+                for (int x = 0; x < 8; ++x)
+                    if (g->cells[y * 9 + x + 1] > g->cells[y * 9 + x])
+                        hash |= 1ull << (y * 8 + x);
+            break;
+        default: {
+            const float (*cs)[PHASH_SIZE] = phash_cos_table();
+            float rows[PHASH_SIZE][PHASH_LOW];
+            float coef[64], sorted[64];
+            for (int y = 0; y < PHASH_SIZE; ++y) {
+                const double *src = g->cells + y * PHASH_SIZE;
+                for (int u = 0; u < PHASH_LOW; ++u) {
+                    float acc = 0.0f;
+                    for (int x = 0; x < PHASH_SIZE; ++x)
+                        acc += (float)src[x] * cs[u][x];
+                    rows[y][u] = acc;
+                }
+            }
+            for (int v = 0; v < PHASH_LOW; ++v) {
+                for (int u = 0; u < PHASH_LOW; ++u) {
+                    float acc = 0.0f;
+                    for (int y = 0; y < PHASH_SIZE; ++y)
+                        acc += rows[y][u] * cs[v][y];
+                    coef[v * PHASH_LOW + u] = sorted[v * PHASH_LOW + u] = acc;
+                }
+            }
+            qsort(sorted, 64, sizeof(float), hash_compare_float);
+            float median = 0.5f * (sorted[31] + sorted[32]);
+            for (int i = 0; i < 64; ++i)
+                if (coef[i] > median)
+                    hash |= 1ull << i;
+            break;
+        }
+    }
+    return hash;
+}
+
+bool fossil_image_analyze_hash(const fossil_image_t *image, fossil_hash_type_t type, uint64_t *out_hash) {
+    if (!image || !image->data || !out_hash || image->width == 0 || image->height == 0)
+        return false;
+    if (!gradient_format_supported(image->format))
+        return false;
+
+    hash_grid_t grid;
+    switch (type) {
+        case FOSSIL_HASH_AVERAGE:
+            grid.width = grid.height = 8;
+            break;
+        case FOSSIL_HASH_DIFFERENCE:
+            grid.width = 9;
+            grid.height = 8;
+            break;
+        case FOSSIL_HASH_PERCEPTUAL:
+            grid.width = grid.height = PHASH_SIZE;
+            break;
+        default:
+            return false;
+    }
+    if (!hash_build_grid(image, &grid))
+        return false;
+    *out_hash = hash_from_grid(&grid, type);
+    return true;
+}
+
+typedef struct hash_batch_ctx {
+    const fossil_image_t *const *images;
+    uint64_t *hashes;
+    fossil_hash_type_t type;
+    atomic_bool failed;
+} hash_batch_ctx_t;
+
+static void hash_batch_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    hash_batch_ctx_t *b = (hash_batch_ctx_t *)arg;
+    for (uint32_t i = begin; i < end; ++i) {
+        if (!fossil_image_analyze_hash(b->images[i], b->type, &b->hashes[i])) {
+            b->hashes[i] = 0;
+            atomic_store_explicit(&b->failed, true, memory_order_relaxed);
+        }
+    }
+}
+
+bool fossil_image_analyze_hash_batch(
+    const fossil_image_t *const *images,
+    uint32_t count,
+    fossil_hash_type_t type,
+    uint64_t *out_hashes
+) {
+    if (!images || !out_hashes)
+        return false;
+    if (type != FOSSIL_HASH_AVERAGE && type != FOSSIL_HASH_DIFFERENCE && type != FOSSIL_HASH_PERCEPTUAL)
+        return false;
+
+    hash_batch_ctx_t b;
+    b.images = images;
+    b.hashes = out_hashes;
+    b.type = type;
+    atomic_init(&b.failed, false);
+    if (count && !fossil_image_parallel_for(count, 1, hash_batch_band, &b))
+        return false;
+    return !atomic_load(&b.failed);
+}
+
+static inline uint32_t hash_popcount(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (uint32_t)((v * 0x0101010101010101ull) >> 56);
+}
+
+uint32_t fossil_image_analyze_hash_distance(uint64_t a, uint64_t b) {
+    return hash_popcount(a ^ b);
+}
+
+size_t fossil_image_analyze_hash_search(
+    const uint64_t *hashes,
+    size_t count,
+    uint64_t query,
+    uint32_t max_distance,
+    size_t *out_indices,
+    size_t max_results
+) {
+    if (!hashes || (max_results && !out_indices))
+        return 0;
+
+    // Distances for a block at a time in a branch-free loop the compiler
+    // vectorizes; matches are collected from the block afterwards
+    enum { BLOCK = 256 };
+    uint8_t dist[BLOCK];
+    size_t found = 0;
+    for (size_t base = 0; base < count; base += BLOCK) {
+        size_t n = count - base < BLOCK ? count - base : BLOCK;
+        const uint64_t *h = hashes + base;
+        for (size_t i = 0; i < n; ++i)
+            dist[i] = (uint8_t)hash_popcount(h[i] ^ query);
+        for (size_t i = 0; i < n; ++i) {
+            if (dist[i] <= max_distance) {
+                if (found < max_results)
+                    out_indices[found] = base + i;
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+
+// ------------------------------------------------------
+// Image Quality
+// ------------------------------------------------------
+
+typedef struct mse_ctx {
+    const fossil_image_t *a;
+    const fossil_image_t *b;
+    size_t row_samples;
+    double *partial;                   // per band: sum of squared differences
+} mse_ctx_t;
+
+static uint64_t mse_row8(const uint8_t *a, const uint8_t *b, size_t n) {
+    uint64_t total = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Each 32-bit lane gains at most 2 * 2 * 255^2 per block, so flushing
+    // every 4096 blocks keeps it from overflowing
+    const __m128i zero = _mm_setzero_si128();
+    while (n - i >= 16) {
+        size_t blocks = (n - i) / 16;
+        if (blocks > 4096)
+            blocks = 4096;
+        __m128i acc = zero;
+        for (size_t k = 0; k < blocks; ++k, i += 16) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+            __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero));
+            __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, acc);
+        total += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+    for (; i < n; ++i) {
+        int32_t d = (int32_t)a[i] - b[i];
+        total += (uint32_t)(d * d);
+    }
+    return total;
+}
+
+static void mse_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    mse_ctx_t *m = (mse_ctx_t *)arg;
+    const size_t n = m->row_samples;
+    double sum = 0.0;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const size_t base = (size_t)y * n;
+        switch (fossil_image_bytes_per_pixel(m->a->format) / m->a->channels) {
+            case 1:
+                sum += (double)mse_row8(m->a->data + base, m->b->data + base, n);
+                break;
+            case 2: {
+                const uint16_t *a = (const uint16_t *)m->a->data + base;
+                const uint16_t *b = (const uint16_t *)m->b->data + base;
+                uint64_t row = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    int64_t d = (int64_t)a[i] - b[i];
+                    row += (uint64_t)(d * d);
+                }
+                sum += (double)row;
+                break;
+            }
+            default: {
+                const float *a = m->a->fdata + base;
+                const float *b = m->b->fdata + base;
+                double row = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    double d = (double)a[i] - b[i];
+                    row += d * d;
+                }
+                sum += row;
+                break;
+            }
+        }
+    }
+    m->partial[band] = sum;
+}
+
+bool fossil_image_analyze_mse(const fossil_image_t *a, const fossil_image_t *b, double *out_mse) {
+    if (!a || !b || !out_mse || !a->data || !b->data)
+        return false;
+    if (a->width != b->width || a->height != b->height || a->format != b->format)
+        return false;
+    if (a->width == 0 || a->height == 0 || a->channels == 0 || fossil_image_bytes_per_pixel(a->format) == 0)
+        return false;
+
+    mse_ctx_t m;
+    m.a = a;
+    m.b = b;
+    m.row_samples = (size_t)a->width * a->channels;
+    uint32_t bands = fossil_image_parallel_bands(a->height, 16);
+    m.partial = (double *)calloc(bands, sizeof(double));
+    if (!m.partial || !fossil_image_parallel_for_bands(bands, a->height, mse_band, &m)) {
+        free(m.partial);
+        return false;
+    }
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < bands; ++i)
+        sum += m.partial[i];
+    free(m.partial);
+    *out_mse = sum / ((double)m.row_samples * a->height);
+    return true;
+}
+
+bool fossil_image_analyze_psnr(const fossil_image_t *a, const fossil_image_t *b, double *out_psnr) {
+    double mse;
+    if (!out_psnr || !fossil_image_analyze_mse(a, b, &mse))
+        return false;
+
+    double peak;
+    switch (fossil_image_bytes_per_pixel(a->format) / a->channels) {
+        case 1:
+            peak = 255.0;
+            break;
+        case 2:
+            peak = 65535.0;
+            break;
+        default:
+            peak = 1.0;
+            break;
+    }
+    *out_psnr = mse > 0.0 ? 10.0 * log10(peak * peak / mse) : INFINITY;
+    return true;
+}
+
+/*
+ * SSIM works on luma scaled to 0-255 and centered on 128 so the second
+ * moments keep their precision in float. Each band slides down its output
+ * rows keeping the horizontally filtered x, y, x^2, y^2 and xy of the last
+ * taps input rows in a ring, so every input row is filtered once and each
+ * output row costs a single vertical combine.
+ */
+#define SSIM_GAUSSIAN_TAPS 11
+#define SSIM_BOX_TAPS 8
+#define SSIM_C1 6.5025f                // (0.01 * 255)^2
+#define SSIM_C2 58.5225f               // (0.03 * 255)^2
+#define SSIM_MIN_ROWS 16
+
+typedef struct ssim_ctx {
+    const float *x;
+    const float *y;
+    uint32_t width;
+    uint32_t taps;
+    float weights[SSIM_GAUSSIAN_TAPS];
+    uint32_t out_width;
+    float *scratch;                    // per band: (taps + 1) * 5 * out_width
+    double *sums;                      // per band: sum of SSIM, sum of contrast-structure
+    float *map;                        // optional out_width x out_height SSIM values
+} ssim_ctx_t;
+
+static uint32_t ssim_window(fossil_ssim_window_t window, float *weights) {
+    if (window == FOSSIL_SSIM_BOX) {
+        for (uint32_t i = 0; i < SSIM_BOX_TAPS; ++i)
+            weights[i] = 1.0f / SSIM_BOX_TAPS;
+        return SSIM_BOX_TAPS;
+    }
+    double total = 0.0, g[SSIM_GAUSSIAN_TAPS];
+    for (int i = 0; i < SSIM_GAUSSIAN_TAPS; ++i) {
+        double d = i - SSIM_GAUSSIAN_TAPS / 2;
+        g[i] = exp(-d * d / (2.0 * 1.5 * 1.5));
+        total += g[i];
+    }
+    for (int i = 0; i < SSIM_GAUSSIAN_TAPS; ++i)
+        weights[i] = (float)(g[i] / total);
+    return SSIM_GAUSSIAN_TAPS;
+}
+
+static void ssim_filter_row(const ssim_ctx_t *s, uint32_t row, float *out) {
+    const uint32_t ow = s->out_width;
+    const float *x = s->x + (size_t)row * s->width;
+    const float *y = s->y + (size_t)row * s->width;
+    float *mx = out, *my = out + ow, *mxx = out + 2 * ow, *myy = out + 3 * ow, *mxy = out + 4 * ow;
+
+    memset(out, 0, 5 * (size_t)ow * sizeof(float));
+    for (uint32_t k = 0; k < s->taps; ++k) {
+        const float w = s->weights[k];
+        const float *xk = x + k, *yk = y + k;
+        for (uint32_t c = 0; c < ow; ++c) {
+            float xv = xk[c], yv = yk[c];
+            mx[c] += w * xv;
+            my[c] += w * yv;
+            mxx[c] += w * xv * xv;
+            myy[c] += w * yv * yv;
+            mxy[c] += w * xv * yv;
+        }
+    }
+}
+
+static void ssim_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    ssim_ctx_t *s = (ssim_ctx_t *)arg;
+    const uint32_t ow = s->out_width, taps = s->taps;
+    const size_t stride = 5 * (size_t)ow;
+    float *ring = s->scratch + (size_t)band * (taps + 1) * stride;
+    float *acc = ring + (size_t)taps * stride;
+    double sum_ssim = 0.0, sum_cs = 0.0;
+
+    for (uint32_t r = begin; r + 1 < begin + taps; ++r)
+        ssim_filter_row(s, r, ring + (size_t)(r % taps) * stride);
+
+    for (uint32_t r = begin; r < end; ++r) {
+        ssim_filter_row(s, r + taps - 1, ring + (size_t)((r + taps - 1) % taps) * stride);
+
+        memset(acc, 0, stride * sizeof(float));
+        for (uint32_t k = 0; k < taps; ++k) {
+            const float w = s->weights[k];
+            const float *src = ring + (size_t)((r + k) % taps) * stride;
+            for (size_t i = 0; i < stride; ++i)
+                acc[i] += w * src[i];
+        }
+
+        const float *mx = acc, *my = acc + ow, *mxx = acc + 2 * ow, *myy = acc + 3 * ow, *mxy = acc + 4 * ow;
+        float *map = s->map ? s->map + (size_t)r * ow : NULL;
+        for (uint32_t c = 0; c < ow; ++c) {
+            float vx = mxx[c] - mx[c] * mx[c];
+            float vy = myy[c] - my[c] * my[c];
+            float cov = mxy[c] - mx[c] * my[c];
+            float ux = mx[c] + 128.0f, uy = my[c] + 128.0f;
+            float l = (2.0f * ux * uy + SSIM_C1) / (ux * ux + uy * uy + SSIM_C1);
+            float cs = (2.0f * cov + SSIM_C2) / (vx + vy + SSIM_C2);
+            sum_ssim += l * cs;
+            sum_cs += cs;
+            if (map)
+                map[c] = l * cs;
+        }
+    }
+    s->sums[2 * band] = sum_ssim;
+    s->sums[2 * band + 1] = sum_cs;
+}
+
+/* Mean SSIM and mean contrast-structure term over the valid windows of x and y. */
+static bool ssim_planes(
+    const float *x, const float *y, uint32_t w, uint32_t h,
+    fossil_ssim_window_t window, float *map, double *out_ssim, double *out_cs
+) {
+    ssim_ctx_t s;
+    s.x = x;
+    s.y = y;
+    s.width = w;
+    s.taps = ssim_window(window, s.weights);
+    if (w < s.taps || h < s.taps)
+        return false;
+    s.out_width = w - s.taps + 1;
+    s.map = map;
+
+    const uint32_t oh = h - s.taps + 1;
+    uint32_t bands = fossil_image_parallel_bands(oh, SSIM_MIN_ROWS);
+    s.scratch = (float *)malloc((size_t)bands * (s.taps + 1) * 5 * s.out_width * sizeof(float));
+    s.sums = (double *)calloc(2 * (size_t)bands, sizeof(double));
+    bool ok = s.scratch && s.sums && fossil_image_parallel_for_bands(bands, oh, ssim_band, &s);
+    if (ok) {
+        double sum_ssim = 0.0, sum_cs = 0.0;
+        for (uint32_t i = 0; i < bands; ++i) {
+            sum_ssim += s.sums[2 * i];
+            sum_cs += s.sums[2 * i + 1];
+        }
+        double windows = (double)s.out_width * oh;
+        *out_ssim = sum_ssim / windows;
+        if (out_cs)
+            *out_cs = sum_cs / windows;
+    }
+    free(s.scratch);
+    free(s.sums);
+    return ok;
+}
+
+/* Centered luma plane of the image, or NULL on failure. */
+static float *quality_load_plane(const fossil_image_t *image) {
+    const uint32_t w = image->width, h = image->height;
+    float *plane = (float *)malloc((size_t)w * h * sizeof(float));
+    void *tmp = malloc((size_t)w * sizeof(uint16_t));
+    if (!plane || !tmp) {
+        free(plane);
+        free(tmp);
+        return NULL;
+    }
+    for (uint32_t y = 0; y < h; ++y) {
+        float *row = plane + (size_t)y * w;
+        analyze_luma_row(image, y, row, tmp);
+        for (uint32_t x = 0; x < w; ++x)
+            row[x] -= 128.0f;
+    }
+    free(tmp);
+    return plane;
+}
+
+static bool quality_validate(const fossil_image_t *a, const fossil_image_t *b) {
+    if (!a || !b || !a->data || !b->data)
+        return false;
+    if (a->width != b->width || a->height != b->height)
+        return false;
+    return gradient_format_supported(a->format) && gradient_format_supported(b->format);
+}
+
+bool fossil_image_analyze_ssim(
+    const fossil_image_t *a,
+    const fossil_image_t *b,
+    fossil_ssim_window_t window,
+    double *out_ssim,
+    fossil_image_t *ssim_map
+) {
+    if (!quality_validate(a, b) || !out_ssim)
+        return false;
+    if (window != FOSSIL_SSIM_GAUSSIAN && window != FOSSIL_SSIM_BOX)
+        return false;
+    const uint32_t taps = window == FOSSIL_SSIM_BOX ? SSIM_BOX_TAPS : SSIM_GAUSSIAN_TAPS;
+    if (a->width < taps || a->height < taps)
+        return false;
+
+    float *x = quality_load_plane(a);
+    float *y = quality_load_plane(b);
+    bool ok = x && y;
+    if (ok && ssim_map)
+        ok = analyze_prepare_dst(ssim_map, a->width - taps + 1, a->height - taps + 1, FOSSIL_PIXEL_FORMAT_FLOAT32);
+    ok = ok && ssim_planes(x, y, a->width, a->height, window, ssim_map ? ssim_map->fdata : NULL, out_ssim, NULL);
+    free(x);
+    free(y);
+    return ok;
+}
+
+/* 2x2 average into a plane of half the size, dropping an odd last row or column. */
+static void quality_halve(const float *src, uint32_t w, uint32_t h, float *dst) {
+    const uint32_t hw = w / 2, hh = h / 2;
+    for (uint32_t y = 0; y < hh; ++y) {
+        const float *r0 = src + (size_t)(2 * y) * w;
+        const float *r1 = r0 + w;
+        float *out = dst + (size_t)y * hw;
+        for (uint32_t x = 0; x < hw; ++x)
+            out[x] = 0.25f * (r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1]);
+    }
+}
+
+bool fossil_image_analyze_ms_ssim(const fossil_image_t *a, const fossil_image_t *b, double *out_ms_ssim) {
+    static const double scale_weights[5] = { 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+
+    if (!quality_validate(a, b) || !out_ms_ssim)
+        return false;
+    uint32_t w = a->width, h = a->height;
+    if (w < SSIM_GAUSSIAN_TAPS || h < SSIM_GAUSSIAN_TAPS)
+        return false;
+
+    // Use as many of the five scales as keep a full window, and renormalize
+    // the weights over them
+    uint32_t scales = 1;
+    while (scales < 5 && (w >> scales) >= SSIM_GAUSSIAN_TAPS && (h >> scales) >= SSIM_GAUSSIAN_TAPS)
+        ++scales;
+    double weight_total = 0.0;
+    for (uint32_t i = 0; i < scales; ++i)
+        weight_total += scale_weights[i];
+
+    float *x = quality_load_plane(a);
+    float *y = quality_load_plane(b);
+    float *hx = (float *)malloc(((size_t)w / 2) * (h / 2) * sizeof(float) + sizeof(float));
+    float *hy = (float *)malloc(((size_t)w / 2) * (h / 2) * sizeof(float) + sizeof(float));
+    bool ok = x && y && hx && hy;
+
+    double result = 1.0;
+    for (uint32_t i = 0; ok && i < scales; ++i) {
+        double ssim, cs;
+        ok = ssim_planes(x, y, w, h, FOSSIL_SSIM_GAUSSIAN, NULL, &ssim, &cs);
+        if (!ok)
+            break;
+        double term = i + 1 == scales ? ssim : cs;
+        result *= pow(term > 0.0 ? term : 0.0, scale_weights[i] / weight_total);
+        if (i + 1 < scales) {
+            quality_halve(x, w, h, hx);
+            quality_halve(y, w, h, hy);
+            float *t = x;
+            x = hx;
+            hx = t;
+            t = y;
+            y = hy;
+            hy = t;
+            w /= 2;
+            h /= 2;
+        }
+    }
+    free(x);
+    free(y);
+    free(hx);
+    free(hy);
+    if (ok)
+        *out_ms_ssim = result;
+    return ok;
+}
+
+// ------------------------------------------------------
+// Template Matching
+// ------------------------------------------------------
+
+/*
+ * Copy a GRAY8 or FLOAT32 image into a float plane centered on its mean;
+ * centering keeps the float correlation sums small.
+ */
+static float *match_load_plane(const fossil_image_t *image) {
+    size_t n = (size_t)image->width * image->height;
+    float *plane = (float *)malloc(n * sizeof(float));
+    if (!plane)
+        return NULL;
+    double sum = 0.0;
+    if (image->format == FOSSIL_PIXEL_FORMAT_GRAY8) {
+        for (size_t i = 0; i < n; ++i) {
+            plane[i] = (float)image->data[i];
+            sum += plane[i];
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            plane[i] = image->fdata[i];
+            sum += plane[i];
+        }
+    }
+    double mean = sum / (double)n;
+    for (size_t i = 0; i < n; ++i)
+        plane[i] = (float)(plane[i] - mean);
+    return plane;
+}
+
+typedef struct match_ctx {
+    const float *plane;         // image minus its global mean
+    double *sum;                // summed-area tables, (width + 1) x (height + 1)
+    double *sqsum;
+    const float *corr;          // plane correlated with the zero-mean template
+    float *scores;
+    fossil_image_match_t *cands;
+    uint32_t *cand_counts;
+    uint32_t max_peaks;
+    uint32_t width;
+    uint32_t height;
+    uint32_t out_width;
+    uint32_t out_height;
+    uint32_t templ_width;
+    uint32_t templ_height;
+    double templ_energy;        // sum of squared zero-mean template values
+} match_ctx_t;
+
+static void match_sat_rows(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    match_ctx_t *m = (match_ctx_t *)arg;
+    const size_t stride = (size_t)m->width + 1;
+    for (uint32_t y = begin; y < end; ++y) {
+        const float *src = m->plane + (size_t)y * m->width;
+        double *s = m->sum + (size_t)(y + 1) * stride;
+        double *q = m->sqsum + (size_t)(y + 1) * stride;
+        double rs = 0.0, rq = 0.0;
+        s[0] = q[0] = 0.0;
+        for (uint32_t x = 0; x < m->width; ++x) {
+            double v = src[x];
+            rs += v;
+            rq += v * v;
+            s[x + 1] = rs;
+            q[x + 1] = rq;
+        }
+    }
+}
+
+static void match_sat_columns(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    match_ctx_t *m = (match_ctx_t *)arg;
+    const size_t stride = (size_t)m->width + 1;
+    for (uint32_t y = 1; y <= m->height; ++y) {
+        double *s = m->sum + (size_t)y * stride;
+        double *q = m->sqsum + (size_t)y * stride;
+        for (uint32_t x = begin; x < end; ++x) {
+            s[x] += s[x - stride];
+            q[x] += q[x - stride];
+        }
+    }
+}
+
+static void match_score_rows(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    match_ctx_t *m = (match_ctx_t *)arg;
+    const size_t stride = (size_t)m->width + 1;
+    const uint32_t tw = m->templ_width, th = m->templ_height;
+    const double n = (double)tw * th;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const double *s0 = m->sum + (size_t)y * stride;
+        const double *s1 = m->sum + (size_t)(y + th) * stride;
+        const double *q0 = m->sqsum + (size_t)y * stride;
+        const double *q1 = m->sqsum + (size_t)(y + th) * stride;
+        const float *corr = m->corr + (size_t)(y + th / 2) * m->width + tw / 2;
+        float *out = m->scores + (size_t)y * m->out_width;
+        for (uint32_t x = 0; x < m->out_width; ++x) {
+            double sum = s1[x + tw] - s1[x] - s0[x + tw] + s0[x];
+            double sq = q1[x + tw] - q1[x] - q0[x + tw] + q0[x];
+            double var = sq - sum * sum / n;
+            // Flat windows carry no signal; treat them as uncorrelated
+            if (var <= sq * 1e-10) {
+                out[x] = 0.0f;
+                continue;
+            }
+            double score = corr[x] / sqrt(var * m->templ_energy);
+            out[x] = (float)(score > 1.0 ? 1.0 : (score < -1.0 ? -1.0 : score));
+        }
+    }
+}
+
+/* Keep cands sorted by descending score, at most k entries. */
+static uint32_t match_insert(fossil_image_match_t *cands, uint32_t count, uint32_t k, fossil_image_match_t c) {
+    if (count == k && cands[k - 1].score >= c.score)
+        return count;
+    uint32_t i = count < k ? count++ : k - 1;
+    while (i > 0 && cands[i - 1].score < c.score) {
+        cands[i] = cands[i - 1];
+        --i;
+    }
+    cands[i] = c;
+    return count;
+}
+
+static void match_peak_rows(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    match_ctx_t *m = (match_ctx_t *)arg;
+    const uint32_t w = m->out_width, h = m->out_height;
+    fossil_image_match_t *cands = m->cands + (size_t)band * m->max_peaks;
+    uint32_t count = 0;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        for (uint32_t x = 0; x < w; ++x) {
+            float v = m->scores[(size_t)y * w + x];
+            if (count == m->max_peaks && cands[count - 1].score >= v)
+                continue;
+            // Local maximum of the 3x3 neighbourhood; on plateaus the first
+            // sample in raster order wins
+            bool peak = true;
+            for (int dy = -1; dy <= 1 && peak; ++dy) {
+                int64_t ny = (int64_t)y + dy;
+                if (ny < 0 || ny >= h)
+                    continue;
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int64_t nx = (int64_t)x + dx;
+                    if ((dx == 0 && dy == 0) || nx < 0 || nx >= w)
+                        continue;
+                    float nv = m->scores[(size_t)ny * w + (size_t)nx];
+                    bool before = dy < 0 || (dy == 0 && dx < 0);
+                    if (nv > v || (before && nv == v)) {
+                        peak = false;
+                        break;
+                    }
+                }
+            }
+            if (peak) {
+                fossil_image_match_t c = { x, y, v };
+                count = match_insert(cands, count, m->max_peaks, c);
+            }
+        }
+    }
+    m->cand_counts[band] = count;
+}
+
+bool fossil_image_analyze_match_template(
+    const fossil_image_t *image,
+    const fossil_image_t *templ,
+    fossil_image_t *score_map,
+    fossil_image_match_t *peaks,
+    uint32_t max_peaks,
+    uint32_t *out_peak_count
+) {
+    if (!image || !templ || !image->data || !templ->data)
+        return false;
+    if ((peaks || max_peaks) && (!peaks || !max_peaks || !out_peak_count))
+        return false;
+    if ((image->format != FOSSIL_PIXEL_FORMAT_GRAY8 && image->format != FOSSIL_PIXEL_FORMAT_FLOAT32) ||
+        (templ->format != FOSSIL_PIXEL_FORMAT_GRAY8 && templ->format != FOSSIL_PIXEL_FORMAT_FLOAT32))
+        return false;
+    if (templ->width == 0 || templ->height == 0 ||
+        templ->width > image->width || templ->height > image->height)
+        return false;
+
+    match_ctx_t m = { 0 };
+    m.width = image->width;
+    m.height = image->height;
+    m.templ_width = templ->width;
+    m.templ_height = templ->height;
+    m.out_width = image->width - templ->width + 1;
+    m.out_height = image->height - templ->height + 1;
+    m.max_peaks = max_peaks;
+
+    float *kernel = match_load_plane(templ);
+    if (!kernel)
+        return false;
+    size_t taps = (size_t)templ->width * templ->height;
+    for (size_t i = 0; i < taps; ++i)
+        m.templ_energy += (double)kernel[i] * kernel[i];
+    // A template without variation correlates with nothing: every score is 0
+    const bool flat = m.templ_energy <= 1e-12;
+
+    size_t pixels = (size_t)m.width * m.height;
+    size_t sat_size = ((size_t)m.width + 1) * ((size_t)m.height + 1);
+    float *plane = match_load_plane(image);
+    float *corr = (float *)malloc(pixels * sizeof(float));
+    float *scores = NULL;
+    if (score_map) {
+        if (analyze_prepare_dst(score_map, m.out_width, m.out_height, FOSSIL_PIXEL_FORMAT_FLOAT32))
+            scores = score_map->fdata;
+    } else {
+        scores = (float *)malloc((size_t)m.out_width * m.out_height * sizeof(float));
+    }
+    m.sum = (double *)malloc(sat_size * sizeof(double));
+    m.sqsum = (double *)malloc(sat_size * sizeof(double));
+    bool ok = plane && corr && scores && m.sum && m.sqsum;
+
+    m.scores = scores;
+    if (ok && flat) {
+        memset(scores, 0, (size_t)m.out_width * m.out_height * sizeof(float));
+    } else if (ok) {
+        m.plane = plane;
+        m.corr = corr;
+        memset(m.sum, 0, (m.width + (size_t)1) * sizeof(double));
+        memset(m.sqsum, 0, (m.width + (size_t)1) * sizeof(double));
+        fossil_image_parallel_for(m.height, 64, match_sat_rows, &m);
+        fossil_image_parallel_for(m.width + 1, 256, match_sat_columns, &m);
+
+        // The numerator is the correlation of the centered image with the
+        // zero-mean template; filter_correlate picks direct or FFT by cost
+        memcpy(corr, plane, pixels * sizeof(float));
+        fossil_image_t view = { 0 };
+        view.width = m.width;
+        view.height = m.height;
+        view.channels = 1;
+        view.format = FOSSIL_PIXEL_FORMAT_FLOAT32;
+        view.fdata = corr;
+        view.size = pixels * sizeof(float);
+        ok = fossil_image_filter_correlate(&view, kernel, m.templ_width, m.templ_height, FOSSIL_CONV_AUTO) &&
+             fossil_image_parallel_for(m.out_height, 16, match_score_rows, &m);
+    }
+
+    if (ok && max_peaks) {
+        uint32_t bands = fossil_image_parallel_bands(m.out_height, 16);
+        m.cands = (fossil_image_match_t *)malloc((size_t)bands * max_peaks * sizeof(fossil_image_match_t));
+        m.cand_counts = (uint32_t *)calloc(bands, sizeof(uint32_t));
+        ok = m.cands && m.cand_counts && fossil_image_parallel_for_bands(bands, m.out_height, match_peak_rows, &m);
+        if (ok) {
+            uint32_t count = 0;
+            for (uint32_t b = 0; b < bands; ++b)
+                for (uint32_t i = 0; i < m.cand_counts[b]; ++i)
+                    count = match_insert(peaks, count, max_peaks, m.cands[(size_t)b * max_peaks + i]);
+            *out_peak_count = count;
+        }
+        free(m.cands);
+        free(m.cand_counts);
+    }
+
+    free(kernel);
+    free(plane);
+    free(corr);
+    if (!score_map)
+        free(scores);
+    free(m.sum);
+    free(m.sqsum);
+    return ok;
+}
@@ -23,10 +23,16 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/image/color.h"
+#include "fossil/image/tile.h"
 #include <math.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // ======================================================
 // Fossil Image — Color Sub-Library Implementation
 // ======================================================
@@ -85,6 +91,60 @@ bool fossil_image_color_brightness(fossil_image_t *image, int offset) {
     return true;
 }
 
+/*
+ * Tiled brightness: each tile row is handed to fossil_image_color_brightness
+ * as a one-row view, so tiles get exactly the row-major result and the
+ * zero padding past the image edge is never touched.
+ */
+typedef struct color_tiled_ctx {
+    const fossil_image_tiled_t *tiled;
+    int offset;
+} color_tiled_ctx_t;
+
+static void color_brightness_tile(void *arg, const fossil_image_tile_t *tile, uint32_t band) {
+    const color_tiled_ctx_t *t = (const color_tiled_ctx_t *)arg;
+    fossil_image_t view;
+    (void)band;
+    memset(&view, 0, sizeof(view));
+    view.width = tile->width;
+    view.height = 1;
+    view.channels = t->tiled->channels;
+    view.format = t->tiled->format;
+    view.size = (size_t)tile->width * fossil_image_bytes_per_pixel(view.format);
+    for (uint32_t r = 0; r < tile->height; ++r) {
+        uint8_t *row = tile->data + (size_t)r * tile->stride;
+        view.data = row;
+        view.fdata = (float *)row;
+        fossil_image_color_brightness(&view, t->offset);
+    }
+}
+
+bool fossil_image_color_brightness_tiled(fossil_image_tiled_t *tiled, int offset) {
+    if (!tiled || !tiled->data)
+        return false;
+    switch (tiled->format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8:
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            break;
+        default:
+            return false;
+    }
+
+    color_tiled_ctx_t t;
+    t.tiled = tiled;
+    t.offset = offset;
+    return fossil_image_tile_for_each(tiled, color_brightness_tile, &t);
+}
+
 bool fossil_image_color_contrast(fossil_image_t *image, float factor) {
     if (!image)
         return false;
@@ -136,6 +196,129 @@ bool fossil_image_color_contrast(fossil_image_t *image, float factor) {
     return true;
 }
 
+// ------------------------------------------------------
+// 16-bit gamma LUT cache
+// ------------------------------------------------------
+
+/*
+ * A full 65536-entry table costs 65536 powf calls to build, so tables are
+ * kept in a small cache keyed by the bit pattern of the gamma value. Entries
+ * are reference counted while a caller walks its image; only idle entries
+ * are evicted (least recently used first). A miss builds the table outside
+ * the lock, so concurrent callers with different gammas never serialize on
+ * the powf loop. If every slot is busy the table is used once and freed.
+ */
+#define GAMMA16_CACHE_SLOTS 4
+
+typedef struct gamma16_entry {
+    uint32_t key;
+    unsigned refs;
+    unsigned long stamp;
+    bool cached;
+    uint16_t lut[65536];
+} gamma16_entry_t;
+
+static gamma16_entry_t *gamma16_cache[GAMMA16_CACHE_SLOTS];
+static unsigned long gamma16_clock;
+static atomic_flag gamma16_lock = ATOMIC_FLAG_INIT;
+
+static void gamma16_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&gamma16_lock, memory_order_acquire))
+        ;
+}
+
+static void gamma16_lock_release(void) {
+    atomic_flag_clear_explicit(&gamma16_lock, memory_order_release);
+}
+
+static uint32_t gamma16_key(float gamma) {
+    uint32_t key;
+    memcpy(&key, &gamma, sizeof(key));
+    return key;
+}
+
+static gamma16_entry_t *gamma16_lookup(uint32_t key) {
+    for (int i = 0; i < GAMMA16_CACHE_SLOTS; ++i) {
+        gamma16_entry_t *e = gamma16_cache[i];
+        if (e && e->key == key) {
+            e->refs++;
+            e->stamp = ++gamma16_clock;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static gamma16_entry_t *gamma16_acquire(float gamma) {
+    uint32_t key = gamma16_key(gamma);
+
+    gamma16_lock_acquire();
+    gamma16_entry_t *entry = gamma16_lookup(key);
+    gamma16_lock_release();
+    if (entry)
+        return entry;
+
+    gamma16_entry_t *fresh = (gamma16_entry_t *)malloc(sizeof(*fresh));
+    if (!fresh)
+        return NULL;
+    fresh->key = key;
+    fresh->refs = 1;
+    fresh->cached = false;
+
+    double inv_gamma = 1.0 / (double)gamma;
+    fresh->lut[0] = 0;
+    for (int i = 1; i < 65536; ++i) {
+        double v = pow(i / 65535.0, inv_gamma) * 65535.0 + 0.5;
+        fresh->lut[i] = (uint16_t)(v >= 65535.0 ? 65535 : v);
+    }
+
+    gamma16_lock_acquire();
+    // Another caller may have published the same table meanwhile
+    entry = gamma16_lookup(key);
+    if (!entry) {
+        int victim = -1;
+        for (int i = 0; i < GAMMA16_CACHE_SLOTS; ++i) {
+            gamma16_entry_t *e = gamma16_cache[i];
+            if (!e) { victim = i; break; }
+            if (e->refs == 0 && (victim < 0 || e->stamp < gamma16_cache[victim]->stamp))
+                victim = i;
+        }
+        if (victim >= 0) {
+            free(gamma16_cache[victim]);
+            fresh->cached = true;
+            fresh->stamp = ++gamma16_clock;
+            gamma16_cache[victim] = fresh;
+        }
+        entry = fresh;
+        fresh = NULL;
+    }
+    gamma16_lock_release();
+
+    free(fresh);
+    return entry;
+}
+
+static void gamma16_release(gamma16_entry_t *entry) {
+    gamma16_lock_acquire();
+    bool drop = !entry->cached;
+    entry->refs--;
+    gamma16_lock_release();
+    if (drop)
+        free(entry);
+}
+
+void fossil_image_color_gamma_cache_clear(void) {
+    gamma16_lock_acquire();
+    for (int i = 0; i < GAMMA16_CACHE_SLOTS; ++i) {
+        gamma16_entry_t *e = gamma16_cache[i];
+        if (e && e->refs == 0) {
+            free(e);
+            gamma16_cache[i] = NULL;
+        }
+    }
+    gamma16_lock_release();
+}
+
 bool fossil_image_color_gamma(fossil_image_t *image, float gamma) {
     if (!image || gamma <= 0.0f)
         return false;
@@ -164,12 +347,13 @@ bool fossil_image_color_gamma(fossil_image_t *image, float gamma) {
         case FOSSIL_PIXEL_FORMAT_RGBA64:
         {
             if (!image->data) return false;
+            gamma16_entry_t *entry = gamma16_acquire(gamma);
+            if (!entry) return false;
+            const uint16_t *lut = entry->lut;
             uint16_t *data16 = (uint16_t *)image->data;
-            float inv_gamma = 1.0f / gamma;
-            for (size_t i = 0; i < pixels; ++i) {
-                float norm = data16[i] / 65535.0f;
-                data16[i] = (uint16_t)(clamp8(powf(norm, inv_gamma) * 65535.0f));
-            }
+            for (size_t i = 0; i < pixels; ++i)
+                data16[i] = lut[data16[i]];
+            gamma16_release(entry);
             break;
         }
         case FOSSIL_PIXEL_FORMAT_FLOAT32:
@@ -189,43 +373,172 @@ bool fossil_image_color_gamma(fossil_image_t *image, float gamma) {
     return true;
 }
 
-static void rgb_to_hsv(float r, float g, float b, float *h, float *s, float *v) {
-    float max = fmaxf(r, fmaxf(g, b));
-    float min = fminf(r, fminf(g, b));
-    float delta = max - min;
+// ------------------------------------------------------
+// HSV helpers
+// ------------------------------------------------------
 
-    *v = max;
-    *s = (max == 0) ? 0 : (delta / max);
+/**
+ * Branch-free HSV adjustment over planar rows of normalized floats.
+ * Hue is carried in sextants ([0, 6) instead of degrees) so wrapping is a
+ * masked add rather than fmodf, and the six-way sector chain of the classic
+ * conversion collapses to f(n) = v - v*s*clamp(min(k, 4 - k), 0, 1) with
+ * k = (n + h) mod 6. The SSE2 path evaluates four pixels per iteration with
+ * compare masks in place of branches; the portable loop below it uses the
+ * same formulation for the tail and for other targets.
+ */
+static inline float sel_max(float a, float b) { return a > b ? a : b; }
+static inline float sel_min(float a, float b) { return a < b ? a : b; }
+static inline float sel_unit(float v) { return sel_min(sel_max(v, 0.0f), 1.0f); }
 
-    if (delta == 0) {
-        *h = 0;
-    } else if (max == r) {
-        *h = 60.0f * fmodf(((g - b) / delta), 6.0f);
-    } else if (max == g) {
-        *h = 60.0f * (((b - r) / delta) + 2.0f);
-    } else {
-        *h = 60.0f * (((r - g) / delta) + 4.0f);
+#if defined(__SSE2__)
+static inline __m128 sse_select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 sse_unit(__m128 v) {
+    return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+static inline __m128 sse_hsv_channel(__m128 v, __m128 vs, __m128 h, float n) {
+    const __m128 six = _mm_set1_ps(6.0f);
+    __m128 k = _mm_add_ps(h, _mm_set1_ps(n));
+    k = _mm_sub_ps(k, _mm_and_ps(_mm_cmpge_ps(k, six), six));
+    __m128 t = _mm_min_ps(k, _mm_sub_ps(_mm_set1_ps(4.0f), k));
+    return _mm_sub_ps(v, _mm_mul_ps(vs, sse_unit(t)));
+}
+#endif
+
+static void hsv_adjust_planar(
+    float *restrict r,
+    float *restrict g,
+    float *restrict b,
+    size_t n,
+    float hue6,
+    float sat_mult,
+    float val_mult
+) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 six = _mm_set1_ps(6.0f);
+    const __m128 vhue = _mm_set1_ps(hue6);
+    const __m128 vsat = _mm_set1_ps(sat_mult);
+    const __m128 vval = _mm_set1_ps(val_mult);
+    for (; i + 4 <= n; i += 4) {
+        __m128 rr = _mm_loadu_ps(r + i);
+        __m128 gg = _mm_loadu_ps(g + i);
+        __m128 bb = _mm_loadu_ps(b + i);
+        __m128 mx = _mm_max_ps(rr, _mm_max_ps(gg, bb));
+        __m128 mn = _mm_min_ps(rr, _mm_min_ps(gg, bb));
+        __m128 d = _mm_sub_ps(mx, mn);
+        __m128 inv_d = _mm_div_ps(one, sse_select(_mm_cmpgt_ps(d, zero), d, one));
+        __m128 inv_mx = _mm_div_ps(one, sse_select(_mm_cmpgt_ps(mx, zero), mx, one));
+
+        __m128 h_r = _mm_mul_ps(_mm_sub_ps(gg, bb), inv_d);
+        __m128 h_g = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(bb, rr), inv_d), _mm_set1_ps(2.0f));
+        __m128 h_b = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(rr, gg), inv_d), _mm_set1_ps(4.0f));
+        __m128 h = sse_select(_mm_cmpeq_ps(mx, rr), h_r,
+                              sse_select(_mm_cmpeq_ps(mx, gg), h_g, h_b));
+        h = _mm_add_ps(h, vhue);
+        h = _mm_add_ps(h, _mm_and_ps(_mm_cmplt_ps(h, zero), six));
+        h = _mm_sub_ps(h, _mm_and_ps(_mm_cmpge_ps(h, six), six));
+
+        __m128 s = sse_unit(_mm_mul_ps(_mm_mul_ps(d, inv_mx), vsat));
+        __m128 v = sse_unit(_mm_mul_ps(mx, vval));
+        __m128 vs = _mm_mul_ps(v, s);
+
+        _mm_storeu_ps(r + i, sse_hsv_channel(v, vs, h, 5.0f));
+        _mm_storeu_ps(g + i, sse_hsv_channel(v, vs, h, 3.0f));
+        _mm_storeu_ps(b + i, sse_hsv_channel(v, vs, h, 1.0f));
     }
+#endif
+    for (; i < n; ++i) {
+        float rr = r[i], gg = g[i], bb = b[i];
+        float mx = sel_max(rr, sel_max(gg, bb));
+        float mn = sel_min(rr, sel_min(gg, bb));
+        float d = mx - mn;
+        // Gray pixels (d == 0) divide by one: every hue term is zero there
+        float inv_d = 1.0f / (d > 0.0f ? d : 1.0f);
+        float inv_mx = 1.0f / (mx > 0.0f ? mx : 1.0f);
+
+        float h_r = (gg - bb) * inv_d;
+        float h_g = (bb - rr) * inv_d + 2.0f;
+        float h_b = (rr - gg) * inv_d + 4.0f;
+        float h = (mx == rr) ? h_r : ((mx == gg) ? h_g : h_b);
+        h += hue6;
+        h += (h < 0.0f) ? 6.0f : 0.0f;
+        h -= (h >= 6.0f) ? 6.0f : 0.0f;
+
+        float s = sel_unit(d * inv_mx * sat_mult);
+        float v = sel_unit(mx * val_mult);
+        float vs = v * s;
 
-    if (*h < 0) *h += 360.0f;
+        float kr = h + 5.0f; kr -= (kr >= 6.0f) ? 6.0f : 0.0f;
+        float kg = h + 3.0f; kg -= (kg >= 6.0f) ? 6.0f : 0.0f;
+        float kb = h + 1.0f; kb -= (kb >= 6.0f) ? 6.0f : 0.0f;
+
+        r[i] = v - vs * sel_unit(sel_min(kr, 4.0f - kr));
+        g[i] = v - vs * sel_unit(sel_min(kg, 4.0f - kg));
+        b[i] = v - vs * sel_unit(sel_min(kb, 4.0f - kb));
+    }
 }
 
-static void hsv_to_rgb(float h, float s, float v, float *r, float *g, float *b) {
-    float c = v * s;
-    float x = c * (1.0f - fabsf(fmodf(h / 60.0f, 2.0f) - 1.0f));
-    float m = v - c;
+/**
+ * 8-bit variant of the kernel above. With byte inputs max, min and their
+ * difference are small integers, so the per-pixel divisions and the value
+ * scale come from 256-entry tables built once per call: 1/d for the hue
+ * sextant, sat_mult/max for saturation and clamp(max/255 * val_mult) for
+ * value. Pixels are read and written in place, with no float planes.
+ */
+typedef struct hsv_u8_tables {
+    float rcp[256];                    // 1 / d, for the hue sextant
+    float sat[256];                    // sat_mult / max
+    float val[256];                    // clamped max / 255 * val_mult
+} hsv_u8_tables_t;
+
+static void hsv_u8_tables_init(hsv_u8_tables_t *t, float sat_mult, float val_mult) {
+    t->rcp[0] = 0.0f;
+    t->sat[0] = 0.0f;
+    for (int i = 1; i < 256; ++i) {
+        t->rcp[i] = 1.0f / (float)i;
+        t->sat[i] = sat_mult / (float)i;
+    }
+    for (int i = 0; i < 256; ++i)
+        t->val[i] = sel_unit((float)i * (1.0f / 255.0f) * val_mult);
+}
+
+static void hsv_adjust_u8_row(uint8_t *p, size_t c, uint32_t n, const hsv_u8_tables_t *t, float hue6) {
+    for (uint32_t i = 0; i < n; ++i, p += c) {
+        int rr = p[0], gg = p[1], bb = p[2];
+        int mx = rr > gg ? (rr > bb ? rr : bb) : (gg > bb ? gg : bb);
+        int mn = rr < gg ? (rr < bb ? rr : bb) : (gg < bb ? gg : bb);
+        int d = mx - mn;
+
+        // Gray pixels (d == 0) get a zero reciprocal, so every hue term is zero
+        float h;
+        if (mx == rr)
+            h = (float)(gg - bb) * t->rcp[d];
+        else if (mx == gg)
+            h = (float)(bb - rr) * t->rcp[d] + 2.0f;
+        else
+            h = (float)(rr - gg) * t->rcp[d] + 4.0f;
+        h += hue6;
+        h += (h < 0.0f) ? 6.0f : 0.0f;
+        h -= (h >= 6.0f) ? 6.0f : 0.0f;
 
-    float r1, g1, b1;
-    if      (h < 60)  { r1 = c; g1 = x; b1 = 0; }
-    else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
-    else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
-    else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
-    else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
-    else              { r1 = c; g1 = 0; b1 = x; }
+        float s = sel_unit((float)d * t->sat[mx]);
+        float v = t->val[mx];
+        float vs = v * s;
 
-    *r = (r1 + m);
-    *g = (g1 + m);
-    *b = (b1 + m);
+        float kr = h + 5.0f; kr -= (kr >= 6.0f) ? 6.0f : 0.0f;
+        float kg = h + 3.0f; kg -= (kg >= 6.0f) ? 6.0f : 0.0f;
+        float kb = h + 1.0f; kb -= (kb >= 6.0f) ? 6.0f : 0.0f;
+
+        p[0] = (uint8_t)((v - vs * sel_unit(sel_min(kr, 4.0f - kr))) * 255.0f + 0.5f);
+        p[1] = (uint8_t)((v - vs * sel_unit(sel_min(kg, 4.0f - kg))) * 255.0f + 0.5f);
+        p[2] = (uint8_t)((v - vs * sel_unit(sel_min(kb, 4.0f - kb))) * 255.0f + 0.5f);
+    }
 }
 
 bool fossil_image_color_hsv_adjust(
@@ -237,96 +550,89 @@ bool fossil_image_color_hsv_adjust(
     if (!image)
         return false;
 
-    size_t npixels = (size_t)image->width * image->height;
-
+    bool is_u8 = false, is_u16 = false;
     switch (image->format) {
         case FOSSIL_PIXEL_FORMAT_RGB24:
         case FOSSIL_PIXEL_FORMAT_RGBA32:
         case FOSSIL_PIXEL_FORMAT_YUV24:
-        {
             if (!image->data || image->channels < 3)
                 return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = image->data[i * image->channels + 0] / 255.0f;
-                float g = image->data[i * image->channels + 1] / 255.0f;
-                float b = image->data[i * image->channels + 2] / 255.0f;
-
-                float h, s, v;
-                rgb_to_hsv(r, g, b, &h, &s, &v);
-                h += hue_shift;
-                if (h < 0) h += 360.0f;
-                if (h >= 360.0f) h -= 360.0f;
-
-                s = fminf(fmaxf(s * sat_mult, 0.0f), 1.0f);
-                v = fminf(fmaxf(v * val_mult, 0.0f), 1.0f);
-
-                hsv_to_rgb(h, s, v, &r, &g, &b);
-
-                image->data[i * image->channels + 0] = clamp8(r * 255.0f);
-                image->data[i * image->channels + 1] = clamp8(g * 255.0f);
-                image->data[i * image->channels + 2] = clamp8(b * 255.0f);
-            }
+            is_u8 = true;
             break;
-        }
         case FOSSIL_PIXEL_FORMAT_RGB48:
         case FOSSIL_PIXEL_FORMAT_RGBA64:
-        {
             if (!image->data || image->channels < 3)
                 return false;
-            uint16_t *data16 = (uint16_t *)image->data;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = data16[i * image->channels + 0] / 65535.0f;
-                float g = data16[i * image->channels + 1] / 65535.0f;
-                float b = data16[i * image->channels + 2] / 65535.0f;
-
-                float h, s, v;
-                rgb_to_hsv(r, g, b, &h, &s, &v);
-                h += hue_shift;
-                if (h < 0) h += 360.0f;
-                if (h >= 360.0f) h -= 360.0f;
-
-                s = fminf(fmaxf(s * sat_mult, 0.0f), 1.0f);
-                v = fminf(fmaxf(v * val_mult, 0.0f), 1.0f);
-
-                hsv_to_rgb(h, s, v, &r, &g, &b);
-
-                data16[i * image->channels + 0] = (uint16_t)(fminf(fmaxf(r * 65535.0f, 0.0f), 65535.0f));
-                data16[i * image->channels + 1] = (uint16_t)(fminf(fmaxf(g * 65535.0f, 0.0f), 65535.0f));
-                data16[i * image->channels + 2] = (uint16_t)(fminf(fmaxf(b * 65535.0f, 0.0f), 65535.0f));
-            }
+            is_u16 = true;
             break;
-        }
         case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
         case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
-        {
             if (!image->fdata || image->channels < 3)
                 return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = image->fdata[i * image->channels + 0];
-                float g = image->fdata[i * image->channels + 1];
-                float b = image->fdata[i * image->channels + 2];
+            break;
+        default:
+            return false;
+    }
+
+    // Normalize the shift to [0, 360)
+    float hue = fmodf(hue_shift, 360.0f);
+    if (hue < 0.0f) hue += 360.0f;
 
-                float h, s, v;
-                rgb_to_hsv(r, g, b, &h, &s, &v);
-                h += hue_shift;
-                if (h < 0) h += 360.0f;
-                if (h >= 360.0f) h -= 360.0f;
+    // Every other case, pure hue shifts included, runs the same kernel so the
+    // result is continuous in all three parameters
+    if (hue == 0.0f && sat_mult == 1.0f && val_mult == 1.0f)
+        return true;
 
-                s = fminf(fmaxf(s * sat_mult, 0.0f), 1.0f);
-                v = fminf(fmaxf(v * val_mult, 0.0f), 1.0f);
+    uint32_t w = image->width;
+    size_t c = image->channels;
+    float hue6 = hue / 60.0f;
 
-                hsv_to_rgb(h, s, v, &r, &g, &b);
+    if (is_u8) {
+        hsv_u8_tables_t tables;
+        hsv_u8_tables_init(&tables, sat_mult, val_mult);
+        for (uint32_t y = 0; y < image->height; ++y)
+            hsv_adjust_u8_row(image->data + (size_t)y * w * c, c, w, &tables, hue6);
+        return true;
+    }
+
+    float *planes = (float *)malloc((size_t)w * 3 * sizeof(float));
+    if (!planes)
+        return false;
+    float *pr = planes, *pg = planes + w, *pb = planes + 2 * (size_t)w;
 
-                image->fdata[i * image->channels + 0] = r;
-                image->fdata[i * image->channels + 1] = g;
-                image->fdata[i * image->channels + 2] = b;
+    for (uint32_t y = 0; y < image->height; ++y) {
+        size_t row = (size_t)y * w * c;
+        if (is_u16) {
+            const float k = 1.0f / 65535.0f;
+            uint16_t *p = (uint16_t *)image->data + row;
+            for (uint32_t x = 0; x < w; ++x) {
+                pr[x] = p[x * c + 0] * k;
+                pg[x] = p[x * c + 1] * k;
+                pb[x] = p[x * c + 2] * k;
+            }
+            hsv_adjust_planar(pr, pg, pb, w, hue6, sat_mult, val_mult);
+            for (uint32_t x = 0; x < w; ++x) {
+                p[x * c + 0] = (uint16_t)(pr[x] * 65535.0f + 0.5f);
+                p[x * c + 1] = (uint16_t)(pg[x] * 65535.0f + 0.5f);
+                p[x * c + 2] = (uint16_t)(pb[x] * 65535.0f + 0.5f);
+            }
+        } else {
+            float *p = image->fdata + row;
+            for (uint32_t x = 0; x < w; ++x) {
+                pr[x] = p[x * c + 0];
+                pg[x] = p[x * c + 1];
+                pb[x] = p[x * c + 2];
+            }
+            hsv_adjust_planar(pr, pg, pb, w, hue6, sat_mult, val_mult);
+            for (uint32_t x = 0; x < w; ++x) {
+                p[x * c + 0] = pr[x];
+                p[x * c + 1] = pg[x];
+                p[x * c + 2] = pb[x];
             }
-            break;
         }
-        default:
-            return false;
     }
 
+    free(planes);
     return true;
 }
 
@@ -399,81 +705,16 @@ bool fossil_image_color_to_grayscale(fossil_image_t *image) {
     if (!image)
         return false;
 
-    size_t npixels = (size_t)image->width * image->height;
-
     switch (image->format) {
         case FOSSIL_PIXEL_FORMAT_RGB24:
         case FOSSIL_PIXEL_FORMAT_RGBA32:
         case FOSSIL_PIXEL_FORMAT_YUV24:
-        case FOSSIL_PIXEL_FORMAT_INDEXED8:
-        {
-            if (!image->data || image->channels < 3)
-                return false;
-            uint8_t *new_data = (uint8_t *)calloc(npixels, 1);
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint8_t r = image->data[i * image->channels + 0];
-                uint8_t g = image->data[i * image->channels + 1];
-                uint8_t b = image->data[i * image->channels + 2];
-                new_data[i] = (uint8_t)(0.299f * r + 0.587f * g + 0.114f * b);
-            }
-            if (image->owns_data)
-                free(image->data);
-            image->data = new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-            image->size = npixels;
-            image->owns_data = true;
-            return true;
-        }
         case FOSSIL_PIXEL_FORMAT_RGB48:
         case FOSSIL_PIXEL_FORMAT_RGBA64:
-        {
-            if (!image->data || image->channels < 3)
-                return false;
-            uint16_t *data16 = (uint16_t *)image->data;
-            uint16_t *new_data = (uint16_t *)calloc(npixels, sizeof(uint16_t));
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint16_t r = data16[i * image->channels + 0];
-                uint16_t g = data16[i * image->channels + 1];
-                uint16_t b = data16[i * image->channels + 2];
-                new_data[i] = (uint16_t)(0.299f * r + 0.587f * g + 0.114f * b);
-            }
-            if (image->owns_data)
-                free(image->data);
-            image->data = (uint8_t *)new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY16;
-            image->size = npixels * sizeof(uint16_t);
-            image->owns_data = true;
-            return true;
-        }
         case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
         case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
-        {
-            if (!image->fdata || image->channels < 3)
-                return false;
-            float *new_data = (float *)calloc(npixels, sizeof(float));
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = image->fdata[i * image->channels + 0];
-                float g = image->fdata[i * image->channels + 1];
-                float b = image->fdata[i * image->channels + 2];
-                new_data[i] = 0.299f * r + 0.587f * g + 0.114f * b;
-            }
-            if (image->owns_data)
-                free(image->fdata);
-            image->fdata = new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_FLOAT32;
-            image->size = npixels * sizeof(float);
-            image->owns_data = true;
-            return true;
-        }
+            // Shares the fixed-point, allocation-free luma kernels
+            return fossil_image_process_grayscale(image);
         case FOSSIL_PIXEL_FORMAT_GRAY8:
         case FOSSIL_PIXEL_FORMAT_GRAY16:
         case FOSSIL_PIXEL_FORMAT_FLOAT32:
@@ -483,3 +724,739 @@ bool fossil_image_color_to_grayscale(fossil_image_t *image) {
             return false;
     }
 }
+
+// ------------------------------------------------------
+// sRGB transfer function
+// ------------------------------------------------------
+
+static float srgb_decode_value(float v) {
+    if (v <= 0.04045f)
+        return v * (1.0f / 12.92f);
+    return powf((v + 0.055f) * (1.0f / 1.055f), 2.4f);
+}
+
+static float srgb_encode_value(float v) {
+    if (!(v > 0.0f))
+        return 0.0f;
+    if (v >= 1.0f)
+        return 1.0f;
+    if (v <= 0.0031308f)
+        return v * 12.92f;
+    return 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+}
+
+/*
+ * Decode tables are built on first use and published with a single
+ * compare-and-swap; a thread that loses the race frees its copy.
+ */
+static _Atomic(float *) srgb8_decode_lut;
+static _Atomic(float *) srgb16_decode_lut;
+
+static const float *srgb_decode_table(_Atomic(float *) *slot, size_t entries) {
+    float *table = atomic_load_explicit(slot, memory_order_acquire);
+    if (table)
+        return table;
+
+    float *fresh = (float *)malloc(entries * sizeof(float));
+    if (!fresh)
+        return NULL;
+    float scale = 1.0f / (float)(entries - 1);
+    for (size_t i = 0; i < entries; ++i)
+        fresh[i] = srgb_decode_value((float)i * scale);
+
+    float *expected = NULL;
+    if (atomic_compare_exchange_strong_explicit(slot, &expected, fresh,
+            memory_order_acq_rel, memory_order_acquire))
+        return fresh;
+    free(fresh);
+    return expected;
+}
+
+#if defined(__SSE2__)
+/*
+ * Vector encode. x^(1/2.4) = x^(5/12) starts from an exponent-scaling
+ * guess on the float bit pattern and is refined with four Newton steps on
+ * y^12 = x^5, which lands within float rounding of powf. Inputs are
+ * clamped to [0, 1]; the linear toe is blended in with a compare mask.
+ */
+static inline __m128 sse_srgb_encode(__m128 x) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 toe = _mm_set1_ps(0.0031308f);
+    x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), one);
+
+    __m128 xp = _mm_max_ps(x, toe);
+    __m128 bits = _mm_cvtepi32_ps(_mm_castps_si128(xp));
+    const __m128 k = _mm_set1_ps(1065353216.0f);
+    __m128 guess = _mm_add_ps(k, _mm_mul_ps(_mm_sub_ps(bits, k), _mm_set1_ps(5.0f / 12.0f)));
+    __m128 y = _mm_castsi128_ps(_mm_cvttps_epi32(guess));
+
+    __m128 x2 = _mm_mul_ps(xp, xp);
+    __m128 x5 = _mm_mul_ps(_mm_mul_ps(x2, x2), xp);
+    const __m128 eleven = _mm_set1_ps(11.0f);
+    const __m128 twelfth = _mm_set1_ps(1.0f / 12.0f);
+    for (int i = 0; i < 4; ++i) {
+        __m128 y2 = _mm_mul_ps(y, y);
+        __m128 y4 = _mm_mul_ps(y2, y2);
+        __m128 y11 = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(y4, y4), y2), y);
+        y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(eleven, y), _mm_div_ps(x5, y11)), twelfth);
+    }
+
+    __m128 curve = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.055f), y), _mm_set1_ps(0.055f));
+    __m128 linear = _mm_mul_ps(x, _mm_set1_ps(12.92f));
+    return sse_select(_mm_cmple_ps(x, toe), linear, curve);
+}
+#endif
+
+static size_t srgb_channels(fossil_pixel_format_t format) {
+    switch (format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+            return 1;
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+            return 3;
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+static int srgb_depth(fossil_pixel_format_t format) {
+    switch (format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+            return 8;
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+            return 16;
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            return 32;
+        default:
+            return 0;
+    }
+}
+
+void fossil_image_color_srgb8_to_linear_row(
+    const uint8_t *src,
+    float *dst,
+    size_t pixels,
+    size_t channels
+) {
+    size_t n = pixels * channels;
+    const float *lut = srgb_decode_table(&srgb8_decode_lut, 256);
+    if (lut) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = lut[src[i]];
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = srgb_decode_value(src[i] * (1.0f / 255.0f));
+    }
+    // Alpha is stored linearly
+    if (channels == 4) {
+        for (size_t i = 3; i < n; i += 4)
+            dst[i] = src[i] * (1.0f / 255.0f);
+    }
+}
+
+void fossil_image_color_srgb16_to_linear_row(
+    const uint16_t *src,
+    float *dst,
+    size_t pixels,
+    size_t channels
+) {
+    size_t n = pixels * channels;
+    const float *lut = srgb_decode_table(&srgb16_decode_lut, 65536);
+    if (lut) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = lut[src[i]];
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = srgb_decode_value(src[i] * (1.0f / 65535.0f));
+    }
+    if (channels == 4) {
+        for (size_t i = 3; i < n; i += 4)
+            dst[i] = src[i] * (1.0f / 65535.0f);
+    }
+}
+
+void fossil_image_color_linear_to_srgb8_row(
+    const float *src,
+    uint8_t *dst,
+    size_t pixels,
+    size_t channels
+) {
+    size_t n = pixels * channels;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_add_ps(_mm_mul_ps(sse_srgb_encode(_mm_loadu_ps(src + i)), scale), half);
+        __m128i q = _mm_cvttps_epi32(v);
+        q = _mm_packs_epi32(q, q);
+        q = _mm_packus_epi16(q, q);
+        uint32_t packed = (uint32_t)_mm_cvtsi128_si32(q);
+        memcpy(dst + i, &packed, sizeof(packed));
+    }
+#endif
+    for (; i < n; ++i)
+        dst[i] = (uint8_t)(srgb_encode_value(src[i]) * 255.0f + 0.5f);
+    if (channels == 4) {
+        for (i = 3; i < n; i += 4) {
+            float a = src[i];
+            a = a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+            dst[i] = (uint8_t)(a * 255.0f + 0.5f);
+        }
+    }
+}
+
+void fossil_image_color_linear_to_srgb16_row(
+    const float *src,
+    uint16_t *dst,
+    size_t pixels,
+    size_t channels
+) {
+    size_t n = pixels * channels;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(65535.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16((short)0x8000);
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_add_ps(_mm_mul_ps(sse_srgb_encode(_mm_loadu_ps(src + i)), scale), half);
+        // SSE2 has no unsigned 32->16 pack: bias into signed range and back
+        __m128i q = _mm_sub_epi32(_mm_cvttps_epi32(v), bias);
+        q = _mm_xor_si128(_mm_packs_epi32(q, q), flip);
+        _mm_storel_epi64((__m128i *)(void *)(dst + i), q);
+    }
+#endif
+    for (; i < n; ++i)
+        dst[i] = (uint16_t)(srgb_encode_value(src[i]) * 65535.0f + 0.5f);
+    if (channels == 4) {
+        for (i = 3; i < n; i += 4) {
+            float a = src[i];
+            a = a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+            dst[i] = (uint16_t)(a * 65535.0f + 0.5f);
+        }
+    }
+}
+
+bool fossil_image_color_linear_rows_supported(fossil_pixel_format_t format) {
+    return srgb_depth(format) != 0;
+}
+
+bool fossil_image_color_decode_linear_row(
+    fossil_pixel_format_t format,
+    const void *src,
+    float *dst,
+    size_t pixels
+) {
+    if (!src || !dst)
+        return false;
+    size_t channels = srgb_channels(format);
+    switch (srgb_depth(format)) {
+        case 8:
+            fossil_image_color_srgb8_to_linear_row((const uint8_t *)src, dst, pixels, channels);
+            return true;
+        case 16:
+            fossil_image_color_srgb16_to_linear_row((const uint16_t *)src, dst, pixels, channels);
+            return true;
+        case 32:
+            memmove(dst, src, pixels * channels * sizeof(float));
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool fossil_image_color_encode_linear_row(
+    fossil_pixel_format_t format,
+    const float *src,
+    void *dst,
+    size_t pixels
+) {
+    if (!src || !dst)
+        return false;
+    size_t channels = srgb_channels(format);
+    switch (srgb_depth(format)) {
+        case 8:
+            fossil_image_color_linear_to_srgb8_row(src, (uint8_t *)dst, pixels, channels);
+            return true;
+        case 16:
+            fossil_image_color_linear_to_srgb16_row(src, (uint16_t *)dst, pixels, channels);
+            return true;
+        case 32:
+            memmove(dst, src, pixels * channels * sizeof(float));
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool fossil_image_color_srgb_to_linear(fossil_image_t *image) {
+    if (!image || !image->data)
+        return false;
+
+    fossil_pixel_format_t target;
+    switch (image->format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+            target = FOSSIL_PIXEL_FORMAT_FLOAT32;
+            break;
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+            target = FOSSIL_PIXEL_FORMAT_FLOAT32_RGB;
+            break;
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+            target = FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA;
+            break;
+        default:
+            return false;
+    }
+
+    size_t channels = srgb_channels(image->format);
+    size_t samples = (size_t)image->width * image->height * channels;
+    float *fdata = (float *)malloc(samples * sizeof(float));
+    if (!fdata)
+        return false;
+    fossil_image_color_decode_linear_row(image->format, image->data, fdata,
+                                         (size_t)image->width * image->height);
+
+    if (image->owns_data)
+        free(image->data);
+    image->fdata = fdata;
+    image->format = target;
+    image->channels = (uint32_t)channels;
+    image->size = samples * sizeof(float);
+    image->owns_data = true;
+    return true;
+}
+
+bool fossil_image_color_linear_to_srgb(
+    fossil_image_t *image,
+    fossil_pixel_format_t format
+) {
+    if (!image || !image->fdata || srgb_depth(image->format) != 32)
+        return false;
+
+    int depth = srgb_depth(format);
+    size_t channels = srgb_channels(format);
+    if ((depth != 8 && depth != 16) || channels != image->channels)
+        return false;
+
+    size_t pixels = (size_t)image->width * image->height;
+    size_t size = pixels * channels * (size_t)(depth / 8);
+    uint8_t *data = (uint8_t *)malloc(size);
+    if (!data)
+        return false;
+    fossil_image_color_encode_linear_row(format, image->fdata, data, pixels);
+
+    if (image->owns_data)
+        free(image->fdata);
+    image->data = data;
+    image->format = format;
+    image->size = size;
+    image->owns_data = true;
+    return true;
+}
+
+// ------------------------------------------------------
+// Palette quantization
+// ------------------------------------------------------
+
+/*
+ * Colours are binned on a 5-bit-per-channel grid (32768 cells). Median cut
+ * splits boxes of that grid; the inverse colour map caches the nearest
+ * palette entry per cell, filled lazily so only colours that occur are ever
+ * searched.
+ */
+#define QUANT_SHIFT 3
+#define QUANT_LEVELS 32
+#define QUANT_CELLS (QUANT_LEVELS * QUANT_LEVELS * QUANT_LEVELS)
+#define QUANT_UNSET 0xFFFFu
+
+static inline uint32_t quant_cell(int r, int g, int b) {
+    return ((uint32_t)(r >> QUANT_SHIFT) << 10) |
+           ((uint32_t)(g >> QUANT_SHIFT) << 5) |
+           (uint32_t)(b >> QUANT_SHIFT);
+}
+
+static bool quant_source_ok(const fossil_image_t *image) {
+    if (!image || !image->data || image->width == 0 || image->height == 0)
+        return false;
+    return image->format == FOSSIL_PIXEL_FORMAT_GRAY8 ||
+           image->format == FOSSIL_PIXEL_FORMAT_RGB24 ||
+           image->format == FOSSIL_PIXEL_FORMAT_RGBA32;
+}
+
+static inline void quant_fetch(const uint8_t *px, uint32_t channels, int rgb[3]) {
+    rgb[0] = px[0];
+    rgb[1] = channels >= 3 ? px[1] : px[0];
+    rgb[2] = channels >= 3 ? px[2] : px[0];
+}
+
+typedef struct quant_box {
+    uint8_t lo[3];
+    uint8_t hi[3];
+    uint64_t count;
+} quant_box_t;
+
+typedef struct quant_hist {
+    uint32_t count[QUANT_CELLS];
+    uint64_t sum[QUANT_CELLS][3];
+} quant_hist_t;
+
+static inline uint32_t quant_index(int r, int g, int b) {
+    return ((uint32_t)r << 10) | ((uint32_t)g << 5) | (uint32_t)b;
+}
+
+/* Tighten a box to the occupied cells and recount its population. */
+static void quant_box_shrink(const quant_hist_t *hist, quant_box_t *box) {
+    uint8_t lo[3] = { 31, 31, 31 };
+    uint8_t hi[3] = { 0, 0, 0 };
+    uint64_t count = 0;
+    for (int r = box->lo[0]; r <= box->hi[0]; ++r) {
+        for (int g = box->lo[1]; g <= box->hi[1]; ++g) {
+            for (int b = box->lo[2]; b <= box->hi[2]; ++b) {
+                uint32_t n = hist->count[quant_index(r, g, b)];
+                if (!n)
+                    continue;
+                count += n;
+                if (r < lo[0]) lo[0] = (uint8_t)r;
+                if (r > hi[0]) hi[0] = (uint8_t)r;
+                if (g < lo[1]) lo[1] = (uint8_t)g;
+                if (g > hi[1]) hi[1] = (uint8_t)g;
+                if (b < lo[2]) lo[2] = (uint8_t)b;
+                if (b > hi[2]) hi[2] = (uint8_t)b;
+            }
+        }
+    }
+    box->count = count;
+    if (count) {
+        memcpy(box->lo, lo, sizeof(lo));
+        memcpy(box->hi, hi, sizeof(hi));
+    }
+}
+
+/* Split along the longest axis at the population median. */
+static bool quant_box_split(const quant_hist_t *hist, quant_box_t *box, quant_box_t *out) {
+    int axis = 0;
+    int span = box->hi[0] - box->lo[0];
+    for (int a = 1; a < 3; ++a) {
+        if (box->hi[a] - box->lo[a] > span) {
+            span = box->hi[a] - box->lo[a];
+            axis = a;
+        }
+    }
+    if (span == 0)
+        return false;
+
+    uint64_t half = box->count / 2;
+    uint64_t acc = 0;
+    int cut = box->lo[axis];
+    for (int v = box->lo[axis]; v < box->hi[axis]; ++v) {
+        int lo[3] = { box->lo[0], box->lo[1], box->lo[2] };
+        int hi[3] = { box->hi[0], box->hi[1], box->hi[2] };
+        lo[axis] = hi[axis] = v;
+        for (int r = lo[0]; r <= hi[0]; ++r)
+            for (int g = lo[1]; g <= hi[1]; ++g)
+                for (int b = lo[2]; b <= hi[2]; ++b)
+                    acc += hist->count[quant_index(r, g, b)];
+        cut = v;
+        if (acc >= half)
+            break;
+    }
+
+    *out = *box;
+    box->hi[axis] = (uint8_t)cut;
+    out->lo[axis] = (uint8_t)(cut + 1);
+    quant_box_shrink(hist, box);
+    quant_box_shrink(hist, out);
+    return true;
+}
+
+bool fossil_image_color_palette_median_cut(
+    const fossil_image_t *image,
+    uint32_t max_colors,
+    uint8_t *palette,
+    uint32_t *out_count
+) {
+    if (!quant_source_ok(image) || !palette || !out_count)
+        return false;
+    if (max_colors == 0 || max_colors > 256)
+        return false;
+
+    quant_hist_t *hist = (quant_hist_t *)calloc(1, sizeof(*hist));
+    quant_box_t *boxes = (quant_box_t *)malloc(max_colors * sizeof(quant_box_t));
+    if (!hist || !boxes) {
+        free(hist);
+        free(boxes);
+        return false;
+    }
+
+    size_t pixels = (size_t)image->width * image->height;
+    uint32_t c = image->channels;
+    for (size_t i = 0; i < pixels; ++i) {
+        int rgb[3];
+        quant_fetch(image->data + i * c, c, rgb);
+        uint32_t cell = quant_cell(rgb[0], rgb[1], rgb[2]);
+        hist->count[cell]++;
+        hist->sum[cell][0] += (uint64_t)rgb[0];
+        hist->sum[cell][1] += (uint64_t)rgb[1];
+        hist->sum[cell][2] += (uint64_t)rgb[2];
+    }
+
+    uint32_t nboxes = 1;
+    boxes[0] = (quant_box_t){ { 0, 0, 0 }, { 31, 31, 31 }, 0 };
+    quant_box_shrink(hist, &boxes[0]);
+
+    // Always split the box with the largest population times extent
+    while (nboxes < max_colors) {
+        int best = -1;
+        uint64_t best_score = 0;
+        for (uint32_t i = 0; i < nboxes; ++i) {
+            int span = 0;
+            for (int a = 0; a < 3; ++a)
+                if (boxes[i].hi[a] - boxes[i].lo[a] > span)
+                    span = boxes[i].hi[a] - boxes[i].lo[a];
+            uint64_t score = boxes[i].count * (uint64_t)span;
+            if (score > best_score) {
+                best_score = score;
+                best = (int)i;
+            }
+        }
+        if (best < 0 || !quant_box_split(hist, &boxes[best], &boxes[nboxes]))
+            break;
+        nboxes++;
+    }
+
+    for (uint32_t i = 0; i < nboxes; ++i) {
+        uint64_t sum[3] = { 0, 0, 0 };
+        uint64_t n = 0;
+        for (int r = boxes[i].lo[0]; r <= boxes[i].hi[0]; ++r) {
+            for (int g = boxes[i].lo[1]; g <= boxes[i].hi[1]; ++g) {
+                for (int b = boxes[i].lo[2]; b <= boxes[i].hi[2]; ++b) {
+                    uint32_t cell = quant_index(r, g, b);
+                    n += hist->count[cell];
+                    sum[0] += hist->sum[cell][0];
+                    sum[1] += hist->sum[cell][1];
+                    sum[2] += hist->sum[cell][2];
+                }
+            }
+        }
+        for (int a = 0; a < 3; ++a)
+            palette[i * 3 + a] = n ? (uint8_t)((sum[a] + n / 2) / n) : 0;
+    }
+
+    free(hist);
+    free(boxes);
+    *out_count = nboxes;
+    return true;
+}
+
+typedef struct quant_inverse {
+    uint32_t count;
+    uint8_t palette[256 * 3];
+    uint16_t cells[QUANT_CELLS];
+} quant_inverse_t;
+
+/*
+ * The most recently released inverse map is kept for reuse, so quantizing a
+ * sequence of frames against one palette fills each cell only once. A caller
+ * takes the map out of the slot while it works, which keeps lazy filling
+ * free of data races.
+ */
+static quant_inverse_t *quant_inverse_cache;
+static atomic_flag quant_inverse_lock = ATOMIC_FLAG_INIT;
+
+static quant_inverse_t *quant_inverse_acquire(const uint8_t *palette, uint32_t count) {
+    while (atomic_flag_test_and_set_explicit(&quant_inverse_lock, memory_order_acquire))
+        ;
+    quant_inverse_t *inv = quant_inverse_cache;
+    quant_inverse_cache = NULL;
+    atomic_flag_clear_explicit(&quant_inverse_lock, memory_order_release);
+
+    if (inv && inv->count == count && memcmp(inv->palette, palette, count * 3) == 0)
+        return inv;
+    if (!inv) {
+        inv = (quant_inverse_t *)malloc(sizeof(*inv));
+        if (!inv)
+            return NULL;
+    }
+    inv->count = count;
+    memcpy(inv->palette, palette, count * 3);
+    for (size_t i = 0; i < QUANT_CELLS; ++i)
+        inv->cells[i] = QUANT_UNSET;
+    return inv;
+}
+
+static void quant_inverse_release(quant_inverse_t *inv) {
+    while (atomic_flag_test_and_set_explicit(&quant_inverse_lock, memory_order_acquire))
+        ;
+    quant_inverse_t *old = quant_inverse_cache;
+    quant_inverse_cache = inv;
+    atomic_flag_clear_explicit(&quant_inverse_lock, memory_order_release);
+    free(old);
+}
+
+static inline uint8_t quant_nearest(quant_inverse_t *inv, int r, int g, int b) {
+    uint32_t cell = quant_cell(r, g, b);
+    uint16_t idx = inv->cells[cell];
+    if (idx != QUANT_UNSET)
+        return (uint8_t)idx;
+
+    // Search against the cell centre so the answer holds for the whole cell
+    int cr = (r & ~((1 << QUANT_SHIFT) - 1)) + (1 << (QUANT_SHIFT - 1));
+    int cg = (g & ~((1 << QUANT_SHIFT) - 1)) + (1 << (QUANT_SHIFT - 1));
+    int cb = (b & ~((1 << QUANT_SHIFT) - 1)) + (1 << (QUANT_SHIFT - 1));
+    uint32_t best = 0;
+    int32_t best_d = INT32_MAX;
+    for (uint32_t i = 0; i < inv->count; ++i) {
+        int dr = cr - inv->palette[i * 3 + 0];
+        int dg = cg - inv->palette[i * 3 + 1];
+        int db = cb - inv->palette[i * 3 + 2];
+        int32_t d = dr * dr + dg * dg + db * db;
+        if (d < best_d) {
+            best_d = d;
+            best = i;
+        }
+    }
+    inv->cells[cell] = (uint16_t)best;
+    return (uint8_t)best;
+}
+
+static inline int quant_clamp(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 255.0f) return 255;
+    return (int)(v + 0.5f);
+}
+
+static const uint8_t quant_bayer8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+bool fossil_image_color_map_palette(
+    fossil_image_t *image,
+    const uint8_t *palette,
+    uint32_t count,
+    fossil_dither_t dither
+) {
+    if (!quant_source_ok(image) || !palette || count == 0 || count > 256)
+        return false;
+    if (dither != FOSSIL_DITHER_NONE &&
+        dither != FOSSIL_DITHER_FLOYD_STEINBERG &&
+        dither != FOSSIL_DITHER_ORDERED)
+        return false;
+
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    uint32_t c = image->channels;
+    size_t pixels = (size_t)w * h;
+
+    uint8_t *indices = (uint8_t *)malloc(pixels);
+    uint8_t *pal = (uint8_t *)malloc((size_t)count * 3);
+    // Two rows of diffused error with one pixel of padding on each side
+    float *err = dither == FOSSIL_DITHER_FLOYD_STEINBERG
+        ? (float *)calloc(((size_t)w + 2) * 3 * 2, sizeof(float)) : NULL;
+    quant_inverse_t *inv = quant_inverse_acquire(palette, count);
+    if (!indices || !pal || !inv ||
+        (dither == FOSSIL_DITHER_FLOYD_STEINBERG && !err)) {
+        free(indices);
+        free(pal);
+        free(err);
+        if (inv)
+            quant_inverse_release(inv);
+        return false;
+    }
+    memcpy(pal, palette, (size_t)count * 3);
+
+    // Ordered dither amplitude roughly matches the palette's spacing
+    float spread = 255.0f / cbrtf((float)count);
+    float *err_cur = err;
+    float *err_next = err ? err + ((size_t)w + 2) * 3 : NULL;
+
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t *row = image->data + (size_t)y * w * c;
+        uint8_t *out = indices + (size_t)y * w;
+        for (uint32_t x = 0; x < w; ++x) {
+            int rgb[3];
+            quant_fetch(row + (size_t)x * c, c, rgb);
+            if (dither == FOSSIL_DITHER_NONE) {
+                out[x] = quant_nearest(inv, rgb[0], rgb[1], rgb[2]);
+            } else if (dither == FOSSIL_DITHER_ORDERED) {
+                float t = ((quant_bayer8[y & 7][x & 7] + 0.5f) / 64.0f - 0.5f) * spread;
+                out[x] = quant_nearest(inv,
+                    quant_clamp(rgb[0] + t), quant_clamp(rgb[1] + t), quant_clamp(rgb[2] + t));
+            } else {
+                float *e = err_cur + ((size_t)x + 1) * 3;
+                float v[3];
+                int q[3];
+                for (int a = 0; a < 3; ++a) {
+                    v[a] = rgb[a] + e[a];
+                    q[a] = quant_clamp(v[a]);
+                }
+                uint8_t idx = quant_nearest(inv, q[0], q[1], q[2]);
+                out[x] = idx;
+                float *n = err_next + (size_t)x * 3;
+                for (int a = 0; a < 3; ++a) {
+                    float d = v[a] - pal[idx * 3 + a];
+                    e[3 + a] += d * (7.0f / 16.0f);
+                    n[a] += d * (3.0f / 16.0f);
+                    n[3 + a] += d * (5.0f / 16.0f);
+                    n[6 + a] += d * (1.0f / 16.0f);
+                }
+            }
+        }
+        if (err) {
+            float *t = err_cur;
+            err_cur = err_next;
+            err_next = t;
+            memset(err_next, 0, ((size_t)w + 2) * 3 * sizeof(float));
+        }
+    }
+
+    quant_inverse_release(inv);
+    free(err);
+
+    if (image->owns_data)
+        free(image->data);
+    free(image->palette);
+    image->data = indices;
+    image->owns_data = true;
+    image->palette = pal;
+    image->palette_size = count;
+    image->format = FOSSIL_PIXEL_FORMAT_INDEXED8;
+    image->channels = 1;
+    image->size = pixels;
+    return true;
+}
+
+bool fossil_image_color_quantize(
+    fossil_image_t *image,
+    uint32_t max_colors,
+    fossil_dither_t dither
+) {
+    uint8_t palette[256 * 3];
+    uint32_t count = 0;
+    if (!fossil_image_color_palette_median_cut(image, max_colors, palette, &count))
+        return false;
+    return fossil_image_color_map_palette(image, palette, count, dither);
+}
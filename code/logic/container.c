@@ -0,0 +1,888 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/container.h"
+#include "fossil/image/parallel.h"
+#include "fossil/image/tile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define container_seek(f, off) _fseeki64((f), (__int64)(off), SEEK_SET)
+#else
+#include <sys/types.h>
+#define container_seek(f, off) fseeko((f), (off_t)(off), SEEK_SET)
+#endif
+
+// ======================================================
+// Fossil Image — Container Sub-Library Implementation
+// ======================================================
+
+/*
+ * File layout, all integers little-endian:
+ *
+ *   header    64 bytes   magic, geometry, metadata size, index offset, payload size
+ *   metadata  289 bytes  + 3 bytes per palette entry
+ *   index     20 bytes per tile: payload offset (u64), size (u32), codec (u8),
+ *             3 reserved bytes, Adler-32 of the stored payload (u32)
+ *   payloads  tiles in row-major tile order
+ *
+ * A tile holds only the pixels inside the image (edge tiles are cropped),
+ * rows packed. Samples wider than a byte (16-bit and float formats) are
+ * little-endian as well, so files move between hosts of either byte order.
+ * LZ tiles replace every byte with its difference to the same byte of the
+ * previous pixel before compression.
+ */
+#define CONTAINER_MAGIC "FSLIMGC1"
+#define CONTAINER_VERSION 1u
+#define CONTAINER_HEADER_SIZE 64u
+#define CONTAINER_META_SIZE 289u
+#define CONTAINER_ENTRY_SIZE 20u
+#define CONTAINER_FAILED 0xFFu
+
+/* Tiles handed to the parallel helper at once, and the payload memory they may use. */
+#define CONTAINER_BATCH_TILES 256u
+#define CONTAINER_BATCH_BYTES ((size_t)32 << 20)
+
+/* LZ77 in the LZ4 block layout: 4-byte minimum match, 64 KiB window. */
+#define LZ_MIN_MATCH 4u
+#define LZ_HASH_BITS 12u
+#define LZ_LAST_LITERALS 5u
+#define LZ_MATCH_LIMIT 12u
+#define LZ_WINDOW 65535u
+
+struct fossil_image_container_s {
+    FILE *file;
+    fossil_image_t meta;               // every stored field except the pixels
+    uint32_t tile_size;
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+    size_t bpp;
+    uint64_t index_offset;
+    uint64_t stored_bytes;
+};
+
+typedef struct container_entry {
+    uint64_t offset;
+    uint32_t size;
+    uint8_t codec;
+    uint32_t checksum;
+} container_entry_t;
+
+// ------------------------------------------------------
+// Byte order
+// ------------------------------------------------------
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static void put_f64(uint8_t *p, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put_u64(p, bits);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    return (uint64_t)get_u32(p) | (uint64_t)get_u32(p + 4) << 32;
+}
+
+static double get_f64(const uint8_t *p) {
+    uint64_t bits = get_u64(p);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static bool container_big_endian(void) {
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 0;
+}
+
+/* Reverse the bytes of every sample; only called on big-endian hosts. */
+static void container_swap_samples(uint8_t *p, size_t n, size_t sample) {
+    for (size_t i = 0; i + sample <= n; i += sample) {
+        for (size_t a = i, b = i + sample - 1; a < b; ++a, --b) {
+            uint8_t t = p[a];
+            p[a] = p[b];
+            p[b] = t;
+        }
+    }
+}
+
+/* Adler-32 as in zlib; the sums are reduced every 5552 bytes before they can overflow. */
+static uint32_t container_adler32(const uint8_t *p, size_t n) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (n > 0) {
+        size_t chunk = n < 5552 ? n : 5552;
+        n -= chunk;
+        while (chunk--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return b << 16 | a;
+}
+
+// ------------------------------------------------------
+// LZ codec
+// ------------------------------------------------------
+
+static inline size_t lz_bound(size_t n) {
+    return n + n / 255 + 16;
+}
+
+static inline uint32_t lz_hash(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t *lz_put_length(uint8_t *op, size_t len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+static uint8_t *lz_put_literals(uint8_t *op, uint8_t *token, const uint8_t *lit, size_t count) {
+    *token = (uint8_t)((count >= 15 ? 15 : count) << 4);
+    if (count >= 15)
+        op = lz_put_length(op, count - 15);
+    memcpy(op, lit, count);
+    return op + count;
+}
+
+/* Compress n bytes into dst (at least lz_bound(n) bytes); returns the compressed size. */
+static size_t lz_compress(const uint8_t *src, size_t n, uint8_t *dst, uint32_t *table) {
+    const uint8_t *ip = src;
+    const uint8_t *anchor = src;
+    const uint8_t *end = src + n;
+    uint8_t *op = dst;
+
+    if (n > LZ_MATCH_LIMIT) {
+        const uint8_t *limit = end - LZ_MATCH_LIMIT;
+        const uint8_t *match_end = end - LZ_LAST_LITERALS;
+        uint32_t misses = 0;
+        memset(table, 0, sizeof(uint32_t) << LZ_HASH_BITS);
+
+        while (ip <= limit) {
+            uint32_t h = lz_hash(ip);
+            const uint8_t *ref = src + table[h];
+            table[h] = (uint32_t)(ip - src);
+            if (ref >= ip || (size_t)(ip - ref) > LZ_WINDOW || memcmp(ref, ip, LZ_MIN_MATCH) != 0) {
+                // Skip faster through data that does not compress
+                size_t step = 1 + (misses++ >> 6);
+                if (step > (size_t)(limit - ip))
+                    break;
+                ip += step;
+                continue;
+            }
+            misses = 0;
+
+            size_t len = LZ_MIN_MATCH;
+            while (ip + len < match_end && ref[len] == ip[len])
+                len++;
+
+            uint8_t *token = op++;
+            op = lz_put_literals(op, token, anchor, (size_t)(ip - anchor));
+            size_t offset = (size_t)(ip - ref);
+            *op++ = (uint8_t)offset;
+            *op++ = (uint8_t)(offset >> 8);
+            size_t extra = len - LZ_MIN_MATCH;
+            *token |= (uint8_t)(extra >= 15 ? 15 : extra);
+            if (extra >= 15)
+                op = lz_put_length(op, extra - 15);
+
+            ip += len;
+            anchor = ip;
+            if (ip <= limit)
+                table[lz_hash(ip - 2)] = (uint32_t)(ip - 2 - src);
+        }
+    }
+
+    uint8_t *token = op++;
+    op = lz_put_literals(op, token, anchor, (size_t)(end - anchor));
+    return (size_t)(op - dst);
+}
+
+static bool lz_get_length(const uint8_t **ip, const uint8_t *end, size_t *len) {
+    uint8_t b;
+    do {
+        if (*ip >= end)
+            return false;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+/* Decompress exactly out_n bytes; false on any malformed input. */
+static bool lz_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t out_n) {
+    const uint8_t *ip = src;
+    const uint8_t *end = src + n;
+    uint8_t *op = dst;
+    uint8_t *out_end = dst + out_n;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !lz_get_length(&ip, end, &lit))
+            return false;
+        if (lit > (size_t)(end - ip) || lit > (size_t)(out_end - op))
+            return false;
+        memcpy(op, ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == end)
+            break;
+
+        if (end - ip < 2)
+            return false;
+        size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst))
+            return false;
+        size_t len = token & 15;
+        if (len == 15 && !lz_get_length(&ip, end, &len))
+            return false;
+        len += LZ_MIN_MATCH;
+        if (len > (size_t)(out_end - op))
+            return false;
+
+        // Overlapping matches repeat a period of offset bytes; copy it in doubling chunks
+        const uint8_t *ref = op - offset;
+        size_t done = len < offset ? len : offset;
+        memcpy(op, ref, done);
+        while (done < len) {
+            size_t chunk = len - done < done ? len - done : done;
+            memcpy(op + done, ref, chunk);
+            done += chunk;
+        }
+        op += len;
+    }
+    return op == out_end;
+}
+
+// ------------------------------------------------------
+// Tiles
+// ------------------------------------------------------
+
+static bool container_tile_size_ok(uint32_t tile_size) {
+    return tile_size >= 8 && tile_size <= 4096 && (tile_size & (tile_size - 1)) == 0;
+}
+
+/* Tiles per batch so that the batch's payloads fit CONTAINER_BATCH_BYTES. */
+static uint32_t container_batch_tiles(size_t tile_bytes) {
+    size_t tiles = CONTAINER_BATCH_BYTES / lz_bound(tile_bytes);
+    if (tiles < 1)
+        tiles = 1;
+    return tiles < CONTAINER_BATCH_TILES ? (uint32_t)tiles : CONTAINER_BATCH_TILES;
+}
+
+static void container_tile_rect(
+    uint32_t width,
+    uint32_t height,
+    uint32_t tile_size,
+    uint32_t tx,
+    uint32_t ty,
+    uint32_t *x,
+    uint32_t *y,
+    uint32_t *tw,
+    uint32_t *th
+) {
+    *x = tx * tile_size;
+    *y = ty * tile_size;
+    *tw = width - *x < tile_size ? width - *x : tile_size;
+    *th = height - *y < tile_size ? height - *y : tile_size;
+}
+
+typedef struct container_encode_job {
+    const fossil_image_t *image;
+    size_t bpp;
+    size_t swap;                       // sample size to byte-swap, or 0
+    uint32_t tile_size;
+    uint32_t tiles_x;
+    size_t first;                      // tile index of the batch's first tile
+    size_t capacity;                   // bytes per payload slot
+    fossil_image_codec_t codec;
+    uint8_t *payloads;
+    uint32_t *sizes;
+    uint8_t *codecs;
+    uint32_t *checksums;
+} container_encode_job_t;
+
+static void container_encode_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    container_encode_job_t *job = (container_encode_job_t *)arg;
+    const fossil_image_t *image = job->image;
+    size_t bpp = job->bpp;
+    size_t tile_bytes = (size_t)job->tile_size * job->tile_size * bpp;
+    (void)band;
+
+    uint8_t *raw = (uint8_t *)malloc(tile_bytes * 2);
+    uint32_t *table = (uint32_t *)malloc(sizeof(uint32_t) << LZ_HASH_BITS);
+    for (uint32_t k = begin; k < end; ++k) {
+        if (!raw || !table) {
+            job->codecs[k] = CONTAINER_FAILED;
+            continue;
+        }
+        size_t tile = job->first + k;
+        uint32_t x, y, tw, th;
+        container_tile_rect(image->width, image->height, job->tile_size,
+                            (uint32_t)(tile % job->tiles_x), (uint32_t)(tile / job->tiles_x), &x, &y, &tw, &th);
+        size_t row = (size_t)tw * bpp;
+        size_t n = row * th;
+        for (uint32_t r = 0; r < th; ++r)
+            memcpy(raw + r * row, image->data + ((size_t)(y + r) * image->width + x) * bpp, row);
+        if (job->swap)
+            container_swap_samples(raw, n, job->swap);
+
+        uint8_t *out = job->payloads + (size_t)k * job->capacity;
+        if (job->codec == FOSSIL_IMAGE_CODEC_LZ) {
+            uint8_t *filtered = raw + tile_bytes;
+            for (size_t r = 0; r < n; r += row) {
+                memcpy(filtered + r, raw + r, bpp);
+                for (size_t i = bpp; i < row; ++i)
+                    filtered[r + i] = (uint8_t)(raw[r + i] - raw[r + i - bpp]);
+            }
+            size_t size = lz_compress(filtered, n, out, table);
+            if (size < n) {
+                job->sizes[k] = (uint32_t)size;
+                job->codecs[k] = FOSSIL_IMAGE_CODEC_LZ;
+                job->checksums[k] = container_adler32(out, size);
+                continue;
+            }
+        }
+        memcpy(out, raw, n);
+        job->sizes[k] = (uint32_t)n;
+        job->codecs[k] = FOSSIL_IMAGE_CODEC_STORED;
+        job->checksums[k] = container_adler32(out, n);
+    }
+    free(raw);
+    free(table);
+}
+
+typedef struct container_decode_job {
+    const fossil_image_container_t *container;
+    const uint8_t *payloads;
+    const container_entry_t *entries;  // offsets relative to payloads
+    uint32_t tx0;
+    uint32_t ty0;
+    uint32_t nx;                       // tiles per batch row
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+    uint8_t *dst;
+    size_t dst_stride;
+    size_t swap;                       // sample size to byte-swap, or 0
+    uint8_t *failed;
+} container_decode_job_t;
+
+static void container_decode_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    container_decode_job_t *job = (container_decode_job_t *)arg;
+    const fossil_image_container_t *c = job->container;
+    size_t bpp = c->bpp;
+    (void)band;
+
+    uint8_t *scratch = (uint8_t *)malloc((size_t)c->tile_size * c->tile_size * bpp);
+    for (uint32_t k = begin; k < end; ++k) {
+        const container_entry_t *e = &job->entries[k];
+        uint32_t x, y, tw, th;
+        container_tile_rect(c->meta.width, c->meta.height, c->tile_size,
+                            job->tx0 + k % job->nx, job->ty0 + k / job->nx, &x, &y, &tw, &th);
+        size_t row = (size_t)tw * bpp;
+        size_t n = row * th;
+
+        const uint8_t *pixels = job->payloads + e->offset;
+        bool ok = scratch != NULL && container_adler32(pixels, e->size) == e->checksum;
+        if (ok && e->codec == FOSSIL_IMAGE_CODEC_STORED) {
+            ok = e->size == n;
+            if (ok && job->swap) {
+                memcpy(scratch, pixels, n);
+                pixels = scratch;
+            }
+        } else if (ok && e->codec == FOSSIL_IMAGE_CODEC_LZ) {
+            ok = lz_decompress(pixels, e->size, scratch, n);
+            for (size_t r = 0; ok && r < n; r += row)
+                for (size_t i = r + bpp; i < r + row; ++i)
+                    scratch[i] = (uint8_t)(scratch[i] + scratch[i - bpp]);
+            pixels = scratch;
+        } else {
+            ok = false;
+        }
+        job->failed[k] = !ok;
+        if (!ok)
+            continue;
+        if (job->swap)
+            container_swap_samples(scratch, n, job->swap);
+
+        // Copy the part of the tile inside the requested rectangle
+        uint32_t ix0 = x > job->x ? x : job->x;
+        uint32_t ix1 = x + tw < job->x + job->width ? x + tw : job->x + job->width;
+        uint32_t iy0 = y > job->y ? y : job->y;
+        uint32_t iy1 = y + th < job->y + job->height ? y + th : job->y + job->height;
+        for (uint32_t r = iy0; r < iy1; ++r)
+            memcpy(job->dst + (size_t)(r - job->y) * job->dst_stride + (size_t)(ix0 - job->x) * bpp,
+                   pixels + (size_t)(r - y) * row + (size_t)(ix0 - x) * bpp,
+                   (size_t)(ix1 - ix0) * bpp);
+    }
+    free(scratch);
+}
+
+// ------------------------------------------------------
+// Header and metadata
+// ------------------------------------------------------
+
+static void container_put_header(
+    uint8_t *p,
+    const fossil_image_t *image,
+    uint32_t tile_size,
+    uint32_t tiles_x,
+    uint32_t tiles_y,
+    uint32_t meta_size,
+    uint64_t stored_bytes
+) {
+    memset(p, 0, CONTAINER_HEADER_SIZE);
+    memcpy(p, CONTAINER_MAGIC, 8);
+    put_u32(p + 8, CONTAINER_VERSION);
+    put_u32(p + 12, image->width);
+    put_u32(p + 16, image->height);
+    put_u32(p + 20, image->channels);
+    put_u32(p + 24, (uint32_t)image->format);
+    put_u32(p + 28, tile_size);
+    put_u32(p + 32, tiles_x);
+    put_u32(p + 36, tiles_y);
+    put_u32(p + 40, meta_size);
+    put_u64(p + 48, CONTAINER_HEADER_SIZE + (uint64_t)meta_size);
+    put_u64(p + 56, stored_bytes);
+}
+
+static void container_put_meta(uint8_t *p, const fossil_image_t *image, uint32_t palette_size) {
+    put_u32(p, palette_size);
+    put_f64(p + 4, image->dpi_x);
+    put_f64(p + 12, image->dpi_y);
+    put_f64(p + 20, image->exposure);
+    put_u32(p + 28, image->channels_mask);
+    p[32] = image->is_ai_generated ? 1 : 0;
+    p += 33;
+    memcpy(p, image->name, sizeof(image->name));
+    p += sizeof(image->name);
+    memcpy(p, image->author, sizeof(image->author));
+    p += sizeof(image->author);
+    memcpy(p, image->creation_os, sizeof(image->creation_os));
+    p += sizeof(image->creation_os);
+    memcpy(p, image->software, sizeof(image->software));
+    p += sizeof(image->software);
+    memcpy(p, image->creation_date, sizeof(image->creation_date));
+    p += sizeof(image->creation_date);
+    if (palette_size)
+        memcpy(p, image->palette, (size_t)palette_size * 3);
+}
+
+#define CONTAINER_GET_TEXT(p, field) \
+    do { \
+        memcpy((field), (p), sizeof(field)); \
+        (field)[sizeof(field) - 1] = '\0'; \
+        (p) += sizeof(field); \
+    } while (0)
+
+static void container_get_meta(const uint8_t *p, fossil_image_t *image) {
+    image->dpi_x = get_f64(p + 4);
+    image->dpi_y = get_f64(p + 12);
+    image->exposure = get_f64(p + 20);
+    image->channels_mask = get_u32(p + 28);
+    image->is_ai_generated = p[32] != 0;
+    p += 33;
+    CONTAINER_GET_TEXT(p, image->name);
+    CONTAINER_GET_TEXT(p, image->author);
+    CONTAINER_GET_TEXT(p, image->creation_os);
+    CONTAINER_GET_TEXT(p, image->software);
+    CONTAINER_GET_TEXT(p, image->creation_date);
+}
+
+// ------------------------------------------------------
+// Writing
+// ------------------------------------------------------
+
+static bool container_write_tiles(
+    FILE *f,
+    const fossil_image_t *image,
+    size_t bpp,
+    uint32_t tile_size,
+    uint32_t tiles_x,
+    uint32_t tiles_y,
+    uint64_t index_offset,
+    fossil_image_codec_t codec,
+    uint64_t *stored_bytes
+) {
+    size_t tiles = (size_t)tiles_x * tiles_y;
+    size_t tile_bytes = (size_t)tile_size * tile_size * bpp;
+    uint32_t batch = container_batch_tiles(tile_bytes);
+
+    container_encode_job_t job;
+    job.image = image;
+    job.bpp = bpp;
+    job.swap = container_big_endian() && bpp > image->channels ? bpp / image->channels : 0;
+    job.tile_size = tile_size;
+    job.tiles_x = tiles_x;
+    job.capacity = lz_bound(tile_bytes);
+    job.codec = codec;
+    job.payloads = (uint8_t *)malloc((size_t)batch * job.capacity);
+    job.sizes = (uint32_t *)malloc(batch * sizeof(uint32_t));
+    job.codecs = (uint8_t *)malloc(batch);
+    job.checksums = (uint32_t *)malloc(batch * sizeof(uint32_t));
+    uint8_t *index = (uint8_t *)malloc((size_t)batch * CONTAINER_ENTRY_SIZE);
+
+    uint64_t data_offset = index_offset + (uint64_t)tiles * CONTAINER_ENTRY_SIZE;
+    uint64_t pos = data_offset;
+    bool ok = job.payloads && job.sizes && job.codecs && job.checksums && index &&
+              container_seek(f, data_offset) == 0;
+    for (size_t first = 0; ok && first < tiles; first += batch) {
+        uint32_t count = tiles - first < batch ? (uint32_t)(tiles - first) : batch;
+        job.first = first;
+        if (!fossil_image_parallel_for(count, 1, container_encode_band, &job)) {
+            ok = false;
+            break;
+        }
+
+        memset(index, 0, (size_t)count * CONTAINER_ENTRY_SIZE);
+        for (uint32_t k = 0; ok && k < count; ++k) {
+            uint8_t *entry = index + (size_t)k * CONTAINER_ENTRY_SIZE;
+            ok = job.codecs[k] != CONTAINER_FAILED &&
+                 fwrite(job.payloads + (size_t)k * job.capacity, 1, job.sizes[k], f) == job.sizes[k];
+            put_u64(entry, pos);
+            put_u32(entry + 8, job.sizes[k]);
+            entry[12] = job.codecs[k];
+            put_u32(entry + 16, job.checksums[k]);
+            pos += job.sizes[k];
+        }
+        ok = ok && container_seek(f, index_offset + (uint64_t)first * CONTAINER_ENTRY_SIZE) == 0 &&
+             fwrite(index, CONTAINER_ENTRY_SIZE, count, f) == count &&
+             container_seek(f, pos) == 0;
+    }
+
+    free(job.payloads);
+    free(job.sizes);
+    free(job.codecs);
+    free(job.checksums);
+    free(index);
+    *stored_bytes = pos - data_offset;
+    return ok;
+}
+
+bool fossil_image_container_save(
+    const char *path,
+    const fossil_image_t *image,
+    uint32_t tile_size,
+    fossil_image_codec_t codec
+) {
+    if (!path || !image || !image->data || image->width == 0 || image->height == 0 || image->channels == 0)
+        return false;
+    if (codec != FOSSIL_IMAGE_CODEC_STORED && codec != FOSSIL_IMAGE_CODEC_LZ)
+        return false;
+    size_t bpp = fossil_image_bytes_per_pixel(image->format);
+    if (bpp == 0 || bpp % image->channels != 0 || image->size < (size_t)image->width * image->height * bpp)
+        return false;
+    if (tile_size == 0)
+        tile_size = FOSSIL_IMAGE_TILE_SIZE;
+    if (!container_tile_size_ok(tile_size))
+        return false;
+    uint32_t palette_size = image->palette ? image->palette_size : 0;
+    if (palette_size > 256)
+        return false;
+
+    uint32_t tiles_x = (image->width + tile_size - 1) / tile_size;
+    uint32_t tiles_y = (image->height + tile_size - 1) / tile_size;
+    uint32_t meta_size = CONTAINER_META_SIZE + palette_size * 3;
+    uint8_t header[CONTAINER_HEADER_SIZE];
+    uint8_t meta[CONTAINER_META_SIZE + 256 * 3];
+    container_put_meta(meta, image, palette_size);
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    // The header is rewritten once the payload size is known
+    uint64_t stored_bytes = 0;
+    container_put_header(header, image, tile_size, tiles_x, tiles_y, meta_size, 0);
+    bool ok = fwrite(header, sizeof(header), 1, f) == 1 &&
+              fwrite(meta, 1, meta_size, f) == meta_size &&
+              container_write_tiles(f, image, bpp, tile_size, tiles_x, tiles_y,
+                                    CONTAINER_HEADER_SIZE + (uint64_t)meta_size, codec, &stored_bytes);
+    if (ok) {
+        container_put_header(header, image, tile_size, tiles_x, tiles_y, meta_size, stored_bytes);
+        ok = container_seek(f, 0) == 0 && fwrite(header, sizeof(header), 1, f) == 1;
+    }
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
+
+// ------------------------------------------------------
+// Reading
+// ------------------------------------------------------
+
+fossil_image_container_t *fossil_image_container_open(const char *path) {
+    if (!path)
+        return NULL;
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+
+    uint8_t header[CONTAINER_HEADER_SIZE];
+    uint8_t meta[CONTAINER_META_SIZE];
+    fossil_image_container_t *c = (fossil_image_container_t *)calloc(1, sizeof(*c));
+    if (!c || fread(header, sizeof(header), 1, f) != 1 || memcmp(header, CONTAINER_MAGIC, 8) != 0 ||
+        get_u32(header + 8) != CONTAINER_VERSION) {
+        free(c);
+        fclose(f);
+        return NULL;
+    }
+
+    c->file = f;
+    c->meta.width = get_u32(header + 12);
+    c->meta.height = get_u32(header + 16);
+    c->meta.channels = get_u32(header + 20);
+    c->meta.format = (fossil_pixel_format_t)get_u32(header + 24);
+    c->tile_size = get_u32(header + 28);
+    c->tiles_x = get_u32(header + 32);
+    c->tiles_y = get_u32(header + 36);
+    uint32_t meta_size = get_u32(header + 40);
+    c->index_offset = get_u64(header + 48);
+    c->stored_bytes = get_u64(header + 56);
+    c->bpp = fossil_image_bytes_per_pixel(c->meta.format);
+
+    bool ok = c->bpp != 0 && c->meta.width != 0 && c->meta.height != 0 &&
+              c->meta.channels != 0 && c->bpp % c->meta.channels == 0 &&
+              container_tile_size_ok(c->tile_size) &&
+              c->tiles_x == (c->meta.width + c->tile_size - 1) / c->tile_size &&
+              c->tiles_y == (c->meta.height + c->tile_size - 1) / c->tile_size &&
+              meta_size >= CONTAINER_META_SIZE &&
+              c->index_offset == CONTAINER_HEADER_SIZE + (uint64_t)meta_size &&
+              fread(meta, sizeof(meta), 1, f) == 1;
+    if (ok) {
+        // Readers skip metadata bytes they do not know about
+        uint32_t palette_size = get_u32(meta);
+        container_get_meta(meta, &c->meta);
+        ok = palette_size <= 256 && meta_size >= CONTAINER_META_SIZE + palette_size * 3;
+        if (ok && palette_size) {
+            c->meta.palette = (uint8_t *)malloc((size_t)palette_size * 3);
+            c->meta.palette_size = palette_size;
+            ok = c->meta.palette && fread(c->meta.palette, 3, palette_size, f) == palette_size;
+        }
+    }
+    if (!ok) {
+        fossil_image_container_close(c);
+        return NULL;
+    }
+    return c;
+}
+
+void fossil_image_container_close(fossil_image_container_t *container) {
+    if (!container)
+        return;
+    fclose(container->file);
+    free(container->meta.palette);
+    free(container);
+}
+
+bool fossil_image_container_info(const fossil_image_container_t *container, fossil_image_container_info_t *info) {
+    if (!container || !info)
+        return false;
+    info->width = container->meta.width;
+    info->height = container->meta.height;
+    info->channels = container->meta.channels;
+    info->format = container->meta.format;
+    info->tile_size = container->tile_size;
+    info->tiles_x = container->tiles_x;
+    info->tiles_y = container->tiles_y;
+    info->stored_bytes = container->stored_bytes;
+    return true;
+}
+
+/*
+ * Read the index entries and payloads of tiles tx0 .. tx0+nx-1 in one tile
+ * row. Payloads of a row are contiguous, so this is two reads.
+ */
+static bool container_read_row(
+    fossil_image_container_t *c,
+    uint32_t ty,
+    uint32_t tx0,
+    uint32_t nx,
+    uint8_t *index,
+    container_entry_t *entries,
+    uint8_t *payloads,
+    size_t *used
+) {
+    size_t bound = lz_bound((size_t)c->tile_size * c->tile_size * c->bpp);
+    uint64_t at = c->index_offset + ((uint64_t)ty * c->tiles_x + tx0) * CONTAINER_ENTRY_SIZE;
+    if (container_seek(c->file, at) != 0 || fread(index, CONTAINER_ENTRY_SIZE, nx, c->file) != nx)
+        return false;
+
+    uint64_t first = get_u64(index);
+    uint64_t span = 0;
+    for (uint32_t i = 0; i < nx; ++i) {
+        const uint8_t *p = index + (size_t)i * CONTAINER_ENTRY_SIZE;
+        entries[i].offset = get_u64(p);
+        entries[i].size = get_u32(p + 8);
+        entries[i].codec = p[12];
+        entries[i].checksum = get_u32(p + 16);
+        if (entries[i].offset < first || entries[i].size > bound)
+            return false;
+        uint64_t end = entries[i].offset - first + entries[i].size;
+        if (end > (uint64_t)nx * bound)
+            return false;
+        span = end > span ? end : span;
+        entries[i].offset += *used - first;
+    }
+    if (container_seek(c->file, first) != 0 || fread(payloads + *used, 1, (size_t)span, c->file) != span)
+        return false;
+    *used += (size_t)span;
+    return true;
+}
+
+bool fossil_image_container_read_region(
+    fossil_image_container_t *container,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+) {
+    fossil_image_container_t *c = container;
+    if (!c || !dst || width == 0 || height == 0 ||
+        x > c->meta.width || width > c->meta.width - x || y > c->meta.height || height > c->meta.height - y)
+        return false;
+
+    uint32_t ts = c->tile_size;
+    uint32_t tx0 = x / ts;
+    uint32_t ty0 = y / ts;
+    uint32_t nx = (x + width - 1) / ts - tx0 + 1;
+    uint32_t ty1 = (y + height - 1) / ts;
+    size_t bound = lz_bound((size_t)ts * ts * c->bpp);
+    uint32_t rows = container_batch_tiles((size_t)ts * ts * c->bpp) / nx;
+    if (rows == 0)
+        rows = 1;
+
+    size_t count = (size_t)rows * nx;
+    uint8_t *index = (uint8_t *)malloc((size_t)nx * CONTAINER_ENTRY_SIZE);
+    container_entry_t *entries = (container_entry_t *)malloc(count * sizeof(container_entry_t));
+    uint8_t *payloads = (uint8_t *)malloc(count * bound);
+    uint8_t *failed = (uint8_t *)malloc(count);
+
+    container_decode_job_t job;
+    job.container = c;
+    job.payloads = payloads;
+    job.entries = entries;
+    job.tx0 = tx0;
+    job.nx = nx;
+    job.x = x;
+    job.y = y;
+    job.width = width;
+    job.height = height;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+    job.swap = container_big_endian() && c->bpp > c->meta.channels ? c->bpp / c->meta.channels : 0;
+    job.failed = failed;
+
+    bool ok = index && entries && payloads && failed;
+    for (uint32_t ty = ty0; ok && ty <= ty1; ty += rows) {
+        uint32_t batch_rows = ty1 - ty + 1 < rows ? ty1 - ty + 1 : rows;
+        size_t used = 0;
+        for (uint32_t r = 0; ok && r < batch_rows; ++r)
+            ok = container_read_row(c, ty + r, tx0, nx, index, entries + (size_t)r * nx, payloads, &used);
+        if (!ok)
+            break;
+
+        uint32_t tiles = batch_rows * nx;
+        job.ty0 = ty;
+        ok = fossil_image_parallel_for(tiles, 1, container_decode_band, &job);
+        for (uint32_t k = 0; ok && k < tiles; ++k)
+            ok = !failed[k];
+    }
+
+    free(index);
+    free(entries);
+    free(payloads);
+    free(failed);
+    return ok;
+}
+
+bool fossil_image_container_read_image(fossil_image_container_t *container, fossil_image_t *out_image) {
+    if (!container || !out_image)
+        return false;
+    const fossil_image_t *meta = &container->meta;
+    size_t stride = (size_t)meta->width * container->bpp;
+    size_t size = stride * meta->height;
+    uint8_t *data = (uint8_t *)malloc(size);
+    uint8_t *palette = NULL;
+    if (meta->palette_size)
+        palette = (uint8_t *)malloc((size_t)meta->palette_size * 3);
+    if (!data || (meta->palette_size && !palette) ||
+        !fossil_image_container_read_region(container, 0, 0, meta->width, meta->height, data, stride)) {
+        free(data);
+        free(palette);
+        return false;
+    }
+    if (palette)
+        memcpy(palette, meta->palette, (size_t)meta->palette_size * 3);
+
+    *out_image = *meta;
+    out_image->data = data;
+    out_image->size = size;
+    out_image->owns_data = true;
+    out_image->palette = palette;
+    out_image->userdata = NULL;
+    return true;
+}
+
+bool fossil_image_container_load(const char *path, fossil_image_t *out_image) {
+    fossil_image_container_t *container = fossil_image_container_open(path);
+    if (!container)
+        return false;
+    bool ok = fossil_image_container_read_image(container, out_image);
+    fossil_image_container_close(container);
+    return ok;
+}
@@ -0,0 +1,537 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/disk.h"
+#include "fossil/image/analyze.h"
+#include "fossil/image/tile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define disk_seek(f, off) _fseeki64((f), (__int64)(off), SEEK_SET)
+#else
+#include <sys/types.h>
+#define disk_seek(f, off) fseeko((f), (off_t)(off), SEEK_SET)
+#endif
+
+// ======================================================
+// Fossil Image — Disk Sub-Library Implementation
+// ======================================================
+
+/*
+ * The backing file is a small header followed by every tile of the
+ * fossil_image_tiled_t layout, uncompressed and in tile index order, so a
+ * tile's offset is a multiplication. Tiles past the end of the file (never
+ * written) read as zeros. Cached tiles sit in fixed slots; a per-tile table
+ * maps tile index to slot, and eviction picks the idle slot with the oldest
+ * stamp, as the gamma table cache does.
+ */
+#define DISK_MAGIC "FSLDISK1"
+#define DISK_DATA_OFFSET 64u
+#define DISK_MIN_SLOTS 4u
+#define DISK_BLOCK_TILES 4u
+
+typedef struct disk_header {
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t format;
+    uint32_t tile_size;
+} disk_header_t;
+
+typedef struct disk_slot {
+    size_t tile;                       // tile index, or SIZE_MAX when empty
+    uint64_t stamp;
+    bool dirty;
+} disk_slot_t;
+
+struct fossil_image_disk_s {
+    FILE *file;
+    fossil_image_tiled_t geometry;     // layout only; data stays NULL
+    size_t tile_count;
+    size_t cache_bytes;
+    disk_slot_t *slots;
+    uint32_t slot_count;
+    uint8_t *pixels;                   // slot_count tiles
+    uint32_t *lookup;                  // per tile: slot + 1, or 0 when not cached
+    uint64_t clock;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t writebacks;
+};
+
+static fossil_image_disk_t *disk_alloc(FILE *file, const fossil_image_tiled_t *geometry, size_t cache_bytes) {
+    fossil_image_disk_t *disk = (fossil_image_disk_t *)calloc(1, sizeof(*disk));
+    if (!disk)
+        return NULL;
+    disk->file = file;
+    disk->geometry = *geometry;
+    disk->tile_count = (size_t)geometry->tiles_x * geometry->tiles_y;
+
+    if (cache_bytes == 0)
+        cache_bytes = FOSSIL_IMAGE_DISK_CACHE_BYTES;
+    size_t slots = cache_bytes / geometry->tile_bytes;
+    if (slots < DISK_MIN_SLOTS)
+        slots = DISK_MIN_SLOTS;
+    if (slots > disk->tile_count)
+        slots = disk->tile_count;
+    if (slots > UINT32_MAX - 1)
+        slots = UINT32_MAX - 1;
+    disk->slot_count = (uint32_t)slots;
+    disk->cache_bytes = slots * geometry->tile_bytes;
+
+    disk->slots = (disk_slot_t *)calloc(slots, sizeof(disk_slot_t));
+    disk->pixels = (uint8_t *)malloc(disk->cache_bytes);
+    disk->lookup = (uint32_t *)calloc(disk->tile_count, sizeof(uint32_t));
+    if (!disk->slots || !disk->pixels || !disk->lookup) {
+        free(disk->slots);
+        free(disk->pixels);
+        free(disk->lookup);
+        free(disk);
+        return NULL;
+    }
+    for (size_t i = 0; i < slots; ++i)
+        disk->slots[i].tile = SIZE_MAX;
+    return disk;
+}
+
+fossil_image_disk_t *fossil_image_disk_create(
+    const char *path,
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    size_t cache_bytes
+) {
+    fossil_image_tiled_t geometry;
+    if (!path || !fossil_image_tile_geometry(width, height, format, tile_size, &geometry))
+        return NULL;
+
+    FILE *f = fopen(path, "w+b");
+    if (!f)
+        return NULL;
+    disk_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, DISK_MAGIC, sizeof(hdr.magic));
+    hdr.width = width;
+    hdr.height = height;
+    hdr.channels = geometry.channels;
+    hdr.format = (uint32_t)format;
+    hdr.tile_size = geometry.tile_size;
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1) {
+        fclose(f);
+        return NULL;
+    }
+
+    fossil_image_disk_t *disk = disk_alloc(f, &geometry, cache_bytes);
+    if (!disk)
+        fclose(f);
+    return disk;
+}
+
+fossil_image_disk_t *fossil_image_disk_open(const char *path, size_t cache_bytes) {
+    if (!path)
+        return NULL;
+    FILE *f = fopen(path, "r+b");
+    if (!f)
+        return NULL;
+
+    disk_header_t hdr;
+    fossil_image_tiled_t geometry;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || memcmp(hdr.magic, DISK_MAGIC, sizeof(hdr.magic)) != 0 ||
+        !fossil_image_tile_geometry(hdr.width, hdr.height, (fossil_pixel_format_t)hdr.format, hdr.tile_size, &geometry)) {
+        fclose(f);
+        return NULL;
+    }
+
+    fossil_image_disk_t *disk = disk_alloc(f, &geometry, cache_bytes);
+    if (!disk)
+        fclose(f);
+    return disk;
+}
+
+// ------------------------------------------------------
+// Tile cache
+// ------------------------------------------------------
+
+static bool disk_write_slot(fossil_image_disk_t *disk, uint32_t slot) {
+    disk_slot_t *s = &disk->slots[slot];
+    if (!s->dirty)
+        return true;
+    uint64_t offset = DISK_DATA_OFFSET + (uint64_t)s->tile * disk->geometry.tile_bytes;
+    const uint8_t *data = disk->pixels + (size_t)slot * disk->geometry.tile_bytes;
+    if (disk_seek(disk->file, offset) != 0 ||
+        fwrite(data, 1, disk->geometry.tile_bytes, disk->file) != disk->geometry.tile_bytes)
+        return false;
+    s->dirty = false;
+    disk->writebacks++;
+    return true;
+}
+
+/* Cached pixels of one tile, paging it in (and a victim out) on a miss. */
+static uint8_t *disk_tile(fossil_image_disk_t *disk, size_t tile, bool write) {
+    size_t tile_bytes = disk->geometry.tile_bytes;
+    uint32_t slot = disk->lookup[tile];
+    if (slot) {
+        disk_slot_t *s = &disk->slots[--slot];
+        s->stamp = ++disk->clock;
+        s->dirty |= write;
+        disk->hits++;
+        return disk->pixels + (size_t)slot * tile_bytes;
+    }
+
+    // Empty slots first, then the least recently used one
+    uint32_t victim = 0;
+    for (uint32_t i = 0; i < disk->slot_count; ++i) {
+        if (disk->slots[i].tile == SIZE_MAX) {
+            victim = i;
+            break;
+        }
+        if (disk->slots[i].stamp < disk->slots[victim].stamp)
+            victim = i;
+    }
+    disk_slot_t *s = &disk->slots[victim];
+    if (s->tile != SIZE_MAX) {
+        if (!disk_write_slot(disk, victim))
+            return NULL;
+        disk->lookup[s->tile] = 0;
+        s->tile = SIZE_MAX;
+    }
+
+    uint8_t *data = disk->pixels + (size_t)victim * tile_bytes;
+    uint64_t offset = DISK_DATA_OFFSET + (uint64_t)tile * tile_bytes;
+    size_t got = 0;
+    if (disk_seek(disk->file, offset) == 0)
+        got = fread(data, 1, tile_bytes, disk->file);
+    if (got < tile_bytes) {
+        if (ferror(disk->file))
+            return NULL;
+        clearerr(disk->file);
+        memset(data + got, 0, tile_bytes - got);
+    }
+
+    s->tile = tile;
+    s->stamp = ++disk->clock;
+    s->dirty = write;
+    disk->lookup[tile] = victim + 1;
+    disk->misses++;
+    return data;
+}
+
+bool fossil_image_disk_flush(fossil_image_disk_t *disk) {
+    if (!disk)
+        return false;
+    bool ok = true;
+    for (uint32_t i = 0; i < disk->slot_count; ++i)
+        if (disk->slots[i].tile != SIZE_MAX)
+            ok = disk_write_slot(disk, i) && ok;
+    return fflush(disk->file) == 0 && ok;
+}
+
+bool fossil_image_disk_close(fossil_image_disk_t *disk) {
+    if (!disk)
+        return true;
+    bool ok = fossil_image_disk_flush(disk);
+    ok = fclose(disk->file) == 0 && ok;
+    free(disk->slots);
+    free(disk->pixels);
+    free(disk->lookup);
+    free(disk);
+    return ok;
+}
+
+bool fossil_image_disk_info(const fossil_image_disk_t *disk, fossil_image_disk_info_t *info) {
+    if (!disk || !info)
+        return false;
+    info->width = disk->geometry.width;
+    info->height = disk->geometry.height;
+    info->channels = disk->geometry.channels;
+    info->format = disk->geometry.format;
+    info->tile_size = disk->geometry.tile_size;
+    info->cache_bytes = disk->cache_bytes;
+    info->hits = disk->hits;
+    info->misses = disk->misses;
+    info->writebacks = disk->writebacks;
+    return true;
+}
+
+// ------------------------------------------------------
+// Region access
+// ------------------------------------------------------
+
+static inline size_t disk_bpp(const fossil_image_disk_t *disk) {
+    return disk->geometry.tile_stride / disk->geometry.tile_size;
+}
+
+/* Copy run pixels of row y starting at column x (within one tile). */
+static bool disk_row_run(fossil_image_disk_t *disk, uint32_t x, uint32_t y, uint32_t run, uint8_t *buf, bool write) {
+    const fossil_image_tiled_t *g = &disk->geometry;
+    size_t bpp = disk_bpp(disk);
+    size_t tile = (size_t)(y / g->tile_size) * g->tiles_x + x / g->tile_size;
+    uint8_t *data = disk_tile(disk, tile, write);
+    if (!data)
+        return false;
+    uint8_t *p = data + (size_t)(y % g->tile_size) * g->tile_stride + (size_t)(x % g->tile_size) * bpp;
+    if (write)
+        memcpy(p, buf, (size_t)run * bpp);
+    else
+        memcpy(buf, p, (size_t)run * bpp);
+    return true;
+}
+
+static bool disk_fetch_run(void *ctx, uint32_t x, uint32_t y, uint32_t count, uint8_t *dst) {
+    return disk_row_run((fossil_image_disk_t *)ctx, x, y, count, dst, false);
+}
+
+bool fossil_image_disk_read_region(
+    fossil_image_disk_t *disk,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+) {
+    if (!disk)
+        return false;
+    return fossil_image_tile_read_runs(&disk->geometry, x, y, width, height, dst, dst_stride,
+                                       disk_fetch_run, disk);
+}
+
+bool fossil_image_disk_write_region(
+    fossil_image_disk_t *disk,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    const uint8_t *src,
+    size_t src_stride
+) {
+    if (!disk || !src)
+        return false;
+    const fossil_image_tiled_t *g = &disk->geometry;
+    if (x > g->width || width > g->width - x || y > g->height || height > g->height - y)
+        return false;
+    uint32_t ts = g->tile_size;
+    size_t bpp = disk_bpp(disk);
+
+    for (uint32_t r = 0; r < height; ++r) {
+        const uint8_t *s = src + (size_t)r * src_stride;
+        for (uint32_t sx = x; sx < x + width;) {
+            uint32_t run = ts - sx % ts;
+            if (run > x + width - sx)
+                run = x + width - sx;
+            if (!disk_row_run(disk, sx, y + r, run, (uint8_t *)s, true))
+                return false;
+            s += (size_t)run * bpp;
+            sx += run;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------
+// Streaming operations
+// ------------------------------------------------------
+
+/* Point an image header at a caller buffer holding width x height pixels. */
+static void disk_block_view(const fossil_image_disk_t *disk, uint8_t *buf, uint32_t width, uint32_t height, fossil_image_t *view) {
+    memset(view, 0, sizeof(*view));
+    view->width = width;
+    view->height = height;
+    view->channels = disk->geometry.channels;
+    view->format = disk->geometry.format;
+    view->size = (size_t)width * height * disk_bpp(disk);
+    view->data = buf;
+    view->owns_data = false;
+}
+
+bool fossil_image_disk_process(
+    fossil_image_disk_t *src,
+    fossil_image_disk_t *dst,
+    uint32_t halo,
+    fossil_image_disk_fn fn,
+    void *ctx
+) {
+    if (!src || !fn)
+        return false;
+    const fossil_image_tiled_t *g = &src->geometry;
+    if (dst && (dst->geometry.width != g->width || dst->geometry.height != g->height ||
+                dst->geometry.format != g->format))
+        return false;
+    // Neighbouring blocks would read pixels this pass already replaced
+    if (dst == src && halo > 0)
+        return false;
+
+    uint32_t block = g->tile_size * DISK_BLOCK_TILES;
+    size_t bpp = disk_bpp(src);
+    uint64_t edge = (uint64_t)block + 2 * (uint64_t)halo;
+    uint32_t max_w = (uint32_t)(edge < g->width ? edge : g->width);
+    uint32_t max_h = (uint32_t)(edge < g->height ? edge : g->height);
+    uint8_t *buf = (uint8_t *)malloc((size_t)max_w * max_h * bpp);
+    if (!buf)
+        return false;
+
+    bool ok = true;
+    for (uint32_t y0 = 0; ok && y0 < g->height; y0 += block) {
+        uint32_t h = g->height - y0 < block ? g->height - y0 : block;
+        uint32_t ey0 = y0 > halo ? y0 - halo : 0;
+        uint32_t ey1 = (uint64_t)y0 + h + halo < g->height ? y0 + h + halo : g->height;
+        for (uint32_t x0 = 0; ok && x0 < g->width; x0 += block) {
+            uint32_t w = g->width - x0 < block ? g->width - x0 : block;
+            uint32_t ex0 = x0 > halo ? x0 - halo : 0;
+            uint32_t ex1 = (uint64_t)x0 + w + halo < g->width ? x0 + w + halo : g->width;
+            uint32_t ew = ex1 - ex0;
+
+            fossil_image_t view;
+            disk_block_view(src, buf, ew, ey1 - ey0, &view);
+            ok = fossil_image_disk_read_region(src, (int32_t)ex0, (int32_t)ey0, ew, ey1 - ey0, buf, (size_t)ew * bpp) &&
+                 fn(ctx, &view, ex0, ey0);
+            if (ok && dst) {
+                const uint8_t *inner = buf + ((size_t)(y0 - ey0) * ew + (x0 - ex0)) * bpp;
+                ok = fossil_image_disk_write_region(dst, x0, y0, w, h, inner, (size_t)ew * bpp);
+            }
+        }
+    }
+    free(buf);
+    return ok;
+}
+
+static bool disk_pipeline_block(void *ctx, fossil_image_t *block, uint32_t x, uint32_t y) {
+    (void)x;
+    (void)y;
+    return fossil_image_pipeline_execute((const fossil_image_pipeline_t *)ctx, block);
+}
+
+bool fossil_image_disk_pipeline(
+    fossil_image_disk_t *src,
+    fossil_image_disk_t *dst,
+    const fossil_image_pipeline_t *pipeline
+) {
+    // Blocks are written back at their source size; use disk_resize instead
+    if (!src || !dst || !pipeline || fossil_image_pipeline_has_resize(pipeline))
+        return false;
+    uint32_t halo = fossil_image_pipeline_halo(pipeline);
+    if (halo > 0) {
+        if (src->geometry.width < 3 || src->geometry.height < 3)
+            return false;
+        // Two pixels keep every clipped block at least 3x3 for the 3x3 stages
+        if (halo < 2)
+            halo = 2;
+    }
+    return fossil_image_disk_process(src, dst, halo, disk_pipeline_block, (void *)pipeline);
+}
+
+bool fossil_image_disk_resize(fossil_image_disk_t *src, fossil_image_disk_t *dst, fossil_interp_t mode) {
+    if (!src || !dst || src == dst || src->geometry.format != dst->geometry.format)
+        return false;
+    const fossil_image_tiled_t *sg = &src->geometry;
+    const fossil_image_tiled_t *dg = &dst->geometry;
+    size_t bpp = disk_bpp(src);
+
+    fossil_image_resize_plan_t *plan =
+        fossil_image_process_resize_plan_create(sg->width, sg->height, dg->width, dg->height, mode);
+    if (!plan)
+        return false;
+
+    // Halve the output block until its source window fits the cache budget
+    uint32_t block = dg->tile_size * DISK_BLOCK_TILES;
+    for (; block > 1; block /= 2) {
+        uint32_t sx, sy, sw, sh;
+        fossil_image_process_resize_plan_source_rect(plan, 0, 0,
+            block < dg->width ? block : dg->width, block < dg->height ? block : dg->height,
+            &sx, &sy, &sw, &sh);
+        if ((uint64_t)sw * sh * bpp <= src->cache_bytes)
+            break;
+    }
+
+    uint8_t *out = (uint8_t *)malloc((size_t)block * block * bpp);
+    uint8_t *window = NULL;
+    size_t window_size = 0;
+    bool ok = out != NULL;
+    for (uint32_t y = 0; ok && y < dg->height; y += block) {
+        uint32_t h = dg->height - y < block ? dg->height - y : block;
+        for (uint32_t x = 0; ok && x < dg->width; x += block) {
+            uint32_t w = dg->width - x < block ? dg->width - x : block;
+            uint32_t sx, sy, sw, sh;
+            ok = fossil_image_process_resize_plan_source_rect(plan, x, y, w, h, &sx, &sy, &sw, &sh);
+            if (!ok)
+                break;
+            size_t need = (size_t)sw * sh * bpp;
+            if (need > window_size) {
+                uint8_t *grown = (uint8_t *)realloc(window, need);
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                window = grown;
+                window_size = need;
+            }
+
+            fossil_image_t win_view, out_view;
+            disk_block_view(src, window, sw, sh, &win_view);
+            disk_block_view(dst, out, w, h, &out_view);
+            ok = fossil_image_disk_read_region(src, (int32_t)sx, (int32_t)sy, sw, sh, window, (size_t)sw * bpp) &&
+                 fossil_image_process_resize_plan_execute_rect(plan, &win_view, sx, sy, &out_view, x, y) &&
+                 fossil_image_disk_write_region(dst, x, y, w, h, out, (size_t)w * bpp);
+        }
+    }
+    free(out);
+    free(window);
+    fossil_image_process_resize_plan_destroy(plan);
+    return ok;
+}
+
+typedef struct disk_histogram_ctx {
+    uint64_t *hist;
+    uint32_t *block_hist;
+} disk_histogram_ctx_t;
+
+static bool disk_histogram_block(void *ctx, fossil_image_t *block, uint32_t x, uint32_t y) {
+    disk_histogram_ctx_t *h = (disk_histogram_ctx_t *)ctx;
+    (void)x;
+    (void)y;
+    if (!fossil_image_analyze_histogram(block, h->block_hist))
+        return false;
+    for (size_t i = 0; i < (size_t)256 * block->channels; ++i)
+        h->hist[i] += h->block_hist[i];
+    return true;
+}
+
+bool fossil_image_disk_histogram(fossil_image_disk_t *disk, uint64_t *out_hist) {
+    if (!disk || !out_hist)
+        return false;
+    size_t bins = (size_t)256 * disk->geometry.channels;
+    disk_histogram_ctx_t h;
+    h.hist = out_hist;
+    h.block_hist = (uint32_t *)malloc(bins * sizeof(uint32_t));
+    if (!h.block_hist)
+        return false;
+    memset(out_hist, 0, bins * sizeof(uint64_t));
+    bool ok = fossil_image_disk_process(disk, NULL, 0, disk_histogram_block, &h);
+    free(h.block_hist);
+    return ok;
+}
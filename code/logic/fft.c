@@ -0,0 +1,602 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/fft.h"
+#include "fossil/image/parallel.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ======================================================
+// Fossil Image — FFT Sub-Library Implementation
+// ======================================================
+
+/*
+ * Stockham self-sorting FFT. A length n = R1 * R2 * ... is transformed in one
+ * pass per factor, ping-ponging between the data and a work buffer; each pass
+ * reads butterflies with stride n / R and writes them to their final place, so
+ * no bit-reversal step is needed. Radix 4, 2, 3 and 5 have dedicated
+ * butterflies; any other prime factor uses a direct DFT of that size. The
+ * inverse transform conjugates on the way in and out.
+ */
+#define FFT_MAX_STAGES 64
+#define FFT_CACHE_SLOTS 16
+#define FFT_COLUMN_BLOCK 16
+
+typedef fossil_image_complex_t fft_complex_t;
+
+typedef struct fft_plan {
+    size_t n;
+    unsigned refs;
+    unsigned long stamp;
+    bool cached;
+    uint32_t stages;
+    uint32_t max_radix;
+    uint32_t radix[FFT_MAX_STAGES];
+    size_t span[FFT_MAX_STAGES];        // product of the radices before this pass
+    size_t twiddle_at[FFT_MAX_STAGES];  // span * (radix - 1) twiddles
+    size_t roots_at[FFT_MAX_STAGES];    // radix roots of unity, generic passes only
+    fft_complex_t *table;
+} fft_plan_t;
+
+static fft_plan_t *fft_cache[FFT_CACHE_SLOTS];
+static unsigned long fft_clock;
+static atomic_flag fft_lock = ATOMIC_FLAG_INIT;
+
+static void fft_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&fft_lock, memory_order_acquire))
+        ;
+}
+
+static void fft_lock_release(void) {
+    atomic_flag_clear_explicit(&fft_lock, memory_order_release);
+}
+
+static inline fft_complex_t fft_polar(double turns) {
+    double a = -2.0 * 3.14159265358979323846 * turns;
+    fft_complex_t w = { (float)cos(a), (float)sin(a) };
+    return w;
+}
+
+static inline fft_complex_t fft_mul(fft_complex_t a, fft_complex_t b) {
+    fft_complex_t r = { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+    return r;
+}
+
+static void fft_plan_free(fft_plan_t *plan) {
+    if (plan) {
+        free(plan->table);
+        free(plan);
+    }
+}
+
+static fft_plan_t *fft_plan_create(size_t n) {
+    fft_plan_t *plan = (fft_plan_t *)calloc(1, sizeof(*plan));
+    if (!plan)
+        return NULL;
+    plan->n = n;
+    plan->refs = 1;
+    plan->max_radix = 1;
+
+    // Radix 4 first, then the remaining small primes, then anything left
+    size_t rest = n;
+    static const uint32_t preferred[] = { 4, 2, 3, 5 };
+    for (size_t i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i) {
+        while (rest % preferred[i] == 0 && plan->stages < FFT_MAX_STAGES) {
+            plan->radix[plan->stages++] = preferred[i];
+            rest /= preferred[i];
+        }
+    }
+    for (size_t p = 7; rest > 1 && plan->stages < FFT_MAX_STAGES; p += 2) {
+        if (p * p > rest)
+            p = rest;
+        while (rest % p == 0 && plan->stages < FFT_MAX_STAGES) {
+            plan->radix[plan->stages++] = (uint32_t)p;
+            rest /= p;
+        }
+    }
+    if (rest != 1 || n > UINT32_MAX) {
+        free(plan);
+        return NULL;
+    }
+
+    size_t entries = 0;
+    size_t span = 1;
+    for (uint32_t s = 0; s < plan->stages; ++s) {
+        uint32_t r = plan->radix[s];
+        plan->span[s] = span;
+        plan->twiddle_at[s] = entries;
+        entries += span * (r - 1);
+        plan->roots_at[s] = entries;
+        if (r > 5)
+            entries += r;
+        if (r > plan->max_radix)
+            plan->max_radix = r;
+        span *= r;
+    }
+
+    plan->table = (fft_complex_t *)malloc((entries ? entries : 1) * sizeof(fft_complex_t));
+    if (!plan->table) {
+        free(plan);
+        return NULL;
+    }
+    for (uint32_t s = 0; s < plan->stages; ++s) {
+        uint32_t r = plan->radix[s];
+        fft_complex_t *tw = plan->table + plan->twiddle_at[s];
+        for (size_t q = 0; q < plan->span[s]; ++q)
+            for (uint32_t k = 1; k < r; ++k)
+                tw[q * (r - 1) + (k - 1)] = fft_polar((double)(q * k) / (double)(plan->span[s] * r));
+        if (r > 5) {
+            fft_complex_t *roots = plan->table + plan->roots_at[s];
+            for (uint32_t k = 0; k < r; ++k)
+                roots[k] = fft_polar((double)k / (double)r);
+        }
+    }
+    return plan;
+}
+
+static fft_plan_t *fft_lookup(size_t n) {
+    for (int i = 0; i < FFT_CACHE_SLOTS; ++i) {
+        fft_plan_t *p = fft_cache[i];
+        if (p && p->n == n) {
+            p->refs++;
+            p->stamp = ++fft_clock;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static fft_plan_t *fft_plan_acquire(size_t n) {
+    fft_lock_acquire();
+    fft_plan_t *plan = fft_lookup(n);
+    fft_lock_release();
+    if (plan)
+        return plan;
+
+    fft_plan_t *fresh = fft_plan_create(n);
+    if (!fresh)
+        return NULL;
+
+    fft_lock_acquire();
+    // Another caller may have published the same plan meanwhile
+    plan = fft_lookup(n);
+    if (!plan) {
+        int victim = -1;
+        for (int i = 0; i < FFT_CACHE_SLOTS; ++i) {
+            fft_plan_t *p = fft_cache[i];
+            if (!p) { victim = i; break; }
+            if (p->refs == 0 && (victim < 0 || p->stamp < fft_cache[victim]->stamp))
+                victim = i;
+        }
+        if (victim >= 0) {
+            fft_plan_free(fft_cache[victim]);
+            fresh->cached = true;
+            fresh->stamp = ++fft_clock;
+            fft_cache[victim] = fresh;
+        }
+        plan = fresh;
+        fresh = NULL;
+    }
+    fft_lock_release();
+
+    fft_plan_free(fresh);
+    return plan;
+}
+
+static void fft_plan_release(fft_plan_t *plan) {
+    fft_lock_acquire();
+    bool drop = !plan->cached;
+    plan->refs--;
+    fft_lock_release();
+    if (drop)
+        fft_plan_free(plan);
+}
+
+void fossil_image_fft_cache_clear(void) {
+    fft_lock_acquire();
+    for (int i = 0; i < FFT_CACHE_SLOTS; ++i) {
+        fft_plan_t *p = fft_cache[i];
+        if (p && p->refs == 0) {
+            fft_plan_free(p);
+            fft_cache[i] = NULL;
+        }
+    }
+    fft_lock_release();
+}
+
+size_t fossil_image_fft_good_size(size_t n) {
+    if (n == 0 || n > UINT32_MAX)
+        return 0;
+    size_t best = SIZE_MAX;
+    for (size_t p2 = 1; p2 < best; p2 *= 2) {
+        for (size_t p3 = p2; p3 < best; p3 *= 3) {
+            size_t v = p3;
+            while (v < n)
+                v *= 5;
+            if (v < best)
+                best = v;
+            if (p3 >= n)
+                break;
+        }
+        if (p2 >= n)
+            break;
+    }
+    return best;
+}
+
+// ------------------------------------------------------
+// Butterflies
+// ------------------------------------------------------
+
+/* One Stockham pass of radix r over all n / r butterflies. */
+static void fft_pass(
+    const fft_complex_t *in,
+    fft_complex_t *out,
+    size_t n,
+    uint32_t r,
+    size_t span,
+    const fft_complex_t *tw,
+    const fft_complex_t *roots,
+    fft_complex_t *scratch
+) {
+    const size_t m = n / r;
+    for (size_t base = 0; base < m; base += span) {
+        fft_complex_t *dst = out + base * r;
+        for (size_t q = 0; q < span; ++q) {
+            const fft_complex_t *src = in + base + q;
+            const fft_complex_t *w = tw + q * (r - 1);
+            fft_complex_t *o = dst + q;
+            switch (r) {
+            case 2: {
+                fft_complex_t v0 = src[0];
+                fft_complex_t v1 = fft_mul(src[m], w[0]);
+                o[0].re = v0.re + v1.re; o[0].im = v0.im + v1.im;
+                o[span].re = v0.re - v1.re; o[span].im = v0.im - v1.im;
+                break;
+            }
+            case 3: {
+                const float c = -0.5f, s = 0.86602540378443865f;
+                fft_complex_t v0 = src[0];
+                fft_complex_t v1 = fft_mul(src[m], w[0]);
+                fft_complex_t v2 = fft_mul(src[2 * m], w[1]);
+                float t1r = v1.re + v2.re, t1i = v1.im + v2.im;
+                float ar = v0.re + c * t1r, ai = v0.im + c * t1i;
+                float br = s * (v1.re - v2.re), bi = s * (v1.im - v2.im);
+                o[0].re = v0.re + t1r; o[0].im = v0.im + t1i;
+                o[span].re = ar + bi; o[span].im = ai - br;
+                o[2 * span].re = ar - bi; o[2 * span].im = ai + br;
+                break;
+            }
+            case 4: {
+                fft_complex_t v0 = src[0];
+                fft_complex_t v1 = fft_mul(src[m], w[0]);
+                fft_complex_t v2 = fft_mul(src[2 * m], w[1]);
+                fft_complex_t v3 = fft_mul(src[3 * m], w[2]);
+                float a0r = v0.re + v2.re, a0i = v0.im + v2.im;
+                float a1r = v0.re - v2.re, a1i = v0.im - v2.im;
+                float a2r = v1.re + v3.re, a2i = v1.im + v3.im;
+                float a3r = v1.re - v3.re, a3i = v1.im - v3.im;
+                o[0].re = a0r + a2r; o[0].im = a0i + a2i;
+                o[span].re = a1r + a3i; o[span].im = a1i - a3r;
+                o[2 * span].re = a0r - a2r; o[2 * span].im = a0i - a2i;
+                o[3 * span].re = a1r - a3i; o[3 * span].im = a1i + a3r;
+                break;
+            }
+            case 5: {
+                const float c1 = 0.30901699437494742f, c2 = -0.80901699437494742f;
+                const float s1 = 0.95105651629515357f, s2 = 0.58778525229247313f;
+                fft_complex_t v0 = src[0];
+                fft_complex_t v1 = fft_mul(src[m], w[0]);
+                fft_complex_t v2 = fft_mul(src[2 * m], w[1]);
+                fft_complex_t v3 = fft_mul(src[3 * m], w[2]);
+                fft_complex_t v4 = fft_mul(src[4 * m], w[3]);
+                float t1r = v1.re + v4.re, t1i = v1.im + v4.im;
+                float t2r = v2.re + v3.re, t2i = v2.im + v3.im;
+                float t3r = v1.re - v4.re, t3i = v1.im - v4.im;
+                float t4r = v2.re - v3.re, t4i = v2.im - v3.im;
+                float a1r = v0.re + c1 * t1r + c2 * t2r, a1i = v0.im + c1 * t1i + c2 * t2i;
+                float a2r = v0.re + c2 * t1r + c1 * t2r, a2i = v0.im + c2 * t1i + c1 * t2i;
+                float b1r = s1 * t3r + s2 * t4r, b1i = s1 * t3i + s2 * t4i;
+                float b2r = s2 * t3r - s1 * t4r, b2i = s2 * t3i - s1 * t4i;
+                o[0].re = v0.re + t1r + t2r; o[0].im = v0.im + t1i + t2i;
+                o[span].re = a1r + b1i; o[span].im = a1i - b1r;
+                o[4 * span].re = a1r - b1i; o[4 * span].im = a1i + b1r;
+                o[2 * span].re = a2r + b2i; o[2 * span].im = a2i - b2r;
+                o[3 * span].re = a2r - b2i; o[3 * span].im = a2i + b2r;
+                break;
+            }
+            default: {
+                fft_complex_t *v = scratch;
+                v[0] = src[0];
+                for (uint32_t k = 1; k < r; ++k)
+                    v[k] = fft_mul(src[k * m], w[k - 1]);
+                for (uint32_t k = 0; k < r; ++k) {
+                    float sr = 0.0f, si = 0.0f;
+                    size_t idx = 0;
+                    for (uint32_t j = 0; j < r; ++j) {
+                        fft_complex_t t = fft_mul(v[j], roots[idx]);
+                        sr += t.re;
+                        si += t.im;
+                        idx += k;
+                        if (idx >= r)
+                            idx -= r;
+                    }
+                    o[k * span].re = sr;
+                    o[k * span].im = si;
+                }
+                break;
+            }
+            }
+        }
+    }
+}
+
+/*
+ * Unscaled transform of data in place. work holds n samples and scratch
+ * plan->max_radix samples (generic passes only).
+ */
+static void fft_execute(
+    const fft_plan_t *plan,
+    fft_complex_t *data,
+    fft_complex_t *work,
+    fft_complex_t *scratch,
+    bool inverse
+) {
+    size_t n = plan->n;
+    if (inverse)
+        for (size_t i = 0; i < n; ++i)
+            data[i].im = -data[i].im;
+
+    fft_complex_t *in = data;
+    fft_complex_t *out = work;
+    for (uint32_t s = 0; s < plan->stages; ++s) {
+        fft_pass(in, out, n, plan->radix[s], plan->span[s],
+                 plan->table + plan->twiddle_at[s], plan->table + plan->roots_at[s], scratch);
+        fft_complex_t *t = in; in = out; out = t;
+    }
+    if (in != data)
+        memcpy(data, in, n * sizeof(fft_complex_t));
+
+    if (inverse)
+        for (size_t i = 0; i < n; ++i)
+            data[i].im = -data[i].im;
+}
+
+bool fossil_image_fft_1d(fossil_image_complex_t *data, size_t n, bool inverse) {
+    if (!data || n == 0)
+        return false;
+    fft_plan_t *plan = fft_plan_acquire(n);
+    if (!plan)
+        return false;
+    fft_complex_t *work = (fft_complex_t *)malloc((n + plan->max_radix) * sizeof(fft_complex_t));
+    if (!work) {
+        fft_plan_release(plan);
+        return false;
+    }
+
+    fft_execute(plan, data, work, work + n, inverse);
+    if (inverse) {
+        float scale = 1.0f / (float)n;
+        for (size_t i = 0; i < n; ++i) {
+            data[i].re *= scale;
+            data[i].im *= scale;
+        }
+    }
+    free(work);
+    fft_plan_release(plan);
+    return true;
+}
+
+// ------------------------------------------------------
+// Real 2-D Transforms
+// ------------------------------------------------------
+
+/*
+ * A real row of width w is packed into w / 2 complex samples (even samples in
+ * the real part, odd in the imaginary part), transformed at half length and
+ * split into the w / 2 + 1 bins of the real spectrum. Columns of the half
+ * spectrum are gathered FFT_COLUMN_BLOCK at a time into a contiguous buffer,
+ * transformed and scattered back.
+ */
+typedef struct fft2d_ctx {
+    const fft_plan_t *row_plan;     // length width / 2
+    const fft_plan_t *col_plan;     // length height
+    const fft_complex_t *split;     // exp(-2 pi i k / width), k <= width / 2
+    const float *real_in;
+    float *real_out;
+    fft_complex_t *spectrum;
+    uint32_t width;
+    uint32_t height;
+    bool inverse;
+    float scale;
+    fft_complex_t *scratch;         // one slice per band
+    size_t scratch_size;
+} fft2d_ctx_t;
+
+static void fft2d_rows_forward(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const fft2d_ctx_t *c = (const fft2d_ctx_t *)arg;
+    const size_t m = c->width / 2;
+    const size_t bins = m + 1;
+    fft_complex_t *z = c->scratch + (size_t)band * c->scratch_size;
+    fft_complex_t *work = z + m;
+    fft_complex_t *scratch = work + m;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const float *row = c->real_in + (size_t)y * c->width;
+        for (size_t k = 0; k < m; ++k) {
+            z[k].re = row[2 * k];
+            z[k].im = row[2 * k + 1];
+        }
+        fft_execute(c->row_plan, z, work, scratch, false);
+
+        fft_complex_t *out = c->spectrum + (size_t)y * bins;
+        for (size_t k = 0; k <= m; ++k) {
+            fft_complex_t a = z[k % m];
+            fft_complex_t b = z[(m - k) % m];
+            // Even part (a + conj b) / 2, odd part (a - conj b) / 2i
+            float er = 0.5f * (a.re + b.re), ei = 0.5f * (a.im - b.im);
+            float or_ = 0.5f * (a.im + b.im), oi = -0.5f * (a.re - b.re);
+            fft_complex_t w = c->split[k];
+            out[k].re = er + w.re * or_ - w.im * oi;
+            out[k].im = ei + w.re * oi + w.im * or_;
+        }
+    }
+}
+
+static void fft2d_rows_inverse(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const fft2d_ctx_t *c = (const fft2d_ctx_t *)arg;
+    const size_t m = c->width / 2;
+    const size_t bins = m + 1;
+    fft_complex_t *z = c->scratch + (size_t)band * c->scratch_size;
+    fft_complex_t *work = z + m;
+    fft_complex_t *scratch = work + m;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const fft_complex_t *in = c->spectrum + (size_t)y * bins;
+        for (size_t k = 0; k < m; ++k) {
+            fft_complex_t a = in[k];
+            fft_complex_t b = in[m - k];
+            // Even part (a + conj b) / 2, odd part (a - conj b) * conj(w) / 2
+            float er = 0.5f * (a.re + b.re), ei = 0.5f * (a.im - b.im);
+            float dr = 0.5f * (a.re - b.re), di = 0.5f * (a.im + b.im);
+            fft_complex_t w = c->split[k];
+            float or_ = dr * w.re + di * w.im;
+            float oi = di * w.re - dr * w.im;
+            z[k].re = er - oi;
+            z[k].im = ei + or_;
+        }
+        fft_execute(c->row_plan, z, work, scratch, true);
+
+        float *row = c->real_out + (size_t)y * c->width;
+        for (size_t k = 0; k < m; ++k) {
+            row[2 * k] = z[k].re * c->scale;
+            row[2 * k + 1] = z[k].im * c->scale;
+        }
+    }
+}
+
+static void fft2d_columns(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const fft2d_ctx_t *c = (const fft2d_ctx_t *)arg;
+    const size_t bins = c->width / 2 + 1;
+    const size_t h = c->height;
+    fft_complex_t *block = c->scratch + (size_t)band * c->scratch_size;
+    fft_complex_t *work = block + (size_t)FFT_COLUMN_BLOCK * h;
+    fft_complex_t *scratch = work + h;
+
+    for (uint32_t b = begin; b < end; ++b) {
+        size_t x0 = (size_t)b * FFT_COLUMN_BLOCK;
+        size_t cols = bins - x0 < FFT_COLUMN_BLOCK ? bins - x0 : FFT_COLUMN_BLOCK;
+        for (size_t y = 0; y < h; ++y) {
+            const fft_complex_t *src = c->spectrum + y * bins + x0;
+            for (size_t j = 0; j < cols; ++j)
+                block[j * h + y] = src[j];
+        }
+        for (size_t j = 0; j < cols; ++j)
+            fft_execute(c->col_plan, block + j * h, work, scratch, c->inverse);
+        for (size_t y = 0; y < h; ++y) {
+            fft_complex_t *dst = c->spectrum + y * bins + x0;
+            for (size_t j = 0; j < cols; ++j)
+                dst[j] = block[j * h + y];
+        }
+    }
+}
+
+static bool fft2d_run(fft2d_ctx_t *c, bool inverse) {
+    uint32_t w = c->width;
+    uint32_t h = c->height;
+    size_t m = w / 2;
+    size_t bins = m + 1;
+    uint32_t blocks = (uint32_t)((bins + FFT_COLUMN_BLOCK - 1) / FFT_COLUMN_BLOCK);
+
+    fft_plan_t *row_plan = fft_plan_acquire(m);
+    fft_plan_t *col_plan = fft_plan_acquire(h);
+    fft_complex_t *split = (fft_complex_t *)malloc(bins * sizeof(fft_complex_t));
+    size_t row_scratch = 2 * m + (row_plan ? row_plan->max_radix : 0);
+    size_t col_scratch = ((size_t)FFT_COLUMN_BLOCK + 1) * h + (col_plan ? col_plan->max_radix : 0);
+    uint32_t row_bands = fossil_image_parallel_bands(h, 8);
+    uint32_t col_bands = fossil_image_parallel_bands(blocks, 1);
+    uint32_t bands = row_bands > col_bands ? row_bands : col_bands;
+    c->scratch_size = row_scratch > col_scratch ? row_scratch : col_scratch;
+    c->scratch = (fft_complex_t *)malloc(c->scratch_size * bands * sizeof(fft_complex_t));
+
+    bool ok = row_plan && col_plan && split && c->scratch;
+    if (ok) {
+        for (size_t k = 0; k < bins; ++k)
+            split[k] = fft_polar((double)k / (double)w);
+        c->row_plan = row_plan;
+        c->col_plan = col_plan;
+        c->split = split;
+        c->inverse = inverse;
+        if (!inverse) {
+            fossil_image_parallel_for_bands(row_bands, h, fft2d_rows_forward, c);
+            fossil_image_parallel_for_bands(col_bands, blocks, fft2d_columns, c);
+        } else {
+            c->scale = 1.0f / ((float)m * (float)h);
+            fossil_image_parallel_for_bands(col_bands, blocks, fft2d_columns, c);
+            fossil_image_parallel_for_bands(row_bands, h, fft2d_rows_inverse, c);
+        }
+    }
+
+    if (row_plan)
+        fft_plan_release(row_plan);
+    if (col_plan)
+        fft_plan_release(col_plan);
+    free(split);
+    free(c->scratch);
+    return ok;
+}
+
+bool fossil_image_fft_2d_real(
+    const float *src,
+    uint32_t width,
+    uint32_t height,
+    fossil_image_complex_t *dst
+) {
+    if (!src || !dst || width < 2 || width % 2 != 0 || height == 0)
+        return false;
+    fft2d_ctx_t c = { 0 };
+    c.real_in = src;
+    c.spectrum = dst;
+    c.width = width;
+    c.height = height;
+    return fft2d_run(&c, false);
+}
+
+bool fossil_image_fft_2d_real_inverse(
+    fossil_image_complex_t *src,
+    uint32_t width,
+    uint32_t height,
+    float *dst
+) {
+    if (!src || !dst || width < 2 || width % 2 != 0 || height == 0)
+        return false;
+    fft2d_ctx_t c = { 0 };
+    c.real_out = dst;
+    c.spectrum = src;
+    c.width = width;
+    c.height = height;
+    return fft2d_run(&c, true);
+}
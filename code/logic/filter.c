@@ -23,6 +23,10 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/image/filter.h"
+#include "fossil/image/color.h"
+#include "fossil/image/parallel.h"
+#include "fossil/image/tile.h"
+#include "fossil/image/fft.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -148,6 +152,130 @@ bool fossil_image_filter_convolve3x3(
     return true;
 }
 
+/*
+ * Tiled 3x3 convolution. Each output tile reads its source tile plus a one
+ * pixel halo into per-worker scratch through fossil_image_tile_read_region,
+ * so the working set is two tiles however wide the image is. The sum runs
+ * in the same order as fossil_image_filter_convolve3x3 and the outermost
+ * image pixels stay zero, so the results match it exactly.
+ */
+typedef struct filter_tiled_ctx {
+    const fossil_image_tiled_t *src;
+    const float (*kernel)[3];
+    float scale;
+    float bias;
+    uint8_t *scratch;
+    size_t scratch_stride;
+    size_t scratch_bytes;
+} filter_tiled_ctx_t;
+
+#define FILTER_TILE_CONVOLVE(T, STORE)                                          \
+    do {                                                                        \
+        for (uint32_t r = 0; r < tile->height; ++r) {                           \
+            uint32_t y = tile->y + r;                                           \
+            if (y == 0 || y == h - 1)                                           \
+                continue;                                                       \
+            T *o = (T *)(tile->data + (size_t)r * tile->stride);                \
+            for (uint32_t col = 0; col < tile->width; ++col) {                  \
+                uint32_t x = tile->x + col;                                     \
+                if (x == 0 || x == w - 1)                                       \
+                    continue;                                                   \
+                for (size_t ch = 0; ch < c; ++ch) {                             \
+                    float sum = 0.0f;                                           \
+                    for (int ky = 0; ky < 3; ++ky) {                            \
+                        const T *row = (const T *)(in + (size_t)(r + ky) * t->scratch_stride); \
+                        for (int kx = 0; kx < 3; ++kx)                          \
+                            sum += row[(col + kx) * c + ch] * t->kernel[ky][kx]; \
+                    }                                                           \
+                    sum = sum * t->scale + t->bias;                             \
+                    STORE;                                                      \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+static void filter_convolve_tile(void *arg, const fossil_image_tile_t *tile, uint32_t band) {
+    const filter_tiled_ctx_t *t = (const filter_tiled_ctx_t *)arg;
+    uint32_t w = t->src->width;
+    uint32_t h = t->src->height;
+    size_t c = t->src->channels;
+    uint8_t *in = t->scratch + (size_t)band * t->scratch_bytes;
+    fossil_image_tile_read_region(t->src, (int32_t)tile->x - 1, (int32_t)tile->y - 1,
+                                  tile->width + 2, tile->height + 2, in, t->scratch_stride);
+
+    switch (t->src->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+        FILTER_TILE_CONVOLVE(uint16_t, {
+            if (sum < 0.0f) sum = 0.0f;
+            if (sum > 65535.0f) sum = 65535.0f;
+            o[(size_t)col * c + ch] = (uint16_t)sum;
+        });
+        break;
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        FILTER_TILE_CONVOLVE(float, o[(size_t)col * c + ch] = sum);
+        break;
+    default:
+        FILTER_TILE_CONVOLVE(uint8_t, o[(size_t)col * c + ch] = clamp8(sum));
+        break;
+    }
+}
+
+bool fossil_image_filter_convolve3x3_tiled(
+    const fossil_image_tiled_t *src,
+    fossil_image_tiled_t *out,
+    const float kernel[3][3],
+    float scale,
+    float bias
+) {
+    if (!src || !src->data || !out || !kernel || src->channels == 0 || src->width < 3 || src->height < 3)
+        return false;
+    switch (src->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+    case FOSSIL_PIXEL_FORMAT_INDEXED8:
+    case FOSSIL_PIXEL_FORMAT_YUV24:
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        break;
+    default:
+        return false;
+    }
+
+    filter_tiled_ctx_t t;
+    t.src = src;
+    t.kernel = kernel;
+    t.scale = scale;
+    t.bias = bias;
+    t.scratch_stride = (size_t)(src->tile_size + 2) * (src->tile_stride / src->tile_size);
+    t.scratch_bytes = t.scratch_stride * (src->tile_size + 2);
+    t.scratch = (uint8_t *)malloc((size_t)fossil_image_parallel_get_threads() * t.scratch_bytes);
+    if (!t.scratch)
+        return false;
+
+    // The new image starts zeroed, which covers the border and tile padding
+    fossil_image_tiled_t dst;
+    bool ok = fossil_image_tile_create(src->width, src->height, src->format, src->tile_size, &dst);
+    if (ok) {
+        dst.channels = src->channels;
+        ok = fossil_image_tile_for_each(&dst, filter_convolve_tile, &t);
+        if (ok)
+            *out = dst;
+        else
+            fossil_image_tile_free(&dst);
+    }
+    free(t.scratch);
+    return ok;
+}
+
 // ------------------------------------------------------
 // Predefined Filters
 // ------------------------------------------------------
@@ -180,6 +308,120 @@ bool fossil_image_filter_blur(fossil_image_t *image, float radius) {
     return ok;
 }
 
+/*
+ * Horizontal pass of a symmetric kernel with clamp-to-edge borders.
+ */
+static void blur_row_h(
+    const float *src,
+    float *dst,
+    uint32_t w,
+    size_t c,
+    const float *weights,
+    int radius
+) {
+    for (uint32_t x = 0; x < w; ++x) {
+        // Interior pixels skip the border clamps
+        if (x >= (uint32_t)radius && (uint64_t)x + (uint32_t)radius < w) {
+            const float *s = src + ((size_t)x - (size_t)radius) * c;
+            for (size_t ch = 0; ch < c; ++ch) {
+                float sum = 0.0f;
+                for (int k = 0; k <= 2 * radius; ++k)
+                    sum += weights[k] * s[(size_t)k * c + ch];
+                dst[(size_t)x * c + ch] = sum;
+            }
+            continue;
+        }
+        for (size_t ch = 0; ch < c; ++ch) {
+            float sum = 0.0f;
+            for (int k = -radius; k <= radius; ++k) {
+                int64_t sx = (int64_t)x + k;
+                if (sx < 0) sx = 0;
+                if (sx >= (int64_t)w) sx = (int64_t)w - 1;
+                sum += weights[k + radius] * src[(size_t)sx * c + ch];
+            }
+            dst[(size_t)x * c + ch] = sum;
+        }
+    }
+}
+
+bool fossil_image_filter_blur_linear(fossil_image_t *image, float radius) {
+    if (!image || image->channels == 0 || image->width < 3 || image->height < 3)
+        return false;
+    if (!fossil_image_color_linear_rows_supported(image->format))
+        return false;
+    if (!image->data)
+        return false;
+
+    // n passes of the 3x3 binomial kernel collapse into one separable
+    // binomial of radius n, so the whole blur is a single streaming pass.
+    int n = radius <= 1.0f ? 1 : (int)radius;
+    int taps = 2 * n + 1;
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    size_t c = image->channels;
+    size_t row_samples = (size_t)w * c;
+    size_t stride = (size_t)w * fossil_image_bytes_per_pixel(image->format);
+    uint32_t ring_rows = (uint32_t)taps < h ? (uint32_t)taps : h;
+
+    double *binomial = (double *)calloc((size_t)taps * 2, sizeof(double));
+    float *weights = (float *)malloc((size_t)taps * sizeof(float));
+    float *ring = (float *)malloc(((size_t)ring_rows + 2) * row_samples * sizeof(float));
+    if (!binomial || !weights || !ring) {
+        free(binomial);
+        free(weights);
+        free(ring);
+        return false;
+    }
+
+    // Convolve [1 2 1] / 4 with itself n times; stays normalized at any n
+    double *cur = binomial;
+    double *next = binomial + taps;
+    cur[n] = 1.0;
+    for (int pass = 0; pass < n; ++pass) {
+        for (int k = 0; k < taps; ++k) {
+            double left = k > 0 ? cur[k - 1] : 0.0;
+            double right = k + 1 < taps ? cur[k + 1] : 0.0;
+            next[k] = 0.25 * left + 0.5 * cur[k] + 0.25 * right;
+        }
+        double *t = cur; cur = next; next = t;
+    }
+    for (int k = 0; k < taps; ++k)
+        weights[k] = (float)cur[k];
+    free(binomial);
+
+    float *line = ring + (size_t)ring_rows * row_samples;
+    float *out = line + row_samples;
+    uint32_t decoded = 0;
+
+    for (uint32_t y = 0; y < h; ++y) {
+        // Pull in source rows up to y + n before row y is overwritten
+        uint32_t need = (y + (uint32_t)n < h) ? y + (uint32_t)n : h - 1;
+        for (; decoded <= need; ++decoded) {
+            fossil_image_color_decode_linear_row(image->format,
+                image->data + (size_t)decoded * stride, line, w);
+            blur_row_h(line, ring + (size_t)(decoded % ring_rows) * row_samples,
+                       w, c, weights, n);
+        }
+
+        memset(out, 0, row_samples * sizeof(float));
+        for (int k = -n; k <= n; ++k) {
+            int64_t sy = (int64_t)y + k;
+            if (sy < 0) sy = 0;
+            if (sy >= (int64_t)h) sy = (int64_t)h - 1;
+            const float *src = ring + (size_t)((uint32_t)sy % ring_rows) * row_samples;
+            float wk = weights[k + n];
+            for (size_t i = 0; i < row_samples; ++i)
+                out[i] += wk * src[i];
+        }
+        fossil_image_color_encode_linear_row(image->format, out,
+            image->data + (size_t)y * stride, w);
+    }
+
+    free(weights);
+    free(ring);
+    return true;
+}
+
 bool fossil_image_filter_sharpen(fossil_image_t *image) {
     if (!image || image->channels == 0 || image->width < 3 || image->height < 3)
         return false;
@@ -281,3 +523,1480 @@ bool fossil_image_filter_emboss(fossil_image_t *image) {
         return false;
     }
 }
+
+// ------------------------------------------------------
+// Rank Filters
+// ------------------------------------------------------
+
+/*
+ * Constant-time median (Perreault & Hebert). Every column of a strip keeps a
+ * histogram of the 2r+1 samples above and below the current row; moving down
+ * a row swaps one sample per column. The kernel histogram slides right by
+ * adding one column histogram and removing another. Both levels are split into
+ * coarse buckets (high bits) and fine bins (low bits): the coarse kernel
+ * histogram is updated at every pixel, while each fine bucket is only brought
+ * up to date when the median actually falls into it.
+ */
+#define MEDIAN_MAX_RADIUS 127u
+#define MEDIAN_STRIP_8 256u
+#define MEDIAN_STRIP_16 64u
+
+typedef struct median_ctx {
+    const uint8_t *src;
+    uint8_t *dst;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    int radius;
+    uint32_t shift;         // fine bits per coarse bucket (4 or 8)
+    bool wide;              // 16-bit samples
+    uint32_t strip;         // maximum columns per strip
+    uint8_t *scratch;       // one slice per band
+    size_t scratch_size;
+} median_ctx_t;
+
+static inline uint32_t median_load(const uint8_t *src, bool wide, size_t i) {
+    return wide ? ((const uint16_t *)src)[i] : src[i];
+}
+
+static inline uint32_t clamp_index(int64_t v, uint32_t n) {
+    if (v < 0) return 0;
+    if (v >= (int64_t)n) return n - 1;
+    return (uint32_t)v;
+}
+
+static size_t median_scratch_size(uint32_t strip, int radius, uint32_t shift) {
+    size_t cols = (size_t)strip + 2 * (size_t)radius;
+    size_t coarse = (size_t)1 << shift;
+    size_t values = coarse << shift;
+    size_t bytes = cols * (values + coarse)                 // column histograms
+                 + (values + coarse) * sizeof(uint16_t)     // kernel histograms
+                 + coarse * sizeof(int64_t);                // fine bucket sync points
+    return (bytes + 15) & ~(size_t)15;
+}
+
+static inline void median_strip(
+    const median_ctx_t *m,
+    uint8_t *scratch,
+    uint32_t x0,
+    uint32_t x1,
+    uint32_t ch,
+    const uint32_t shift,
+    const bool wide
+) {
+    const int r = m->radius;
+    const uint32_t coarse = 1u << shift;
+    const uint32_t values = coarse << shift;
+    const uint32_t fine_mask = coarse - 1;
+    const uint32_t span = 2u * (uint32_t)r + 1u;
+    const uint32_t half = span * span / 2u;
+    const uint32_t cols = (x1 - x0) + 2u * (uint32_t)r;
+    const size_t c = m->channels;
+    const size_t row = (size_t)m->width * c;
+    // Locals keep the byte-wide histogram stores from forcing reloads of *m
+    const uint8_t *src = m->src;
+    uint8_t *dst = m->dst;
+    const uint32_t width = m->width;
+    const uint32_t height = m->height;
+
+    int64_t *fine_at = (int64_t *)scratch;
+    uint16_t *k_coarse = (uint16_t *)(fine_at + coarse);
+    uint16_t *k_fine = k_coarse + coarse;
+    uint8_t *col_coarse = (uint8_t *)(k_fine + values);
+    uint8_t *col_fine = col_coarse + (size_t)cols * coarse;
+
+    memset(col_coarse, 0, (size_t)cols * (coarse + values));
+    for (uint32_t j = 0; j < cols; ++j) {
+        size_t gx = (size_t)clamp_index((int64_t)x0 + j - r, width) * c + ch;
+        for (int k = -r; k <= r; ++k) {
+            uint32_t v = median_load(src, wide, (size_t)clamp_index(k, height) * row + gx);
+            col_fine[(size_t)j * values + v]++;
+            col_coarse[(size_t)j * coarse + (v >> shift)]++;
+        }
+    }
+
+    for (uint32_t y = 0; y < height; ++y) {
+        if (y > 0) {
+            size_t out_row = (size_t)clamp_index((int64_t)y - r - 1, height) * row;
+            size_t in_row = (size_t)clamp_index((int64_t)y + r, height) * row;
+            for (uint32_t j = 0; j < cols; ++j) {
+                size_t gx = (size_t)clamp_index((int64_t)x0 + j - r, width) * c + ch;
+                uint32_t vo = median_load(src, wide, out_row + gx);
+                uint32_t vi = median_load(src, wide, in_row + gx);
+                if (vo == vi)
+                    continue;
+                col_fine[(size_t)j * values + vo]--;
+                col_fine[(size_t)j * values + vi]++;
+                col_coarse[(size_t)j * coarse + (vo >> shift)]--;
+                col_coarse[(size_t)j * coarse + (vi >> shift)]++;
+            }
+        }
+
+        memset(k_coarse, 0, coarse * sizeof(uint16_t));
+        for (uint32_t j = 0; j < span; ++j) {
+            const uint8_t *cc = col_coarse + (size_t)j * coarse;
+            for (uint32_t b = 0; b < coarse; ++b)
+                k_coarse[b] += cc[b];
+        }
+        for (uint32_t b = 0; b < coarse; ++b)
+            fine_at[b] = INT64_MIN;
+
+        for (uint32_t i = 0; i < x1 - x0; ++i) {
+            if (i > 0) {
+                const uint8_t *add = col_coarse + (size_t)(i + span - 1) * coarse;
+                const uint8_t *sub = col_coarse + (size_t)(i - 1) * coarse;
+                for (uint32_t b = 0; b < coarse; ++b)
+                    k_coarse[b] = (uint16_t)(k_coarse[b] + add[b] - sub[b]);
+            }
+
+            uint32_t acc = 0;
+            uint32_t b = 0;
+            while (acc + k_coarse[b] <= half)
+                acc += k_coarse[b++];
+
+            // Bring fine bucket b up to column window i, or rebuild it when
+            // catching up would touch more columns than the window holds
+            uint16_t *kf = k_fine + ((size_t)b << shift);
+            size_t base = (size_t)b << shift;
+            if (fine_at[b] == INT64_MIN || 2 * ((int64_t)i - fine_at[b]) >= (int64_t)span) {
+                memset(kf, 0, coarse * sizeof(uint16_t));
+                for (uint32_t j = i; j < i + span; ++j) {
+                    const uint8_t *cf = col_fine + (size_t)j * values + base;
+                    for (uint32_t f = 0; f < coarse; ++f)
+                        kf[f] += cf[f];
+                }
+            } else {
+                for (uint32_t t = (uint32_t)fine_at[b] + 1; t <= i; ++t) {
+                    const uint8_t *add = col_fine + (size_t)(t + span - 1) * values + base;
+                    const uint8_t *sub = col_fine + (size_t)(t - 1) * values + base;
+                    for (uint32_t f = 0; f < coarse; ++f)
+                        kf[f] = (uint16_t)(kf[f] + add[f] - sub[f]);
+                }
+            }
+            fine_at[b] = i;
+
+            uint32_t f = 0;
+            while (acc + kf[f] <= half)
+                acc += kf[f++];
+            uint32_t v = (b << shift) | (f & fine_mask);
+
+            size_t di = (size_t)y * row + (size_t)(x0 + i) * c + ch;
+            if (wide)
+                ((uint16_t *)dst)[di] = (uint16_t)v;
+            else
+                dst[di] = (uint8_t)v;
+        }
+    }
+}
+
+/* Constant bucket sizes let the compiler unroll and vectorize the histogram loops. */
+static void median_strip8(const median_ctx_t *m, uint8_t *scratch, uint32_t x0, uint32_t x1, uint32_t ch) {
+    median_strip(m, scratch, x0, x1, ch, 4, false);
+}
+
+static void median_strip16(const median_ctx_t *m, uint8_t *scratch, uint32_t x0, uint32_t x1, uint32_t ch) {
+    median_strip(m, scratch, x0, x1, ch, 8, true);
+}
+
+static void median_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const median_ctx_t *m = (const median_ctx_t *)arg;
+    uint8_t *scratch = m->scratch + (size_t)band * m->scratch_size;
+    for (uint32_t x0 = begin; x0 < end; x0 += m->strip) {
+        uint32_t x1 = x0 + m->strip < end ? x0 + m->strip : end;
+        for (uint32_t ch = 0; ch < m->channels; ++ch) {
+            if (m->wide)
+                median_strip16(m, scratch, x0, x1, ch);
+            else
+                median_strip8(m, scratch, x0, x1, ch);
+        }
+    }
+}
+
+bool fossil_image_filter_median(fossil_image_t *image, uint32_t radius) {
+    if (!image || !image->data || image->channels == 0 || image->width == 0 || image->height == 0)
+        return false;
+    if (radius > MEDIAN_MAX_RADIUS)
+        return false;
+
+    median_ctx_t m = { 0 };
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+        m.shift = 4;
+        m.strip = MEDIAN_STRIP_8;
+        break;
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+        m.shift = 8;
+        m.wide = true;
+        m.strip = MEDIAN_STRIP_16;
+        break;
+    default:
+        // Unsupported format
+        return false;
+    }
+    if (radius == 0)
+        return true;
+
+    size_t bytes = (size_t)image->width * image->height * image->channels * (m.wide ? 2 : 1);
+    uint8_t *src = (uint8_t *)malloc(bytes);
+    if (!src)
+        return false;
+    memcpy(src, image->data, bytes);
+
+    // Strips narrower than the kernel spend most of their time on borders
+    uint32_t min_cols = m.strip > 4 * radius ? m.strip : 4 * radius;
+    if (m.strip > image->width)
+        m.strip = image->width;
+    uint32_t bands = fossil_image_parallel_bands(image->width, min_cols);
+    m.src = src;
+    m.dst = image->data;
+    m.width = image->width;
+    m.height = image->height;
+    m.channels = image->channels;
+    m.radius = (int)radius;
+    m.scratch_size = median_scratch_size(m.strip, m.radius, m.shift);
+    m.scratch = (uint8_t *)malloc(m.scratch_size * bands);
+    if (!m.scratch) {
+        free(src);
+        return false;
+    }
+
+    fossil_image_parallel_for_bands(bands, image->width, median_band, &m);
+    free(m.scratch);
+    free(src);
+    return true;
+}
+
+// ------------------------------------------------------
+// Morphology
+// ------------------------------------------------------
+
+/*
+ * Rectangular erosion and dilation are separable, and each 1-D pass uses the
+ * van Herk / Gil-Werman scheme: the padded line is cut into blocks of 2r+1,
+ * a running min (or max) is taken forward and backward inside each block, and
+ * every output is the min of one backward and one forward value. That is three
+ * comparisons per sample at any radius. Samples outside the image do not take
+ * part in the window.
+ *
+ * A 1-D pass works on "lanes": every position along the line holds `lanes`
+ * contiguous samples. Horizontal passes use one lane per channel; vertical
+ * passes take a strip of a row as lanes, so the inner loops run along memory.
+ */
+#define MORPH_STRIP_BYTES 256u
+
+#define MORPH_MIN(a, b) ((b) < (a) ? (b) : (a))
+#define MORPH_MAX(a, b) ((b) > (a) ? (b) : (a))
+#define MORPH_AND(a, b) ((a) & (b))
+#define MORPH_OR(a, b)  ((a) | (b))
+
+#define MORPH_VHGW_BODY(T, OP, PAD)                                             \
+    for (size_t i = 0; i < np; ++i) {                                           \
+        const T *e = (i >= r && i - r < n) ? src + (i - r) * step : NULL;        \
+        T *gi = g + i * lanes;                                                  \
+        const T *gp = gi - lanes;                                               \
+        if (!e) {                                                               \
+            for (uint32_t l = 0; l < lanes; ++l)                                \
+                gi[l] = i % k == 0 ? (PAD) : gp[l];                             \
+        } else if (i % k == 0) {                                                \
+            memcpy(gi, e, lanes * sizeof(T));                                   \
+        } else {                                                                \
+            for (uint32_t l = 0; l < lanes; ++l)                                \
+                gi[l] = OP(gp[l], e[l]);                                        \
+        }                                                                       \
+    }                                                                           \
+    for (size_t i = np; i-- > 0;) {                                             \
+        const T *e = (i >= r && i - r < n) ? src + (i - r) * step : NULL;        \
+        T *hi = h + i * lanes;                                                  \
+        const T *hn = hi + lanes;                                               \
+        if (!e) {                                                               \
+            for (uint32_t l = 0; l < lanes; ++l)                                \
+                hi[l] = i % k == k - 1 ? (PAD) : hn[l];                         \
+        } else if (i % k == k - 1) {                                            \
+            memcpy(hi, e, lanes * sizeof(T));                                   \
+        } else {                                                                \
+            for (uint32_t l = 0; l < lanes; ++l)                                \
+                hi[l] = OP(hn[l], e[l]);                                        \
+        }                                                                       \
+    }                                                                           \
+    for (size_t x = 0; x < n; ++x) {                                            \
+        const T *hx = h + x * lanes;                                            \
+        const T *gx = g + (x + 2 * r) * lanes;                                  \
+        T *d = dst + x * step;                                                  \
+        for (uint32_t l = 0; l < lanes; ++l)                                    \
+            d[l] = OP(hx[l], gx[l]);                                            \
+    }
+
+#define MORPH_DEFINE_VHGW(SUFFIX, T, LOW, HIGH, MINOP, MAXOP)                   \
+static void morph_vhgw_##SUFFIX(                                                \
+    const T *src, T *dst, size_t step, size_t n, uint32_t lanes,                \
+    size_t r, bool dilate, T *scratch                                           \
+) {                                                                             \
+    const size_t k = 2 * r + 1;                                                 \
+    const size_t np = (n + 2 * r + k - 1) / k * k;                              \
+    T *g = scratch;                                                             \
+    T *h = scratch + np * lanes;                                                \
+    if (dilate) {                                                               \
+        MORPH_VHGW_BODY(T, MAXOP, LOW)                                          \
+    } else {                                                                    \
+        MORPH_VHGW_BODY(T, MINOP, HIGH)                                         \
+    }                                                                           \
+}
+
+MORPH_DEFINE_VHGW(u8, uint8_t, 0, UINT8_MAX, MORPH_MIN, MORPH_MAX)
+MORPH_DEFINE_VHGW(u16, uint16_t, 0, UINT16_MAX, MORPH_MIN, MORPH_MAX)
+MORPH_DEFINE_VHGW(f32, float, -INFINITY, INFINITY, MORPH_MIN, MORPH_MAX)
+MORPH_DEFINE_VHGW(bits, uint64_t, 0, UINT64_MAX, MORPH_AND, MORPH_OR)
+
+typedef enum morph_kind {
+    MORPH_KIND_U8,
+    MORPH_KIND_U16,
+    MORPH_KIND_F32,
+    MORPH_KIND_BITS         // packed binary mask, 64 pixels per word
+} morph_kind_t;
+
+typedef struct morph_plane {
+    morph_kind_t kind;
+    uint32_t width;         // pixels per row
+    uint32_t height;
+    uint32_t channels;      // lanes per position in horizontal passes
+    size_t row;             // elements per row
+    size_t elem;            // bytes per element
+    uint32_t rx;
+    uint32_t ry;
+    uint32_t strip;         // lanes per vertical strip
+    uint8_t *scratch;       // one slice per band
+    size_t scratch_size;
+    uint32_t row_bands;     // band counts the scratch was sized for
+    uint32_t strip_bands;
+    // Current pass
+    const uint8_t *in;
+    uint8_t *out;
+    bool dilate;
+} morph_plane_t;
+
+static inline size_t morph_padded(size_t n, size_t r) {
+    size_t k = 2 * r + 1;
+    return (n + 2 * r + k - 1) / k * k;
+}
+
+/* Word i of a bit row shifted toward lower indices by s; missing bits read as pad. */
+static inline uint64_t morph_bits_down(const uint64_t *a, size_t words, size_t i, size_t s, uint64_t pad) {
+    size_t j = i + s / 64;
+    unsigned b = (unsigned)(s % 64);
+    uint64_t lo = j < words ? a[j] : pad;
+    if (b == 0)
+        return lo;
+    uint64_t hi = j + 1 < words ? a[j + 1] : pad;
+    return (lo >> b) | (hi << (64 - b));
+}
+
+/* Word i of a bit row shifted toward higher indices by s; missing bits read as pad. */
+static inline uint64_t morph_bits_up(const uint64_t *a, size_t i, size_t s, uint64_t pad) {
+    size_t q = s / 64;
+    unsigned b = (unsigned)(s % 64);
+    uint64_t lo = i >= q ? a[i - q] : pad;
+    if (b == 0)
+        return lo;
+    uint64_t lower = i >= q + 1 ? a[i - q - 1] : pad;
+    return (lo << b) | (lower >> (64 - b));
+}
+
+/*
+ * Horizontal pass on one packed row. The AND (or OR) over a run of r+1 bits
+ * is built by doubling the run length with shifted copies, once looking right
+ * and once looking left; combining the two covers the 2r+1 window. A word of
+ * 64 pixels costs O(log r) operations.
+ */
+static void morph_bits_row(
+    const uint64_t *in,
+    uint64_t *out,
+    uint64_t *left,
+    uint32_t width,
+    size_t words,
+    size_t r,
+    bool dilate
+) {
+    const uint64_t pad = dilate ? 0 : UINT64_MAX;
+    unsigned tail = width % 64;
+
+    memcpy(out, in, words * sizeof(uint64_t));
+    if (tail) {
+        uint64_t used = ((uint64_t)1 << tail) - 1;
+        out[words - 1] = (out[words - 1] & used) | (pad & ~used);
+    }
+    memcpy(left, out, words * sizeof(uint64_t));
+
+    size_t len = 1;
+    while (len < r + 1) {
+        size_t s = 2 * len <= r + 1 ? len : r + 1 - len;
+        for (size_t i = 0; i < words; ++i) {
+            uint64_t v = morph_bits_down(out, words, i, s, pad);
+            out[i] = dilate ? (out[i] | v) : (out[i] & v);
+        }
+        for (size_t i = words; i-- > 0;) {
+            uint64_t v = morph_bits_up(left, i, s, pad);
+            left[i] = dilate ? (left[i] | v) : (left[i] & v);
+        }
+        len += s;
+    }
+    for (size_t i = 0; i < words; ++i)
+        out[i] = dilate ? (out[i] | left[i]) : (out[i] & left[i]);
+}
+
+static void morph_h_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const morph_plane_t *p = (const morph_plane_t *)arg;
+    uint8_t *scratch = p->scratch + (size_t)band * p->scratch_size;
+    size_t bytes = p->row * p->elem;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const uint8_t *src = p->in + (size_t)y * bytes;
+        uint8_t *dst = p->out + (size_t)y * bytes;
+        switch (p->kind) {
+        case MORPH_KIND_U8:
+            morph_vhgw_u8(src, dst, p->channels, p->width, p->channels, p->rx,
+                          p->dilate, scratch);
+            break;
+        case MORPH_KIND_U16:
+            morph_vhgw_u16((const uint16_t *)src, (uint16_t *)dst, p->channels, p->width,
+                           p->channels, p->rx, p->dilate, (uint16_t *)scratch);
+            break;
+        case MORPH_KIND_F32:
+            morph_vhgw_f32((const float *)src, (float *)dst, p->channels, p->width,
+                           p->channels, p->rx, p->dilate, (float *)scratch);
+            break;
+        case MORPH_KIND_BITS:
+            morph_bits_row((const uint64_t *)src, (uint64_t *)dst, (uint64_t *)scratch,
+                           p->width, p->row, p->rx, p->dilate);
+            break;
+        }
+    }
+}
+
+static void morph_v_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const morph_plane_t *p = (const morph_plane_t *)arg;
+    uint8_t *scratch = p->scratch + (size_t)band * p->scratch_size;
+
+    for (uint32_t s = begin; s < end; ++s) {
+        size_t first = (size_t)s * p->strip;
+        uint32_t lanes = (uint32_t)(p->row - first < p->strip ? p->row - first : p->strip);
+        const uint8_t *src = p->in + first * p->elem;
+        uint8_t *dst = p->out + first * p->elem;
+        switch (p->kind) {
+        case MORPH_KIND_U8:
+            morph_vhgw_u8(src, dst, p->row, p->height, lanes, p->ry, p->dilate, scratch);
+            break;
+        case MORPH_KIND_U16:
+            morph_vhgw_u16((const uint16_t *)src, (uint16_t *)dst, p->row, p->height,
+                           lanes, p->ry, p->dilate, (uint16_t *)scratch);
+            break;
+        case MORPH_KIND_F32:
+            morph_vhgw_f32((const float *)src, (float *)dst, p->row, p->height,
+                           lanes, p->ry, p->dilate, (float *)scratch);
+            break;
+        case MORPH_KIND_BITS:
+            morph_vhgw_bits((const uint64_t *)src, (uint64_t *)dst, p->row, p->height,
+                            lanes, p->ry, p->dilate, (uint64_t *)scratch);
+            break;
+        }
+    }
+}
+
+/* Erode or dilate `in` into `out` (which may alias it) through `tmp`. */
+static void morph_basic(morph_plane_t *p, uint8_t *in, uint8_t *out, uint8_t *tmp, bool dilate) {
+    uint32_t strips = (uint32_t)((p->row + p->strip - 1) / p->strip);
+    p->dilate = dilate;
+    p->in = in;
+    p->out = tmp;
+    fossil_image_parallel_for_bands(p->row_bands, p->height, morph_h_band, p);
+    p->in = tmp;
+    p->out = out;
+    fossil_image_parallel_for_bands(p->strip_bands, strips, morph_v_band, p);
+}
+
+/* out = a - b, where a >= b sample-wise (a & ~b for masks). */
+static void morph_subtract(const morph_plane_t *p, const uint8_t *a, const uint8_t *b, uint8_t *out) {
+    size_t n = p->row * p->height;
+    switch (p->kind) {
+    case MORPH_KIND_U8:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = (uint8_t)(a[i] - b[i]);
+        break;
+    case MORPH_KIND_U16: {
+        const uint16_t *a16 = (const uint16_t *)a;
+        const uint16_t *b16 = (const uint16_t *)b;
+        uint16_t *o16 = (uint16_t *)out;
+        for (size_t i = 0; i < n; ++i)
+            o16[i] = (uint16_t)(a16[i] - b16[i]);
+        break;
+    }
+    case MORPH_KIND_F32: {
+        const float *af = (const float *)a;
+        const float *bf = (const float *)b;
+        float *of = (float *)out;
+        for (size_t i = 0; i < n; ++i)
+            of[i] = af[i] - bf[i];
+        break;
+    }
+    case MORPH_KIND_BITS: {
+        const uint64_t *aw = (const uint64_t *)a;
+        const uint64_t *bw = (const uint64_t *)b;
+        uint64_t *ow = (uint64_t *)out;
+        for (size_t i = 0; i < n; ++i)
+            ow[i] = aw[i] & ~bw[i];
+        break;
+    }
+    }
+}
+
+static bool morph_run(morph_plane_t *p, uint8_t *data, fossil_morph_op_t op) {
+    size_t bytes = p->row * p->height * p->elem;
+    bool needs_copy = op == FOSSIL_MORPH_GRADIENT || op == FOSSIL_MORPH_TOPHAT ||
+                      op == FOSSIL_MORPH_BLACKHAT;
+
+    size_t line = p->kind == MORPH_KIND_BITS ? p->row : morph_padded(p->width, p->rx) * p->channels;
+    size_t column = morph_padded(p->height, p->ry) * p->strip;
+    p->scratch_size = ((line > column ? line : column) * 2 * p->elem + 63) & ~(size_t)63;
+    p->row_bands = fossil_image_parallel_bands(p->height, 16);
+    p->strip_bands = fossil_image_parallel_bands((uint32_t)((p->row + p->strip - 1) / p->strip), 1);
+    uint32_t bands = p->row_bands > p->strip_bands ? p->row_bands : p->strip_bands;
+
+    p->scratch = (uint8_t *)malloc(p->scratch_size * bands);
+    uint8_t *tmp = (uint8_t *)malloc(bytes);
+    uint8_t *copy = needs_copy ? (uint8_t *)malloc(bytes) : NULL;
+    if (!p->scratch || !tmp || (needs_copy && !copy)) {
+        free(p->scratch);
+        free(tmp);
+        free(copy);
+        return false;
+    }
+    if (copy)
+        memcpy(copy, data, bytes);
+
+    switch (op) {
+    case FOSSIL_MORPH_ERODE:
+        morph_basic(p, data, data, tmp, false);
+        break;
+    case FOSSIL_MORPH_DILATE:
+        morph_basic(p, data, data, tmp, true);
+        break;
+    case FOSSIL_MORPH_OPEN:
+        morph_basic(p, data, data, tmp, false);
+        morph_basic(p, data, data, tmp, true);
+        break;
+    case FOSSIL_MORPH_CLOSE:
+        morph_basic(p, data, data, tmp, true);
+        morph_basic(p, data, data, tmp, false);
+        break;
+    case FOSSIL_MORPH_GRADIENT:
+        morph_basic(p, copy, copy, tmp, true);
+        morph_basic(p, data, data, tmp, false);
+        morph_subtract(p, copy, data, data);
+        break;
+    case FOSSIL_MORPH_TOPHAT:
+        morph_basic(p, copy, copy, tmp, false);
+        morph_basic(p, copy, copy, tmp, true);
+        morph_subtract(p, data, copy, data);
+        break;
+    case FOSSIL_MORPH_BLACKHAT:
+        morph_basic(p, copy, copy, tmp, true);
+        morph_basic(p, copy, copy, tmp, false);
+        morph_subtract(p, copy, data, data);
+        break;
+    }
+
+    free(p->scratch);
+    free(tmp);
+    free(copy);
+    return true;
+}
+
+/* A GRAY8 image holding only 0 and 255 is morphed as a packed bit mask. */
+static bool morph_is_binary(const fossil_image_t *image) {
+    size_t n = (size_t)image->width * image->height;
+    for (size_t i = 0; i < n; ++i) {
+        if (image->data[i] != 0 && image->data[i] != 255)
+            return false;
+    }
+    return true;
+}
+
+static bool morph_binary(fossil_image_t *image, fossil_morph_op_t op, uint32_t rx, uint32_t ry) {
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    size_t words = ((size_t)w + 63) / 64;
+    uint64_t *mask = (uint64_t *)calloc(words * h, sizeof(uint64_t));
+    if (!mask)
+        return false;
+
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t *src = image->data + (size_t)y * w;
+        uint64_t *row = mask + (size_t)y * words;
+        for (uint32_t x = 0; x < w; ++x)
+            row[x / 64] |= (uint64_t)(src[x] != 0) << (x % 64);
+    }
+
+    morph_plane_t p = { 0 };
+    p.kind = MORPH_KIND_BITS;
+    p.width = w;
+    p.height = h;
+    p.channels = 1;
+    p.row = words;
+    p.elem = sizeof(uint64_t);
+    p.rx = rx;
+    p.ry = ry;
+    p.strip = MORPH_STRIP_BYTES / sizeof(uint64_t);
+    if (!morph_run(&p, (uint8_t *)mask, op)) {
+        free(mask);
+        return false;
+    }
+
+    for (uint32_t y = 0; y < h; ++y) {
+        uint8_t *dst = image->data + (size_t)y * w;
+        const uint64_t *row = mask + (size_t)y * words;
+        for (uint32_t x = 0; x < w; ++x)
+            dst[x] = (uint8_t)(0u - (uint8_t)((row[x / 64] >> (x % 64)) & 1u));
+    }
+    free(mask);
+    return true;
+}
+
+bool fossil_image_filter_morphology(
+    fossil_image_t *image,
+    fossil_morph_op_t op,
+    uint32_t radius_x,
+    uint32_t radius_y
+) {
+    if (!image || !image->data || image->channels == 0 || image->width == 0 || image->height == 0)
+        return false;
+    if (op < FOSSIL_MORPH_ERODE || op > FOSSIL_MORPH_BLACKHAT)
+        return false;
+
+    morph_plane_t p = { 0 };
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+        if (morph_is_binary(image))
+            return morph_binary(image, op, radius_x, radius_y);
+        // fall through
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+        p.kind = MORPH_KIND_U8;
+        p.elem = sizeof(uint8_t);
+        break;
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+        p.kind = MORPH_KIND_U16;
+        p.elem = sizeof(uint16_t);
+        break;
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        p.kind = MORPH_KIND_F32;
+        p.elem = sizeof(float);
+        break;
+    default:
+        // Unsupported format
+        return false;
+    }
+
+    p.width = image->width;
+    p.height = image->height;
+    p.channels = image->channels;
+    p.row = (size_t)image->width * image->channels;
+    p.rx = radius_x;
+    p.ry = radius_y;
+    p.strip = (uint32_t)(MORPH_STRIP_BYTES / p.elem);
+    return morph_run(&p, image->data, op);
+}
+
+// ------------------------------------------------------
+// Edge-Preserving Smoothing
+// ------------------------------------------------------
+
+/*
+ * Bilateral grid (Paris & Durand). Pixels are splatted into a coarse 3-D grid
+ * indexed by (x / sigma_s, y / sigma_s, guide / sigma_r), where the guide is
+ * the pixel's luma. Each cell holds the channel sums plus a count. The grid is
+ * blurred with a 5-tap binomial along each axis and the result is sliced back
+ * with trilinear interpolation, dividing by the interpolated count. The cost
+ * per pixel does not depend on the spatial sigma. Two empty cells on every
+ * side let the clamped blur treat the border as empty.
+ */
+#define BILATERAL_PAD 2
+#define BILATERAL_TAPS 2
+
+typedef struct bilateral_ctx {
+    fossil_image_t *image;
+    float *grid;
+    float *tmp;
+    uint32_t gx;
+    uint32_t gy;
+    uint32_t gz;
+    uint32_t lanes;         // channels + count
+    float inv_ss;
+    float inv_sr;
+    float guide_min;
+    float in_scale;         // 1/255 for 8-bit samples, 1 for float
+    bool is_float;
+    int axis;               // blur axis for bilateral_blur_band: 1 = y, 2 = z
+    const float *weights;
+} bilateral_ctx_t;
+
+static inline void bilateral_load(const bilateral_ctx_t *b, size_t i, float *px) {
+    uint32_t c = b->image->channels;
+    if (b->is_float) {
+        for (uint32_t ch = 0; ch < c; ++ch)
+            px[ch] = b->image->fdata[i + ch];
+    } else {
+        for (uint32_t ch = 0; ch < c; ++ch)
+            px[ch] = (float)b->image->data[i + ch] * b->in_scale;
+    }
+}
+
+static inline float bilateral_guide(const float *px, uint32_t c) {
+    return c >= 3 ? 0.299f * px[0] + 0.587f * px[1] + 0.114f * px[2] : px[0];
+}
+
+static inline uint32_t bilateral_cell(float v, uint32_t limit) {
+    int64_t i = (int64_t)(v + 0.5f) + BILATERAL_PAD;
+    if (i < 0) i = 0;
+    if (i >= (int64_t)limit) i = (int64_t)limit - 1;
+    return (uint32_t)i;
+}
+
+/* Every image row lands in exactly one grid row, so bands never share cells. */
+static void bilateral_splat_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    const bilateral_ctx_t *b = (const bilateral_ctx_t *)arg;
+    uint32_t w = b->image->width;
+    uint32_t c = b->image->channels;
+    size_t plane = (size_t)b->gy * b->gx;
+    float px[4];
+
+    for (uint32_t y = 0; y < b->image->height; ++y) {
+        uint32_t cy = bilateral_cell((float)y * b->inv_ss, b->gy);
+        if (cy < begin || cy >= end)
+            continue;
+        for (uint32_t x = 0; x < w; ++x) {
+            bilateral_load(b, ((size_t)y * w + x) * c, px);
+            uint32_t cx = bilateral_cell((float)x * b->inv_ss, b->gx);
+            uint32_t cz = bilateral_cell((bilateral_guide(px, c) - b->guide_min) * b->inv_sr, b->gz);
+            float *cell = b->grid + ((size_t)cz * plane + (size_t)cy * b->gx + cx) * b->lanes;
+            for (uint32_t ch = 0; ch < c; ++ch)
+                cell[ch] += px[ch];
+            cell[c] += 1.0f;
+        }
+    }
+}
+
+/* Blur along x: each (z, y) line is a row of gx cells, lanes wide. */
+static void bilateral_blur_x_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    const bilateral_ctx_t *b = (const bilateral_ctx_t *)arg;
+    size_t line = (size_t)b->gx * b->lanes;
+    for (uint32_t i = begin; i < end; ++i)
+        blur_row_h(b->grid + i * line, b->tmp + i * line, b->gx, b->lanes,
+                   b->weights, BILATERAL_TAPS);
+}
+
+/* Blur along y or z: output line (z, y) sums whole neighbouring lines. */
+static void bilateral_blur_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    const bilateral_ctx_t *b = (const bilateral_ctx_t *)arg;
+    size_t line = (size_t)b->gx * b->lanes;
+    const float *src = b->axis == 1 ? b->tmp : b->grid;
+    float *dst = b->axis == 1 ? b->grid : b->tmp;
+
+    for (uint32_t i = begin; i < end; ++i) {
+        int64_t z = i / b->gy;
+        int64_t y = i % b->gy;
+        float *out = dst + (size_t)i * line;
+        memset(out, 0, line * sizeof(float));
+        for (int k = -BILATERAL_TAPS; k <= BILATERAL_TAPS; ++k) {
+            int64_t sz = z, sy = y;
+            if (b->axis == 1) {
+                sy += k;
+                if (sy < 0) sy = 0;
+                if (sy >= (int64_t)b->gy) sy = (int64_t)b->gy - 1;
+            } else {
+                sz += k;
+                if (sz < 0) sz = 0;
+                if (sz >= (int64_t)b->gz) sz = (int64_t)b->gz - 1;
+            }
+            const float *in = src + ((size_t)sz * b->gy + (size_t)sy) * line;
+            float wk = b->weights[k + BILATERAL_TAPS];
+            for (size_t j = 0; j < line; ++j)
+                out[j] += wk * in[j];
+        }
+    }
+}
+
+static void bilateral_slice_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    const bilateral_ctx_t *b = (const bilateral_ctx_t *)arg;
+    uint32_t w = b->image->width;
+    uint32_t c = b->image->channels;
+    uint32_t lanes = b->lanes;
+    size_t sx = lanes;
+    size_t sy = (size_t)b->gx * lanes;
+    size_t sz = (size_t)b->gy * sy;
+    float px[4];
+    float acc[5];
+
+    for (uint32_t y = begin; y < end; ++y) {
+        float fy = (float)y * b->inv_ss + BILATERAL_PAD;
+        uint32_t y0 = (uint32_t)fy;
+        float ty = fy - (float)y0;
+        for (uint32_t x = 0; x < w; ++x) {
+            size_t i = ((size_t)y * w + x) * c;
+            bilateral_load(b, i, px);
+            float fx = (float)x * b->inv_ss + BILATERAL_PAD;
+            float fz = (bilateral_guide(px, c) - b->guide_min) * b->inv_sr + BILATERAL_PAD;
+            if (fz < 0.0f) fz = 0.0f;
+            if (fz > (float)(b->gz - 2)) fz = (float)(b->gz - 2);
+            uint32_t x0 = (uint32_t)fx;
+            uint32_t z0 = (uint32_t)fz;
+            float tx = fx - (float)x0;
+            float tz = fz - (float)z0;
+
+            const float *base = b->tmp + (size_t)z0 * sz + (size_t)y0 * sy + (size_t)x0 * sx;
+            for (uint32_t l = 0; l < lanes; ++l) {
+                float c00 = base[l] + tx * (base[sx + l] - base[l]);
+                float c01 = base[sy + l] + tx * (base[sy + sx + l] - base[sy + l]);
+                float c10 = base[sz + l] + tx * (base[sz + sx + l] - base[sz + l]);
+                float c11 = base[sz + sy + l] + tx * (base[sz + sy + sx + l] - base[sz + sy + l]);
+                float c0 = c00 + ty * (c01 - c00);
+                float c1 = c10 + ty * (c11 - c10);
+                acc[l] = c0 + tz * (c1 - c0);
+            }
+            if (acc[c] <= 1e-6f)
+                continue;
+
+            float inv = 1.0f / acc[c];
+            if (b->is_float) {
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    b->image->fdata[i + ch] = acc[ch] * inv;
+            } else {
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    b->image->data[i + ch] = clamp8(acc[ch] * inv * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+bool fossil_image_filter_bilateral(
+    fossil_image_t *image,
+    float sigma_spatial,
+    float sigma_range
+) {
+    if (!image || !image->data || image->width == 0 || image->height == 0)
+        return false;
+    if (image->channels == 0 || image->channels > 4)
+        return false;
+    if (!(sigma_spatial >= 1.0f) || !(sigma_range > 0.0f))
+        return false;
+
+    bilateral_ctx_t b = { 0 };
+    b.image = image;
+    float guide_span = 1.0f;
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+        b.in_scale = 1.0f / 255.0f;
+        b.guide_min = 0.0f;
+        break;
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA: {
+        b.in_scale = 1.0f;
+        b.is_float = true;
+        float gmin = INFINITY, gmax = -INFINITY, px[4];
+        size_t n = (size_t)image->width * image->height;
+        for (size_t i = 0; i < n; ++i) {
+            bilateral_load(&b, i * image->channels, px);
+            float g = bilateral_guide(px, image->channels);
+            if (g < gmin) gmin = g;
+            if (g > gmax) gmax = g;
+        }
+        if (!isfinite(gmin) || !isfinite(gmax))
+            return false;
+        b.guide_min = gmin;
+        guide_span = gmax - gmin;
+        break;
+    }
+    default:
+        // Unsupported format
+        return false;
+    }
+
+    b.inv_ss = 1.0f / sigma_spatial;
+    b.inv_sr = 1.0f / sigma_range;
+    b.lanes = image->channels + 1;
+    b.gx = (uint32_t)((float)(image->width - 1) * b.inv_ss + 0.5f) + 1 + 2 * BILATERAL_PAD;
+    b.gy = (uint32_t)((float)(image->height - 1) * b.inv_ss + 0.5f) + 1 + 2 * BILATERAL_PAD;
+    double gz = (double)guide_span * b.inv_sr + 1.5 + 2 * BILATERAL_PAD;
+    size_t cells = (size_t)b.gx * b.gy;
+    if (gz > 65536.0 || cells > SIZE_MAX / 65536 / b.lanes)
+        return false;
+    b.gz = (uint32_t)gz;
+    cells *= b.gz;
+
+    static const float weights[2 * BILATERAL_TAPS + 1] = {
+        1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f
+    };
+    b.weights = weights;
+    b.grid = (float *)calloc(cells * b.lanes, sizeof(float));
+    b.tmp = (float *)malloc(cells * b.lanes * sizeof(float));
+    if (!b.grid || !b.tmp) {
+        free(b.grid);
+        free(b.tmp);
+        return false;
+    }
+
+    uint32_t lines = b.gy * b.gz;
+    fossil_image_parallel_for(b.gy, 1, bilateral_splat_band, &b);
+    fossil_image_parallel_for(lines, 16, bilateral_blur_x_band, &b);
+    b.axis = 1;
+    fossil_image_parallel_for(lines, 16, bilateral_blur_band, &b);
+    b.axis = 2;
+    fossil_image_parallel_for(lines, 16, bilateral_blur_band, &b);
+    fossil_image_parallel_for(image->height, 16, bilateral_slice_band, &b);
+
+    free(b.grid);
+    free(b.tmp);
+    return true;
+}
+
+// ------------------------------------------------------
+// Detail Filters
+// ------------------------------------------------------
+
+/*
+ * Unsharp mask and high-pass share one streaming engine. Each band of rows
+ * keeps a ring of 2r+1 horizontally blurred rows; once row y + r is in the
+ * ring, the vertical pass produces the blurred row y, and the difference to
+ * the source row is applied and written back in the same step. No blurred
+ * copy of the image is made. Bands write in place, so the r rows above and
+ * below each band are copied aside before the bands start.
+ */
+typedef struct detail_ctx {
+    fossil_image_t *image;
+    uint32_t bands;
+    int radius;
+    const float *weights;
+    float amount;
+    float threshold;
+    bool high_pass;
+    size_t stride;          // bytes per image row
+    uint8_t *halo;          // 2 * radius rows per band
+    float *scratch;         // one slice per band
+    size_t scratch_size;    // floats per band
+} detail_ctx_t;
+
+static inline uint32_t detail_band_begin(const detail_ctx_t *d, uint32_t band) {
+    return (uint32_t)((uint64_t)d->image->height * band / d->bands);
+}
+
+/* Source row sy as seen by a band, taking rows outside the band from the halo. */
+static const uint8_t *detail_row(const detail_ctx_t *d, uint32_t band, uint32_t begin, uint32_t end, uint32_t sy) {
+    size_t r = (size_t)d->radius;
+    uint8_t *halo = d->halo + (size_t)band * 2 * r * d->stride;
+    if (sy < begin)
+        return halo + (sy + r - begin) * d->stride;
+    if (sy >= end)
+        return halo + (r + sy - end) * d->stride;
+    return d->image->data + (size_t)sy * d->stride;
+}
+
+static void detail_load(const fossil_image_t *image, const uint8_t *row, float *dst, size_t n) {
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64: {
+        const uint16_t *src = (const uint16_t *)row;
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = (float)src[i] * (1.0f / 65535.0f);
+        break;
+    }
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        memcpy(dst, row, n * sizeof(float));
+        break;
+    default:
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = (float)row[i] * (1.0f / 255.0f);
+        break;
+    }
+}
+
+static void detail_store(const fossil_image_t *image, const float *src, uint8_t *row, size_t n) {
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64: {
+        uint16_t *dst = (uint16_t *)row;
+        for (size_t i = 0; i < n; ++i) {
+            float v = src[i] * 65535.0f + 0.5f;
+            if (v < 0.0f) v = 0.0f;
+            if (v > 65535.0f) v = 65535.0f;
+            dst[i] = (uint16_t)v;
+        }
+        break;
+    }
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        memcpy(row, src, n * sizeof(float));
+        break;
+    default:
+        for (size_t i = 0; i < n; ++i)
+            row[i] = clamp8(src[i] * 255.0f + 0.5f);
+        break;
+    }
+}
+
+static void detail_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const detail_ctx_t *d = (const detail_ctx_t *)arg;
+    const fossil_image_t *image = d->image;
+    const int r = d->radius;
+    const uint32_t h = image->height;
+    const size_t n = (size_t)image->width * image->channels;
+    const uint32_t ring_rows = 2 * (uint32_t)r + 1;
+
+    float *ring = d->scratch + (size_t)band * d->scratch_size;
+    float *line = ring + (size_t)ring_rows * n;
+    float *out = line + n;
+    int64_t loaded = (int64_t)begin - r - 1;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        // Ring slot k holds source row y + k - r, clamped to the image
+        for (; loaded < (int64_t)y + r; ++loaded) {
+            int64_t want = loaded + 1;
+            uint32_t sy = clamp_index(want, h);
+            detail_load(image, detail_row(d, band, begin, end, sy), line, n);
+            blur_row_h(line, ring + (size_t)((uint64_t)(want + r) % ring_rows) * n,
+                       image->width, image->channels, d->weights, r);
+        }
+
+        memset(out, 0, n * sizeof(float));
+        for (int k = -r; k <= r; ++k) {
+            const float *src = ring + (size_t)((uint64_t)((int64_t)y + k + r) % ring_rows) * n;
+            float wk = d->weights[k + r];
+            for (size_t i = 0; i < n; ++i)
+                out[i] += wk * src[i];
+        }
+
+        detail_load(image, detail_row(d, band, begin, end, y), line, n);
+        if (d->high_pass) {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = line[i] - out[i] + 0.5f;
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                float diff = line[i] - out[i];
+                out[i] = fabsf(diff) >= d->threshold ? line[i] + d->amount * diff : line[i];
+            }
+        }
+        detail_store(image, out, image->data + (size_t)y * d->stride, n);
+    }
+}
+
+static bool detail_filter(
+    fossil_image_t *image,
+    float sigma,
+    float amount,
+    float threshold,
+    bool high_pass
+) {
+    if (!image || !image->data || image->channels == 0 || image->width == 0 || image->height == 0)
+        return false;
+    if (!(sigma > 0.0f) || !isfinite(amount) || !(threshold >= 0.0f))
+        return false;
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        break;
+    default:
+        // Unsupported format
+        return false;
+    }
+
+    int r = (int)ceilf(3.0f * sigma);
+    if (r < 1)
+        r = 1;
+    if (r > 1024)
+        return false;
+    uint32_t h = image->height;
+    size_t n = (size_t)image->width * image->channels;
+
+    detail_ctx_t d = { 0 };
+    d.image = image;
+    d.radius = r;
+    d.amount = amount;
+    d.threshold = threshold;
+    d.high_pass = high_pass;
+    d.stride = (size_t)image->width * fossil_image_bytes_per_pixel(image->format);
+    uint32_t min_rows = 4 * (uint32_t)r > 64 ? 4 * (uint32_t)r : 64;
+    d.bands = fossil_image_parallel_bands(h, min_rows);
+    d.scratch_size = ((size_t)2 * r + 3) * n;
+
+    float *weights = (float *)malloc(((size_t)2 * r + 1) * sizeof(float));
+    d.halo = (uint8_t *)malloc((size_t)d.bands * 2 * r * d.stride + 1);
+    d.scratch = (float *)malloc(d.scratch_size * d.bands * sizeof(float));
+    if (!weights || !d.halo || !d.scratch) {
+        free(weights);
+        free(d.halo);
+        free(d.scratch);
+        return false;
+    }
+
+    float sum = 0.0f;
+    for (int k = -r; k <= r; ++k) {
+        weights[k + r] = expf(-(float)(k * k) / (2.0f * sigma * sigma));
+        sum += weights[k + r];
+    }
+    for (int k = 0; k < 2 * r + 1; ++k)
+        weights[k] /= sum;
+    d.weights = weights;
+
+    // Rows just outside each band, captured before any band writes
+    for (uint32_t b = 0; b < d.bands; ++b) {
+        uint32_t begin = detail_band_begin(&d, b);
+        uint32_t end = detail_band_begin(&d, b + 1);
+        uint8_t *halo = d.halo + (size_t)b * 2 * r * d.stride;
+        for (int k = 0; k < r; ++k) {
+            int64_t above = (int64_t)begin - r + k;
+            int64_t below = (int64_t)end + k;
+            if (above >= 0)
+                memcpy(halo + (size_t)k * d.stride, image->data + (size_t)above * d.stride, d.stride);
+            if (below < (int64_t)h)
+                memcpy(halo + ((size_t)r + k) * d.stride, image->data + (size_t)below * d.stride, d.stride);
+        }
+    }
+
+    fossil_image_parallel_for_bands(d.bands, h, detail_band, &d);
+    free(weights);
+    free(d.halo);
+    free(d.scratch);
+    return true;
+}
+
+bool fossil_image_filter_unsharp_mask(
+    fossil_image_t *image,
+    float sigma,
+    float amount,
+    float threshold
+) {
+    return detail_filter(image, sigma, amount, threshold, false);
+}
+
+bool fossil_image_filter_high_pass(fossil_image_t *image, float sigma) {
+    return detail_filter(image, sigma, 0.0f, 0.0f, true);
+}
+
+// ------------------------------------------------------
+// Arbitrary Kernels
+// ------------------------------------------------------
+
+/*
+ * Each channel is first copied into a float plane extended by the kernel size
+ * with clamp-to-edge borders, so both methods compute a plain "valid"
+ * correlation of that plane. The direct method accumulates one kernel tap at a
+ * time across whole rows. The FFT method multiplies the plane's spectrum by
+ * the conjugate kernel spectrum; the FFT size covers the whole plane, so the
+ * circular wrap never reaches an output pixel.
+ */
+typedef struct conv_ctx {
+    const float *plane;
+    float *out;
+    const float *kernel;
+    uint32_t plane_width;
+    uint32_t width;
+    uint32_t kernel_width;
+    uint32_t kernel_height;
+} conv_ctx_t;
+
+static void conv_direct_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    const conv_ctx_t *k = (const conv_ctx_t *)arg;
+    const uint32_t w = k->width;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        float *out = k->out + (size_t)y * w;
+        memset(out, 0, (size_t)w * sizeof(float));
+        for (uint32_t j = 0; j < k->kernel_height; ++j) {
+            const float *row = k->plane + (size_t)(y + j) * k->plane_width;
+            const float *taps = k->kernel + (size_t)j * k->kernel_width;
+            for (uint32_t i = 0; i < k->kernel_width; ++i) {
+                float t = taps[i];
+                if (t == 0.0f)
+                    continue;
+                const float *src = row + i;
+                for (uint32_t x = 0; x < w; ++x)
+                    out[x] += t * src[x];
+            }
+        }
+    }
+}
+
+static void conv_load_plane(
+    const fossil_image_t *image,
+    uint32_t ch,
+    float *plane,
+    uint32_t plane_width,
+    uint32_t plane_height,
+    size_t plane_stride,
+    uint32_t ax,
+    uint32_t ay
+) {
+    const uint32_t w = image->width;
+    const uint32_t c = image->channels;
+    for (uint32_t py = 0; py < plane_height; ++py) {
+        size_t row = (size_t)clamp_index((int64_t)py - ay, image->height) * w;
+        float *dst = plane + (size_t)py * plane_stride;
+        for (uint32_t px = 0; px < plane_width; ++px) {
+            size_t i = (row + clamp_index((int64_t)px - ax, w)) * c + ch;
+            switch (image->format) {
+            case FOSSIL_PIXEL_FORMAT_GRAY16:
+            case FOSSIL_PIXEL_FORMAT_RGB48:
+            case FOSSIL_PIXEL_FORMAT_RGBA64:
+                dst[px] = (float)((const uint16_t *)image->data)[i];
+                break;
+            case FOSSIL_PIXEL_FORMAT_FLOAT32:
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+                dst[px] = image->fdata[i];
+                break;
+            default:
+                dst[px] = (float)image->data[i];
+                break;
+            }
+        }
+    }
+}
+
+static void conv_store_channel(fossil_image_t *image, uint32_t ch, const float *src, size_t src_stride) {
+    const uint32_t w = image->width;
+    const uint32_t c = image->channels;
+    for (uint32_t y = 0; y < image->height; ++y) {
+        const float *row = src + (size_t)y * src_stride;
+        for (uint32_t x = 0; x < w; ++x) {
+            size_t i = ((size_t)y * w + x) * c + ch;
+            float v = row[x];
+            switch (image->format) {
+            case FOSSIL_PIXEL_FORMAT_GRAY16:
+            case FOSSIL_PIXEL_FORMAT_RGB48:
+            case FOSSIL_PIXEL_FORMAT_RGBA64:
+                v += 0.5f;
+                if (v < 0.0f) v = 0.0f;
+                if (v > 65535.0f) v = 65535.0f;
+                ((uint16_t *)image->data)[i] = (uint16_t)v;
+                break;
+            case FOSSIL_PIXEL_FORMAT_FLOAT32:
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+                image->fdata[i] = v;
+                break;
+            default:
+                image->data[i] = clamp8(v + 0.5f);
+                break;
+            }
+        }
+    }
+}
+
+static size_t conv_fft_width(size_t n) {
+    size_t size = fossil_image_fft_good_size(n);
+    while (size && size % 2 != 0)
+        size = fossil_image_fft_good_size(size + 1);
+    return size;
+}
+
+/*
+ * Rough operation counts: the direct method costs one multiply-add per tap
+ * and sample; the FFT method two real 2-D transforms per channel, weighted
+ * for their poorer vectorization.
+ */
+static bool conv_prefer_fft(uint32_t w, uint32_t h, uint32_t kw, uint32_t kh, size_t fw, size_t fh) {
+    double direct = (double)w * h * kw * kh;
+    double area = (double)fw * fh;
+    double fft = 6.0 * area * log2(area > 2.0 ? area : 2.0);
+    return fft < direct;
+}
+
+static bool conv_fft_channels(fossil_image_t *image, const float *kernel, uint32_t kw, uint32_t kh,
+                              uint32_t ax, uint32_t ay, size_t fw, size_t fh) {
+    const uint32_t w = image->width;
+    const uint32_t h = image->height;
+    size_t bins = fw / 2 + 1;
+    float *plane = (float *)malloc(fw * fh * sizeof(float));
+    fossil_image_complex_t *kspec = (fossil_image_complex_t *)malloc(bins * fh * sizeof(fossil_image_complex_t));
+    fossil_image_complex_t *pspec = (fossil_image_complex_t *)malloc(bins * fh * sizeof(fossil_image_complex_t));
+    bool ok = plane && kspec && pspec;
+
+    if (ok) {
+        memset(plane, 0, fw * fh * sizeof(float));
+        for (uint32_t j = 0; j < kh; ++j)
+            memcpy(plane + (size_t)j * fw, kernel + (size_t)j * kw, kw * sizeof(float));
+        ok = fossil_image_fft_2d_real(plane, (uint32_t)fw, (uint32_t)fh, kspec);
+    }
+    for (uint32_t ch = 0; ok && ch < image->channels; ++ch) {
+        memset(plane, 0, fw * fh * sizeof(float));
+        conv_load_plane(image, ch, plane, w + kw - 1, h + kh - 1, fw, ax, ay);
+        ok = fossil_image_fft_2d_real(plane, (uint32_t)fw, (uint32_t)fh, pspec);
+        if (!ok)
+            break;
+        // Correlation: P * conj(K)
+        for (size_t i = 0; i < bins * fh; ++i) {
+            fossil_image_complex_t p = pspec[i], k = kspec[i];
+            pspec[i].re = p.re * k.re + p.im * k.im;
+            pspec[i].im = p.im * k.re - p.re * k.im;
+        }
+        ok = fossil_image_fft_2d_real_inverse(pspec, (uint32_t)fw, (uint32_t)fh, plane);
+        if (ok)
+            conv_store_channel(image, ch, plane, fw);
+    }
+
+    free(plane);
+    free(kspec);
+    free(pspec);
+    return ok;
+}
+
+static bool conv_direct_channels(fossil_image_t *image, const float *kernel, uint32_t kw, uint32_t kh,
+                                 uint32_t ax, uint32_t ay) {
+    const uint32_t w = image->width;
+    const uint32_t h = image->height;
+    uint32_t pw = w + kw - 1;
+    uint32_t ph = h + kh - 1;
+    float *plane = (float *)malloc((size_t)pw * ph * sizeof(float));
+    float *out = (float *)malloc((size_t)w * h * sizeof(float));
+    if (!plane || !out) {
+        free(plane);
+        free(out);
+        return false;
+    }
+
+    conv_ctx_t k = { 0 };
+    k.plane = plane;
+    k.out = out;
+    k.kernel = kernel;
+    k.plane_width = pw;
+    k.width = w;
+    k.kernel_width = kw;
+    k.kernel_height = kh;
+    uint32_t min_rows = (uint32_t)(65536 / ((size_t)w * kw * kh + 1)) + 1;
+    for (uint32_t ch = 0; ch < image->channels; ++ch) {
+        conv_load_plane(image, ch, plane, pw, ph, pw, ax, ay);
+        fossil_image_parallel_for(h, min_rows, conv_direct_band, &k);
+        conv_store_channel(image, ch, out, w);
+    }
+    free(plane);
+    free(out);
+    return true;
+}
+
+/* Correlate with taps anchored at (ax, ay). */
+static bool conv_run(
+    fossil_image_t *image,
+    const float *kernel,
+    uint32_t kw,
+    uint32_t kh,
+    uint32_t ax,
+    uint32_t ay,
+    fossil_conv_method_t method
+) {
+    size_t fw = conv_fft_width((size_t)image->width + kw - 1);
+    size_t fh = fossil_image_fft_good_size((size_t)image->height + kh - 1);
+    bool fft_possible = fw != 0 && fh != 0 && fw <= UINT32_MAX && fh <= UINT32_MAX;
+
+    if (method == FOSSIL_CONV_AUTO)
+        method = fft_possible && conv_prefer_fft(image->width, image->height, kw, kh, fw, fh)
+            ? FOSSIL_CONV_FFT : FOSSIL_CONV_DIRECT;
+    if (method == FOSSIL_CONV_FFT) {
+        if (!fft_possible)
+            return false;
+        return conv_fft_channels(image, kernel, kw, kh, ax, ay, fw, fh);
+    }
+    return conv_direct_channels(image, kernel, kw, kh, ax, ay);
+}
+
+static bool conv_validate(
+    const fossil_image_t *image,
+    const float *kernel,
+    uint32_t kw,
+    uint32_t kh,
+    fossil_conv_method_t method
+) {
+    if (!image || !image->data || !kernel || image->channels == 0)
+        return false;
+    if (image->width == 0 || image->height == 0 || kw == 0 || kh == 0)
+        return false;
+    if ((uint64_t)image->width + kw > UINT32_MAX || (uint64_t)image->height + kh > UINT32_MAX)
+        return false;
+    if (method < FOSSIL_CONV_AUTO || method > FOSSIL_CONV_FFT)
+        return false;
+    switch (image->format) {
+    case FOSSIL_PIXEL_FORMAT_GRAY8:
+    case FOSSIL_PIXEL_FORMAT_RGB24:
+    case FOSSIL_PIXEL_FORMAT_RGBA32:
+    case FOSSIL_PIXEL_FORMAT_GRAY16:
+    case FOSSIL_PIXEL_FORMAT_RGB48:
+    case FOSSIL_PIXEL_FORMAT_RGBA64:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+    case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool fossil_image_filter_correlate(
+    fossil_image_t *image,
+    const float *kernel,
+    uint32_t kernel_width,
+    uint32_t kernel_height,
+    fossil_conv_method_t method
+) {
+    if (!conv_validate(image, kernel, kernel_width, kernel_height, method))
+        return false;
+    return conv_run(image, kernel, kernel_width, kernel_height,
+                    kernel_width / 2, kernel_height / 2, method);
+}
+
+bool fossil_image_filter_convolve(
+    fossil_image_t *image,
+    const float *kernel,
+    uint32_t kernel_width,
+    uint32_t kernel_height,
+    fossil_conv_method_t method
+) {
+    if (!conv_validate(image, kernel, kernel_width, kernel_height, method))
+        return false;
+
+    // Convolution is correlation with the kernel rotated by 180 degrees
+    size_t taps = (size_t)kernel_width * kernel_height;
+    float *flipped = (float *)malloc(taps * sizeof(float));
+    if (!flipped)
+        return false;
+    for (size_t i = 0; i < taps; ++i)
+        flipped[i] = kernel[taps - 1 - i];
+
+    bool ok = conv_run(image, flipped, kernel_width, kernel_height,
+                       kernel_width / 2, kernel_height / 2, method);
+    free(flipped);
+    return ok;
+}
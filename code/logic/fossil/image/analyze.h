@@ -36,6 +36,69 @@ extern "C"
 // Fossil Image — Analyze Sub-Library
 // ======================================================
 
+/**
+ * @brief One template-match location reported by fossil_image_analyze_match_template.
+ */
+typedef struct fossil_image_match_s {
+    uint32_t x;                        ///< Left edge of the matching window
+    uint32_t y;                        ///< Top edge of the matching window
+    float score;                       ///< Normalized cross-correlation in [-1, 1]
+} fossil_image_match_t;
+
+/**
+ * @brief 3x3 derivative kernels for fossil_image_analyze_gradient.
+ */
+typedef enum fossil_gradient_op_e {
+    FOSSIL_GRADIENT_SOBEL = 0,         ///< [1 2 1] smoothing, |G| up to 1020 per axis
+    FOSSIL_GRADIENT_SCHARR             ///< [3 10 3] smoothing, better rotational symmetry, up to 4080
+} fossil_gradient_op_t;
+
+/**
+ * @brief Magnitude norm for fossil_image_analyze_gradient.
+ */
+typedef enum fossil_gradient_norm_e {
+    FOSSIL_GRADIENT_L1 = 0,            ///< |Gx| + |Gy|
+    FOSSIL_GRADIENT_L2                 ///< sqrt(Gx^2 + Gy^2), rounded
+} fossil_gradient_norm_t;
+
+/**
+ * @brief Pixel adjacency for fossil_image_analyze_components.
+ */
+typedef enum fossil_connectivity_e {
+    FOSSIL_CONNECTIVITY_4 = 4,         ///< Edge neighbours only
+    FOSSIL_CONNECTIVITY_8 = 8          ///< Edge and corner neighbours
+} fossil_connectivity_t;
+
+/**
+ * @brief Statistics of one connected component.
+ */
+typedef struct fossil_image_component_s {
+    uint32_t area;                     ///< Number of pixels
+    uint32_t left;                     ///< Inclusive bounding box
+    uint32_t top;
+    uint32_t right;
+    uint32_t bottom;
+    double centroid_x;                 ///< Mean pixel position
+    double centroid_y;
+} fossil_image_component_t;
+
+/**
+ * @brief Perceptual hash variants for fossil_image_analyze_hash.
+ */
+typedef enum fossil_hash_type_e {
+    FOSSIL_HASH_AVERAGE = 0,           ///< 8x8 luma means above the overall mean
+    FOSSIL_HASH_DIFFERENCE,            ///< 9x8 luma means, each brighter than its left neighbour
+    FOSSIL_HASH_PERCEPTUAL             ///< 8x8 low-frequency DCT of 32x32 luma, above the median
+} fossil_hash_type_t;
+
+/**
+ * @brief Window used for the local statistics of fossil_image_analyze_ssim.
+ */
+typedef enum fossil_ssim_window_e {
+    FOSSIL_SSIM_GAUSSIAN = 0,          ///< 11x11 Gaussian, sigma 1.5
+    FOSSIL_SSIM_BOX                    ///< 8x8 uniform
+} fossil_ssim_window_t;
+
 /**
  * @brief Computes the histogram of pixel values for each channel in the image.
  *
@@ -110,8 +173,8 @@ bool fossil_image_analyze_contrast(
  *
  * This function applies the Sobel edge detection algorithm to the input image,
  * producing a new grayscale image that highlights the magnitude of edges. The
- * result is written to the destination image, which must be preallocated and
- * compatible in size with the source image.
+ * result is written to the destination image as GRAY8 of the source size, with
+ * a zero border; a buffer the destination already owns is reused or released.
  *
  * @param src Pointer to the input fossil_image_t structure to analyze.
  * @param dst Pointer to the output fossil_image_t structure to receive the edge map.
@@ -138,6 +201,282 @@ bool fossil_image_analyze_entropy(
     double *out_entropy
 );
 
+/**
+ * @brief Computes horizontal and vertical luma derivatives of an image.
+ *
+ * The source is reduced to 8-bit luma (0-255) and differentiated with a 3x3
+ * Sobel or Scharr kernel, replicating edge pixels at the border. Gx grows to
+ * the right and Gy downwards. Every output is optional, but at least one must
+ * be requested.
+ *
+ * @param src Pointer to the source image (any 8-bit, 16-bit or float format).
+ * @param op Derivative kernel.
+ * @param norm Norm used for the magnitude output.
+ * @param gx Optional width * height array receiving the horizontal derivative.
+ * @param gy Optional width * height array receiving the vertical derivative.
+ * @param magnitude Optional output, reshaped to a GRAY16 gradient magnitude map.
+ * @param orientation Optional output, reshaped to a FLOAT32 map of atan2(Gy, Gx)
+ *        in radians.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_gradient(
+    const fossil_image_t *src,
+    fossil_gradient_op_t op,
+    fossil_gradient_norm_t norm,
+    int16_t *gx,
+    int16_t *gy,
+    fossil_image_t *magnitude,
+    fossil_image_t *orientation
+);
+
+/**
+ * @brief Detects edges with the Canny algorithm.
+ *
+ * Computes the Sobel gradient of the luma (see fossil_image_analyze_gradient),
+ * thins it to one-pixel ridges by non-maximum suppression, and keeps ridges
+ * above high_threshold together with any ridge above low_threshold connected
+ * to them. Thresholds are L2 gradient magnitudes on the 0-255 luma scale. When
+ * high_threshold is 0 or less both are derived from the gradient histogram:
+ * high is the 70th percentile of non-zero magnitudes and low is 0.4 of it.
+ * Pre-smooth noisy input (e.g. with fossil_image_filter_blur) for best results.
+ *
+ * @param src Pointer to the source image (any 8-bit, 16-bit or float format).
+ * @param dst Output, reshaped to a GRAY8 map with edges at 255 and 0 elsewhere.
+ * @param low_threshold Magnitude needed to extend an edge.
+ * @param high_threshold Magnitude needed to start an edge, or <= 0 for automatic.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_canny(
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    float low_threshold,
+    float high_threshold
+);
+
+/**
+ * @brief Labels the connected foreground regions of a binary mask.
+ *
+ * Every non-zero pixel of a GRAY8 mask (such as the output of
+ * fossil_image_process_threshold) is foreground. Components are numbered from
+ * 1 in the raster order of their first pixel; background is 0. Row bands are
+ * labeled in parallel and merged along their seams.
+ *
+ * @param src Pointer to the GRAY8 mask.
+ * @param connectivity 4- or 8-connectivity.
+ * @param labels Optional width * height array receiving each pixel's label.
+ * @param components Optional array receiving statistics of components 1..max_components.
+ * @param max_components Capacity of components (0 when components is NULL).
+ * @param out_count Receives the total number of components.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_components(
+    const fossil_image_t *src,
+    fossil_connectivity_t connectivity,
+    uint32_t *labels,
+    fossil_image_component_t *components,
+    uint32_t max_components,
+    uint32_t *out_count
+);
+
+/**
+ * @brief Computes the exact Euclidean distance from each pixel to the background.
+ *
+ * Every non-zero pixel of the GRAY8 mask receives its distance, in pixels, to
+ * the nearest zero pixel; zero pixels receive 0. Runs in linear time with two
+ * separable passes (Felzenszwalb-Huttenlocher), parallel over columns and
+ * then rows. A mask without any zero pixel yields infinity (FLOAT32) or 65535
+ * (GRAY16) everywhere.
+ *
+ * @param mask Pointer to the GRAY8 mask.
+ * @param dst Output, reshaped to the mask size in the requested format.
+ * @param format FOSSIL_PIXEL_FORMAT_FLOAT32 for exact distances or
+ *        FOSSIL_PIXEL_FORMAT_GRAY16 for rounded ones saturating at 65535.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_distance_transform(
+    const fossil_image_t *mask,
+    fossil_image_t *dst,
+    fossil_pixel_format_t format
+);
+
+/**
+ * @brief Computes a 64-bit perceptual hash of an image.
+ *
+ * The image is reduced to a small grid of luma area averages (any supported
+ * pixel format; color is converted with the BT.601 grayscale weights) and
+ * one bit per cell, row-major from the least significant bit, is derived
+ * from it. Similar images give hashes with a small Hamming distance.
+ *
+ * @param image Pointer to the input image.
+ * @param type Hash variant.
+ * @param out_hash Receives the hash.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_hash(
+    const fossil_image_t *image,
+    fossil_hash_type_t type,
+    uint64_t *out_hash
+);
+
+/**
+ * @brief Hashes a batch of images in parallel.
+ *
+ * Images are distributed across the worker threads. Each result equals
+ * fossil_image_analyze_hash for that image; images that cannot be hashed
+ * receive 0.
+ *
+ * @param images Array of count image pointers.
+ * @param count Number of images.
+ * @param type Hash variant.
+ * @param out_hashes Output array of count hashes.
+ * @return true if every image was hashed, false otherwise.
+ */
+bool fossil_image_analyze_hash_batch(
+    const fossil_image_t *const *images,
+    uint32_t count,
+    fossil_hash_type_t type,
+    uint64_t *out_hashes
+);
+
+/**
+ * @brief Returns the Hamming distance between two hashes.
+ *
+ * @param a First hash.
+ * @param b Second hash.
+ * @return Number of differing bits, 0 to 64.
+ */
+uint32_t fossil_image_analyze_hash_distance(uint64_t a, uint64_t b);
+
+/**
+ * @brief Finds the hashes within a Hamming distance of a query.
+ *
+ * Scans the array in blocks with a branch-free popcount the compiler can
+ * vectorize.
+ *
+ * @param hashes Array of count hashes to search.
+ * @param count Number of hashes.
+ * @param query Hash to compare against.
+ * @param max_distance Largest accepted Hamming distance.
+ * @param out_indices Optional output for the first max_results matching
+ *        indices in ascending order.
+ * @param max_results Capacity of out_indices.
+ * @return Total number of matching hashes, which may exceed max_results.
+ */
+size_t fossil_image_analyze_hash_search(
+    const uint64_t *hashes,
+    size_t count,
+    uint64_t query,
+    uint32_t max_distance,
+    size_t *out_indices,
+    size_t max_results
+);
+
+/**
+ * @brief Computes the mean squared error between two images.
+ *
+ * Both images must have the same size and pixel format. Every channel
+ * sample counts, in the native units of the format (0-255, 0-65535 or the
+ * float value). Rows are processed in parallel with SIMD where available.
+ *
+ * @param a Pointer to the first image.
+ * @param b Pointer to the second image.
+ * @param out_mse Receives the mean squared error.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_mse(
+    const fossil_image_t *a,
+    const fossil_image_t *b,
+    double *out_mse
+);
+
+/**
+ * @brief Computes the peak signal-to-noise ratio between two images in dB.
+ *
+ * Uses the mean squared error of fossil_image_analyze_mse against a peak of
+ * 255 for 8-bit formats, 65535 for 16-bit formats and 1.0 for float formats.
+ * Identical images yield infinity.
+ *
+ * @param a Pointer to the first image.
+ * @param b Pointer to the second image.
+ * @param out_psnr Receives the PSNR in decibels.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_psnr(
+    const fossil_image_t *a,
+    const fossil_image_t *b,
+    double *out_psnr
+);
+
+/**
+ * @brief Computes the structural similarity index of two images.
+ *
+ * Compares the luma of both images (BT.601 weights, 0-255 scale) over every
+ * window position fully inside the image, with the standard constants
+ * K1 = 0.01 and K2 = 0.03. The formats may differ but the sizes must match.
+ *
+ * @param a Pointer to the first image.
+ * @param b Pointer to the second image.
+ * @param window Local statistics window.
+ * @param out_ssim Receives the mean SSIM, 1 for identical images.
+ * @param ssim_map Optional output; receives a FLOAT32 map of per-window SSIM
+ *        values of size (width - window + 1) x (height - window + 1).
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_ssim(
+    const fossil_image_t *a,
+    const fossil_image_t *b,
+    fossil_ssim_window_t window,
+    double *out_ssim,
+    fossil_image_t *ssim_map
+);
+
+/**
+ * @brief Computes the multi-scale structural similarity index of two images.
+ *
+ * Evaluates the Gaussian-window SSIM terms on up to five 2x2-averaged scales
+ * and combines them with the standard exponents. Scales too small for an
+ * 11x11 window are skipped and the remaining exponents renormalized.
+ *
+ * @param a Pointer to the first image.
+ * @param b Pointer to the second image.
+ * @param out_ms_ssim Receives the MS-SSIM, 1 for identical images.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_ms_ssim(
+    const fossil_image_t *a,
+    const fossil_image_t *b,
+    double *out_ms_ssim
+);
+
+/**
+ * @brief Locates a template in an image by normalized cross-correlation.
+ *
+ * Scores every placement of the template fully inside the image with the
+ * zero-mean normalized cross-correlation, which ignores brightness and
+ * contrast differences. Window means and variances come from summed-area
+ * tables; the correlation itself runs through the FFT when the template is
+ * large. Windows or templates without variation score 0.
+ *
+ * @param image Pointer to the GRAY8 or FLOAT32 image to search.
+ * @param templ Pointer to the GRAY8 or FLOAT32 template, no larger than the image.
+ * @param score_map Optional output; receives a FLOAT32 map of
+ *        (width - templ width + 1) x (height - templ height + 1) scores indexed by
+ *        window top-left corner. Any buffer it owns is reused or released.
+ * @param peaks Optional output array for the best local maxima of the score map,
+ *        sorted by descending score.
+ * @param max_peaks Capacity of peaks (0 when peaks is NULL).
+ * @param out_peak_count Receives the number of peaks written.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_analyze_match_template(
+    const fossil_image_t *image,
+    const fossil_image_t *templ,
+    fossil_image_t *score_map,
+    fossil_image_match_t *peaks,
+    uint32_t max_peaks,
+    uint32_t *out_peak_count
+);
+
 #ifdef __cplusplus
 }
 
@@ -229,8 +568,8 @@ namespace fossil {
              *
              * This method applies the Sobel edge detection algorithm to the input image,
              * producing a new grayscale image that highlights the magnitude of edges. The
-             * result is written to the destination image, which must be preallocated and
-             * compatible in size with the source image.
+             * result is written to the destination image as GRAY8 of the source size; a
+             * buffer the destination already owns is reused or released.
              *
              * @param src Pointer to the input fossil_image_t structure to analyze.
              * @param dst Pointer to the output fossil_image_t structure to receive the edge map.
@@ -241,6 +580,212 @@ namespace fossil {
             return fossil_image_analyze_edge_sobel(src, dst);
             }
 
+            /**
+             * @brief Computes horizontal and vertical luma derivatives of an image.
+             *
+             * This method differentiates the image luma with a Sobel or Scharr kernel
+             * and writes whichever of the derivative, magnitude and orientation outputs
+             * are requested. See fossil_image_analyze_gradient.
+             *
+             * @param src Pointer to the source image.
+             * @param op Derivative kernel.
+             * @param norm Norm used for the magnitude output.
+             * @param gx Optional width * height array for the horizontal derivative.
+             * @param gy Optional width * height array for the vertical derivative.
+             * @param magnitude Optional GRAY16 magnitude output.
+             * @param orientation Optional FLOAT32 orientation output in radians.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool gradient(const fossil_image_t *src, fossil_gradient_op_t op,
+                                 fossil_gradient_norm_t norm, int16_t *gx, int16_t *gy,
+                                 fossil_image_t *magnitude, fossil_image_t *orientation)
+            {
+            return fossil_image_analyze_gradient(src, op, norm, gx, gy, magnitude, orientation);
+            }
+
+            /**
+             * @brief Detects edges with the Canny algorithm.
+             *
+             * This method produces a GRAY8 edge map (255 on edges) using gradient
+             * non-maximum suppression and hysteresis. See fossil_image_analyze_canny.
+             *
+             * @param src Pointer to the source image.
+             * @param dst Output GRAY8 edge map.
+             * @param low_threshold Magnitude needed to extend an edge.
+             * @param high_threshold Magnitude needed to start an edge, or <= 0 for automatic.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool canny(const fossil_image_t *src, fossil_image_t *dst,
+                              float low_threshold, float high_threshold)
+            {
+            return fossil_image_analyze_canny(src, dst, low_threshold, high_threshold);
+            }
+
+            /**
+             * @brief Labels the connected foreground regions of a binary mask.
+             *
+             * This method numbers the components of a GRAY8 mask in raster order and
+             * reports their area, bounding box and centroid. See
+             * fossil_image_analyze_components.
+             *
+             * @param src Pointer to the GRAY8 mask.
+             * @param connectivity 4- or 8-connectivity.
+             * @param labels Optional width * height label array.
+             * @param components Optional statistics array.
+             * @param max_components Capacity of components.
+             * @param out_count Receives the total number of components.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool components(const fossil_image_t *src, fossil_connectivity_t connectivity,
+                                   uint32_t *labels, fossil_image_component_t *components,
+                                   uint32_t max_components, uint32_t *out_count)
+            {
+            return fossil_image_analyze_components(src, connectivity, labels, components, max_components, out_count);
+            }
+
+            /**
+             * @brief Computes the exact Euclidean distance from each pixel to the background.
+             *
+             * This method measures, for every non-zero mask pixel, the distance to the
+             * nearest zero pixel. See fossil_image_analyze_distance_transform.
+             *
+             * @param mask Pointer to the GRAY8 mask.
+             * @param dst Output distance image.
+             * @param format FOSSIL_PIXEL_FORMAT_FLOAT32 or FOSSIL_PIXEL_FORMAT_GRAY16.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool distanceTransform(const fossil_image_t *mask, fossil_image_t *dst,
+                                          fossil_pixel_format_t format)
+            {
+            return fossil_image_analyze_distance_transform(mask, dst, format);
+            }
+
+            /**
+             * @brief Computes a 64-bit perceptual hash of an image.
+             *
+             * See fossil_image_analyze_hash.
+             *
+             * @param image Pointer to the input image.
+             * @param type Hash variant.
+             * @param out_hash Receives the hash.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool hash(const fossil_image_t *image, fossil_hash_type_t type, uint64_t *out_hash)
+            {
+            return fossil_image_analyze_hash(image, type, out_hash);
+            }
+
+            /**
+             * @brief Hashes a batch of images in parallel.
+             *
+             * See fossil_image_analyze_hash_batch.
+             *
+             * @param images Array of count image pointers.
+             * @param count Number of images.
+             * @param type Hash variant.
+             * @param out_hashes Output array of count hashes.
+             * @return true if every image was hashed, false otherwise.
+             */
+            static bool hashBatch(const fossil_image_t *const *images, uint32_t count,
+                                  fossil_hash_type_t type, uint64_t *out_hashes)
+            {
+            return fossil_image_analyze_hash_batch(images, count, type, out_hashes);
+            }
+
+            /**
+             * @brief Returns the Hamming distance between two hashes.
+             *
+             * @param a First hash.
+             * @param b Second hash.
+             * @return Number of differing bits.
+             */
+            static uint32_t hashDistance(uint64_t a, uint64_t b)
+            {
+            return fossil_image_analyze_hash_distance(a, b);
+            }
+
+            /**
+             * @brief Finds the hashes within a Hamming distance of a query.
+             *
+             * See fossil_image_analyze_hash_search.
+             *
+             * @param hashes Array of count hashes.
+             * @param count Number of hashes.
+             * @param query Hash to compare against.
+             * @param max_distance Largest accepted distance.
+             * @param out_indices Optional output for matching indices.
+             * @param max_results Capacity of out_indices.
+             * @return Total number of matches.
+             */
+            static size_t hashSearch(const uint64_t *hashes, size_t count, uint64_t query,
+                                     uint32_t max_distance, size_t *out_indices, size_t max_results)
+            {
+            return fossil_image_analyze_hash_search(hashes, count, query, max_distance, out_indices, max_results);
+            }
+
+            /**
+             * @brief Computes the mean squared error between two images.
+             *
+             * See fossil_image_analyze_mse.
+             *
+             * @param a Pointer to the first image.
+             * @param b Pointer to the second image.
+             * @param out_mse Receives the mean squared error.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool mse(const fossil_image_t *a, const fossil_image_t *b, double *out_mse)
+            {
+            return fossil_image_analyze_mse(a, b, out_mse);
+            }
+
+            /**
+             * @brief Computes the peak signal-to-noise ratio between two images in dB.
+             *
+             * See fossil_image_analyze_psnr.
+             *
+             * @param a Pointer to the first image.
+             * @param b Pointer to the second image.
+             * @param out_psnr Receives the PSNR.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool psnr(const fossil_image_t *a, const fossil_image_t *b, double *out_psnr)
+            {
+            return fossil_image_analyze_psnr(a, b, out_psnr);
+            }
+
+            /**
+             * @brief Computes the structural similarity index of two images.
+             *
+             * See fossil_image_analyze_ssim.
+             *
+             * @param a Pointer to the first image.
+             * @param b Pointer to the second image.
+             * @param window Local statistics window.
+             * @param out_ssim Receives the mean SSIM.
+             * @param ssim_map Optional per-window SSIM map.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool ssim(const fossil_image_t *a, const fossil_image_t *b, fossil_ssim_window_t window,
+                             double *out_ssim, fossil_image_t *ssim_map)
+            {
+            return fossil_image_analyze_ssim(a, b, window, out_ssim, ssim_map);
+            }
+
+            /**
+             * @brief Computes the multi-scale structural similarity index of two images.
+             *
+             * See fossil_image_analyze_ms_ssim.
+             *
+             * @param a Pointer to the first image.
+             * @param b Pointer to the second image.
+             * @param out_ms_ssim Receives the MS-SSIM.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool msSsim(const fossil_image_t *a, const fossil_image_t *b, double *out_ms_ssim)
+            {
+            return fossil_image_analyze_ms_ssim(a, b, out_ms_ssim);
+            }
+
             /**
              * @brief Computes the color variance and entropy estimate for visual complexity analysis.
              *
@@ -256,6 +801,27 @@ namespace fossil {
             {
             return fossil_image_analyze_entropy(image, out_entropy);
             }
+
+            /**
+             * @brief Locates a template in an image by normalized cross-correlation.
+             *
+             * This method scores every placement of the template inside the image and
+             * reports the best local maxima. See fossil_image_analyze_match_template.
+             *
+             * @param image Pointer to the GRAY8 or FLOAT32 image to search.
+             * @param templ Pointer to the GRAY8 or FLOAT32 template.
+             * @param score_map Optional FLOAT32 score map output (may be nullptr).
+             * @param peaks Optional array receiving the best matches.
+             * @param max_peaks Capacity of peaks.
+             * @param out_peak_count Receives the number of peaks written.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool matchTemplate(const fossil_image_t *image, const fossil_image_t *templ,
+                                      fossil_image_t *score_map, fossil_image_match_t *peaks,
+                                      uint32_t max_peaks, uint32_t *out_peak_count)
+            {
+            return fossil_image_analyze_match_template(image, templ, score_map, peaks, max_peaks, out_peak_count);
+            }
         };
 
     } // namespace image
@@ -26,6 +26,7 @@
 #define FOSSIL_IMAGE_COLOR_H
 
 #include "process.h"
+#include "tile.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -52,6 +53,22 @@ bool fossil_image_color_brightness(
     int offset
 );
 
+/**
+ * @brief Adjust the brightness of a tiled image in place.
+ *
+ * Produces the same pixels as fossil_image_color_brightness on the
+ * row-major image. Tiles run in parallel on the parallel helper and the
+ * padding past the image edge is left untouched.
+ *
+ * @param tiled Tiled image to process.
+ * @param offset Integer value to add to each color channel (-255 to +255).
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_brightness_tiled(
+    fossil_image_tiled_t *tiled,
+    int offset
+);
+
 /**
  * @brief Adjust the contrast of an image by a specified factor.
  *
@@ -76,6 +93,10 @@ bool fossil_image_color_contrast(
  * which compensates for nonlinear display characteristics. The gamma value
  * must be greater than zero, with typical values ranging from 0.5 to 3.0.
  *
+ * 16-bit formats (GRAY16, RGB48, RGBA64) are mapped through a rounded
+ * 65536-entry lookup table. Tables are cached per gamma value, so repeated
+ * calls with the same gamma only pay for the table build once.
+ *
  * @param image Pointer to the fossil_image_t structure representing the image to process.
  * @param gamma Gamma correction value (> 0, typically 0.5–3.0).
  * @return true if the operation succeeds, false otherwise.
@@ -85,6 +106,15 @@ bool fossil_image_color_gamma(
     float gamma
 );
 
+/**
+ * @brief Release the cached 16-bit gamma lookup tables.
+ *
+ * Frees every cached table that is not currently in use by another thread.
+ * Calling this is optional; it is mainly useful for leak checkers and for
+ * returning memory after a batch of HDR processing.
+ */
+void fossil_image_color_gamma_cache_clear(void);
+
 /**
  * @brief Adjust hue, saturation, and value (brightness) of an image.
  *
@@ -93,6 +123,10 @@ bool fossil_image_color_gamma(
  * parameters multiply the saturation and value, respectively, allowing for
  * increased or decreased color intensity and brightness.
  *
+ * All parameter combinations share one branch-free HSV kernel, so pure hue
+ * shifts agree with nearby saturation or value changes. Grays are left
+ * untouched and primaries rotate exactly at multiples of 120 degrees.
+ *
  * @param image Pointer to the fossil_image_t structure representing the image to process.
  * @param hue_shift Hue rotation in degrees (-180 to 180).
  * @param sat_mult Saturation multiplier (e.g., 1.0 = unchanged).
@@ -139,6 +173,199 @@ bool fossil_image_color_to_grayscale(
     fossil_image_t *image
 );
 
+// ======================================================
+// Fossil Image — sRGB / Linear Light
+// ======================================================
+
+/**
+ * @brief Decode a row of 8-bit sRGB samples to linear-light floats.
+ *
+ * Uses the exact piecewise sRGB transfer function through a 256-entry lookup
+ * table. When channels is 4 the fourth sample of each pixel is treated as
+ * alpha and only rescaled to [0, 1].
+ *
+ * @param src Source samples (pixels * channels).
+ * @param dst Destination floats (pixels * channels).
+ * @param pixels Number of pixels in the row.
+ * @param channels Samples per pixel (1, 3, or 4).
+ */
+void fossil_image_color_srgb8_to_linear_row(
+    const uint8_t *src,
+    float *dst,
+    size_t pixels,
+    size_t channels
+);
+
+/**
+ * @brief Decode a row of 16-bit sRGB samples to linear-light floats.
+ *
+ * Same as the 8-bit variant, backed by a 65536-entry lookup table.
+ */
+void fossil_image_color_srgb16_to_linear_row(
+    const uint16_t *src,
+    float *dst,
+    size_t pixels,
+    size_t channels
+);
+
+/**
+ * @brief Encode a row of linear-light floats to 8-bit sRGB.
+ *
+ * Input is clamped to [0, 1] and rounded to nearest. The transfer curve is
+ * evaluated four samples at a time where SIMD is available.
+ */
+void fossil_image_color_linear_to_srgb8_row(
+    const float *src,
+    uint8_t *dst,
+    size_t pixels,
+    size_t channels
+);
+
+/**
+ * @brief Encode a row of linear-light floats to 16-bit sRGB.
+ */
+void fossil_image_color_linear_to_srgb16_row(
+    const float *src,
+    uint16_t *dst,
+    size_t pixels,
+    size_t channels
+);
+
+/**
+ * @brief Check whether a pixel format can be streamed through linear light.
+ *
+ * GRAY, RGB and RGBA formats at 8, 16 and 32-bit float depth are supported.
+ * Float formats are assumed to already hold linear values.
+ */
+bool fossil_image_color_linear_rows_supported(
+    fossil_pixel_format_t format
+);
+
+/**
+ * @brief Decode one row of pixels in the given format to linear-light floats.
+ *
+ * @param format Pixel format of src.
+ * @param src Packed source pixels.
+ * @param dst Destination floats (pixels * channels of the format).
+ * @param pixels Number of pixels to convert.
+ * @return true on success, false if the format is not supported.
+ */
+bool fossil_image_color_decode_linear_row(
+    fossil_pixel_format_t format,
+    const void *src,
+    float *dst,
+    size_t pixels
+);
+
+/**
+ * @brief Encode one row of linear-light floats into the given pixel format.
+ *
+ * @param format Pixel format of dst.
+ * @param src Linear-light floats (pixels * channels of the format).
+ * @param dst Packed destination pixels.
+ * @param pixels Number of pixels to convert.
+ * @return true on success, false if the format is not supported.
+ */
+bool fossil_image_color_encode_linear_row(
+    fossil_pixel_format_t format,
+    const float *src,
+    void *dst,
+    size_t pixels
+);
+
+/**
+ * @brief Convert an 8 or 16-bit sRGB image to linear-light float32 in place.
+ *
+ * GRAY becomes FLOAT32, RGB becomes FLOAT32_RGB and RGBA becomes FLOAT32_RGBA.
+ *
+ * @param image Pointer to the fossil_image_t structure to convert.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_srgb_to_linear(
+    fossil_image_t *image
+);
+
+/**
+ * @brief Convert a linear-light float32 image to sRGB in place.
+ *
+ * @param image Pointer to a FLOAT32, FLOAT32_RGB or FLOAT32_RGBA image.
+ * @param format Target 8 or 16-bit format with the same channel count.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_linear_to_srgb(
+    fossil_image_t *image,
+    fossil_pixel_format_t format
+);
+
+// ======================================================
+// Fossil Image — Palette Quantization
+// ======================================================
+
+/// Dithering applied when mapping pixels onto a palette
+typedef enum fossil_dither_e {
+    FOSSIL_DITHER_NONE = 0,             ///< Nearest palette colour
+    FOSSIL_DITHER_FLOYD_STEINBERG,      ///< Error diffusion, streamed row by row
+    FOSSIL_DITHER_ORDERED               ///< 8x8 Bayer threshold matrix
+} fossil_dither_t;
+
+/**
+ * @brief Build a palette for an image using median cut.
+ *
+ * Colours are histogrammed on a 5-bit-per-channel grid and the occupied colour
+ * space is split repeatedly at the population median of its longest axis.
+ * Each palette entry is the mean colour of its box. Fewer than max_colors
+ * entries are produced when the image has fewer distinct colours.
+ *
+ * @param image GRAY8, RGB24 or RGBA32 source image (alpha is ignored).
+ * @param max_colors Maximum number of palette entries (1-256).
+ * @param palette Output RGB triplets; room for max_colors * 3 bytes.
+ * @param out_count Receives the number of entries written.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_palette_median_cut(
+    const fossil_image_t *image,
+    uint32_t max_colors,
+    uint8_t *palette,
+    uint32_t *out_count
+);
+
+/**
+ * @brief Convert an image to INDEXED8 against a given palette.
+ *
+ * Nearest colours come from an inverse colour map that is filled lazily and
+ * kept between calls, so mapping many frames onto one palette only searches
+ * each colour cell once. The palette is copied into image->palette.
+ *
+ * @param image GRAY8, RGB24 or RGBA32 image, converted in place.
+ * @param palette RGB triplets (count * 3 bytes).
+ * @param count Number of palette entries (1-256).
+ * @param dither Dithering mode.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_map_palette(
+    fossil_image_t *image,
+    const uint8_t *palette,
+    uint32_t count,
+    fossil_dither_t dither
+);
+
+/**
+ * @brief Quantize an image to an INDEXED8 image with its own palette.
+ *
+ * Runs fossil_image_color_palette_median_cut followed by
+ * fossil_image_color_map_palette.
+ *
+ * @param image GRAY8, RGB24 or RGBA32 image, converted in place.
+ * @param max_colors Maximum number of palette entries (1-256).
+ * @param dither Dithering mode.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_color_quantize(
+    fossil_image_t *image,
+    uint32_t max_colors,
+    fossil_dither_t dither
+);
+
 #ifdef __cplusplus
 }
 
@@ -174,6 +401,23 @@ namespace fossil {
             return fossil_image_color_brightness(image, offset);
             }
 
+            /**
+             * @brief Adjusts the brightness of a tiled image in place.
+             *
+             * Same pixels as brightness on the row-major image, processed
+             * tile by tile in parallel.
+             *
+             * @param tiled Tiled image to process.
+             * @param offset Integer value to add to each color channel (-255 to +255).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool brightness_tiled(
+            fossil_image_tiled_t *tiled,
+            int offset
+            ) {
+            return fossil_image_color_brightness_tiled(tiled, offset);
+            }
+
             /**
              * @brief Adjusts the contrast of the image by a specified factor.
              *
@@ -211,6 +455,94 @@ namespace fossil {
             return fossil_image_color_gamma(image, gamma);
             }
 
+            /**
+             * @brief Releases the cached 16-bit gamma lookup tables.
+             *
+             * Frees every cached table that is not currently in use. This is
+             * optional and mainly useful for leak checkers.
+             */
+            static void gamma_cache_clear() {
+            fossil_image_color_gamma_cache_clear();
+            }
+
+            /**
+             * @brief Converts an 8 or 16-bit sRGB image to linear-light float32 in place.
+             *
+             * @param image Pointer to the fossil_image_t structure to convert.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool srgb_to_linear(
+            fossil_image_t *image
+            ) {
+            return fossil_image_color_srgb_to_linear(image);
+            }
+
+            /**
+             * @brief Converts a linear-light float32 image to sRGB in place.
+             *
+             * @param image Pointer to a FLOAT32, FLOAT32_RGB or FLOAT32_RGBA image.
+             * @param format Target 8 or 16-bit format with the same channel count.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool linear_to_srgb(
+            fossil_image_t *image,
+            fossil_pixel_format_t format
+            ) {
+            return fossil_image_color_linear_to_srgb(image, format);
+            }
+
+            /**
+             * @brief Builds a palette for an image using median cut.
+             *
+             * @param image GRAY8, RGB24 or RGBA32 source image (alpha is ignored).
+             * @param max_colors Maximum number of palette entries (1-256).
+             * @param palette Output RGB triplets; room for max_colors * 3 bytes.
+             * @param out_count Receives the number of entries written.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool palette_median_cut(
+            const fossil_image_t *image,
+            uint32_t max_colors,
+            uint8_t *palette,
+            uint32_t *out_count
+            ) {
+            return fossil_image_color_palette_median_cut(image, max_colors, palette, out_count);
+            }
+
+            /**
+             * @brief Converts an image to INDEXED8 against a given palette.
+             *
+             * @param image GRAY8, RGB24 or RGBA32 image, converted in place.
+             * @param palette RGB triplets (count * 3 bytes).
+             * @param count Number of palette entries (1-256).
+             * @param dither Dithering mode.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool map_palette(
+            fossil_image_t *image,
+            const uint8_t *palette,
+            uint32_t count,
+            fossil_dither_t dither
+            ) {
+            return fossil_image_color_map_palette(image, palette, count, dither);
+            }
+
+            /**
+             * @brief Quantizes an image to INDEXED8 with its own median-cut palette.
+             *
+             * @param image GRAY8, RGB24 or RGBA32 image, converted in place.
+             * @param max_colors Maximum number of palette entries (1-256).
+             * @param dither Dithering mode.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool quantize(
+            fossil_image_t *image,
+            uint32_t max_colors,
+            fossil_dither_t dither
+            ) {
+            return fossil_image_color_quantize(image, max_colors, dither);
+            }
+
             /**
              * @brief Adjusts hue, saturation, and value (brightness) of the image.
              *
@@ -0,0 +1,276 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_CONTAINER_H
+#define FOSSIL_IMAGE_CONTAINER_H
+
+#include "process.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — Container Sub-Library
+// ======================================================
+
+/**
+ * @brief Per-tile compression used by the container format.
+ */
+typedef enum fossil_image_codec_t {
+    FOSSIL_IMAGE_CODEC_STORED = 0,     ///< Tiles kept uncompressed
+    FOSSIL_IMAGE_CODEC_LZ              ///< Per-row byte delta followed by LZ77 (LZ4 block layout)
+} fossil_image_codec_t;
+
+/**
+ * @brief Opaque reader for a tiled container file.
+ *
+ * A container file ("fic") holds a fixed little-endian header, a metadata
+ * block with every serialisable fossil_image_t field (palette included), a
+ * tile index and the tiles themselves. Each tile is compressed on its own
+ * and the index stores its offset and checksum, so any tile is found with
+ * one seek, any region decodes only the tiles it touches and damaged tiles
+ * are reported instead of decoded. Tiles that do not shrink under
+ * compression are stored as is. 16-bit and float samples are stored
+ * little-endian, so files are portable between hosts.
+ */
+typedef struct fossil_image_container_s fossil_image_container_t;
+
+/**
+ * @brief Geometry and size of a container file.
+ */
+typedef struct fossil_image_container_info_t {
+    uint32_t width;                    ///< Image width in pixels
+    uint32_t height;                   ///< Image height in pixels
+    uint32_t channels;                 ///< Number of channels
+    fossil_pixel_format_t format;      ///< Pixel format
+    uint32_t tile_size;                ///< Tile edge in pixels
+    uint32_t tiles_x;                  ///< Tiles per row
+    uint32_t tiles_y;                  ///< Tile rows
+    uint64_t stored_bytes;             ///< Bytes of tile payload in the file
+} fossil_image_container_info_t;
+
+/**
+ * @brief Write an image to a container file.
+ *
+ * Tiles are compressed in batches on the parallel helper and written in
+ * row-major tile order. The userdata pointer is not stored.
+ *
+ * @param path Destination file.
+ * @param image Image to store.
+ * @param tile_size Tile edge as for fossil_image_tile_create (0 for the default).
+ * @param codec Compression applied to each tile.
+ * @return true if successful, false on invalid arguments or I/O errors.
+ */
+bool fossil_image_container_save(
+    const char *path,
+    const fossil_image_t *image,
+    uint32_t tile_size,
+    fossil_image_codec_t codec
+);
+
+/**
+ * @brief Open a container file for random access.
+ *
+ * Only the header and metadata are read; tiles are read on demand.
+ *
+ * @param path Container file.
+ * @return The reader, or NULL if the file is missing or malformed.
+ */
+fossil_image_container_t *fossil_image_container_open(
+    const char *path
+);
+
+/**
+ * @brief Close a container reader. Safe to call with NULL.
+ *
+ * @param container Reader to close.
+ */
+void fossil_image_container_close(
+    fossil_image_container_t *container
+);
+
+/**
+ * @brief Query geometry and stored size.
+ *
+ * @param container Reader.
+ * @param info Receives the information.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_container_info(
+    const fossil_image_container_t *container,
+    fossil_image_container_info_t *info
+);
+
+/**
+ * @brief Decode a rectangle into row-major memory.
+ *
+ * Only the tiles overlapping the rectangle are read; they are decoded in
+ * parallel.
+ *
+ * @param container Reader.
+ * @param x Left edge.
+ * @param y Top edge.
+ * @param width Rectangle width; must fit inside the image.
+ * @param height Rectangle height; must fit inside the image.
+ * @param dst Destination pixels.
+ * @param dst_stride Bytes between destination rows.
+ * @return true if successful, false on invalid arguments, I/O errors or
+ *         corrupt tiles.
+ */
+bool fossil_image_container_read_region(
+    fossil_image_container_t *container,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+);
+
+/**
+ * @brief Decode the whole image together with its metadata.
+ *
+ * out_image receives newly allocated pixels (and palette) owned by it, as
+ * with fossil_image_io_load.
+ *
+ * @param container Reader.
+ * @param out_image Image to fill.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_container_read_image(
+    fossil_image_container_t *container,
+    fossil_image_t *out_image
+);
+
+/**
+ * @brief Open, decode and close a container file in one call.
+ *
+ * @param path Container file.
+ * @param out_image Image to fill.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_container_load(
+    const char *path,
+    fossil_image_t *out_image
+);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Container class providing static methods for tiled image files.
+         *
+         * This class serves as a C++ wrapper around the C container functions.
+         */
+        class Container {
+        public:
+            /**
+             * @brief Write an image to a container file.
+             */
+            static bool save(
+            const char *path,
+            const fossil_image_t *image,
+            uint32_t tile_size,
+            fossil_image_codec_t codec
+            ) {
+            return fossil_image_container_save(path, image, tile_size, codec);
+            }
+
+            /**
+             * @brief Open a container file for random access.
+             */
+            static fossil_image_container_t *open(
+            const char *path
+            ) {
+            return fossil_image_container_open(path);
+            }
+
+            /**
+             * @brief Close a container reader.
+             */
+            static void close(
+            fossil_image_container_t *container
+            ) {
+            fossil_image_container_close(container);
+            }
+
+            /**
+             * @brief Query geometry and stored size.
+             */
+            static bool info(
+            const fossil_image_container_t *container,
+            fossil_image_container_info_t *info
+            ) {
+            return fossil_image_container_info(container, info);
+            }
+
+            /**
+             * @brief Decode a rectangle into row-major memory.
+             */
+            static bool read_region(
+            fossil_image_container_t *container,
+            uint32_t x,
+            uint32_t y,
+            uint32_t width,
+            uint32_t height,
+            uint8_t *dst,
+            size_t dst_stride
+            ) {
+            return fossil_image_container_read_region(container, x, y, width, height, dst, dst_stride);
+            }
+
+            /**
+             * @brief Decode the whole image together with its metadata.
+             */
+            static bool read_image(
+            fossil_image_container_t *container,
+            fossil_image_t *out_image
+            ) {
+            return fossil_image_container_read_image(container, out_image);
+            }
+
+            /**
+             * @brief Open, decode and close a container file in one call.
+             */
+            static bool load(
+            const char *path,
+            fossil_image_t *out_image
+            ) {
+            return fossil_image_container_load(path, out_image);
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_CONTAINER_H */
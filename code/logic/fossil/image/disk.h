@@ -0,0 +1,421 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_DISK_H
+#define FOSSIL_IMAGE_DISK_H
+
+#include "process.h"
+#include "pipeline.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — Disk Sub-Library
+// ======================================================
+
+/**
+ * @brief Default tile cache budget for disk-backed images (64 MiB).
+ */
+#define FOSSIL_IMAGE_DISK_CACHE_BYTES ((size_t)64 << 20)
+
+/**
+ * @brief Opaque image whose pixels live in a local file.
+ *
+ * The file holds the image as fixed-size tiles (the fossil_image_tiled_t
+ * layout). Tiles are paged into a cache bounded by a byte budget and evicted
+ * least recently used first; modified tiles are written back on eviction,
+ * flush and close. Only the cache is ever resident, so images far larger
+ * than memory can be read, written and filtered. A disk image must not be
+ * used from several threads at once; the streaming operations below run
+ * their per-block work on the parallel helper instead.
+ */
+typedef struct fossil_image_disk_s fossil_image_disk_t;
+
+/**
+ * @brief Geometry and cache statistics of a disk-backed image.
+ */
+typedef struct fossil_image_disk_info_t {
+    uint32_t width;                    ///< Image width in pixels
+    uint32_t height;                   ///< Image height in pixels
+    uint32_t channels;                 ///< Number of channels
+    fossil_pixel_format_t format;      ///< Pixel format
+    uint32_t tile_size;                ///< Tile edge in pixels
+    size_t cache_bytes;                ///< Bytes of tile cache
+    uint64_t hits;                     ///< Tile lookups served from the cache
+    uint64_t misses;                   ///< Tile lookups that read the file
+    uint64_t writebacks;               ///< Modified tiles written to the file
+} fossil_image_disk_info_t;
+
+/**
+ * @brief Callback for fossil_image_disk_process.
+ *
+ * @param ctx Caller context.
+ * @param block Pixels of the rectangle starting at (x, y); may be modified.
+ * @param x Left edge of the block in image pixels.
+ * @param y Top edge of the block in image pixels.
+ * @return true to continue, false to stop with an error.
+ */
+typedef bool (*fossil_image_disk_fn)(void *ctx, fossil_image_t *block, uint32_t x, uint32_t y);
+
+/**
+ * @brief Create a zero-filled disk-backed image, replacing any existing file.
+ *
+ * Tiles that are never written take no disk space on file systems with
+ * sparse file support.
+ *
+ * @param path Backing file.
+ * @param width Image width.
+ * @param height Image height.
+ * @param format Pixel format.
+ * @param tile_size Tile edge as for fossil_image_tile_create (0 for the default).
+ * @param cache_bytes Cache budget, or 0 for FOSSIL_IMAGE_DISK_CACHE_BYTES.
+ *                    At least a few tiles are always cached.
+ * @return The image, or NULL on failure.
+ */
+fossil_image_disk_t *fossil_image_disk_create(
+    const char *path,
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    size_t cache_bytes
+);
+
+/**
+ * @brief Open a file written by fossil_image_disk_create for reading and writing.
+ *
+ * @param path Backing file.
+ * @param cache_bytes Cache budget, or 0 for FOSSIL_IMAGE_DISK_CACHE_BYTES.
+ * @return The image, or NULL if the file is missing or not a disk image.
+ */
+fossil_image_disk_t *fossil_image_disk_open(
+    const char *path,
+    size_t cache_bytes
+);
+
+/**
+ * @brief Write every modified cached tile to the file.
+ *
+ * @param disk Disk image.
+ * @return true if successful, false on I/O errors.
+ */
+bool fossil_image_disk_flush(
+    fossil_image_disk_t *disk
+);
+
+/**
+ * @brief Flush and release a disk image. Safe to call with NULL.
+ *
+ * @param disk Disk image.
+ * @return true if the final flush succeeded.
+ */
+bool fossil_image_disk_close(
+    fossil_image_disk_t *disk
+);
+
+/**
+ * @brief Query geometry and cache statistics.
+ *
+ * @param disk Disk image.
+ * @param info Receives the information.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_info(
+    const fossil_image_disk_t *disk,
+    fossil_image_disk_info_t *info
+);
+
+/**
+ * @brief Copy a rectangle out of a disk image into row-major memory.
+ *
+ * As with fossil_image_tile_read_region, pixels outside the image repeat
+ * the nearest edge pixel.
+ *
+ * @param disk Disk image.
+ * @param x Left edge, may be negative.
+ * @param y Top edge, may be negative.
+ * @param width Rectangle width.
+ * @param height Rectangle height.
+ * @param dst Destination pixels.
+ * @param dst_stride Bytes between destination rows.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_read_region(
+    fossil_image_disk_t *disk,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+);
+
+/**
+ * @brief Copy row-major pixels into a rectangle of a disk image.
+ *
+ * @param disk Disk image.
+ * @param x Left edge.
+ * @param y Top edge.
+ * @param width Rectangle width; must fit inside the image.
+ * @param height Rectangle height; must fit inside the image.
+ * @param src Source pixels.
+ * @param src_stride Bytes between source rows.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_write_region(
+    fossil_image_disk_t *disk,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    const uint8_t *src,
+    size_t src_stride
+);
+
+/**
+ * @brief Stream a disk image block by block through a callback.
+ *
+ * The image is split into tile-aligned blocks. Each block is grown by halo
+ * pixels on every side (clipped at the image edges, so filters see the real
+ * border), read into memory and passed to fn. If dst is given, the part of
+ * the block inside the original rectangle is then written to dst, which must
+ * have the same size and format; dst may be src only when halo is 0.
+ *
+ * @param src Disk image to read.
+ * @param dst Disk image to write, or NULL for read-only passes.
+ * @param halo Context pixels around each block.
+ * @param fn Callback run once per block.
+ * @param ctx Passed to the callback.
+ * @return true if successful, false on invalid arguments, I/O errors or
+ *         when the callback fails.
+ */
+bool fossil_image_disk_process(
+    fossil_image_disk_t *src,
+    fossil_image_disk_t *dst,
+    uint32_t halo,
+    fossil_image_disk_fn fn,
+    void *ctx
+);
+
+/**
+ * @brief Run a pipeline over a disk image.
+ *
+ * The halo is taken from the pipeline's neighbourhood depth, so the result
+ * is identical to executing the pipeline on the whole image in memory.
+ *
+ * @param src Disk image to read.
+ * @param dst Disk image to write (may be src for point-only pipelines).
+ * @param pipeline Operations to apply (must not contain a resize; use
+ *                 fossil_image_disk_resize for that).
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_pipeline(
+    fossil_image_disk_t *src,
+    fossil_image_disk_t *dst,
+    const fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Resize one disk image into another.
+ *
+ * The output is produced in blocks with fossil_image_process_resize_plan_execute_rect,
+ * reading only the source window each block needs; blocks shrink for strong
+ * reductions so windows stay within the cache budget. Pixels match
+ * fossil_image_process_resize_into on the same data.
+ *
+ * @param src Disk image to read.
+ * @param dst Disk image to write; its size is the target size.
+ * @param mode Interpolation mode.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_resize(
+    fossil_image_disk_t *src,
+    fossil_image_disk_t *dst,
+    fossil_interp_t mode
+);
+
+/**
+ * @brief Per-channel histogram of a disk image, as fossil_image_analyze_histogram.
+ *
+ * @param disk Disk image.
+ * @param out_hist 256 * channels bins; 64-bit so gigapixel counts fit.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_disk_histogram(
+    fossil_image_disk_t *disk,
+    uint64_t *out_hist
+);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Disk class providing static methods for out-of-core images.
+         *
+         * This class serves as a C++ wrapper around the C disk image functions.
+         */
+        class Disk {
+        public:
+            /**
+             * @brief Create a zero-filled disk-backed image.
+             */
+            static fossil_image_disk_t *create(
+            const char *path,
+            uint32_t width,
+            uint32_t height,
+            fossil_pixel_format_t format,
+            uint32_t tile_size,
+            size_t cache_bytes
+            ) {
+            return fossil_image_disk_create(path, width, height, format, tile_size, cache_bytes);
+            }
+
+            /**
+             * @brief Open an existing disk image.
+             */
+            static fossil_image_disk_t *open(
+            const char *path,
+            size_t cache_bytes
+            ) {
+            return fossil_image_disk_open(path, cache_bytes);
+            }
+
+            /**
+             * @brief Write every modified cached tile to the file.
+             */
+            static bool flush(
+            fossil_image_disk_t *disk
+            ) {
+            return fossil_image_disk_flush(disk);
+            }
+
+            /**
+             * @brief Flush and release a disk image.
+             */
+            static bool close(
+            fossil_image_disk_t *disk
+            ) {
+            return fossil_image_disk_close(disk);
+            }
+
+            /**
+             * @brief Query geometry and cache statistics.
+             */
+            static bool info(
+            const fossil_image_disk_t *disk,
+            fossil_image_disk_info_t *info
+            ) {
+            return fossil_image_disk_info(disk, info);
+            }
+
+            /**
+             * @brief Copy a rectangle out of a disk image.
+             */
+            static bool read_region(
+            fossil_image_disk_t *disk,
+            int32_t x,
+            int32_t y,
+            uint32_t width,
+            uint32_t height,
+            uint8_t *dst,
+            size_t dst_stride
+            ) {
+            return fossil_image_disk_read_region(disk, x, y, width, height, dst, dst_stride);
+            }
+
+            /**
+             * @brief Copy pixels into a rectangle of a disk image.
+             */
+            static bool write_region(
+            fossil_image_disk_t *disk,
+            uint32_t x,
+            uint32_t y,
+            uint32_t width,
+            uint32_t height,
+            const uint8_t *src,
+            size_t src_stride
+            ) {
+            return fossil_image_disk_write_region(disk, x, y, width, height, src, src_stride);
+            }
+
+            /**
+             * @brief Stream a disk image block by block through a callback.
+             */
+            static bool process(
+            fossil_image_disk_t *src,
+            fossil_image_disk_t *dst,
+            uint32_t halo,
+            fossil_image_disk_fn fn,
+            void *ctx
+            ) {
+            return fossil_image_disk_process(src, dst, halo, fn, ctx);
+            }
+
+            /**
+             * @brief Run a pipeline over a disk image.
+             */
+            static bool pipeline(
+            fossil_image_disk_t *src,
+            fossil_image_disk_t *dst,
+            const fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_disk_pipeline(src, dst, pipeline);
+            }
+
+            /**
+             * @brief Resize one disk image into another.
+             */
+            static bool resize(
+            fossil_image_disk_t *src,
+            fossil_image_disk_t *dst,
+            fossil_interp_t mode
+            ) {
+            return fossil_image_disk_resize(src, dst, mode);
+            }
+
+            /**
+             * @brief Per-channel histogram of a disk image.
+             */
+            static bool histogram(
+            fossil_image_disk_t *disk,
+            uint64_t *out_hist
+            ) {
+            return fossil_image_disk_histogram(disk, out_hist);
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_DISK_H */
@@ -0,0 +1,195 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_FFT_H
+#define FOSSIL_IMAGE_FFT_H
+
+#include "process.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — FFT Sub-Library
+// ======================================================
+
+/**
+ * @brief Single-precision complex sample.
+ */
+typedef struct fossil_image_complex_t {
+    float re;   ///< Real part
+    float im;   ///< Imaginary part
+} fossil_image_complex_t;
+
+/**
+ * @brief Smallest transform length >= n whose only prime factors are 2, 3 and 5.
+ *
+ * Any length can be transformed, but such lengths use the fast radix-2/3/4/5
+ * butterflies; callers padding data (for example for convolution) should pad
+ * to this size.
+ *
+ * @param n Minimum length.
+ * @return The padded length, or 0 if n is 0 or too large.
+ */
+size_t fossil_image_fft_good_size(
+    size_t n
+);
+
+/**
+ * @brief In-place complex FFT of length n.
+ *
+ * The forward transform uses exp(-2*pi*i*k*n/N) and is unscaled; the inverse
+ * is scaled by 1/n so a round trip restores the input. Plans (factorization
+ * and twiddle tables) are cached by length and shared between threads.
+ *
+ * @param data Array of n complex samples.
+ * @param n Transform length.
+ * @param inverse Compute the inverse transform.
+ * @return true on success, false on invalid arguments or allocation failure.
+ */
+bool fossil_image_fft_1d(
+    fossil_image_complex_t *data,
+    size_t n,
+    bool inverse
+);
+
+/**
+ * @brief Forward 2-D FFT of a real width x height plane.
+ *
+ * Only the non-redundant half of the spectrum is produced: dst holds
+ * (width / 2 + 1) x height complex bins, row-major. Rows are transformed as
+ * half-length complex FFTs, columns in cache-sized blocks; both passes run on
+ * the parallel helper.
+ *
+ * @param src Real input, width * height samples, row-major.
+ * @param width Plane width; must be even.
+ * @param height Plane height.
+ * @param dst Output spectrum, (width / 2 + 1) * height bins.
+ * @return true on success, false otherwise.
+ */
+bool fossil_image_fft_2d_real(
+    const float *src,
+    uint32_t width,
+    uint32_t height,
+    fossil_image_complex_t *dst
+);
+
+/**
+ * @brief Inverse of fossil_image_fft_2d_real, scaled by 1 / (width * height).
+ *
+ * @param src Half spectrum, (width / 2 + 1) * height bins. It is used as
+ *            scratch and is overwritten.
+ * @param width Plane width; must be even.
+ * @param height Plane height.
+ * @param dst Real output, width * height samples.
+ * @return true on success, false otherwise.
+ */
+bool fossil_image_fft_2d_real_inverse(
+    fossil_image_complex_t *src,
+    uint32_t width,
+    uint32_t height,
+    float *dst
+);
+
+/**
+ * @brief Release cached FFT plans that are not in use.
+ */
+void fossil_image_fft_cache_clear(void);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Fft class providing static methods for Fourier transforms.
+         *
+         * This class serves as a C++ wrapper around the C FFT functions that
+         * the large-kernel convolution in Filter is built on.
+         */
+        class Fft {
+        public:
+            /**
+             * @brief Smallest 2/3/5-smooth length >= n.
+             */
+            static size_t good_size(
+            size_t n
+            ) {
+            return fossil_image_fft_good_size(n);
+            }
+
+            /**
+             * @brief In-place complex FFT of length n.
+             */
+            static bool transform(
+            fossil_image_complex_t *data,
+            size_t n,
+            bool inverse
+            ) {
+            return fossil_image_fft_1d(data, n, inverse);
+            }
+
+            /**
+             * @brief Forward 2-D FFT of a real plane (half spectrum).
+             */
+            static bool forward_2d_real(
+            const float *src,
+            uint32_t width,
+            uint32_t height,
+            fossil_image_complex_t *dst
+            ) {
+            return fossil_image_fft_2d_real(src, width, height, dst);
+            }
+
+            /**
+             * @brief Inverse 2-D FFT back to a real plane.
+             */
+            static bool inverse_2d_real(
+            fossil_image_complex_t *src,
+            uint32_t width,
+            uint32_t height,
+            float *dst
+            ) {
+            return fossil_image_fft_2d_real_inverse(src, width, height, dst);
+            }
+
+            /**
+             * @brief Release cached FFT plans that are not in use.
+             */
+            static void cache_clear() {
+            fossil_image_fft_cache_clear();
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_FFT_H */
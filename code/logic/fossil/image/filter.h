@@ -26,6 +26,7 @@
 #define FOSSIL_IMAGE_FILTER_H
 
 #include "process.h"
+#include "tile.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -36,6 +37,28 @@ extern "C"
 // Fossil Image — Filter Sub-Library
 // ======================================================
 
+/**
+ * @brief Morphological operations for fossil_image_filter_morphology.
+ */
+typedef enum fossil_morph_op_e {
+    FOSSIL_MORPH_ERODE = 0,     ///< Minimum over the window
+    FOSSIL_MORPH_DILATE,        ///< Maximum over the window
+    FOSSIL_MORPH_OPEN,          ///< Erode, then dilate
+    FOSSIL_MORPH_CLOSE,         ///< Dilate, then erode
+    FOSSIL_MORPH_GRADIENT,      ///< Dilation minus erosion
+    FOSSIL_MORPH_TOPHAT,        ///< Image minus its opening
+    FOSSIL_MORPH_BLACKHAT       ///< Closing minus the image
+} fossil_morph_op_t;
+
+/**
+ * @brief Evaluation strategy for fossil_image_filter_convolve/correlate.
+ */
+typedef enum fossil_conv_method_e {
+    FOSSIL_CONV_AUTO = 0,       ///< Pick direct or FFT from the estimated cost
+    FOSSIL_CONV_DIRECT,         ///< Multiply-add every kernel tap
+    FOSSIL_CONV_FFT             ///< Multiply spectra of the padded image and kernel
+} fossil_conv_method_t;
+
 /**
  * @brief Apply a 3x3 convolution kernel to an image.
  *
@@ -58,6 +81,30 @@ bool fossil_image_filter_convolve3x3(
     float bias
 );
 
+/**
+ * @brief Apply a 3x3 convolution kernel to a tiled image.
+ *
+ * Produces the same pixels as fossil_image_filter_convolve3x3 on the
+ * row-major image, but works tile by tile: each output tile reads only its
+ * source tile and a one pixel halo, so column access never strides across
+ * whole image rows. Tiles run in parallel on the parallel helper.
+ *
+ * @param src Tiled source image, at least 3x3.
+ * @param out Receives a new tiled image with the same geometry; release with
+ *            fossil_image_tile_free.
+ * @param kernel 3x3 matrix of floats representing the convolution kernel.
+ * @param scale Normalization factor applied to the convolution result.
+ * @param bias Value added to each pixel after convolution.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_convolve3x3_tiled(
+    const fossil_image_tiled_t *src,
+    fossil_image_tiled_t *out,
+    const float kernel[3][3],
+    float scale,
+    float bias
+);
+
 /**
  * @brief Apply a Gaussian blur filter.
  *
@@ -75,6 +122,24 @@ bool fossil_image_filter_blur(
     float radius
 );
 
+/**
+ * @brief Apply a Gaussian blur in linear light.
+ *
+ * Produces the same binomial blur as fossil_image_filter_blur, but 8 and
+ * 16-bit sRGB pixels are decoded to linear light before averaging, so bright
+ * detail is not dimmed. The repeated 3x3 passes are folded into one separable
+ * kernel that streams through a ring of decoded rows; no float copy of the
+ * image is made. Borders are extended from the nearest edge pixel.
+ *
+ * @param image Pointer to a GRAY, RGB or RGBA image to blur.
+ * @param radius The radius of the Gaussian kernel; larger values produce more blur.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_blur_linear(
+    fossil_image_t *image,
+    float radius
+);
+
 /**
  * @brief Apply a sharpening filter.
  *
@@ -117,6 +182,153 @@ bool fossil_image_filter_emboss(
     fossil_image_t *image
 );
 
+/**
+ * @brief Apply a median filter over a (2 * radius + 1) square window.
+ *
+ * Uses sliding column histograms split into coarse and fine levels, so the
+ * cost per pixel does not grow with the radius. Each channel is filtered on
+ * its own and borders are extended from the nearest edge pixel. The image is
+ * processed in column strips spread over the worker threads.
+ *
+ * @param image Pointer to a GRAY8, RGB24, RGBA32, GRAY16, RGB48 or RGBA64 image.
+ * @param radius Window radius, 0 to 127; 0 leaves the image unchanged.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_median(
+    fossil_image_t *image,
+    uint32_t radius
+);
+
+/**
+ * @brief Apply a morphological operation with a rectangular structuring element.
+ *
+ * The element spans (2 * radius_x + 1) x (2 * radius_y + 1) pixels. Erosion and
+ * dilation use the van Herk/Gil-Werman algorithm, which costs three
+ * comparisons per sample in each direction whatever the radius; pixels outside
+ * the image are ignored. GRAY8 images holding only 0 and 255 are processed as
+ * packed bit masks, 64 pixels per word. Channels are processed independently.
+ *
+ * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+ * @param op The operation to apply.
+ * @param radius_x Horizontal radius of the structuring element.
+ * @param radius_y Vertical radius of the structuring element.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_morphology(
+    fossil_image_t *image,
+    fossil_morph_op_t op,
+    uint32_t radius_x,
+    uint32_t radius_y
+);
+
+/**
+ * @brief Apply an edge-preserving bilateral filter using a bilateral grid.
+ *
+ * Pixels are accumulated into a coarse grid over position and luma, the grid
+ * is blurred, and each pixel reads its result back by trilinear interpolation.
+ * The cost per pixel is nearly independent of sigma_spatial; memory grows with
+ * the number of grid cells, (width / sigma_spatial) * (height / sigma_spatial)
+ * * (luma range / sigma_range). Color images are smoothed across pixels of
+ * similar luma.
+ *
+ * @param image Pointer to a GRAY8, RGB24, RGBA32 or float image.
+ * @param sigma_spatial Spatial standard deviation in pixels (at least 1).
+ * @param sigma_range Range standard deviation; in 0..1 units for 8-bit images
+ *                    and in sample units for float images.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_bilateral(
+    fossil_image_t *image,
+    float sigma_spatial,
+    float sigma_range
+);
+
+/**
+ * @brief Sharpen an image with an unsharp mask.
+ *
+ * Each sample becomes src + amount * (src - blur), where blur is a Gaussian of
+ * the given sigma. Samples whose difference to the blur is below threshold are
+ * left untouched, which keeps flat, noisy areas from being sharpened. The blur,
+ * difference and add-back run in one streaming pass over parallel row bands;
+ * no blurred copy of the image is allocated.
+ *
+ * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+ * @param sigma Gaussian standard deviation in pixels (greater than 0).
+ * @param amount Strength of the sharpening; 0 leaves the image unchanged.
+ * @param threshold Minimum difference to sharpen, in 0..1 units for integer
+ *                  formats and in sample units for float formats.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_unsharp_mask(
+    fossil_image_t *image,
+    float sigma,
+    float amount,
+    float threshold
+);
+
+/**
+ * @brief Keep only the detail above a Gaussian blur.
+ *
+ * Each sample becomes src - blur + 0.5 (mid-gray for integer formats), the
+ * detail layer an unsharp mask adds back. Uses the same streaming pass as
+ * fossil_image_filter_unsharp_mask.
+ *
+ * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+ * @param sigma Gaussian standard deviation in pixels (greater than 0).
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_high_pass(
+    fossil_image_t *image,
+    float sigma
+);
+
+/**
+ * @brief Convolve an image with an arbitrary kernel.
+ *
+ * The kernel is kernel_width x kernel_height floats, row-major, centered at
+ * ((kernel_width - 1) / 2, (kernel_height - 1) / 2) and rotated 180 degrees as
+ * convolution requires. Borders are extended from the nearest edge pixel and
+ * channels are filtered independently. With FOSSIL_CONV_AUTO, small kernels
+ * are applied directly and large ones (typically beyond about 11x11) through
+ * the FFT; both give the same result up to float rounding.
+ *
+ * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+ * @param kernel Kernel taps, kernel_width * kernel_height values.
+ * @param kernel_width Kernel width in taps.
+ * @param kernel_height Kernel height in taps.
+ * @param method Evaluation strategy.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_convolve(
+    fossil_image_t *image,
+    const float *kernel,
+    uint32_t kernel_width,
+    uint32_t kernel_height,
+    fossil_conv_method_t method
+);
+
+/**
+ * @brief Cross-correlate an image with an arbitrary kernel.
+ *
+ * Like fossil_image_filter_convolve but without rotating the kernel, which is
+ * anchored at (kernel_width / 2, kernel_height / 2). Useful for matched
+ * filtering.
+ *
+ * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+ * @param kernel Kernel taps, kernel_width * kernel_height values.
+ * @param kernel_width Kernel width in taps.
+ * @param kernel_height Kernel height in taps.
+ * @param method Evaluation strategy.
+ * @return true if the operation succeeds, false otherwise.
+ */
+bool fossil_image_filter_correlate(
+    fossil_image_t *image,
+    const float *kernel,
+    uint32_t kernel_width,
+    uint32_t kernel_height,
+    fossil_conv_method_t method
+);
+
 #ifdef __cplusplus
 }
 
@@ -160,6 +372,29 @@ namespace fossil {
                 return fossil_image_filter_convolve3x3(image, kernel, scale, bias);
             }
 
+            /**
+             * @brief Apply a 3x3 convolution kernel to a tiled image.
+             *
+             * Same pixels as convolve3x3 on the row-major image, computed one
+             * tile plus a one pixel halo at a time.
+             *
+             * @param src Tiled source image, at least 3x3.
+             * @param out Receives a new tiled image with the same geometry.
+             * @param kernel 3x3 matrix of floats representing the convolution kernel.
+             * @param scale Normalization factor applied to the convolution result.
+             * @param bias Value added to each pixel after convolution.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool convolve3x3_tiled(
+            const fossil_image_tiled_t *src,
+            fossil_image_tiled_t *out,
+            const float kernel[3][3],
+            float scale,
+            float bias
+            ) {
+                return fossil_image_filter_convolve3x3_tiled(src, out, kernel, scale, bias);
+            }
+
             /**
              * @brief Apply a Gaussian blur filter.
              *
@@ -180,6 +415,23 @@ namespace fossil {
                 return fossil_image_filter_blur(image, radius);
             }
 
+            /**
+             * @brief Apply a Gaussian blur in linear light.
+             *
+             * This method blurs the image like blur(), but averages 8 and 16-bit
+             * sRGB pixels in linear light, streaming one decoded row at a time.
+             *
+             * @param image Pointer to the fossil_image_t structure representing the image to process.
+             * @param radius The radius of the Gaussian kernel; larger values produce more blur.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool blur_linear(
+            fossil_image_t *image,
+            float radius
+            ) {
+                return fossil_image_filter_blur_linear(image, radius);
+            }
+
             /**
              * @brief Apply a sharpening filter.
              *
@@ -228,6 +480,126 @@ namespace fossil {
                 return fossil_image_filter_emboss(image);
             }
 
+            /**
+             * @brief Apply a constant-time median filter.
+             *
+             * @param image Pointer to an 8 or 16-bit GRAY, RGB or RGBA image.
+             * @param radius Window radius, 0 to 127.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool median(
+            fossil_image_t *image,
+            uint32_t radius
+            ) {
+                return fossil_image_filter_median(image, radius);
+            }
+
+            /**
+             * @brief Apply a morphological operation with a rectangular element.
+             *
+             * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+             * @param op The operation to apply.
+             * @param radius_x Horizontal radius of the structuring element.
+             * @param radius_y Vertical radius of the structuring element.
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool morphology(
+            fossil_image_t *image,
+            fossil_morph_op_t op,
+            uint32_t radius_x,
+            uint32_t radius_y
+            ) {
+                return fossil_image_filter_morphology(image, op, radius_x, radius_y);
+            }
+
+            /**
+             * @brief Apply an edge-preserving bilateral filter using a bilateral grid.
+             *
+             * @param image Pointer to a GRAY8, RGB24, RGBA32 or float image.
+             * @param sigma_spatial Spatial standard deviation in pixels (at least 1).
+             * @param sigma_range Range standard deviation (0..1 units for 8-bit images).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool bilateral(
+            fossil_image_t *image,
+            float sigma_spatial,
+            float sigma_range
+            ) {
+                return fossil_image_filter_bilateral(image, sigma_spatial, sigma_range);
+            }
+
+            /**
+             * @brief Sharpen an image with an unsharp mask.
+             *
+             * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+             * @param sigma Gaussian standard deviation in pixels (greater than 0).
+             * @param amount Strength of the sharpening.
+             * @param threshold Minimum difference to sharpen (0..1 units for integer formats).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool unsharp_mask(
+            fossil_image_t *image,
+            float sigma,
+            float amount,
+            float threshold
+            ) {
+                return fossil_image_filter_unsharp_mask(image, sigma, amount, threshold);
+            }
+
+            /**
+             * @brief Keep only the detail above a Gaussian blur.
+             *
+             * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+             * @param sigma Gaussian standard deviation in pixels (greater than 0).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool high_pass(
+            fossil_image_t *image,
+            float sigma
+            ) {
+                return fossil_image_filter_high_pass(image, sigma);
+            }
+
+            /**
+             * @brief Convolve an image with an arbitrary kernel.
+             *
+             * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+             * @param kernel Kernel taps, kernel_width * kernel_height values.
+             * @param kernel_width Kernel width in taps.
+             * @param kernel_height Kernel height in taps.
+             * @param method Evaluation strategy (direct, FFT or automatic).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool convolve(
+            fossil_image_t *image,
+            const float *kernel,
+            uint32_t kernel_width,
+            uint32_t kernel_height,
+            fossil_conv_method_t method
+            ) {
+                return fossil_image_filter_convolve(image, kernel, kernel_width, kernel_height, method);
+            }
+
+            /**
+             * @brief Cross-correlate an image with an arbitrary kernel.
+             *
+             * @param image Pointer to an 8-bit, 16-bit or float GRAY, RGB or RGBA image.
+             * @param kernel Kernel taps, kernel_width * kernel_height values.
+             * @param kernel_width Kernel width in taps.
+             * @param kernel_height Kernel height in taps.
+             * @param method Evaluation strategy (direct, FFT or automatic).
+             * @return true if the operation succeeds, false otherwise.
+             */
+            static bool correlate(
+            fossil_image_t *image,
+            const float *kernel,
+            uint32_t kernel_width,
+            uint32_t kernel_height,
+            fossil_conv_method_t method
+            ) {
+                return fossil_image_filter_correlate(image, kernel, kernel_width, kernel_height, method);
+            }
+
         };
 
     } // namespace image
@@ -31,5 +31,11 @@
 #include "color.h"
 #include "draw.h"
 #include "io.h"
+#include "parallel.h"
+#include "fft.h"
+#include "pipeline.h"
+#include "tile.h"
+#include "disk.h"
+#include "container.h"
 
 #endif /* FOSSIL_IMAGE_FRAMEWORK_H */
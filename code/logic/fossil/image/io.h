@@ -38,7 +38,7 @@ extern "C"
 
 /**
  * @brief Load image from file by format string ID.
- * Supported formats: "bmp", "ppm"
+ * Supported formats: "bmp", "ppm", "raw", "fic" (tiled container, see container.h)
  */
 bool fossil_image_io_load(
     const char *filename,
@@ -48,7 +48,7 @@ bool fossil_image_io_load(
 
 /**
  * @brief Save image to file by format string ID.
- * Supported formats: "bmp", "ppm"
+ * Supported formats: "bmp", "ppm", "raw", "fic" (tiled container, see container.h)
  */
 bool fossil_image_io_save(
     const char *filename,
@@ -87,7 +87,7 @@ namespace fossil {
         public:
             /**
              * @brief Load image from file by format string ID.
-             * Supported formats: "bmp", "ppm"
+             * Supported formats: "bmp", "ppm", "raw", "fic" (tiled container, see container.h)
              */
             static bool load(
             const std::string &filename,
@@ -99,7 +99,7 @@ namespace fossil {
 
             /**
              * @brief Save image to file by format string ID.
-             * Supported formats: "bmp", "ppm"
+             * Supported formats: "bmp", "ppm", "raw", "fic" (tiled container, see container.h)
              */
             static bool save(
             const std::string &filename,
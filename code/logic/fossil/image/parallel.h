@@ -0,0 +1,196 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_PARALLEL_H
+#define FOSSIL_IMAGE_PARALLEL_H
+
+#include "process.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — Parallel Sub-Library
+// ======================================================
+
+/**
+ * @brief Work function run on one contiguous band of a parallel loop.
+ *
+ * @param ctx User context passed to fossil_image_parallel_for.
+ * @param begin First item of the band (inclusive).
+ * @param end Last item of the band (exclusive).
+ * @param band Index of the band, in [0, number of bands).
+ */
+typedef void (*fossil_image_parallel_fn)(
+    void *ctx,
+    uint32_t begin,
+    uint32_t end,
+    uint32_t band
+);
+
+/**
+ * @brief Set the number of worker threads used by parallel kernels.
+ *
+ * A value of 0 (the default) uses one thread per online processor. A value of
+ * 1 runs every kernel on the calling thread.
+ *
+ * @param threads Requested thread count, or 0 for automatic.
+ */
+void fossil_image_parallel_set_threads(
+    uint32_t threads
+);
+
+/**
+ * @brief Get the number of worker threads parallel kernels will use.
+ *
+ * @return Effective thread count (at least 1).
+ */
+uint32_t fossil_image_parallel_get_threads(void);
+
+/**
+ * @brief Get the number of bands a parallel loop will be split into.
+ *
+ * Kernels use this to size per-band scratch (for example partial histograms)
+ * and then pass the result to fossil_image_parallel_for_bands, so the loop
+ * keeps that band count even if the thread count changes in between.
+ *
+ * @param count Number of items (usually rows).
+ * @param min_per_band Minimum number of items worth giving to one thread.
+ * @return Band count, at least 1 when count is non-zero.
+ */
+uint32_t fossil_image_parallel_bands(
+    uint32_t count,
+    uint32_t min_per_band
+);
+
+/**
+ * @brief Run fn over [0, count) split into a given number of bands.
+ *
+ * Band b covers [count * b / n, count * (b + 1) / n) for n = bands (clamped
+ * to [1, count]), so results can be merged deterministically by band index
+ * and per-band scratch sized for n bands is never overrun. Bands run on a
+ * shared pool of worker threads, with the calling thread taking part, and the
+ * call returns once every band has finished. When the pool is in use by
+ * another loop (including a loop nested inside a band) or cannot start a
+ * thread, the remaining bands run on the calling thread.
+ *
+ * @param bands Number of bands, usually from fossil_image_parallel_bands.
+ * @param count Number of items (usually rows).
+ * @param fn Work function.
+ * @param ctx User context forwarded to fn.
+ * @return true if the loop ran, false on invalid arguments.
+ */
+bool fossil_image_parallel_for_bands(
+    uint32_t bands,
+    uint32_t count,
+    fossil_image_parallel_fn fn,
+    void *ctx
+);
+
+/**
+ * @brief Run fn over [0, count) split into contiguous bands.
+ *
+ * Equivalent to fossil_image_parallel_for_bands with
+ * fossil_image_parallel_bands(count, min_per_band) bands. Kernels that size
+ * per-band scratch should take the band count once and use
+ * fossil_image_parallel_for_bands instead.
+ *
+ * @param count Number of items (usually rows).
+ * @param min_per_band Minimum number of items worth giving to one thread.
+ * @param fn Work function.
+ * @param ctx User context forwarded to fn.
+ * @return true if the loop ran, false on invalid arguments.
+ */
+bool fossil_image_parallel_for(
+    uint32_t count,
+    uint32_t min_per_band,
+    fossil_image_parallel_fn fn,
+    void *ctx
+);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Parallel class providing static methods for thread configuration.
+         *
+         * This class serves as a C++ wrapper around the C parallel helpers that
+         * the row-band kernels of the library are built on.
+         */
+        class Parallel {
+        public:
+            /**
+             * @brief Sets the number of worker threads (0 = one per processor).
+             */
+            static void set_threads(
+            uint32_t threads
+            ) {
+            fossil_image_parallel_set_threads(threads);
+            }
+
+            /**
+             * @brief Gets the effective number of worker threads.
+             */
+            static uint32_t get_threads() {
+            return fossil_image_parallel_get_threads();
+            }
+
+            /**
+             * @brief Runs fn over [0, count) split into contiguous bands.
+             */
+            static bool run(
+            uint32_t count,
+            uint32_t min_per_band,
+            fossil_image_parallel_fn fn,
+            void *ctx
+            ) {
+            return fossil_image_parallel_for(count, min_per_band, fn, ctx);
+            }
+
+            /**
+             * @brief Runs fn over [0, count) split into exactly bands bands.
+             */
+            static bool run_bands(
+            uint32_t bands,
+            uint32_t count,
+            fossil_image_parallel_fn fn,
+            void *ctx
+            ) {
+            return fossil_image_parallel_for_bands(bands, count, fn, ctx);
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_PARALLEL_H */
@@ -0,0 +1,446 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_PIPELINE_H
+#define FOSSIL_IMAGE_PIPELINE_H
+
+#include "process.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — Pipeline Sub-Library
+// ======================================================
+
+/**
+ * @brief Opaque, lazily evaluated chain of image operations.
+ *
+ * Operations are only recorded when added; nothing touches pixels until
+ * fossil_image_pipeline_execute. At that point runs of adjacent point
+ * operations are fused into a single lookup (or a single in-cache pass for
+ * float images) and 3x3 neighbourhood operations are streamed through small
+ * row rings, so the whole chain reads and writes the image once. Results
+ * are identical to calling the matching color and filter functions in order.
+ */
+typedef struct fossil_image_pipeline_s fossil_image_pipeline_t;
+
+/**
+ * @brief Create an empty pipeline.
+ *
+ * @return The pipeline, or NULL on allocation failure.
+ */
+fossil_image_pipeline_t *fossil_image_pipeline_create(void);
+
+/**
+ * @brief Release a pipeline. Safe to call with NULL.
+ *
+ * @param pipeline Pipeline to release.
+ */
+void fossil_image_pipeline_destroy(
+    fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Remove every recorded operation so the pipeline can be reused.
+ *
+ * @param pipeline Pipeline to reset.
+ */
+void fossil_image_pipeline_clear(
+    fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Record fossil_image_color_brightness.
+ *
+ * @param pipeline Pipeline to append to.
+ * @param offset Value added to every sample.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_brightness(
+    fossil_image_pipeline_t *pipeline,
+    int offset
+);
+
+/**
+ * @brief Record fossil_image_color_contrast.
+ *
+ * @param pipeline Pipeline to append to.
+ * @param factor Contrast factor around the mid level.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_contrast(
+    fossil_image_pipeline_t *pipeline,
+    float factor
+);
+
+/**
+ * @brief Record fossil_image_color_gamma.
+ *
+ * @param pipeline Pipeline to append to.
+ * @param gamma Gamma value, greater than zero.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_gamma(
+    fossil_image_pipeline_t *pipeline,
+    float gamma
+);
+
+/**
+ * @brief Record fossil_image_filter_convolve3x3.
+ *
+ * @param pipeline Pipeline to append to.
+ * @param kernel 3x3 kernel, copied into the pipeline.
+ * @param scale Multiplier applied to each weighted sum.
+ * @param bias Value added after scaling.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_convolve3x3(
+    fossil_image_pipeline_t *pipeline,
+    const float kernel[3][3],
+    float scale,
+    float bias
+);
+
+/**
+ * @brief Record fossil_image_filter_blur (one 3x3 pass per unit of radius).
+ *
+ * @param pipeline Pipeline to append to.
+ * @param radius Blur radius.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_blur(
+    fossil_image_pipeline_t *pipeline,
+    float radius
+);
+
+/**
+ * @brief Record fossil_image_filter_sharpen.
+ *
+ * @param pipeline Pipeline to append to.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_sharpen(
+    fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Record fossil_image_filter_edge.
+ *
+ * @param pipeline Pipeline to append to.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_edge(
+    fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Record fossil_image_filter_emboss.
+ *
+ * @param pipeline Pipeline to append to.
+ * @return true if recorded, false otherwise.
+ */
+bool fossil_image_pipeline_emboss(
+    fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Record fossil_image_process_resize as the final operation.
+ *
+ * The resize runs after every other operation, straight from the processed
+ * image into the new buffer through fossil_image_process_resize_into, so the
+ * chain still needs no intermediate image. Nothing can be recorded after it.
+ *
+ * @param pipeline Pipeline to append to.
+ * @param width Target width in pixels.
+ * @param height Target height in pixels.
+ * @param mode Interpolation mode for resampling.
+ * @return true if recorded, false for a zero size or a second resize.
+ */
+bool fossil_image_pipeline_resize(
+    fossil_image_pipeline_t *pipeline,
+    uint32_t width,
+    uint32_t height,
+    fossil_interp_t mode
+);
+
+/**
+ * @brief Number of operations recorded so far.
+ *
+ * @param pipeline Pipeline to inspect.
+ * @return Operation count (a blur counts one per 3x3 pass).
+ */
+uint32_t fossil_image_pipeline_op_count(
+    const fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Number of kernels the operations compile to after fusion.
+ *
+ * Each maximal run of point operations counts once, as does every
+ * neighbourhood operation and the resize.
+ *
+ * @param pipeline Pipeline to inspect.
+ * @return Fused stage count.
+ */
+uint32_t fossil_image_pipeline_stage_count(
+    const fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Pixels of context each output pixel depends on.
+ *
+ * Every 3x3 stage widens the footprint by one pixel, so this is the number
+ * of neighbourhood operations. Callers processing an image in pieces must
+ * supply this much overlap around each piece.
+ *
+ * @param pipeline Pipeline to inspect.
+ * @return Halo width in pixels (0 for point-only pipelines).
+ */
+uint32_t fossil_image_pipeline_halo(
+    const fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Whether a resize has been recorded.
+ *
+ * A resize changes the image geometry, so pipelines carrying one cannot be
+ * run piecewise over fixed-size blocks.
+ *
+ * @param pipeline Pipeline to inspect.
+ * @return true if the pipeline ends in a resize.
+ */
+bool fossil_image_pipeline_has_resize(
+    const fossil_image_pipeline_t *pipeline
+);
+
+/**
+ * @brief Run the recorded operations on an image in place.
+ *
+ * The image is processed in row bands on the parallel helper; each band
+ * snapshots the few rows its neighbourhood stages borrow from adjacent
+ * bands, so bands never observe each other's output. A recorded resize
+ * then replaces the pixel buffer, as fossil_image_process_resize does; its
+ * arguments are checked and its buffer allocated before any pixel changes.
+ * On failure the image is left unchanged.
+ *
+ * @param pipeline Operations to apply.
+ * @param image Image to process.
+ * @return true if successful, false on unsupported formats, images smaller
+ *         than 3x3 when a neighbourhood operation is recorded, a resize of
+ *         an INDEXED8 image with a mode other than nearest, or allocation
+ *         failure.
+ */
+bool fossil_image_pipeline_execute(
+    const fossil_image_pipeline_t *pipeline,
+    fossil_image_t *image
+);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Pipeline class providing static methods for fused operation chains.
+         *
+         * This class serves as a C++ wrapper around the C pipeline functions,
+         * which record Color and Filter operations and run them in one pass.
+         */
+        class Pipeline {
+        public:
+            /**
+             * @brief Create an empty pipeline.
+             */
+            static fossil_image_pipeline_t *create() {
+            return fossil_image_pipeline_create();
+            }
+
+            /**
+             * @brief Release a pipeline.
+             */
+            static void destroy(
+            fossil_image_pipeline_t *pipeline
+            ) {
+            fossil_image_pipeline_destroy(pipeline);
+            }
+
+            /**
+             * @brief Remove every recorded operation.
+             */
+            static void clear(
+            fossil_image_pipeline_t *pipeline
+            ) {
+            fossil_image_pipeline_clear(pipeline);
+            }
+
+            /**
+             * @brief Record a brightness offset.
+             */
+            static bool brightness(
+            fossil_image_pipeline_t *pipeline,
+            int offset
+            ) {
+            return fossil_image_pipeline_brightness(pipeline, offset);
+            }
+
+            /**
+             * @brief Record a contrast adjustment.
+             */
+            static bool contrast(
+            fossil_image_pipeline_t *pipeline,
+            float factor
+            ) {
+            return fossil_image_pipeline_contrast(pipeline, factor);
+            }
+
+            /**
+             * @brief Record a gamma correction.
+             */
+            static bool gamma(
+            fossil_image_pipeline_t *pipeline,
+            float gamma
+            ) {
+            return fossil_image_pipeline_gamma(pipeline, gamma);
+            }
+
+            /**
+             * @brief Record a 3x3 convolution.
+             */
+            static bool convolve3x3(
+            fossil_image_pipeline_t *pipeline,
+            const float kernel[3][3],
+            float scale,
+            float bias
+            ) {
+            return fossil_image_pipeline_convolve3x3(pipeline, kernel, scale, bias);
+            }
+
+            /**
+             * @brief Record a blur.
+             */
+            static bool blur(
+            fossil_image_pipeline_t *pipeline,
+            float radius
+            ) {
+            return fossil_image_pipeline_blur(pipeline, radius);
+            }
+
+            /**
+             * @brief Record a sharpen filter.
+             */
+            static bool sharpen(
+            fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_sharpen(pipeline);
+            }
+
+            /**
+             * @brief Record an edge detection filter.
+             */
+            static bool edge(
+            fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_edge(pipeline);
+            }
+
+            /**
+             * @brief Record an emboss filter.
+             */
+            static bool emboss(
+            fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_emboss(pipeline);
+            }
+
+            /**
+             * @brief Record a resize as the final operation.
+             */
+            static bool resize(
+            fossil_image_pipeline_t *pipeline,
+            uint32_t width,
+            uint32_t height,
+            fossil_interp_t mode
+            ) {
+            return fossil_image_pipeline_resize(pipeline, width, height, mode);
+            }
+
+            /**
+             * @brief Number of recorded operations.
+             */
+            static uint32_t op_count(
+            const fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_op_count(pipeline);
+            }
+
+            /**
+             * @brief Number of fused stages.
+             */
+            static uint32_t stage_count(
+            const fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_stage_count(pipeline);
+            }
+
+            /**
+             * @brief Pixels of context each output pixel depends on.
+             */
+            static uint32_t halo(
+            const fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_halo(pipeline);
+            }
+
+            /**
+             * @brief Whether a resize has been recorded.
+             */
+            static bool has_resize(
+            const fossil_image_pipeline_t *pipeline
+            ) {
+            return fossil_image_pipeline_has_resize(pipeline);
+            }
+
+            /**
+             * @brief Run the recorded operations on an image in place.
+             */
+            static bool execute(
+            const fossil_image_pipeline_t *pipeline,
+            fossil_image_t *image
+            ) {
+            return fossil_image_pipeline_execute(pipeline, image);
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_PIPELINE_H */
@@ -70,7 +70,8 @@ typedef enum fossil_interp_e {
     FOSSIL_INTERP_LANCZOS,
     FOSSIL_INTERP_BICUBIC,
     FOSSIL_INTERP_MITCHELL,
-    FOSSIL_INTERP_BSPLINE
+    FOSSIL_INTERP_BSPLINE,
+    FOSSIL_INTERP_AREA                 ///< Coverage-weighted mean of the source pixels (for shrinking)
 } fossil_interp_t;
 
 /**
@@ -91,6 +92,8 @@ typedef struct fossil_image_s {
     };
     size_t size;                        ///< Total buffer size in bytes
     bool owns_data;                     ///< Free buffer on destroy
+    uint8_t *palette;                   ///< RGB triplets for INDEXED8 images (owned, may be NULL)
+    uint32_t palette_size;              ///< Number of palette entries (0-256)
 
     // Optional metadata fields
     char name[64];                      ///< Debug/identifier
@@ -108,10 +111,45 @@ typedef struct fossil_image_s {
     char creation_date[32];             ///< Optional timestamp as string
 } fossil_image_t;
 
+/**
+ * @brief Precomputed resampling coefficients for one source and target size.
+ *
+ * Created by fossil_image_process_resize_plan_create. A plan is never
+ * modified after creation, so one plan may be executed from several threads.
+ */
+typedef struct fossil_image_resize_plan_s fossil_image_resize_plan_t;
+
+/**
+ * @brief Decimation filter used between pyramid levels.
+ */
+typedef enum fossil_pyramid_filter_e {
+    FOSSIL_PYRAMID_BOX = 0,            ///< 2x2 average (mipmap)
+    FOSSIL_PYRAMID_GAUSSIAN            ///< Separable 5-tap [1 4 6 4 1] / 16 binomial
+} fossil_pyramid_filter_t;
+
+/**
+ * @brief Chain of successively halved images sharing one allocation.
+ */
+typedef struct fossil_image_pyramid_s {
+    fossil_image_t *levels;            ///< count levels; the block also holds every level's pixels
+    uint32_t count;                    ///< Number of levels, level 0 being a copy of the source
+    size_t size;                       ///< Bytes in the block
+} fossil_image_pyramid_t;
+
 // ======================================================
 // Fossil Image — Process Sub-Library
 // ======================================================
 
+/**
+ * @brief Get the number of bytes used by one pixel of a format.
+ *
+ * @param format Pixel format.
+ * @return Bytes per pixel, or 0 for FOSSIL_PIXEL_FORMAT_NONE and unknown formats.
+ */
+size_t fossil_image_bytes_per_pixel(
+    fossil_pixel_format_t format
+);
+
 /**
  * @brief Create a new image with specified dimensions and format.
  *
@@ -151,6 +189,14 @@ void fossil_image_process_destroy(
  * or Lanczos). The image's metadata (width, height, and buffer size) is updated
  * accordingly. Returns true on success, false on failure (e.g., allocation error).
  *
+ * Nearest and linear sample the source at x * width / target width. The
+ * cubic family and Lanczos are not implemented yet and fall back to
+ * nearest. FOSSIL_INTERP_AREA averages every source pixel under each output
+ * pixel, weighted by coverage; exact integer ratios run integer kernels. All
+ * modes run over parallel row bands and support 8-bit, 16-bit and float
+ * formats; INDEXED8 images do not support linear or area. See fossil_image_process_resize_into to resize
+ * without replacing the source buffer.
+ *
  * @param image Pointer to the fossil_image_t structure to resize.
  * @param width Target width in pixels.
  * @param height Target height in pixels.
@@ -164,6 +210,202 @@ bool fossil_image_process_resize(
     fossil_interp_t mode
 );
 
+/**
+ * @brief Resize an image into a caller-provided destination image.
+ *
+ * Resamples src to the size of dst and writes the pixels into dst's
+ * existing buffer; neither image is reallocated. Both images must share a
+ * pixel format and must not share a buffer. The interpolation modes behave
+ * as in fossil_image_process_resize.
+ *
+ * @param src Source image, left unchanged.
+ * @param dst Destination image whose width and height give the target size.
+ * @param mode Interpolation mode for resampling.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_resize_into(
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    fossil_interp_t mode
+);
+
+/**
+ * @brief Resize an image into a rectangle of a caller-provided destination image.
+ *
+ * Resamples src to width x height and writes it at (dst_x, dst_y) inside
+ * dst, leaving the rest of dst untouched, e.g. to fill one cell of a
+ * contact sheet. The rectangle must lie inside dst.
+ *
+ * @param src Source image, left unchanged.
+ * @param dst Destination image with the same pixel format.
+ * @param dst_x Left edge of the target rectangle.
+ * @param dst_y Top edge of the target rectangle.
+ * @param width Target width in pixels.
+ * @param height Target height in pixels.
+ * @param mode Interpolation mode for resampling.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_resize_into_region(
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    uint32_t dst_x,
+    uint32_t dst_y,
+    uint32_t width,
+    uint32_t height,
+    fossil_interp_t mode
+);
+
+/**
+ * @brief Precompute the resampling coefficients for repeated resizes.
+ *
+ * Builds the per-column and per-row source indices and weights for
+ * resizing src_width x src_height images to dst_width x dst_height. Reusing
+ * the plan skips that setup for every further image of the same size.
+ *
+ * @param src_width Source width in pixels.
+ * @param src_height Source height in pixels.
+ * @param dst_width Target width in pixels.
+ * @param dst_height Target height in pixels.
+ * @param mode Interpolation mode for resampling.
+ * @return New plan, or NULL on invalid sizes or allocation failure.
+ */
+fossil_image_resize_plan_t *fossil_image_process_resize_plan_create(
+    uint32_t src_width,
+    uint32_t src_height,
+    uint32_t dst_width,
+    uint32_t dst_height,
+    fossil_interp_t mode
+);
+
+/**
+ * @brief Resize an image with a precomputed plan.
+ *
+ * src must have the plan's source size. The result is written at
+ * (dst_x, dst_y) inside dst, which must have the same pixel format and room
+ * for the plan's target size there.
+ *
+ * @param plan Plan from fossil_image_process_resize_plan_create.
+ * @param src Source image, left unchanged.
+ * @param dst Destination image.
+ * @param dst_x Left edge of the target rectangle.
+ * @param dst_y Top edge of the target rectangle.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_resize_plan_execute(
+    const fossil_image_resize_plan_t *plan,
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    uint32_t dst_x,
+    uint32_t dst_y
+);
+
+/**
+ * @brief Source rectangle read when producing part of a plan's output.
+ *
+ * Lets callers that hold only part of the source (tiles, disk-backed
+ * images) fetch exactly the pixels an output rectangle depends on.
+ *
+ * @param plan Plan from fossil_image_process_resize_plan_create.
+ * @param x Left edge of the output rectangle.
+ * @param y Top edge of the output rectangle.
+ * @param width Output rectangle width.
+ * @param height Output rectangle height.
+ * @param src_x Receives the left edge of the source rectangle.
+ * @param src_y Receives the top edge of the source rectangle.
+ * @param src_width Receives the source rectangle width.
+ * @param src_height Receives the source rectangle height.
+ * @return true if successful, false if the rectangle is empty or outside the output.
+ */
+bool fossil_image_process_resize_plan_source_rect(
+    const fossil_image_resize_plan_t *plan,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint32_t *src_x,
+    uint32_t *src_y,
+    uint32_t *src_width,
+    uint32_t *src_height
+);
+
+/**
+ * @brief Produce one rectangle of a plan's output from a window of the source.
+ *
+ * dst receives the output pixels (x, y) to (x + dst->width, y + dst->height)
+ * at its origin. window holds source pixels starting at (window_x, window_y)
+ * and must cover the rectangle given by
+ * fossil_image_process_resize_plan_source_rect. The pixels match the same
+ * rectangle of a full fossil_image_process_resize_plan_execute.
+ *
+ * @param plan Plan from fossil_image_process_resize_plan_create.
+ * @param window Part of the source image.
+ * @param window_x Source column of the window's first pixel.
+ * @param window_y Source row of the window's first pixel.
+ * @param dst Destination for the rectangle, same pixel format as window.
+ * @param x Left edge of the rectangle in the plan's output.
+ * @param y Top edge of the rectangle in the plan's output.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_resize_plan_execute_rect(
+    const fossil_image_resize_plan_t *plan,
+    const fossil_image_t *window,
+    uint32_t window_x,
+    uint32_t window_y,
+    fossil_image_t *dst,
+    uint32_t x,
+    uint32_t y
+);
+
+/**
+ * @brief Release a resize plan. Safe to call with NULL.
+ *
+ * @param plan Plan to release.
+ */
+void fossil_image_process_resize_plan_destroy(
+    fossil_image_resize_plan_t *plan
+);
+
+/**
+ * @brief Shrink an image by an integer factor with area averaging.
+ *
+ * Equivalent to fossil_image_process_resize with FOSSIL_INTERP_AREA to
+ * width / factor by height / factor (at least 1x1). When the factor divides
+ * both dimensions every output pixel is the rounded mean of a factor x factor
+ * block; 2x reductions of GRAY8 and RGBA32 images use SIMD kernels.
+ *
+ * @param image Pointer to the image to shrink in place.
+ * @param factor Reduction factor, 1 or more.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_downscale(
+    fossil_image_t *image,
+    uint32_t factor
+);
+
+/**
+ * @brief Resize an image with interpolation carried out in linear light.
+ *
+ * Same as fossil_image_process_resize, but 8 and 16-bit sRGB pixels are
+ * decoded to linear light before they are mixed and re-encoded afterwards,
+ * which avoids the darkening of fine detail that averaging gamma-encoded
+ * values causes. Conversion happens per source row, so no float copy of the
+ * image is made. Float formats are taken as already linear. Bilinear and
+ * area modes mix in linear light; modes that do not mix pixels (nearest)
+ * behave exactly like fossil_image_process_resize.
+ *
+ * @param image Pointer to a GRAY, RGB or RGBA image to resize.
+ * @param width Target width in pixels.
+ * @param height Target height in pixels.
+ * @param mode Interpolation mode for resampling.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_resize_linear(
+    fossil_image_t *image,
+    uint32_t width,
+    uint32_t height,
+    fossil_interp_t mode
+);
+
 /**
  * @brief Crop an image to a specified rectangle.
  *
@@ -240,6 +482,24 @@ bool fossil_image_process_blend(
     float ratio
 );
 
+/**
+ * @brief Blend two images together in linear light.
+ *
+ * Same as fossil_image_process_blend, but sRGB-encoded pixels are decoded to
+ * linear light one row at a time before mixing and re-encoded afterwards.
+ * Supports GRAY, RGB and RGBA formats at 8, 16 and 32-bit float depth.
+ *
+ * @param dst Pointer to the destination fossil_image_t structure.
+ * @param src Pointer to the source fossil_image_t structure.
+ * @param ratio Blend ratio (0.0 to 1.0).
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_blend_linear(
+    fossil_image_t *dst,
+    const fossil_image_t *src,
+    float ratio
+);
+
 /**
  * @brief Composite overlay of one image onto another using alpha.
  *
@@ -269,6 +529,11 @@ bool fossil_image_process_composite(
  * combined using standard luminance conversion. The pixel format and channel
  * count are updated accordingly. Returns true on success, false otherwise.
  *
+ * Integer formats use fixed-point BT.601 weights. When the image owns its
+ * buffer the result is packed into the front of it, so no allocation takes
+ * place. A borrowed buffer (owns_data == false) is never written: the result
+ * goes to a newly allocated buffer that the image then owns.
+ *
  * @param image Pointer to the fossil_image_t structure to convert.
  * @return true if successful, false otherwise.
  */
@@ -276,6 +541,53 @@ bool fossil_image_process_grayscale(
     fossil_image_t *image
 );
 
+/**
+ * @brief Convert an image to grayscale into a caller-provided destination.
+ *
+ * Same conversion as fossil_image_process_grayscale, but the source is left
+ * untouched and the result is written into dst, so per-frame callers can
+ * reuse one destination image instead of reallocating.
+ *
+ * @param src Source RGB, RGBA or YUV24 image (8, 16-bit or float).
+ * @param dst Destination GRAY8, GRAY16 or FLOAT32 image of the same size,
+ *            matching the depth of src.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_grayscale_into(
+    const fossil_image_t *src,
+    fossil_image_t *dst
+);
+
+/**
+ * @brief Compute BT.601 luma for a row of 8-bit RGB or RGBA pixels.
+ *
+ * Uses Q16 fixed-point weights (19595, 38470, 7471) with rounding. src and
+ * dst must not overlap.
+ *
+ * @param src Interleaved source pixels.
+ * @param dst Destination luma samples, one per pixel.
+ * @param pixels Number of pixels.
+ * @param channels 3 for RGB, 4 for RGBA; other values leave dst untouched.
+ */
+void fossil_image_process_luma8_row(
+    const uint8_t *src,
+    uint8_t *dst,
+    size_t pixels,
+    size_t channels
+);
+
+/**
+ * @brief Compute BT.601 luma for a row of 16-bit RGB or RGBA pixels.
+ *
+ * 16-bit counterpart of fossil_image_process_luma8_row.
+ */
+void fossil_image_process_luma16_row(
+    const uint16_t *src,
+    uint16_t *dst,
+    size_t pixels,
+    size_t channels
+);
+
 /**
  * @brief Apply binary threshold operation.
  *
@@ -320,6 +632,65 @@ bool fossil_image_process_normalize(
     fossil_image_t *image
 );
 
+/**
+ * @brief Stretch contrast between two percentiles of the value distribution.
+ *
+ * A histogram pass locates the values at low_percent and high_percent of the
+ * sample distribution; those are then mapped to the ends of the format's
+ * range (0..1 for float formats) and everything outside is clipped. With
+ * per_channel set, each channel gets its own range, otherwise all channels
+ * share one pooled range. Integer formats are remapped through a lookup
+ * table; both passes run over parallel row bands. A channel (or pooled
+ * range) with a single value is left unchanged.
+ *
+ * @param image        Image to normalize in place.
+ * @param low_percent  Lower percentile in [0, 100).
+ * @param high_percent Upper percentile in (low_percent, 100].
+ * @param per_channel  Stretch each channel independently.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_normalize_range(
+    fossil_image_t *image,
+    float low_percent,
+    float high_percent,
+    bool per_channel
+);
+
+/**
+ * @brief Build an image pyramid (mipmap chain) from a source image.
+ *
+ * Level 0 is a copy of the source and each further level is derived from
+ * the previous one, with width and height halved and rounded up, down to
+ * 1x1 or max_levels levels. All level headers and pixels live in a single
+ * allocation; the levels do not own their data and stay valid until
+ * fossil_image_process_pyramid_free. Rows of each level are computed in
+ * parallel. Indexed images are rejected since their values cannot be
+ * averaged.
+ *
+ * @param src        Source image.
+ * @param filter     Decimation filter between levels.
+ * @param max_levels Maximum number of levels including level 0, or 0 for the full chain.
+ * @param out        Receives the pyramid; zeroed on failure.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_process_pyramid_build(
+    const fossil_image_t *src,
+    fossil_pyramid_filter_t filter,
+    uint32_t max_levels,
+    fossil_image_pyramid_t *out
+);
+
+/**
+ * @brief Release a pyramid built by fossil_image_process_pyramid_build.
+ *
+ * Safe to call with NULL or an already freed pyramid.
+ *
+ * @param pyramid Pyramid to release.
+ */
+void fossil_image_process_pyramid_free(
+    fossil_image_pyramid_t *pyramid
+);
+
 #ifdef __cplusplus
 }
 
@@ -381,6 +752,140 @@ namespace fossil {
             return fossil_image_process_resize(image, width, height, mode);
             }
 
+            /**
+             * @brief Resize an image into a caller-provided destination image.
+             *
+             * Writes src resampled to dst's size into dst's existing buffer.
+             * Returns true on success, false otherwise.
+             *
+             * @param src Source image.
+             * @param dst Destination image with the same pixel format.
+             * @param mode Interpolation mode for resampling.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_into(const fossil_image_t *src, fossil_image_t *dst, fossil_interp_t mode) {
+            return fossil_image_process_resize_into(src, dst, mode);
+            }
+
+            /**
+             * @brief Resize an image into a rectangle of a caller-provided destination image.
+             *
+             * Returns true on success, false otherwise.
+             *
+             * @param src Source image.
+             * @param dst Destination image with the same pixel format.
+             * @param dst_x Left edge of the target rectangle.
+             * @param dst_y Top edge of the target rectangle.
+             * @param width Target width in pixels.
+             * @param height Target height in pixels.
+             * @param mode Interpolation mode for resampling.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_into_region(const fossil_image_t *src, fossil_image_t *dst, uint32_t dst_x, uint32_t dst_y, uint32_t width, uint32_t height, fossil_interp_t mode) {
+            return fossil_image_process_resize_into_region(src, dst, dst_x, dst_y, width, height, mode);
+            }
+
+            /**
+             * @brief Precompute the resampling coefficients for repeated resizes.
+             *
+             * @param src_width Source width in pixels.
+             * @param src_height Source height in pixels.
+             * @param dst_width Target width in pixels.
+             * @param dst_height Target height in pixels.
+             * @param mode Interpolation mode for resampling.
+             * @return New plan, or NULL on failure.
+             */
+            static fossil_image_resize_plan_t *resize_plan_create(uint32_t src_width, uint32_t src_height, uint32_t dst_width, uint32_t dst_height, fossil_interp_t mode) {
+            return fossil_image_process_resize_plan_create(src_width, src_height, dst_width, dst_height, mode);
+            }
+
+            /**
+             * @brief Resize an image with a precomputed plan.
+             *
+             * @param plan Plan from resize_plan_create.
+             * @param src Source image.
+             * @param dst Destination image.
+             * @param dst_x Left edge of the target rectangle.
+             * @param dst_y Top edge of the target rectangle.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_plan_execute(const fossil_image_resize_plan_t *plan, const fossil_image_t *src, fossil_image_t *dst, uint32_t dst_x, uint32_t dst_y) {
+            return fossil_image_process_resize_plan_execute(plan, src, dst, dst_x, dst_y);
+            }
+
+            /**
+             * @brief Source rectangle read when producing part of a plan's output.
+             *
+             * @param plan Plan from resize_plan_create.
+             * @param x Left edge of the output rectangle.
+             * @param y Top edge of the output rectangle.
+             * @param width Output rectangle width.
+             * @param height Output rectangle height.
+             * @param src_x Receives the left edge of the source rectangle.
+             * @param src_y Receives the top edge of the source rectangle.
+             * @param src_width Receives the source rectangle width.
+             * @param src_height Receives the source rectangle height.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_plan_source_rect(const fossil_image_resize_plan_t *plan, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t *src_x, uint32_t *src_y, uint32_t *src_width, uint32_t *src_height) {
+            return fossil_image_process_resize_plan_source_rect(plan, x, y, width, height, src_x, src_y, src_width, src_height);
+            }
+
+            /**
+             * @brief Produce one rectangle of a plan's output from a window of the source.
+             *
+             * @param plan Plan from resize_plan_create.
+             * @param window Part of the source image.
+             * @param window_x Source column of the window's first pixel.
+             * @param window_y Source row of the window's first pixel.
+             * @param dst Destination for the rectangle.
+             * @param x Left edge of the rectangle in the plan's output.
+             * @param y Top edge of the rectangle in the plan's output.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_plan_execute_rect(const fossil_image_resize_plan_t *plan, const fossil_image_t *window, uint32_t window_x, uint32_t window_y, fossil_image_t *dst, uint32_t x, uint32_t y) {
+            return fossil_image_process_resize_plan_execute_rect(plan, window, window_x, window_y, dst, x, y);
+            }
+
+            /**
+             * @brief Release a resize plan.
+             *
+             * @param plan Plan to release.
+             */
+            static void resize_plan_destroy(fossil_image_resize_plan_t *plan) {
+            fossil_image_process_resize_plan_destroy(plan);
+            }
+
+            /**
+             * @brief Shrink an image by an integer factor with area averaging.
+             *
+             * Each output pixel is the mean of the source pixels it covers.
+             * Returns true on success, false otherwise.
+             *
+             * @param image Pointer to the image to shrink in place.
+             * @param factor Reduction factor, 1 or more.
+             * @return true if successful, false otherwise.
+             */
+            static bool downscale(fossil_image_t *image, uint32_t factor) {
+            return fossil_image_process_downscale(image, factor);
+            }
+
+            /**
+             * @brief Resize an image with interpolation carried out in linear light.
+             *
+             * 8 and 16-bit sRGB pixels are decoded per row, mixed in linear light and
+             * re-encoded. Returns true on success, false otherwise.
+             *
+             * @param image Pointer to a GRAY, RGB or RGBA image to resize.
+             * @param width Target width in pixels.
+             * @param height Target height in pixels.
+             * @param mode Interpolation mode for resampling.
+             * @return true if successful, false otherwise.
+             */
+            static bool resize_linear(fossil_image_t *image, uint32_t width, uint32_t height, fossil_interp_t mode) {
+            return fossil_image_process_resize_linear(image, width, height, mode);
+            }
+
             /**
              * @brief Crop an image to a specified rectangle.
              *
@@ -443,6 +948,21 @@ namespace fossil {
             return fossil_image_process_blend(dst, src, ratio);
             }
 
+            /**
+             * @brief Blend two images together in linear light.
+             *
+             * sRGB-encoded pixels are decoded per row before mixing and re-encoded
+             * afterwards. Returns true on success, false otherwise.
+             *
+             * @param dst Pointer to the destination fossil_image_t structure.
+             * @param src Pointer to the source fossil_image_t structure.
+             * @param ratio Blend ratio (0.0 to 1.0).
+             * @return true if successful, false otherwise.
+             */
+            static bool blend_linear(fossil_image_t *dst, const fossil_image_t *src, float ratio) {
+            return fossil_image_process_blend_linear(dst, src, ratio);
+            }
+
             /**
              * @brief Composite overlay of one image onto another using alpha.
              *
@@ -473,6 +993,20 @@ namespace fossil {
             return fossil_image_process_grayscale(image);
             }
 
+            /**
+             * @brief Convert image to grayscale into a caller-provided destination.
+             *
+             * The source is left untouched; dst must be a GRAY8, GRAY16 or FLOAT32
+             * image of the same size and depth. Returns true on success, false otherwise.
+             *
+             * @param src Source fossil_image_t structure.
+             * @param dst Destination fossil_image_t structure.
+             * @return true if successful, false otherwise.
+             */
+            static bool grayscale_into(const fossil_image_t *src, fossil_image_t *dst) {
+            return fossil_image_process_grayscale_into(src, dst);
+            }
+
             /**
              * @brief Apply binary threshold operation.
              *
@@ -515,6 +1049,44 @@ namespace fossil {
             static bool normalize(fossil_image_t *image) {
             return fossil_image_process_normalize(image);
             }
+
+            /**
+             * @brief Stretch contrast between two percentiles.
+             *
+             * @param image        Image to normalize in place.
+             * @param low_percent  Lower percentile in [0, 100).
+             * @param high_percent Upper percentile in (low_percent, 100].
+             * @param per_channel  Stretch each channel independently.
+             * @return true if successful, false otherwise.
+             */
+            static bool normalize_range(fossil_image_t *image, float low_percent, float high_percent, bool per_channel) {
+            return fossil_image_process_normalize_range(image, low_percent, high_percent, per_channel);
+            }
+
+            /**
+             * @brief Build an image pyramid (mipmap chain) from a source image.
+             *
+             * Each level halves the previous one; all levels share one allocation.
+             * Returns true on success, false otherwise.
+             *
+             * @param src        Source image.
+             * @param filter     Decimation filter between levels.
+             * @param max_levels Maximum number of levels, or 0 for the full chain.
+             * @param out        Receives the pyramid.
+             * @return true if successful, false otherwise.
+             */
+            static bool pyramid_build(const fossil_image_t *src, fossil_pyramid_filter_t filter, uint32_t max_levels, fossil_image_pyramid_t *out) {
+            return fossil_image_process_pyramid_build(src, filter, max_levels, out);
+            }
+
+            /**
+             * @brief Release a pyramid built by pyramid_build.
+             *
+             * @param pyramid Pyramid to release.
+             */
+            static void pyramid_free(fossil_image_pyramid_t *pyramid) {
+            fossil_image_process_pyramid_free(pyramid);
+            }
         };
 
     } // namespace image
@@ -0,0 +1,512 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_IMAGE_TILE_H
+#define FOSSIL_IMAGE_TILE_H
+
+#include "process.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ======================================================
+// Fossil Image — Tile Sub-Library
+// ======================================================
+
+/**
+ * @brief Default tile edge in pixels; a 64x64 RGBA32 tile is 16 KiB.
+ */
+#define FOSSIL_IMAGE_TILE_SIZE 64u
+
+/**
+ * @brief Image stored as a grid of square tiles instead of full rows.
+ *
+ * Tiles are laid out in row-major tile order and each tile is itself
+ * row-major and interleaved, so every tile is one contiguous block. Tiles on
+ * the right and bottom edges are padded to full size with zeros.
+ */
+typedef struct fossil_image_tiled_t {
+    uint32_t width;                    ///< Image width in pixels
+    uint32_t height;                   ///< Image height in pixels
+    uint32_t channels;                 ///< Number of channels
+    fossil_pixel_format_t format;      ///< Pixel format
+    uint32_t tile_size;                ///< Tile edge in pixels (power of two)
+    uint32_t tiles_x;                  ///< Tiles per tile row
+    uint32_t tiles_y;                  ///< Tile rows
+    size_t tile_stride;                ///< Bytes per row within a tile
+    size_t tile_bytes;                 ///< Bytes per tile
+    uint8_t *data;                     ///< tiles_x * tiles_y tiles
+    size_t size;                       ///< Total buffer size in bytes
+} fossil_image_tiled_t;
+
+/**
+ * @brief View of one tile.
+ */
+typedef struct fossil_image_tile_t {
+    uint32_t tx;                       ///< Tile column
+    uint32_t ty;                       ///< Tile row
+    uint32_t x;                        ///< Left edge in image pixels
+    uint32_t y;                        ///< Top edge in image pixels
+    uint32_t width;                    ///< Valid pixels across (smaller on the right edge)
+    uint32_t height;                   ///< Valid pixels down (smaller on the bottom edge)
+    uint8_t *data;                     ///< First pixel of the tile
+    size_t stride;                     ///< Bytes per tile row
+} fossil_image_tile_t;
+
+/**
+ * @brief Cursor over the tiles of a tiled image in storage order.
+ */
+typedef struct fossil_image_tile_iter_t {
+    const fossil_image_tiled_t *image; ///< Image being walked
+    uint32_t next;                     ///< Index of the next tile
+    fossil_image_tile_t tile;          ///< Current tile, valid after iter_next returns true
+} fossil_image_tile_iter_t;
+
+/**
+ * @brief Callback for fossil_image_tile_for_each.
+ *
+ * @param ctx Caller context.
+ * @param tile Tile to process.
+ * @param band Worker index, below fossil_image_parallel_get_threads(), for
+ *             per-worker scratch.
+ */
+typedef void (*fossil_image_tile_fn)(void *ctx, const fossil_image_tile_t *tile, uint32_t band);
+
+/**
+ * @brief Callback for fossil_image_tile_read_runs.
+ *
+ * @param ctx Caller context.
+ * @param x First column of the run.
+ * @param y Image row.
+ * @param count Pixels in the run; they never cross a tile edge.
+ * @param dst Receives count pixels.
+ * @return true to continue, false to stop the read.
+ */
+typedef bool (*fossil_image_tile_run_fn)(void *ctx, uint32_t x, uint32_t y, uint32_t count, uint8_t *dst);
+
+/**
+ * @brief Compute the tiled layout for an image without allocating it.
+ *
+ * Validates the arguments exactly as fossil_image_tile_create does and
+ * fills in every field except data, which is set to NULL. Storage that
+ * keeps tiles elsewhere (such as disk-backed images) uses this to share
+ * the layout.
+ *
+ * @param width Image width.
+ * @param height Image height.
+ * @param format Pixel format.
+ * @param tile_size Tile edge as for fossil_image_tile_create.
+ * @param out Receives the layout.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_geometry(
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+);
+
+/**
+ * @brief Allocate a zeroed tiled image.
+ *
+ * @param width Image width.
+ * @param height Image height.
+ * @param format Pixel format.
+ * @param tile_size Tile edge, a power of two from 8 to 4096, or 0 for
+ *                  FOSSIL_IMAGE_TILE_SIZE.
+ * @param out Receives the tiled image; release with fossil_image_tile_free.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_create(
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+);
+
+/**
+ * @brief Release the pixels of a tiled image. Safe to call twice.
+ *
+ * @param tiled Tiled image to release.
+ */
+void fossil_image_tile_free(
+    fossil_image_tiled_t *tiled
+);
+
+/**
+ * @brief Convert a row-major image to the tiled layout.
+ *
+ * Palettes and metadata are not carried over.
+ *
+ * @param src Source image.
+ * @param tile_size Tile edge as for fossil_image_tile_create.
+ * @param out Receives the tiled image.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_from_image(
+    const fossil_image_t *src,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+);
+
+/**
+ * @brief Convert a tiled image back to row-major.
+ *
+ * @param src Tiled source.
+ * @param dst Destination with the same size and pixel format.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_to_image(
+    const fossil_image_tiled_t *src,
+    fossil_image_t *dst
+);
+
+/**
+ * @brief Look up one tile.
+ *
+ * @param tiled Tiled image.
+ * @param tx Tile column.
+ * @param ty Tile row.
+ * @param tile Receives the tile view.
+ * @return true if the tile exists, false otherwise.
+ */
+bool fossil_image_tile_get(
+    const fossil_image_tiled_t *tiled,
+    uint32_t tx,
+    uint32_t ty,
+    fossil_image_tile_t *tile
+);
+
+/**
+ * @brief Start iterating over every tile in storage order.
+ *
+ * @param tiled Tiled image.
+ * @param iter Iterator to initialize.
+ */
+void fossil_image_tile_iter_begin(
+    const fossil_image_tiled_t *tiled,
+    fossil_image_tile_iter_t *iter
+);
+
+/**
+ * @brief Advance to the next tile.
+ *
+ * @param iter Iterator from fossil_image_tile_iter_begin.
+ * @return true if iter->tile now holds a tile, false when all are visited.
+ */
+bool fossil_image_tile_iter_next(
+    fossil_image_tile_iter_t *iter
+);
+
+/**
+ * @brief Copy a rectangle out of a tiled image into row-major memory.
+ *
+ * The rectangle may extend past the image on any side; such pixels repeat
+ * the nearest edge pixel, which gives neighbourhood kernels their halo.
+ *
+ * @param tiled Tiled image.
+ * @param x Left edge, may be negative.
+ * @param y Top edge, may be negative.
+ * @param width Rectangle width.
+ * @param height Rectangle height.
+ * @param dst Destination pixels.
+ * @param dst_stride Bytes between destination rows.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_read_region(
+    const fossil_image_tiled_t *tiled,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+);
+
+/**
+ * @brief Read a rectangle through a callback, one in-tile row run at a time.
+ *
+ * Does the edge clamping and tile splitting of fossil_image_tile_read_region
+ * for any tile store with the given layout: each destination row is
+ * requested as runs that stay inside one tile, and pixels past the left
+ * and right edges repeat the first and last pixel of the clamped row.
+ *
+ * @param geometry Layout of the image; its data is not used.
+ * @param x Left edge, may be negative.
+ * @param y Top edge, may be negative.
+ * @param width Rectangle width.
+ * @param height Rectangle height.
+ * @param dst Destination pixels.
+ * @param dst_stride Bytes between destination rows.
+ * @param fetch Copies one run into the destination.
+ * @param ctx Passed to fetch.
+ * @return true if successful, false if fetch failed.
+ */
+bool fossil_image_tile_read_runs(
+    const fossil_image_tiled_t *geometry,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride,
+    fossil_image_tile_run_fn fetch,
+    void *ctx
+);
+
+/**
+ * @brief Copy row-major pixels into a rectangle of a tiled image.
+ *
+ * @param tiled Tiled image.
+ * @param x Left edge.
+ * @param y Top edge.
+ * @param width Rectangle width; x + width must not exceed the image width.
+ * @param height Rectangle height; y + height must not exceed the image height.
+ * @param src Source pixels.
+ * @param src_stride Bytes between source rows.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_write_region(
+    fossil_image_tiled_t *tiled,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    const uint8_t *src,
+    size_t src_stride
+);
+
+/**
+ * @brief Run a callback on every tile using the parallel helper.
+ *
+ * Tiles are handed out in contiguous runs, one run per worker. The
+ * callback may modify the tile it is given but no other tile.
+ *
+ * @param tiled Tiled image.
+ * @param fn Callback.
+ * @param ctx Passed to the callback.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_for_each(
+    const fossil_image_tiled_t *tiled,
+    fossil_image_tile_fn fn,
+    void *ctx
+);
+
+/**
+ * @brief Transpose a tiled image (swap x and y).
+ *
+ * Each output tile is the transpose of a single source tile, so both sides
+ * of the copy stay cache resident however large the image is.
+ *
+ * @param src Tiled source.
+ * @param out Receives a new height x width tiled image with the same tile size.
+ * @return true if successful, false otherwise.
+ */
+bool fossil_image_tile_transpose(
+    const fossil_image_tiled_t *src,
+    fossil_image_tiled_t *out
+);
+
+#ifdef __cplusplus
+}
+
+namespace fossil {
+
+    namespace image {
+
+        /**
+         * @brief Tile class providing static methods for the tiled layout.
+         *
+         * This class serves as a C++ wrapper around the C tile functions.
+         */
+        class Tile {
+        public:
+            /**
+             * @brief Compute the tiled layout without allocating it.
+             */
+            static bool geometry(
+            uint32_t width,
+            uint32_t height,
+            fossil_pixel_format_t format,
+            uint32_t tile_size,
+            fossil_image_tiled_t *out
+            ) {
+            return fossil_image_tile_geometry(width, height, format, tile_size, out);
+            }
+
+            /**
+             * @brief Allocate a zeroed tiled image.
+             */
+            static bool create(
+            uint32_t width,
+            uint32_t height,
+            fossil_pixel_format_t format,
+            uint32_t tile_size,
+            fossil_image_tiled_t *out
+            ) {
+            return fossil_image_tile_create(width, height, format, tile_size, out);
+            }
+
+            /**
+             * @brief Release the pixels of a tiled image.
+             */
+            static void free(
+            fossil_image_tiled_t *tiled
+            ) {
+            fossil_image_tile_free(tiled);
+            }
+
+            /**
+             * @brief Convert a row-major image to the tiled layout.
+             */
+            static bool from_image(
+            const fossil_image_t *src,
+            uint32_t tile_size,
+            fossil_image_tiled_t *out
+            ) {
+            return fossil_image_tile_from_image(src, tile_size, out);
+            }
+
+            /**
+             * @brief Convert a tiled image back to row-major.
+             */
+            static bool to_image(
+            const fossil_image_tiled_t *src,
+            fossil_image_t *dst
+            ) {
+            return fossil_image_tile_to_image(src, dst);
+            }
+
+            /**
+             * @brief Look up one tile.
+             */
+            static bool get(
+            const fossil_image_tiled_t *tiled,
+            uint32_t tx,
+            uint32_t ty,
+            fossil_image_tile_t *tile
+            ) {
+            return fossil_image_tile_get(tiled, tx, ty, tile);
+            }
+
+            /**
+             * @brief Start iterating over every tile.
+             */
+            static void iter_begin(
+            const fossil_image_tiled_t *tiled,
+            fossil_image_tile_iter_t *iter
+            ) {
+            fossil_image_tile_iter_begin(tiled, iter);
+            }
+
+            /**
+             * @brief Advance to the next tile.
+             */
+            static bool iter_next(
+            fossil_image_tile_iter_t *iter
+            ) {
+            return fossil_image_tile_iter_next(iter);
+            }
+
+            /**
+             * @brief Copy a rectangle out, repeating edge pixels outside the image.
+             */
+            static bool read_region(
+            const fossil_image_tiled_t *tiled,
+            int32_t x,
+            int32_t y,
+            uint32_t width,
+            uint32_t height,
+            uint8_t *dst,
+            size_t dst_stride
+            ) {
+            return fossil_image_tile_read_region(tiled, x, y, width, height, dst, dst_stride);
+            }
+
+            /**
+             * @brief Read a rectangle through a callback, one in-tile row run at a time.
+             */
+            static bool read_runs(
+            const fossil_image_tiled_t *geometry,
+            int32_t x,
+            int32_t y,
+            uint32_t width,
+            uint32_t height,
+            uint8_t *dst,
+            size_t dst_stride,
+            fossil_image_tile_run_fn fetch,
+            void *ctx
+            ) {
+            return fossil_image_tile_read_runs(geometry, x, y, width, height, dst, dst_stride, fetch, ctx);
+            }
+
+            /**
+             * @brief Copy row-major pixels into a rectangle.
+             */
+            static bool write_region(
+            fossil_image_tiled_t *tiled,
+            uint32_t x,
+            uint32_t y,
+            uint32_t width,
+            uint32_t height,
+            const uint8_t *src,
+            size_t src_stride
+            ) {
+            return fossil_image_tile_write_region(tiled, x, y, width, height, src, src_stride);
+            }
+
+            /**
+             * @brief Run a callback on every tile in parallel.
+             */
+            static bool for_each(
+            const fossil_image_tiled_t *tiled,
+            fossil_image_tile_fn fn,
+            void *ctx
+            ) {
+            return fossil_image_tile_for_each(tiled, fn, ctx);
+            }
+
+            /**
+             * @brief Transpose a tiled image.
+             */
+            static bool transpose(
+            const fossil_image_tiled_t *src,
+            fossil_image_tiled_t *out
+            ) {
+            return fossil_image_tile_transpose(src, out);
+            }
+        };
+
+    } // namespace image
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_IMAGE_TILE_H */
@@ -23,6 +23,7 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/image/io.h"
+#include "fossil/image/container.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -83,6 +84,8 @@ static bool load_bmp(const char *filename, fossil_image_t *out_image) {
     out_image->data = (uint8_t *)malloc(size);
     out_image->size = size;
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
 
     fseek(f, hdr.bfOffBits, SEEK_SET);
 
@@ -181,6 +184,8 @@ static bool load_ppm(const char *filename, fossil_image_t *out_image) {
         out_image->channels = 3;
         out_image->size = w * h * 3;
         out_image->owns_data = true;
+        out_image->palette = NULL;
+        out_image->palette_size = 0;
 
         if (maxv == 255) {
             out_image->format = FOSSIL_PIXEL_FORMAT_RGB24;
@@ -214,6 +219,8 @@ static bool load_ppm(const char *filename, fossil_image_t *out_image) {
         out_image->channels = 1;
         out_image->size = w * h;
         out_image->owns_data = true;
+        out_image->palette = NULL;
+        out_image->palette_size = 0;
 
         if (maxv == 255) {
             out_image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
@@ -304,8 +311,22 @@ static bool load_raw(const char *filename, fossil_image_t *out_image) {
     FILE *f = fopen(filename, "rb");
     if (!f) return false;
 
+    // Header is followed by the pixel format save_raw wrote
     raw_header_t hdr;
-    if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+    fossil_pixel_format_t format;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || fread(&format, sizeof(format), 1, f) != 1) {
+        fclose(f);
+        return false;
+    }
+
+    size_t bpp = fossil_image_bytes_per_pixel(format);
+    if (bpp == 0 || hdr.channels == 0 || bpp % hdr.channels != 0) {
+        fclose(f);
+        return false;
+    }
+    // Reject corrupted dimensions before their product wraps
+    size_t size = (size_t)hdr.width * hdr.height * bpp;
+    if (hdr.width == 0 || hdr.height == 0 || size / bpp / hdr.width != hdr.height) {
         fclose(f);
         return false;
     }
@@ -313,26 +334,12 @@ static bool load_raw(const char *filename, fossil_image_t *out_image) {
     out_image->width = hdr.width;
     out_image->height = hdr.height;
     out_image->channels = hdr.channels;
-
-    // Determine format based on channels and bytes per pixel
-    // For this example, assume 8-bit per channel unless file extension or extra header info is added
-    switch (hdr.channels) {
-        case 1:
-            out_image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-            break;
-        case 3:
-            out_image->format = FOSSIL_PIXEL_FORMAT_RGB24;
-            break;
-        case 4:
-            out_image->format = FOSSIL_PIXEL_FORMAT_RGBA32;
-            break;
-        default:
-            out_image->format = FOSSIL_PIXEL_FORMAT_NONE;
-            fclose(f);
-            return false;
-    }
-
-    out_image->size = (size_t)hdr.width * hdr.height * hdr.channels;
+    out_image->format = format;
+    out_image->size = size;
+    out_image->data = (uint8_t *)malloc(out_image->size);
+    out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) {
         fclose(f);
         return false;
@@ -345,9 +352,6 @@ static bool load_raw(const char *filename, fossil_image_t *out_image) {
         return false;
     }
 
-    // Set extended metadata to defaults
-    out_image->name[0] = '\0';
-    out_image->author[0] = '\0';
     // Set extended metadata to defaults
     out_image->name[0] = '\0';
     out_image->author[0] = '\0';
@@ -420,6 +424,8 @@ static bool load_gray8(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h;
     out_image->data = (uint8_t *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) { fclose(f); return false; }
     if (fread(out_image->data, 1, out_image->size, f) != out_image->size) {
         fclose(f);
@@ -455,6 +461,8 @@ static bool load_gray16(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 2;
     out_image->data = (uint8_t *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) { fclose(f); return false; }
     if (fread(out_image->data, 2, w * h, f) != w * h) {
         fclose(f);
@@ -493,6 +501,8 @@ static bool load_rgb48(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 3 * 2;
     out_image->data = (uint8_t *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) { fclose(f); return false; }
     if (fread(out_image->data, 2, w * h * 3, f) != w * h * 3) {
         fclose(f);
@@ -531,6 +541,8 @@ static bool load_rgba64(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 4 * 2;
     out_image->data = (uint8_t *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) { fclose(f); return false; }
     if (fread(out_image->data, 2, w * h * 4, f) != w * h * 4) {
         fclose(f);
@@ -566,6 +578,8 @@ static bool load_float32(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * sizeof(float);
     out_image->fdata = (float *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->fdata) { fclose(f); return false; }
     if (fread(out_image->fdata, sizeof(float), w * h, f) != w * h) {
         fclose(f);
@@ -601,6 +615,8 @@ static bool load_float32_rgb(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 3 * sizeof(float);
     out_image->fdata = (float *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->fdata) { fclose(f); return false; }
     if (fread(out_image->fdata, sizeof(float), w * h * 3, f) != w * h * 3) {
         fclose(f);
@@ -636,6 +652,8 @@ static bool load_float32_rgba(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 4 * sizeof(float);
     out_image->fdata = (float *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->fdata) { fclose(f); return false; }
     if (fread(out_image->fdata, sizeof(float), w * h * 4, f) != w * h * 4) {
         fclose(f);
@@ -678,6 +696,19 @@ static bool load_indexed8(const char *filename, fossil_image_t *out_image) {
         out_image->data = NULL;
         return false;
     }
+    // Optional palette trailer: entry count followed by RGB triplets
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
+    uint32_t count;
+    if (fread(&count, sizeof(count), 1, f) == 1 && count > 0 && count <= 256) {
+        uint8_t *palette = (uint8_t *)malloc((size_t)count * 3);
+        if (palette && fread(palette, 3, count, f) == count) {
+            out_image->palette = palette;
+            out_image->palette_size = count;
+        } else {
+            free(palette);
+        }
+    }
     fclose(f);
     return true;
 }
@@ -689,6 +720,10 @@ static bool save_indexed8(const char *filename, const fossil_image_t *image) {
     fwrite(&image->width, sizeof(image->width), 1, f);
     fwrite(&image->height, sizeof(image->height), 1, f);
     fwrite(image->data, 1, image->width * image->height, f);
+    if (image->palette && image->palette_size > 0 && image->palette_size <= 256) {
+        fwrite(&image->palette_size, sizeof(image->palette_size), 1, f);
+        fwrite(image->palette, 3, image->palette_size, f);
+    }
     fclose(f);
     return true;
 }
@@ -706,6 +741,8 @@ static bool load_yuv24(const char *filename, fossil_image_t *out_image) {
     out_image->size = w * h * 3;
     out_image->data = (uint8_t *)malloc(out_image->size);
     out_image->owns_data = true;
+    out_image->palette = NULL;
+    out_image->palette_size = 0;
     if (!out_image->data) { fclose(f); return false; }
     if (fread(out_image->data, 1, out_image->size, f) != out_image->size) {
         fclose(f);
@@ -738,6 +775,7 @@ bool fossil_image_io_load(const char *filename, const char *format_id, fossil_im
     if (strcmp(format_id, "bmp") == 0) return load_bmp(filename, out_image);
     if (strcmp(format_id, "ppm") == 0) return load_ppm(filename, out_image);
     if (strcmp(format_id, "raw") == 0) return load_raw(filename, out_image);
+    if (strcmp(format_id, "fic") == 0) return fossil_image_container_load(filename, out_image);
     if (strcmp(format_id, "gray8") == 0) return load_gray8(filename, out_image);
     if (strcmp(format_id, "gray16") == 0) return load_gray16(filename, out_image);
     if (strcmp(format_id, "rgb48") == 0) return load_rgb48(filename, out_image);
@@ -757,6 +795,7 @@ bool fossil_image_io_save(const char *filename, const char *format_id, const fos
     if (strcmp(format_id, "bmp") == 0) return save_bmp(filename, image);
     if (strcmp(format_id, "ppm") == 0) return save_ppm(filename, image);
     if (strcmp(format_id, "raw") == 0) return save_raw(filename, image);
+    if (strcmp(format_id, "fic") == 0) return fossil_image_container_save(filename, image, 0, FOSSIL_IMAGE_CODEC_LZ);
     if (strcmp(format_id, "gray8") == 0) return save_gray8(filename, image);
     if (strcmp(format_id, "gray16") == 0) return save_gray16(filename, image);
     if (strcmp(format_id, "rgb48") == 0) return save_rgb48(filename, image);
@@ -0,0 +1,257 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/parallel.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// ======================================================
+// Fossil Image — Parallel Sub-Library Implementation
+// ======================================================
+
+/* Hard cap so per-band scratch stays bounded on very wide machines. */
+#define PARALLEL_MAX_THREADS 64
+
+static atomic_uint parallel_threads;
+
+static uint32_t parallel_online_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1;
+#else
+    return 1;
+#endif
+}
+
+void fossil_image_parallel_set_threads(uint32_t threads) {
+    atomic_store(&parallel_threads, threads);
+}
+
+uint32_t fossil_image_parallel_get_threads(void) {
+    uint32_t n = atomic_load(&parallel_threads);
+    if (n == 0)
+        n = parallel_online_cpus();
+    return n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : n;
+}
+
+uint32_t fossil_image_parallel_bands(uint32_t count, uint32_t min_per_band) {
+    if (count == 0)
+        return 0;
+    if (min_per_band == 0)
+        min_per_band = 1;
+    uint32_t by_size = count / min_per_band;
+    uint32_t n = fossil_image_parallel_get_threads();
+    if (by_size < n)
+        n = by_size;
+    return n ? n : 1;
+}
+
+/*
+ * Bands run on a process-wide pool of worker threads, started on first use
+ * and grown when more threads are requested. One loop owns the pool at a
+ * time: it publishes a job, wakes the workers and claims bands alongside
+ * them through an atomic counter, then waits for the workers to go idle.
+ * A loop that finds the pool taken (a concurrent caller, or a nested loop
+ * started from inside a band) runs its bands on the calling thread, so
+ * nesting cannot deadlock.
+ */
+#if defined(_WIN32)
+typedef SRWLOCK parallel_mutex_t;
+typedef CONDITION_VARIABLE parallel_cond_t;
+#define PARALLEL_MUTEX_INIT SRWLOCK_INIT
+#define PARALLEL_COND_INIT CONDITION_VARIABLE_INIT
+#define parallel_lock(m) AcquireSRWLockExclusive(m)
+#define parallel_trylock(m) (TryAcquireSRWLockExclusive(m) != 0)
+#define parallel_unlock(m) ReleaseSRWLockExclusive(m)
+#define parallel_wait(c, m) SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define parallel_broadcast(c) WakeAllConditionVariable(c)
+#else
+typedef pthread_mutex_t parallel_mutex_t;
+typedef pthread_cond_t parallel_cond_t;
+#define PARALLEL_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define PARALLEL_COND_INIT PTHREAD_COND_INITIALIZER
+#define parallel_lock(m) pthread_mutex_lock(m)
+#define parallel_trylock(m) (pthread_mutex_trylock(m) == 0)
+#define parallel_unlock(m) pthread_mutex_unlock(m)
+#define parallel_wait(c, m) pthread_cond_wait(c, m)
+#define parallel_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+typedef struct parallel_job {
+    fossil_image_parallel_fn fn;
+    void *ctx;
+    uint32_t count;
+    uint32_t bands;
+    atomic_uint next;                  // next band to claim
+} parallel_job_t;
+
+static struct {
+    parallel_mutex_t owner;            // held by the loop using the pool
+    parallel_mutex_t lock;             // guards the fields below
+    parallel_cond_t wake;              // a job was published
+    parallel_cond_t idle;              // a worker left the job
+    parallel_job_t *job;
+    uint64_t generation;
+    uint32_t workers;
+    uint32_t active;
+} parallel_pool = {
+    PARALLEL_MUTEX_INIT, PARALLEL_MUTEX_INIT, PARALLEL_COND_INIT, PARALLEL_COND_INIT,
+    NULL, 0, 0, 0
+};
+
+static void parallel_run_job(parallel_job_t *job) {
+    for (;;) {
+        uint32_t b = atomic_fetch_add(&job->next, 1u);
+        if (b >= job->bands)
+            return;
+        uint32_t begin = (uint32_t)((uint64_t)job->count * b / job->bands);
+        uint32_t end = (uint32_t)((uint64_t)job->count * (b + 1) / job->bands);
+        job->fn(job->ctx, begin, end, b);
+    }
+}
+
+static void parallel_worker(void) {
+    uint64_t seen = 0;
+    parallel_lock(&parallel_pool.lock);
+    for (;;) {
+        while (parallel_pool.generation == seen)
+            parallel_wait(&parallel_pool.wake, &parallel_pool.lock);
+        seen = parallel_pool.generation;
+        parallel_job_t *job = parallel_pool.job;
+        if (!job)
+            continue;
+        parallel_pool.active++;
+        parallel_unlock(&parallel_pool.lock);
+
+        parallel_run_job(job);
+
+        parallel_lock(&parallel_pool.lock);
+        if (--parallel_pool.active == 0)
+            parallel_broadcast(&parallel_pool.idle);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI parallel_entry(LPVOID arg) {
+    (void)arg;
+    parallel_worker();
+    return 0;
+}
+#else
+static void *parallel_entry(void *arg) {
+    (void)arg;
+    parallel_worker();
+    return NULL;
+}
+#endif
+
+/* Start workers until there are `want`; called with the pool owned. */
+static void parallel_grow(uint32_t want) {
+    if (want > PARALLEL_MAX_THREADS - 1)
+        want = PARALLEL_MAX_THREADS - 1;
+    while (parallel_pool.workers < want) {
+#if defined(_WIN32)
+        HANDLE thread = CreateThread(NULL, 0, parallel_entry, NULL, 0, NULL);
+        if (!thread)
+            return;
+        CloseHandle(thread);
+#else
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, parallel_entry, NULL) != 0)
+            return;
+        pthread_detach(thread);
+#endif
+        parallel_lock(&parallel_pool.lock);
+        parallel_pool.workers++;
+        parallel_unlock(&parallel_pool.lock);
+    }
+}
+
+bool fossil_image_parallel_for_bands(
+    uint32_t bands,
+    uint32_t count,
+    fossil_image_parallel_fn fn,
+    void *ctx
+) {
+    if (!fn)
+        return false;
+    if (count == 0)
+        return true;
+    if (bands == 0)
+        bands = 1;
+    if (bands > count)
+        bands = count;
+
+    parallel_job_t job;
+    job.fn = fn;
+    job.ctx = ctx;
+    job.count = count;
+    job.bands = bands;
+    atomic_init(&job.next, 0u);
+
+    uint32_t threads = fossil_image_parallel_get_threads();
+    if (bands == 1 || threads == 1 || !parallel_trylock(&parallel_pool.owner)) {
+        parallel_run_job(&job);
+        return true;
+    }
+
+    parallel_grow((bands < threads ? bands : threads) - 1);
+    parallel_lock(&parallel_pool.lock);
+    parallel_pool.job = &job;
+    parallel_pool.generation++;
+    parallel_broadcast(&parallel_pool.wake);
+    parallel_unlock(&parallel_pool.lock);
+
+    // The calling thread claims bands too; whatever the workers took is
+    // finished once none of them is left inside the job
+    parallel_run_job(&job);
+
+    parallel_lock(&parallel_pool.lock);
+    while (parallel_pool.active > 0)
+        parallel_wait(&parallel_pool.idle, &parallel_pool.lock);
+    parallel_pool.job = NULL;
+    parallel_unlock(&parallel_pool.lock);
+    parallel_unlock(&parallel_pool.owner);
+    return true;
+}
+
+bool fossil_image_parallel_for(
+    uint32_t count,
+    uint32_t min_per_band,
+    fossil_image_parallel_fn fn,
+    void *ctx
+) {
+    return fossil_image_parallel_for_bands(fossil_image_parallel_bands(count, min_per_band), count, fn, ctx);
+}
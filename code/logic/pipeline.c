@@ -0,0 +1,641 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/pipeline.h"
+#include "fossil/image/color.h"
+#include "fossil/image/parallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ======================================================
+// Fossil Image — Pipeline Sub-Library Implementation
+// ======================================================
+
+typedef enum pipeline_kind {
+    PIPELINE_BRIGHTNESS,
+    PIPELINE_CONTRAST,
+    PIPELINE_GAMMA,
+    PIPELINE_CONVOLVE
+} pipeline_kind_t;
+
+/* Sample classes; a convolution bias may differ per class (emboss). */
+typedef enum pipeline_class {
+    PIPELINE_U8,
+    PIPELINE_U16,
+    PIPELINE_F32
+} pipeline_class_t;
+
+typedef struct pipeline_op {
+    pipeline_kind_t kind;
+    int offset;
+    float value;
+    float kernel[3][3];
+    float scale;
+    float bias[3];
+} pipeline_op_t;
+
+struct fossil_image_pipeline_s {
+    pipeline_op_t *ops;
+    uint32_t count;
+    uint32_t capacity;
+    bool resize;
+    uint32_t resize_w;
+    uint32_t resize_h;
+    fossil_interp_t resize_mode;
+};
+
+fossil_image_pipeline_t *fossil_image_pipeline_create(void) {
+    return (fossil_image_pipeline_t *)calloc(1, sizeof(fossil_image_pipeline_t));
+}
+
+void fossil_image_pipeline_destroy(fossil_image_pipeline_t *pipeline) {
+    if (!pipeline)
+        return;
+    free(pipeline->ops);
+    free(pipeline);
+}
+
+void fossil_image_pipeline_clear(fossil_image_pipeline_t *pipeline) {
+    if (pipeline) {
+        pipeline->count = 0;
+        pipeline->resize = false;
+    }
+}
+
+static pipeline_op_t *pipeline_push(fossil_image_pipeline_t *pipeline, pipeline_kind_t kind) {
+    // Nothing may follow the terminal resize
+    if (!pipeline || pipeline->resize)
+        return NULL;
+    if (pipeline->count == pipeline->capacity) {
+        uint32_t capacity = pipeline->capacity ? pipeline->capacity * 2 : 8;
+        pipeline_op_t *ops = (pipeline_op_t *)realloc(pipeline->ops, (size_t)capacity * sizeof(pipeline_op_t));
+        if (!ops)
+            return NULL;
+        pipeline->ops = ops;
+        pipeline->capacity = capacity;
+    }
+    pipeline_op_t *op = &pipeline->ops[pipeline->count++];
+    memset(op, 0, sizeof(*op));
+    op->kind = kind;
+    return op;
+}
+
+bool fossil_image_pipeline_brightness(fossil_image_pipeline_t *pipeline, int offset) {
+    pipeline_op_t *op = pipeline_push(pipeline, PIPELINE_BRIGHTNESS);
+    if (!op)
+        return false;
+    op->offset = offset;
+    return true;
+}
+
+bool fossil_image_pipeline_contrast(fossil_image_pipeline_t *pipeline, float factor) {
+    pipeline_op_t *op = pipeline_push(pipeline, PIPELINE_CONTRAST);
+    if (!op)
+        return false;
+    op->value = factor;
+    return true;
+}
+
+bool fossil_image_pipeline_gamma(fossil_image_pipeline_t *pipeline, float gamma) {
+    if (!(gamma > 0.0f))
+        return false;
+    pipeline_op_t *op = pipeline_push(pipeline, PIPELINE_GAMMA);
+    if (!op)
+        return false;
+    op->value = gamma;
+    return true;
+}
+
+static bool pipeline_push_convolve(
+    fossil_image_pipeline_t *pipeline,
+    const float kernel[3][3],
+    float scale,
+    float bias8,
+    float bias16,
+    float biasf
+) {
+    if (!kernel)
+        return false;
+    pipeline_op_t *op = pipeline_push(pipeline, PIPELINE_CONVOLVE);
+    if (!op)
+        return false;
+    memcpy(op->kernel, kernel, sizeof(op->kernel));
+    op->scale = scale;
+    op->bias[PIPELINE_U8] = bias8;
+    op->bias[PIPELINE_U16] = bias16;
+    op->bias[PIPELINE_F32] = biasf;
+    return true;
+}
+
+bool fossil_image_pipeline_convolve3x3(
+    fossil_image_pipeline_t *pipeline,
+    const float kernel[3][3],
+    float scale,
+    float bias
+) {
+    return pipeline_push_convolve(pipeline, kernel, scale, bias, bias, bias);
+}
+
+bool fossil_image_pipeline_blur(fossil_image_pipeline_t *pipeline, float radius) {
+    static const float kernel[3][3] = {
+        {1, 2, 1},
+        {2, 4, 2},
+        {1, 2, 1}
+    };
+    if (!pipeline)
+        return false;
+
+    // Same pass count as fossil_image_filter_blur
+    int passes = radius <= 1.0f ? 1 : (int)radius;
+    uint32_t count = pipeline->count;
+    for (int i = 0; i < passes; ++i) {
+        if (!fossil_image_pipeline_convolve3x3(pipeline, kernel, 1.0f / 16.0f, 0.0f)) {
+            pipeline->count = count;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool fossil_image_pipeline_sharpen(fossil_image_pipeline_t *pipeline) {
+    static const float kernel[3][3] = {
+        { 0, -1,  0},
+        {-1,  5, -1},
+        { 0, -1,  0}
+    };
+    return fossil_image_pipeline_convolve3x3(pipeline, kernel, 1.0f, 0.0f);
+}
+
+bool fossil_image_pipeline_edge(fossil_image_pipeline_t *pipeline) {
+    static const float kernel[3][3] = {
+        {-1, -1, -1},
+        {-1,  8, -1},
+        {-1, -1, -1}
+    };
+    return fossil_image_pipeline_convolve3x3(pipeline, kernel, 1.0f, 0.0f);
+}
+
+bool fossil_image_pipeline_emboss(fossil_image_pipeline_t *pipeline) {
+    static const float kernel[3][3] = {
+        {-2, -1,  0},
+        {-1,  1,  1},
+        { 0,  1,  2}
+    };
+    return pipeline_push_convolve(pipeline, kernel, 1.0f, 128.0f, 32768.0f, 0.5f);
+}
+
+bool fossil_image_pipeline_resize(
+    fossil_image_pipeline_t *pipeline,
+    uint32_t width,
+    uint32_t height,
+    fossil_interp_t mode
+) {
+    if (!pipeline || pipeline->resize || width == 0 || height == 0)
+        return false;
+    pipeline->resize = true;
+    pipeline->resize_w = width;
+    pipeline->resize_h = height;
+    pipeline->resize_mode = mode;
+    return true;
+}
+
+uint32_t fossil_image_pipeline_op_count(const fossil_image_pipeline_t *pipeline) {
+    return pipeline ? pipeline->count + pipeline->resize : 0;
+}
+
+uint32_t fossil_image_pipeline_stage_count(const fossil_image_pipeline_t *pipeline) {
+    if (!pipeline)
+        return 0;
+    uint32_t stages = 0;
+    for (uint32_t i = 0; i < pipeline->count; ++i) {
+        bool point = pipeline->ops[i].kind != PIPELINE_CONVOLVE;
+        if (!point || i == 0 || pipeline->ops[i - 1].kind == PIPELINE_CONVOLVE)
+            stages++;
+    }
+    return stages + pipeline->resize;
+}
+
+uint32_t fossil_image_pipeline_halo(const fossil_image_pipeline_t *pipeline) {
+    if (!pipeline)
+        return 0;
+    uint32_t halo = 0;
+    for (uint32_t i = 0; i < pipeline->count; ++i)
+        halo += pipeline->ops[i].kind == PIPELINE_CONVOLVE;
+    return halo;
+}
+
+bool fossil_image_pipeline_has_resize(const fossil_image_pipeline_t *pipeline) {
+    return pipeline && pipeline->resize;
+}
+
+// ------------------------------------------------------
+// Execution
+// ------------------------------------------------------
+
+/*
+ * The op list compiles to K neighbourhood stages separated by K + 1 point
+ * groups (any of which may be empty). For 8- and 16-bit images a group is
+ * folded into one lookup table by running its ops through the color
+ * functions on an identity ramp, so the fused result matches the sequential
+ * one by construction. Float groups cannot be tabulated; their ops run back
+ * to back on one row while it is in cache.
+ *
+ * Each band pulls rows through K + 1 three-row rings: ring 0 holds source
+ * rows after group 0, ring j the output of stage j after group j. Stage j
+ * producing row r first pulls stage j - 1 up to row r + 1, so by the time
+ * the last ring yields row y every source row up to y + K has been read and
+ * row y may be overwritten in place. Rows borrowed from neighbouring bands
+ * are copied out before any band starts. Bands are full-width tiles, the
+ * unit the parallel helper schedules everywhere else in the library.
+ */
+#define PIPELINE_MIN_ROWS 32
+
+typedef struct pipeline_group {
+    uint32_t begin;
+    uint32_t end;
+    void *lut;
+} pipeline_group_t;
+
+typedef struct pipeline_run {
+    fossil_image_t *image;
+    const pipeline_op_t *ops;
+    pipeline_group_t *groups;
+    const pipeline_op_t **stages;
+    pipeline_class_t cls;
+    uint32_t depth;
+    uint32_t bands;
+    size_t stride;
+    size_t samples;
+    uint8_t *halos;
+    uint8_t *rings;
+    uint32_t *next;
+} pipeline_run_t;
+
+static bool pipeline_class_of(const fossil_image_t *image, pipeline_class_t *cls) {
+    switch (image->format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8:
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+            *cls = PIPELINE_U8;
+            return image->data != NULL;
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+            *cls = PIPELINE_U16;
+            return image->data != NULL;
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            *cls = PIPELINE_F32;
+            return image->fdata != NULL;
+        default:
+            return false;
+    }
+}
+
+static bool pipeline_apply_op(const pipeline_op_t *op, fossil_image_t *view) {
+    switch (op->kind) {
+        case PIPELINE_BRIGHTNESS:
+            return fossil_image_color_brightness(view, op->offset);
+        case PIPELINE_CONTRAST:
+            return fossil_image_color_contrast(view, op->value);
+        case PIPELINE_GAMMA:
+            return fossil_image_color_gamma(view, op->value);
+        default:
+            return false;
+    }
+}
+
+/* Tabulate a point group: run its ops over every possible sample value. */
+static void *pipeline_build_lut(const pipeline_op_t *ops, uint32_t begin, uint32_t end, pipeline_class_t cls) {
+    uint32_t n = cls == PIPELINE_U8 ? 256u : 65536u;
+    fossil_image_t ramp;
+    memset(&ramp, 0, sizeof(ramp));
+    ramp.width = n;
+    ramp.height = 1;
+    ramp.channels = 1;
+    ramp.format = cls == PIPELINE_U8 ? FOSSIL_PIXEL_FORMAT_GRAY8 : FOSSIL_PIXEL_FORMAT_GRAY16;
+    ramp.size = (size_t)n * (cls == PIPELINE_U8 ? 1 : 2);
+    ramp.data = (uint8_t *)malloc(ramp.size);
+    if (!ramp.data)
+        return NULL;
+
+    if (cls == PIPELINE_U8) {
+        for (uint32_t i = 0; i < n; ++i)
+            ramp.data[i] = (uint8_t)i;
+    } else {
+        uint16_t *ramp16 = (uint16_t *)ramp.data;
+        for (uint32_t i = 0; i < n; ++i)
+            ramp16[i] = (uint16_t)i;
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+        if (!pipeline_apply_op(&ops[i], &ramp)) {
+            free(ramp.data);
+            return NULL;
+        }
+    }
+    return ramp.data;
+}
+
+static void pipeline_apply_group(const pipeline_run_t *run, const pipeline_group_t *g, uint8_t *row) {
+    if (g->begin == g->end)
+        return;
+    size_t n = run->samples;
+    if (run->cls == PIPELINE_U8) {
+        const uint8_t *lut = (const uint8_t *)g->lut;
+        for (size_t i = 0; i < n; ++i)
+            row[i] = lut[row[i]];
+    } else if (run->cls == PIPELINE_U16) {
+        const uint16_t *lut = (const uint16_t *)g->lut;
+        uint16_t *row16 = (uint16_t *)row;
+        for (size_t i = 0; i < n; ++i)
+            row16[i] = lut[row16[i]];
+    } else {
+        fossil_image_t view = *run->image;
+        view.height = 1;
+        view.size = run->stride;
+        view.owns_data = false;
+        view.fdata = (float *)row;
+        for (uint32_t i = g->begin; i < g->end; ++i)
+            pipeline_apply_op(&run->ops[i], &view);
+    }
+}
+
+/*
+ * One output row of a 3x3 stage. The accumulation order and clamping follow
+ * fossil_image_filter_convolve3x3 exactly; the outermost columns are zero
+ * there, and so they are here.
+ */
+#define PIPELINE_CONVOLVE_ROW(T, STORE)                                         \
+    do {                                                                        \
+        const T *a = (const T *)r0;                                             \
+        const T *b = (const T *)r1;                                             \
+        const T *d = (const T *)r2;                                             \
+        T *o = (T *)out;                                                        \
+        for (size_t ch = 0; ch < c; ++ch) {                                     \
+            o[ch] = 0;                                                          \
+            o[((size_t)w - 1) * c + ch] = 0;                                    \
+        }                                                                       \
+        for (size_t i = c; i < ((size_t)w - 1) * c; ++i) {                      \
+            float sum = 0.0f;                                                   \
+            sum += a[i - c] * k[0][0];                                          \
+            sum += a[i] * k[0][1];                                              \
+            sum += a[i + c] * k[0][2];                                          \
+            sum += b[i - c] * k[1][0];                                          \
+            sum += b[i] * k[1][1];                                              \
+            sum += b[i + c] * k[1][2];                                          \
+            sum += d[i - c] * k[2][0];                                          \
+            sum += d[i] * k[2][1];                                              \
+            sum += d[i + c] * k[2][2];                                          \
+            sum = sum * scale + bias;                                           \
+            STORE;                                                              \
+        }                                                                       \
+    } while (0)
+
+static void pipeline_convolve_row(
+    const pipeline_run_t *run,
+    const pipeline_op_t *op,
+    const uint8_t *r0,
+    const uint8_t *r1,
+    const uint8_t *r2,
+    uint8_t *out
+) {
+    uint32_t w = run->image->width;
+    size_t c = run->image->channels;
+    const float (*k)[3] = op->kernel;
+    float scale = op->scale;
+    float bias = op->bias[run->cls];
+
+    if (run->cls == PIPELINE_U8) {
+        PIPELINE_CONVOLVE_ROW(uint8_t,
+            o[i] = (uint8_t)(sum < 0.0f ? 0.0f : (sum > 255.0f ? 255.0f : sum)));
+    } else if (run->cls == PIPELINE_U16) {
+        PIPELINE_CONVOLVE_ROW(uint16_t,
+            o[i] = (uint16_t)(sum < 0.0f ? 0.0f : (sum > 65535.0f ? 65535.0f : sum)));
+    } else {
+        PIPELINE_CONVOLVE_ROW(float, o[i] = sum);
+    }
+}
+
+static inline uint8_t *pipeline_ring_row(const pipeline_run_t *run, uint8_t *rings, uint32_t ring, uint32_t y) {
+    return rings + ((size_t)ring * 3 + y % 3) * run->stride;
+}
+
+/* Produce rows of ring j up to and including row last. */
+static void pipeline_pull(
+    const pipeline_run_t *run,
+    uint32_t band,
+    uint32_t y0,
+    uint32_t y1,
+    uint32_t j,
+    uint32_t last
+) {
+    uint8_t *rings = run->rings + (size_t)band * (run->depth + 1) * 3 * run->stride;
+    uint32_t *next = run->next + (size_t)band * (run->depth + 1);
+    uint32_t h = run->image->height;
+    uint32_t depth = run->depth;
+
+    for (uint32_t r = next[j]; r <= last; ++r) {
+        uint8_t *dst = pipeline_ring_row(run, rings, j, r);
+        if (j == 0) {
+            // Rows outside the band come from the snapshot taken up front
+            const uint8_t *halo = run->halos + (size_t)band * 2 * depth * run->stride;
+            uint32_t top = y0 > depth ? y0 - depth : 0;
+            const uint8_t *src;
+            if (r < y0)
+                src = halo + (size_t)(r - top) * run->stride;
+            else if (r >= y1)
+                src = halo + ((size_t)depth + (r - y1)) * run->stride;
+            else
+                src = run->image->data + (size_t)r * run->stride;
+            memcpy(dst, src, run->stride);
+        } else {
+            pipeline_pull(run, band, y0, y1, j - 1, r + 1 < h ? r + 1 : h - 1);
+            if (r == 0 || r == h - 1) {
+                memset(dst, 0, run->stride);
+            } else {
+                pipeline_convolve_row(run, run->stages[j - 1],
+                    pipeline_ring_row(run, rings, j - 1, r - 1),
+                    pipeline_ring_row(run, rings, j - 1, r),
+                    pipeline_ring_row(run, rings, j - 1, r + 1),
+                    dst);
+            }
+        }
+        pipeline_apply_group(run, &run->groups[j], dst);
+        next[j] = r + 1;
+    }
+}
+
+static void pipeline_band(void *arg, uint32_t begin, uint32_t end, uint32_t band_unused) {
+    const pipeline_run_t *run = (const pipeline_run_t *)arg;
+    uint32_t h = run->image->height;
+    (void)band_unused;
+
+    for (uint32_t band = begin; band < end; ++band) {
+        uint32_t y0 = (uint32_t)((uint64_t)h * band / run->bands);
+        uint32_t y1 = (uint32_t)((uint64_t)h * (band + 1) / run->bands);
+
+        if (run->depth == 0) {
+            for (uint32_t y = y0; y < y1; ++y)
+                pipeline_apply_group(run, &run->groups[0], run->image->data + (size_t)y * run->stride);
+            continue;
+        }
+
+        uint32_t *next = run->next + (size_t)band * (run->depth + 1);
+        for (uint32_t j = 0; j <= run->depth; ++j) {
+            uint32_t back = run->depth - j;
+            next[j] = y0 > back ? y0 - back : 0;
+        }
+        uint8_t *rings = run->rings + (size_t)band * (run->depth + 1) * 3 * run->stride;
+        for (uint32_t y = y0; y < y1; ++y) {
+            pipeline_pull(run, band, y0, y1, run->depth, y);
+            memcpy(run->image->data + (size_t)y * run->stride,
+                   pipeline_ring_row(run, rings, run->depth, y), run->stride);
+        }
+    }
+}
+
+/* Run the recorded color and filter ops in place; the caller validated the image. */
+static bool pipeline_run_ops(const fossil_image_pipeline_t *pipeline, fossil_image_t *image, pipeline_class_t cls) {
+    pipeline_run_t run;
+    memset(&run, 0, sizeof(run));
+    run.cls = cls;
+    if (pipeline->count == 0)
+        return true;
+
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    run.depth = fossil_image_pipeline_halo(pipeline);
+
+    run.image = image;
+    run.ops = pipeline->ops;
+    run.samples = (size_t)w * image->channels;
+    run.stride = run.samples * (run.cls == PIPELINE_U8 ? 1 : (run.cls == PIPELINE_U16 ? 2 : 4));
+
+    // Split the op list into point groups around each neighbourhood stage
+    run.groups = (pipeline_group_t *)calloc((size_t)run.depth + 1, sizeof(pipeline_group_t));
+    run.stages = (const pipeline_op_t **)calloc((size_t)run.depth + 1, sizeof(pipeline_op_t *));
+    bool ok = run.groups && run.stages;
+    uint32_t g = 0;
+    for (uint32_t i = 0; ok && i < pipeline->count; ++i) {
+        if (pipeline->ops[i].kind == PIPELINE_CONVOLVE) {
+            run.stages[g++] = &pipeline->ops[i];
+            run.groups[g].begin = run.groups[g].end = i + 1;
+        } else {
+            run.groups[g].end = i + 1;
+        }
+    }
+    for (uint32_t j = 0; ok && j <= run.depth; ++j) {
+        pipeline_group_t *grp = &run.groups[j];
+        if (grp->begin == grp->end || run.cls == PIPELINE_F32)
+            continue;
+        grp->lut = pipeline_build_lut(run.ops, grp->begin, grp->end, run.cls);
+        ok = grp->lut != NULL;
+    }
+
+    // Wider bands when deep chains make halo rows expensive
+    uint32_t min_rows = PIPELINE_MIN_ROWS;
+    if (run.depth > min_rows / 4)
+        min_rows = run.depth * 4;
+    run.bands = fossil_image_parallel_bands(h, min_rows);
+
+    if (ok && run.depth > 0) {
+        size_t rings = (size_t)run.bands * (run.depth + 1) * 3 * run.stride;
+        size_t halos = (size_t)run.bands * 2 * run.depth * run.stride;
+        run.rings = (uint8_t *)malloc(rings + halos);
+        run.next = (uint32_t *)malloc((size_t)run.bands * (run.depth + 1) * sizeof(uint32_t));
+        ok = run.rings && run.next;
+        if (ok) {
+            run.halos = run.rings + rings;
+            for (uint32_t b = 0; b < run.bands; ++b) {
+                uint32_t y0 = (uint32_t)((uint64_t)h * b / run.bands);
+                uint32_t y1 = (uint32_t)((uint64_t)h * (b + 1) / run.bands);
+                uint32_t top = y0 > run.depth ? y0 - run.depth : 0;
+                uint32_t bottom = h - y1 < run.depth ? h - y1 : run.depth;
+                uint8_t *halo = run.halos + (size_t)b * 2 * run.depth * run.stride;
+                memcpy(halo, image->data + (size_t)top * run.stride, (size_t)(y0 - top) * run.stride);
+                memcpy(halo + (size_t)run.depth * run.stride,
+                       image->data + (size_t)y1 * run.stride, (size_t)bottom * run.stride);
+            }
+        }
+    }
+
+    // Each work item is one whole band so the split matches the halos above
+    if (ok)
+        ok = fossil_image_parallel_for(run.bands, 1, pipeline_band, &run);
+
+    for (uint32_t j = 0; run.groups && j <= run.depth; ++j)
+        free(run.groups[j].lut);
+    free(run.groups);
+    free(run.stages);
+    free(run.rings);
+    free(run.next);
+    return ok;
+}
+
+bool fossil_image_pipeline_execute(const fossil_image_pipeline_t *pipeline, fossil_image_t *image) {
+    if (!pipeline || !image || image->channels == 0 || image->width == 0 || image->height == 0)
+        return false;
+
+    pipeline_class_t cls;
+    if (!pipeline_class_of(image, &cls))
+        return false;
+    if (fossil_image_pipeline_halo(pipeline) > 0 && (image->width < 3 || image->height < 3))
+        return false;
+    if (!pipeline->resize)
+        return pipeline_run_ops(pipeline, image, cls);
+
+    // Check and allocate everything the resize needs before touching pixels
+    if (image->format == FOSSIL_PIXEL_FORMAT_INDEXED8 && pipeline->resize_mode != FOSSIL_INTERP_NEAREST)
+        return false;
+    size_t bpp = fossil_image_bytes_per_pixel(image->format);
+    size_t new_size = (size_t)pipeline->resize_w * pipeline->resize_h * bpp;
+    if (bpp == 0 || new_size / bpp / pipeline->resize_w != pipeline->resize_h)
+        return false;
+    fossil_image_t out = *image;
+    out.width = pipeline->resize_w;
+    out.height = pipeline->resize_h;
+    out.size = new_size;
+    out.owns_data = false;
+    out.data = (uint8_t *)malloc(new_size);
+    if (!out.data)
+        return false;
+
+    if (!pipeline_run_ops(pipeline, image, cls) ||
+        !fossil_image_process_resize_into(image, &out, pipeline->resize_mode)) {
+        free(out.data);
+        return false;
+    }
+
+    if (image->owns_data)
+        free(image->data);
+    image->data = out.data;
+    image->width = out.width;
+    image->height = out.height;
+    image->size = out.size;
+    image->owns_data = true;
+    return true;
+}
@@ -23,10 +23,19 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/image/process.h"
+#include "fossil/image/color.h"
+#include "fossil/image/parallel.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -190,8 +199,12 @@ void fossil_image_process_destroy(fossil_image_t *image) {
         }
     }
 
+    free(image->palette);
+
     // Reset all pointers and fields to avoid dangling references
     image->data = NULL;
+    image->palette = NULL;
+    image->palette_size = 0;
     image->fdata = NULL;
     image->userdata = NULL;
     image->size = 0;
@@ -217,6 +230,585 @@ void fossil_image_process_destroy(fossil_image_t *image) {
 // Fossil Image — Process Sub-Library
 // ======================================================
 
+// ------------------------------------------------------
+// Resampling
+// ------------------------------------------------------
+
+/*
+ * Every resize runs through one plan. For each axis it holds the first
+ * source index and taps weights of every output index. Nearest and
+ * bilinear sample at x * src / dst, computed in float exactly as the
+ * original loops did, and bilinear mixes its four samples with the same
+ * expression, so results are bit-identical to them. The cubic family and
+ * Lanczos are not implemented and fall back to nearest, as before. Area
+ * mode weights source rows into an accumulator row and weights across it;
+ * exact integer ratios skip the weights and sum blocks in integers (2x2
+ * 8-bit gray and RGBA have SSE2 kernels).
+ */
+#define RESAMPLE_MIN_ROWS 8u
+
+typedef struct resample_axis {
+    uint32_t *start;                   // first source index per output index
+    float *weight;                     // taps weights per output index
+    uint32_t taps;
+} resample_axis_t;
+
+struct fossil_image_resize_plan_s {
+    uint32_t src_w;
+    uint32_t src_h;
+    uint32_t dst_w;
+    uint32_t dst_h;
+    fossil_interp_t mode;
+    uint32_t fx;                       // integer area factors, or 0 for weighted
+    uint32_t fy;
+    resample_axis_t x;
+    resample_axis_t y;
+};
+
+typedef struct resample_ctx {
+    const fossil_image_resize_plan_t *plan;
+    const fossil_image_t *src;         // whole source, or a window of it
+    uint32_t src_x0;                   // source coordinates of the window origin
+    uint32_t src_y0;
+    size_t src_stride;                 // bytes per window row
+    uint8_t *dst;                      // first pixel of the output region
+    size_t dst_stride;                 // bytes per destination row
+    uint32_t ox0;                      // output rectangle within the plan's output
+    uint32_t oy0;
+    uint32_t out_w;
+    uint32_t channels;
+    size_t sample_size;
+    size_t scratch_samples;            // one window row
+    void *scratch;                     // per band: one window row of uint32_t or float
+} resample_ctx_t;
+
+/* Source position of output i along an axis, as the original float loops computed it. */
+static inline float resample_position(uint32_t i, uint32_t src, uint32_t dst) {
+    return (float)i * src / dst;
+}
+
+static bool resample_axis_init(resample_axis_t *a, uint32_t src, uint32_t dst, fossil_interp_t mode) {
+    const double scale = (double)src / dst;
+    switch (mode) {
+        case FOSSIL_INTERP_AREA:
+            a->taps = (uint32_t)ceil(scale) + 1;
+            if (a->taps > src)
+                a->taps = src;
+            break;
+        case FOSSIL_INTERP_LINEAR:
+            // The second tap is clamped to the last index when reading
+            a->taps = 2;
+            break;
+        default:
+            a->taps = 1;
+            break;
+    }
+    a->start = (uint32_t *)malloc((size_t)dst * sizeof(uint32_t));
+    a->weight = (float *)calloc((size_t)dst * a->taps, sizeof(float));
+    if (!a->start || !a->weight)
+        return false;
+
+    for (uint32_t i = 0; i < dst; ++i) {
+        float *w = a->weight + (size_t)i * a->taps;
+        if (mode == FOSSIL_INTERP_AREA) {
+            // Windows are pulled back at the far edge so that all taps stay
+            // inside the source; the extra leading taps get zero weight
+            int64_t first = (int64_t)(i * scale);
+            if (first > (int64_t)(src - a->taps))
+                first = src - a->taps;
+            a->start[i] = (uint32_t)first;
+            double lo = i * scale, hi = (i + 1) * scale;
+            for (uint32_t k = 0; k < a->taps; ++k) {
+                double l = lo > first + k ? lo : first + k;
+                double r = hi < first + k + 1 ? hi : first + k + 1;
+                if (r > l)
+                    w[k] = (float)((r - l) / scale);
+            }
+            continue;
+        }
+        float pos = resample_position(i, src, dst);
+        uint32_t first = (uint32_t)pos;
+        if (first > src - 1)
+            first = src - 1;
+        a->start[i] = first;
+        if (mode == FOSSIL_INTERP_LINEAR) {
+            w[0] = 1 - (pos - first);
+            w[1] = pos - first;
+        } else {
+            w[0] = 1.0f;
+        }
+    }
+    return true;
+}
+
+/* Row y of the source, positioned at window column src_x0. */
+static inline const uint8_t *resample_src_row(const resample_ctx_t *r, uint32_t y) {
+    return r->src->data + (size_t)(y - r->src_y0) * r->src_stride;
+}
+
+/* 2x2 mean of 8-bit rows r0 and r1 into out, SIMD for gray and RGBA. */
+static void area_half8(const uint8_t *r0, const uint8_t *r1, uint8_t *out, uint32_t out_w, uint32_t c) {
+    uint32_t x = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    if (c == 1) {
+        const __m128i low = _mm_set1_epi32(0xFFFF);
+        for (; x + 8 <= out_w; x += 8) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 2 * x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 2 * x));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            lo = _mm_add_epi32(_mm_and_si128(lo, low), _mm_srli_epi32(lo, 16));
+            hi = _mm_add_epi32(_mm_and_si128(hi, low), _mm_srli_epi32(hi, 16));
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(lo, hi), two), 2);
+            _mm_storel_epi64((__m128i *)(out + x), _mm_packus_epi16(sum, sum));
+        }
+    } else if (c == 4) {
+        for (; x + 2 <= out_w; x += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 8 * x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 8 * x));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+            _mm_storel_epi64((__m128i *)(out + 4 * x), _mm_packus_epi16(sum, sum));
+        }
+    }
+#endif
+    for (; x < out_w; ++x) {
+        const uint8_t *a = r0 + (size_t)2 * x * c, *b = r1 + (size_t)2 * x * c;
+        for (uint32_t ch = 0; ch < c; ++ch)
+            out[(size_t)x * c + ch] = (uint8_t)((a[ch] + a[c + ch] + b[ch] + b[c + ch] + 2u) >> 2);
+    }
+}
+
+static void area_integer_row(const resample_ctx_t *r, uint32_t oy, void *scratch) {
+    const fossil_image_resize_plan_t *p = r->plan;
+    const uint32_t c = r->channels, fx = p->fx, fy = p->fy;
+    const size_t row = (size_t)r->out_w * fx * c;
+    // First sample of the source columns under output column ox0
+    const size_t sx = ((size_t)r->ox0 * fx - r->src_x0) * c;
+    uint8_t *out = r->dst + (size_t)(oy - r->oy0) * r->dst_stride;
+
+    if (r->sample_size == 1 && fx == 2 && fy == 2) {
+        area_half8(resample_src_row(r, 2 * oy) + sx, resample_src_row(r, 2 * oy + 1) + sx, out, r->out_w, c);
+        return;
+    }
+
+    // Column sums over the fy source rows, then fx-wide groups across them
+    if (r->sample_size == 4) {
+        float *acc = (float *)scratch;
+        memcpy(acc, (const float *)resample_src_row(r, oy * fy) + sx, row * sizeof(float));
+        for (uint32_t k = 1; k < fy; ++k) {
+            const float *s = (const float *)resample_src_row(r, oy * fy + k) + sx;
+            for (size_t i = 0; i < row; ++i)
+                acc[i] += s[i];
+        }
+        const float inv = 1.0f / ((float)fx * fy);
+        float *d = (float *)out;
+        for (uint32_t ox = 0; ox < r->out_w; ++ox) {
+            const float *s = acc + (size_t)ox * fx * c;
+            for (uint32_t ch = 0; ch < c; ++ch) {
+                float sum = 0.0f;
+                for (uint32_t k = 0; k < fx; ++k)
+                    sum += s[(size_t)k * c + ch];
+                d[(size_t)ox * c + ch] = sum * inv;
+            }
+        }
+        return;
+    }
+
+    uint32_t *acc = (uint32_t *)scratch;
+    if (r->sample_size == 2) {
+        const uint16_t *s = (const uint16_t *)resample_src_row(r, oy * fy) + sx;
+        for (size_t i = 0; i < row; ++i)
+            acc[i] = s[i];
+        for (uint32_t k = 1; k < fy; ++k) {
+            s = (const uint16_t *)resample_src_row(r, oy * fy + k) + sx;
+            for (size_t i = 0; i < row; ++i)
+                acc[i] += s[i];
+        }
+    } else {
+        const uint8_t *s = resample_src_row(r, oy * fy) + sx;
+        for (size_t i = 0; i < row; ++i)
+            acc[i] = s[i];
+        for (uint32_t k = 1; k < fy; ++k) {
+            s = resample_src_row(r, oy * fy + k) + sx;
+            for (size_t i = 0; i < row; ++i)
+                acc[i] += s[i];
+        }
+    }
+
+    // Power-of-two block sizes divide with a shift
+    const uint64_t n = (uint64_t)fx * fy;
+    uint32_t shift = 0;
+    while ((1ull << shift) < n)
+        ++shift;
+    const bool pow2 = (1ull << shift) == n;
+    for (uint32_t ox = 0; ox < r->out_w; ++ox) {
+        const uint32_t *s = acc + (size_t)ox * fx * c;
+        const size_t i = (size_t)ox * c;
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            uint64_t sum = n / 2;
+            for (uint32_t k = 0; k < fx; ++k)
+                sum += s[(size_t)k * c + ch];
+            sum = pow2 ? sum >> shift : sum / n;
+            if (r->sample_size == 2)
+                ((uint16_t *)out)[i + ch] = (uint16_t)sum;
+            else
+                out[i + ch] = (uint8_t)sum;
+        }
+    }
+}
+
+static void resample_nearest_row(const resample_ctx_t *r, uint32_t oy) {
+    const fossil_image_resize_plan_t *p = r->plan;
+    const size_t bpp = r->channels * r->sample_size;
+    const uint8_t *src = resample_src_row(r, p->y.start[oy]);
+    const uint32_t *start = p->x.start + r->ox0;
+    uint8_t *out = r->dst + (size_t)(oy - r->oy0) * r->dst_stride;
+    for (uint32_t ox = 0; ox < r->out_w; ++ox)
+        memcpy(out + (size_t)ox * bpp, src + (size_t)(start[ox] - r->src_x0) * bpp, bpp);
+}
+
+/*
+ * Bilinear row. The four samples are mixed with the expression of the
+ * original resize loop, term for term, so 8-bit and float results match it
+ * exactly.
+ */
+static void resample_linear_row(const resample_ctx_t *r, uint32_t oy) {
+    const fossil_image_resize_plan_t *p = r->plan;
+    const uint32_t c = r->channels;
+    const uint32_t y0 = p->y.start[oy];
+    const uint32_t y1 = y0 + 1 < p->src_h ? y0 + 1 : y0;
+    const float wy = p->y.weight[(size_t)oy * 2 + 1];
+    const uint8_t *row0 = resample_src_row(r, y0);
+    const uint8_t *row1 = resample_src_row(r, y1);
+    uint8_t *out = r->dst + (size_t)(oy - r->oy0) * r->dst_stride;
+
+    for (uint32_t ox = 0; ox < r->out_w; ++ox) {
+        const uint32_t i = r->ox0 + ox;
+        const uint32_t x0 = p->x.start[i];
+        const size_t a = (size_t)(x0 - r->src_x0) * c;
+        const size_t b = (size_t)((x0 + 1 < p->src_w ? x0 + 1 : x0) - r->src_x0) * c;
+        const float wx = p->x.weight[(size_t)i * 2 + 1];
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            const size_t o = (size_t)ox * c + ch;
+            if (r->sample_size == 4) {
+                const float *s0 = (const float *)row0, *s1 = (const float *)row1;
+                ((float *)out)[o] = (1 - wx) * (1 - wy) * s0[a + ch] + wx * (1 - wy) * s0[b + ch] +
+                                    (1 - wx) * wy * s1[a + ch] + wx * wy * s1[b + ch];
+            } else if (r->sample_size == 2) {
+                const uint16_t *s0 = (const uint16_t *)row0, *s1 = (const uint16_t *)row1;
+                float val = (1 - wx) * (1 - wy) * s0[a + ch] + wx * (1 - wy) * s0[b + ch] +
+                            (1 - wx) * wy * s1[a + ch] + wx * wy * s1[b + ch];
+                ((uint16_t *)out)[o] = (uint16_t)(val + 0.5f);
+            } else {
+                float val = (1 - wx) * (1 - wy) * row0[a + ch] + wx * (1 - wy) * row0[b + ch] +
+                            (1 - wx) * wy * row1[a + ch] + wx * wy * row1[b + ch];
+                out[o] = (uint8_t)(val + 0.5f);
+            }
+        }
+    }
+}
+
+static void resample_weighted_row(const resample_ctx_t *r, uint32_t oy, float *acc) {
+    const fossil_image_resize_plan_t *p = r->plan;
+    const uint32_t c = r->channels;
+    const size_t row = r->scratch_samples;
+    const float *wy = p->y.weight + (size_t)oy * p->y.taps;
+    const uint32_t y0 = p->y.start[oy];
+
+    // Vertical taps into acc; the first tap stores, later ones accumulate
+    bool first = true;
+    for (uint32_t k = 0; k < p->y.taps; ++k) {
+        const float w = wy[k];
+        if (w == 0.0f)
+            continue;
+        const uint8_t *s = resample_src_row(r, y0 + k);
+        if (r->sample_size == 4) {
+            const float *f = (const float *)s;
+            if (first)
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] = w * f[i];
+            else
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] += w * f[i];
+        } else if (r->sample_size == 2) {
+            const uint16_t *s16 = (const uint16_t *)s;
+            if (first)
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] = w * s16[i];
+            else
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] += w * s16[i];
+        } else {
+            if (first)
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] = w * s[i];
+            else
+                for (size_t i = 0; i < row; ++i)
+                    acc[i] += w * s[i];
+        }
+        first = false;
+    }
+    if (first)
+        memset(acc, 0, row * sizeof(float));
+
+    // Horizontal taps, all channels of a pixel at once (formats have at most 4)
+    uint8_t *out = r->dst + (size_t)(oy - r->oy0) * r->dst_stride;
+    for (uint32_t ox = 0; ox < r->out_w; ++ox) {
+        const float *wx = p->x.weight + (size_t)(r->ox0 + ox) * p->x.taps;
+        const float *src = acc + (size_t)(p->x.start[r->ox0 + ox] - r->src_x0) * c;
+        float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (uint32_t k = 0; k < p->x.taps; ++k, src += c)
+            for (uint32_t ch = 0; ch < c; ++ch)
+                sum[ch] += wx[k] * src[ch];
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            const size_t i = (size_t)ox * c + ch;
+            if (r->sample_size == 4) {
+                ((float *)out)[i] = sum[ch];
+            } else if (r->sample_size == 2) {
+                float v = sum[ch] + 0.5f;
+                ((uint16_t *)out)[i] = v <= 0.0f ? 0 : v >= 65535.0f ? 65535 : (uint16_t)v;
+            } else {
+                float v = sum[ch] + 0.5f;
+                out[i] = v <= 0.0f ? 0 : v >= 255.0f ? 255 : (uint8_t)v;
+            }
+        }
+    }
+}
+
+static void resample_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    resample_ctx_t *r = (resample_ctx_t *)arg;
+    void *scratch = (uint8_t *)r->scratch + (size_t)band * r->scratch_samples * sizeof(float);
+    for (uint32_t y = r->oy0 + begin; y < r->oy0 + end; ++y) {
+        if (r->plan->fx)
+            area_integer_row(r, y, scratch);
+        else if (r->plan->mode == FOSSIL_INTERP_NEAREST)
+            resample_nearest_row(r, y);
+        else if (r->plan->mode == FOSSIL_INTERP_LINEAR)
+            resample_linear_row(r, y);
+        else
+            resample_weighted_row(r, y, (float *)scratch);
+    }
+}
+
+fossil_image_resize_plan_t *fossil_image_process_resize_plan_create(
+    uint32_t src_width,
+    uint32_t src_height,
+    uint32_t dst_width,
+    uint32_t dst_height,
+    fossil_interp_t mode
+) {
+    if (src_width == 0 || src_height == 0 || dst_width == 0 || dst_height == 0)
+        return NULL;
+    if (mode < FOSSIL_INTERP_NEAREST || mode > FOSSIL_INTERP_AREA)
+        return NULL;
+
+    fossil_image_resize_plan_t *plan = (fossil_image_resize_plan_t *)calloc(1, sizeof(*plan));
+    if (!plan)
+        return NULL;
+    plan->src_w = src_width;
+    plan->src_h = src_height;
+    plan->dst_w = dst_width;
+    plan->dst_h = dst_height;
+    // The cubic family and Lanczos are not implemented; they sample nearest
+    if (mode != FOSSIL_INTERP_LINEAR && mode != FOSSIL_INTERP_AREA)
+        mode = FOSSIL_INTERP_NEAREST;
+    plan->mode = mode;
+    if (mode == FOSSIL_INTERP_AREA && src_width % dst_width == 0 && src_height % dst_height == 0) {
+        plan->fx = src_width / dst_width;
+        plan->fy = src_height / dst_height;
+        return plan;
+    }
+    if (!resample_axis_init(&plan->x, src_width, dst_width, mode) ||
+        !resample_axis_init(&plan->y, src_height, dst_height, mode)) {
+        fossil_image_process_resize_plan_destroy(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+void fossil_image_process_resize_plan_destroy(fossil_image_resize_plan_t *plan) {
+    if (!plan)
+        return;
+    free(plan->x.start);
+    free(plan->x.weight);
+    free(plan->y.start);
+    free(plan->y.weight);
+    free(plan);
+}
+
+/* Format checks shared by every plan execution. */
+static bool resample_formats_ok(const fossil_image_resize_plan_t *plan, const fossil_image_t *src, const fossil_image_t *dst) {
+    if (!src->data || !dst->data || src->data == dst->data || src->format != dst->format)
+        return false;
+    const size_t bpp = fossil_image_bytes_per_pixel(src->format);
+    if (bpp == 0 || src->channels == 0 || src->channels > 4 || bpp % src->channels != 0)
+        return false;
+    // Index values cannot be mixed, only picked
+    if (src->format == FOSSIL_PIXEL_FORMAT_INDEXED8 && plan->mode != FOSSIL_INTERP_NEAREST)
+        return false;
+    return src->size >= (size_t)src->width * src->height * bpp && dst->size >= (size_t)dst->width * dst->height * bpp;
+}
+
+/*
+ * Produce output rectangle (ox0, oy0, out_w, out_h) of the plan from src,
+ * which holds the source starting at (src_x0, src_y0), into dst at (dst_x, dst_y).
+ */
+static bool resample_run(
+    const fossil_image_resize_plan_t *plan,
+    const fossil_image_t *src,
+    uint32_t src_x0,
+    uint32_t src_y0,
+    fossil_image_t *dst,
+    uint32_t dst_x,
+    uint32_t dst_y,
+    uint32_t ox0,
+    uint32_t oy0,
+    uint32_t out_w,
+    uint32_t out_h
+) {
+    const size_t bpp = fossil_image_bytes_per_pixel(src->format);
+    resample_ctx_t r;
+    r.plan = plan;
+    r.src = src;
+    r.src_x0 = src_x0;
+    r.src_y0 = src_y0;
+    r.src_stride = (size_t)src->width * bpp;
+    r.dst_stride = (size_t)dst->width * bpp;
+    r.dst = dst->data + (size_t)dst_y * r.dst_stride + (size_t)dst_x * bpp;
+    r.ox0 = ox0;
+    r.oy0 = oy0;
+    r.out_w = out_w;
+    r.channels = src->channels;
+    r.sample_size = bpp / src->channels;
+    r.scratch_samples = (size_t)src->width * src->channels;
+    r.scratch = NULL;
+    const uint32_t bands = fossil_image_parallel_bands(out_h, RESAMPLE_MIN_ROWS);
+    if (plan->mode == FOSSIL_INTERP_AREA) {
+        r.scratch = malloc((size_t)bands * r.scratch_samples * sizeof(float));
+        if (!r.scratch)
+            return false;
+    }
+    bool ok = fossil_image_parallel_for_bands(bands, out_h, resample_band, &r);
+    free(r.scratch);
+    return ok;
+}
+
+bool fossil_image_process_resize_plan_execute(
+    const fossil_image_resize_plan_t *plan,
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    uint32_t dst_x,
+    uint32_t dst_y
+) {
+    if (!plan || !src || !dst)
+        return false;
+    if (src->width != plan->src_w || src->height != plan->src_h)
+        return false;
+    if (dst_x > dst->width || plan->dst_w > dst->width - dst_x ||
+        dst_y > dst->height || plan->dst_h > dst->height - dst_y)
+        return false;
+    if (!resample_formats_ok(plan, src, dst))
+        return false;
+    return resample_run(plan, src, 0, 0, dst, dst_x, dst_y, 0, 0, plan->dst_w, plan->dst_h);
+}
+
+/* Source indices [*lo, *hi) read by outputs [o0, o0 + n) along one axis. */
+static void resample_axis_span(const resample_axis_t *a, uint32_t factor, uint32_t src,
+                               uint32_t o0, uint32_t n, uint32_t *lo, uint32_t *hi) {
+    if (factor) {
+        *lo = o0 * factor;
+        *hi = (o0 + n) * factor;
+        return;
+    }
+    // Window starts never decrease along an axis; bilinear clamps its
+    // second tap at the last index
+    *lo = a->start[o0];
+    *hi = a->start[o0 + n - 1] + a->taps;
+    if (*hi > src)
+        *hi = src;
+}
+
+bool fossil_image_process_resize_plan_source_rect(
+    const fossil_image_resize_plan_t *plan,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint32_t *src_x,
+    uint32_t *src_y,
+    uint32_t *src_width,
+    uint32_t *src_height
+) {
+    if (!plan || !src_x || !src_y || !src_width || !src_height || width == 0 || height == 0)
+        return false;
+    if (x > plan->dst_w || width > plan->dst_w - x || y > plan->dst_h || height > plan->dst_h - y)
+        return false;
+    uint32_t x0, x1, y0, y1;
+    resample_axis_span(&plan->x, plan->fx, plan->src_w, x, width, &x0, &x1);
+    resample_axis_span(&plan->y, plan->fy, plan->src_h, y, height, &y0, &y1);
+    *src_x = x0;
+    *src_y = y0;
+    *src_width = x1 - x0;
+    *src_height = y1 - y0;
+    return true;
+}
+
+bool fossil_image_process_resize_plan_execute_rect(
+    const fossil_image_resize_plan_t *plan,
+    const fossil_image_t *window,
+    uint32_t window_x,
+    uint32_t window_y,
+    fossil_image_t *dst,
+    uint32_t x,
+    uint32_t y
+) {
+    if (!plan || !window || !dst)
+        return false;
+    uint32_t sx, sy, sw, sh;
+    if (!fossil_image_process_resize_plan_source_rect(plan, x, y, dst->width, dst->height, &sx, &sy, &sw, &sh))
+        return false;
+    // The window must cover every source pixel the rectangle reads
+    if (window_x > sx || window_y > sy ||
+        (uint64_t)window_x + window->width < (uint64_t)sx + sw ||
+        (uint64_t)window_y + window->height < (uint64_t)sy + sh)
+        return false;
+    if (!resample_formats_ok(plan, window, dst))
+        return false;
+    return resample_run(plan, window, window_x, window_y, dst, 0, 0, x, y, dst->width, dst->height);
+}
+
+bool fossil_image_process_resize_into_region(
+    const fossil_image_t *src,
+    fossil_image_t *dst,
+    uint32_t dst_x,
+    uint32_t dst_y,
+    uint32_t width,
+    uint32_t height,
+    fossil_interp_t mode
+) {
+    if (!src)
+        return false;
+    fossil_image_resize_plan_t *plan =
+        fossil_image_process_resize_plan_create(src->width, src->height, width, height, mode);
+    if (!plan)
+        return false;
+    bool ok = fossil_image_process_resize_plan_execute(plan, src, dst, dst_x, dst_y);
+    fossil_image_process_resize_plan_destroy(plan);
+    return ok;
+}
+
+bool fossil_image_process_resize_into(const fossil_image_t *src, fossil_image_t *dst, fossil_interp_t mode) {
+    if (!dst)
+        return false;
+    return fossil_image_process_resize_into_region(src, dst, 0, 0, dst->width, dst->height, mode);
+}
+
 bool fossil_image_process_resize(
     fossil_image_t *image,
     uint32_t new_w,
@@ -230,160 +822,217 @@ bool fossil_image_process_resize(
     if (new_w == 0 || new_h == 0)
         return false;
 
-    size_t channels = image->channels;
     size_t bytes_per_pixel = fossil_image_bytes_per_pixel(image->format);
     size_t new_size = (size_t)new_w * (size_t)new_h * bytes_per_pixel;
+    if (bytes_per_pixel == 0 || new_size / bytes_per_pixel / new_w != new_h)
+        return false;
 
-    // Handle float formats
-    bool is_float = (
-        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32 ||
-        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGB ||
-        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA
-    );
-
-    void *new_buffer = NULL;
-    if (is_float) {
-        new_buffer = calloc(new_size / sizeof(float), sizeof(float));
-    } else {
-        new_buffer = calloc(new_size, 1);
+    // Resample into a fresh buffer described by a borrowed header, then adopt it
+    fossil_image_t out = *image;
+    out.width = new_w;
+    out.height = new_h;
+    out.size = new_size;
+    out.owns_data = false;
+    out.data = (uint8_t *)malloc(new_size);
+    if (!out.data)
+        return false;
+    if (!fossil_image_process_resize_into(image, &out, mode)) {
+        free(out.data);
+        return false;
     }
-    if (!new_buffer)
+
+    if (image->owns_data)
+        free(image->data);
+    image->data = out.data;
+    image->owns_data = true;
+    image->width = new_w;
+    image->height = new_h;
+    image->size = new_size;
+    return true;
+}
+
+bool fossil_image_process_downscale(fossil_image_t *image, uint32_t factor) {
+    if (!image || factor == 0)
         return false;
+    uint32_t new_w = image->width / factor;
+    uint32_t new_h = image->height / factor;
+    return fossil_image_process_resize(image, new_w ? new_w : 1, new_h ? new_h : 1, FOSSIL_INTERP_AREA);
+}
 
-    switch (mode) {
-        case FOSSIL_INTERP_NEAREST:
-            if (is_float) {
-                float *src = image->fdata;
-                float *dst = (float *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        uint32_t src_x = (uint32_t)((float)x * image->width / new_w);
-                        uint32_t src_y = (uint32_t)((float)y * image->height / new_h);
-                        size_t src_i = (src_y * image->width + src_x) * channels;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        for (size_t c = 0; c < channels; ++c) {
-                            dst[dst_i + c] = src[src_i + c];
-                        }
-                    }
-                }
+/* Bilinear resize of decoded rows into dst; rows holds 2 * width + new_w pixels. */
+static bool linear_resize_bilinear(const fossil_image_t *image, uint32_t new_w, uint32_t new_h,
+                                   uint8_t *dst, float *rows) {
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    size_t c = image->channels;
+    size_t bpp = fossil_image_bytes_per_pixel(image->format);
+    size_t src_stride = (size_t)w * bpp;
+    size_t dst_stride = (size_t)new_w * bpp;
+
+    uint32_t *x0 = (uint32_t *)malloc((size_t)new_w * 2 * sizeof(uint32_t));
+    float *wx = (float *)malloc((size_t)new_w * sizeof(float));
+    if (!x0 || !wx) {
+        free(x0);
+        free(wx);
+        return false;
+    }
+
+    // Column taps are identical for every output row
+    uint32_t *x1 = x0 + new_w;
+    for (uint32_t x = 0; x < new_w; ++x) {
+        float src_xf = (float)x * w / new_w;
+        x0[x] = (uint32_t)src_xf;
+        x1[x] = (x0[x] + 1 < w) ? x0[x] + 1 : x0[x];
+        wx[x] = src_xf - x0[x];
+    }
+
+    // Two decoded source rows, reused while consecutive outputs share them
+    float *row_a = rows;
+    float *row_b = rows + (size_t)w * c;
+    float *out = rows + (size_t)w * 2 * c;
+    int64_t have_a = -1;
+    int64_t have_b = -1;
+
+    for (uint32_t y = 0; y < new_h; ++y) {
+        float src_yf = (float)y * h / new_h;
+        uint32_t y0 = (uint32_t)src_yf;
+        uint32_t y1 = (y0 + 1 < h) ? y0 + 1 : y0;
+        float wy = src_yf - y0;
+
+        if (have_a != y0) {
+            if (have_b == y0) {
+                float *t = row_a; row_a = row_b; row_b = t;
+                have_b = have_a;
             } else {
-                uint8_t *src = image->data;
-                uint8_t *dst = (uint8_t *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        uint32_t src_x = (uint32_t)((float)x * image->width / new_w);
-                        uint32_t src_y = (uint32_t)((float)y * image->height / new_h);
-                        size_t src_i = (src_y * image->width + src_x) * channels;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        memcpy(&dst[dst_i], &src[src_i], channels);
-                    }
-                }
+                fossil_image_color_decode_linear_row(image->format,
+                    image->data + (size_t)y0 * src_stride, row_a, w);
             }
-            break;
-        case FOSSIL_INTERP_LINEAR:
-            if (is_float) {
-                float *src = image->fdata;
-                float *dst = (float *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    float src_yf = (float)y * image->height / new_h;
-                    uint32_t y0 = (uint32_t)src_yf;
-                    uint32_t y1 = (y0 + 1 < image->height) ? y0 + 1 : y0;
-                    float wy = src_yf - y0;
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        float src_xf = (float)x * image->width / new_w;
-                        uint32_t x0 = (uint32_t)src_xf;
-                        uint32_t x1 = (x0 + 1 < image->width) ? x0 + 1 : x0;
-                        float wx = src_xf - x0;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        for (size_t c = 0; c < channels; ++c) {
-                            float p00 = src[(y0 * image->width + x0) * channels + c];
-                            float p01 = src[(y0 * image->width + x1) * channels + c];
-                            float p10 = src[(y1 * image->width + x0) * channels + c];
-                            float p11 = src[(y1 * image->width + x1) * channels + c];
-                            float val = (1 - wx) * (1 - wy) * p00 +
-                                        wx * (1 - wy) * p01 +
-                                        (1 - wx) * wy * p10 +
-                                        wx * wy * p11;
-                            dst[dst_i + c] = val;
-                        }
-                    }
-                }
-            } else {
-                uint8_t *src = image->data;
-                uint8_t *dst = (uint8_t *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    float src_yf = (float)y * image->height / new_h;
-                    uint32_t y0 = (uint32_t)src_yf;
-                    uint32_t y1 = (y0 + 1 < image->height) ? y0 + 1 : y0;
-                    float wy = src_yf - y0;
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        float src_xf = (float)x * image->width / new_w;
-                        uint32_t x0 = (uint32_t)src_xf;
-                        uint32_t x1 = (x0 + 1 < image->width) ? x0 + 1 : x0;
-                        float wx = src_xf - x0;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        for (size_t c = 0; c < channels; ++c) {
-                            uint8_t p00 = src[(y0 * image->width + x0) * channels + c];
-                            uint8_t p01 = src[(y0 * image->width + x1) * channels + c];
-                            uint8_t p10 = src[(y1 * image->width + x0) * channels + c];
-                            uint8_t p11 = src[(y1 * image->width + x1) * channels + c];
-                            float val = (1 - wx) * (1 - wy) * p00 +
-                                        wx * (1 - wy) * p01 +
-                                        (1 - wx) * wy * p10 +
-                                        wx * wy * p11;
-                            dst[dst_i + c] = (uint8_t)(val + 0.5f);
-                        }
-                    }
-                }
+            have_a = y0;
+        }
+        if (have_b != y1) {
+            fossil_image_color_decode_linear_row(image->format,
+                image->data + (size_t)y1 * src_stride, row_b, w);
+            have_b = y1;
+        }
+
+        for (uint32_t x = 0; x < new_w; ++x) {
+            const float *a0 = row_a + (size_t)x0[x] * c;
+            const float *a1 = row_a + (size_t)x1[x] * c;
+            const float *b0 = row_b + (size_t)x0[x] * c;
+            const float *b1 = row_b + (size_t)x1[x] * c;
+            float fx = wx[x];
+            for (size_t ch = 0; ch < c; ++ch) {
+                float top = a0[ch] + (a1[ch] - a0[ch]) * fx;
+                float bot = b0[ch] + (b1[ch] - b0[ch]) * fx;
+                out[(size_t)x * c + ch] = top + (bot - top) * wy;
             }
-            break;
-        case FOSSIL_INTERP_CUBIC:
-        case FOSSIL_INTERP_LANCZOS:
-        case FOSSIL_INTERP_BICUBIC:
-        case FOSSIL_INTERP_MITCHELL:
-        case FOSSIL_INTERP_BSPLINE:
-            // Not implemented, fallback to nearest
-            if (is_float) {
-                float *src = image->fdata;
-                float *dst = (float *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        uint32_t src_x = (uint32_t)((float)x * image->width / new_w);
-                        uint32_t src_y = (uint32_t)((float)y * image->height / new_h);
-                        size_t src_i = (src_y * image->width + src_x) * channels;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        for (size_t c = 0; c < channels; ++c) {
-                            dst[dst_i + c] = src[src_i + c];
-                        }
-                    }
-                }
-            } else {
-                uint8_t *src = image->data;
-                uint8_t *dst = (uint8_t *)new_buffer;
-                for (uint32_t y = 0; y < new_h; ++y) {
-                    for (uint32_t x = 0; x < new_w; ++x) {
-                        uint32_t src_x = (uint32_t)((float)x * image->width / new_w);
-                        uint32_t src_y = (uint32_t)((float)y * image->height / new_h);
-                        size_t src_i = (src_y * image->width + src_x) * channels;
-                        size_t dst_i = (y * new_w + x) * channels;
-                        memcpy(&dst[dst_i], &src[src_i], channels);
-                    }
-                }
+        }
+        fossil_image_color_encode_linear_row(image->format, out,
+            dst + (size_t)y * dst_stride, new_w);
+    }
+
+    free(x0);
+    free(wx);
+    return true;
+}
+
+/*
+ * Area resize of decoded rows into dst, with the plan's area weights: the
+ * source rows under each output row are weighted into an accumulator row,
+ * which is then weighted across. rows holds 2 * width + new_w pixels.
+ */
+static bool linear_resize_area(const fossil_image_t *image, uint32_t new_w, uint32_t new_h,
+                               uint8_t *dst, float *rows) {
+    uint32_t w = image->width;
+    uint32_t h = image->height;
+    size_t c = image->channels;
+    size_t bpp = fossil_image_bytes_per_pixel(image->format);
+    size_t src_stride = (size_t)w * bpp;
+    size_t dst_stride = (size_t)new_w * bpp;
+    size_t samples = (size_t)w * c;
+
+    resample_axis_t ax = {0};
+    resample_axis_t ay = {0};
+    bool ok = resample_axis_init(&ax, w, new_w, FOSSIL_INTERP_AREA) &&
+              resample_axis_init(&ay, h, new_h, FOSSIL_INTERP_AREA);
+
+    float *row = rows;
+    float *acc = rows + samples;
+    float *out = acc + samples;
+    for (uint32_t y = 0; ok && y < new_h; ++y) {
+        const float *wy = ay.weight + (size_t)y * ay.taps;
+        memset(acc, 0, samples * sizeof(float));
+        for (uint32_t k = 0; k < ay.taps; ++k) {
+            if (wy[k] == 0.0f)
+                continue;
+            fossil_image_color_decode_linear_row(image->format,
+                image->data + (size_t)(ay.start[y] + k) * src_stride, row, w);
+            for (size_t i = 0; i < samples; ++i)
+                acc[i] += wy[k] * row[i];
+        }
+
+        for (uint32_t x = 0; x < new_w; ++x) {
+            const float *wx = ax.weight + (size_t)x * ax.taps;
+            const float *src = acc + (size_t)ax.start[x] * c;
+            for (size_t ch = 0; ch < c; ++ch) {
+                float sum = 0.0f;
+                for (uint32_t k = 0; k < ax.taps; ++k)
+                    sum += wx[k] * src[(size_t)k * c + ch];
+                out[(size_t)x * c + ch] = sum;
             }
-            break;
-        default:
-            free(new_buffer);
-            return false;
+        }
+        fossil_image_color_encode_linear_row(image->format, out,
+            dst + (size_t)y * dst_stride, new_w);
     }
 
-    // Free old buffer and update image
-    if (is_float) {
-        free(image->fdata);
-        image->fdata = (float *)new_buffer;
-    } else {
-        free(image->data);
-        image->data = (uint8_t *)new_buffer;
+    free(ax.start);
+    free(ax.weight);
+    free(ay.start);
+    free(ay.weight);
+    return ok;
+}
+
+bool fossil_image_process_resize_linear(
+    fossil_image_t *image,
+    uint32_t new_w,
+    uint32_t new_h,
+    fossil_interp_t mode
+) {
+    if (!image || new_w == 0 || new_h == 0)
+        return false;
+    if (!fossil_image_color_linear_rows_supported(image->format))
+        return false;
+
+    bool is_float = (
+        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32 ||
+        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGB ||
+        image->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA
+    );
+    // Only bilinear and area mix samples; everything else is a plain resize
+    if (is_float || (mode != FOSSIL_INTERP_LINEAR && mode != FOSSIL_INTERP_AREA))
+        return fossil_image_process_resize(image, new_w, new_h, mode);
+    if (!image->data)
+        return false;
+
+    size_t c = image->channels;
+    size_t new_size = (size_t)new_w * new_h * fossil_image_bytes_per_pixel(image->format);
+    uint8_t *new_buffer = (uint8_t *)malloc(new_size);
+    float *rows = (float *)malloc(((size_t)image->width * 2 + new_w) * c * sizeof(float));
+    bool ok = new_buffer && rows;
+    if (ok && mode == FOSSIL_INTERP_AREA)
+        ok = linear_resize_area(image, new_w, new_h, new_buffer, rows);
+    else if (ok)
+        ok = linear_resize_bilinear(image, new_w, new_h, new_buffer, rows);
+    free(rows);
+    if (!ok) {
+        free(new_buffer);
+        return false;
     }
+
+    if (image->owns_data)
+        free(image->data);
+    image->data = new_buffer;
+    image->owns_data = true;
     image->width = new_w;
     image->height = new_h;
     image->size = new_size;
@@ -645,6 +1294,49 @@ bool fossil_image_process_blend(
     return true;
 }
 
+bool fossil_image_process_blend_linear(
+    fossil_image_t *dst,
+    const fossil_image_t *src,
+    float ratio
+) {
+    if (!dst || !src)
+        return false;
+
+    if (dst->width != src->width || dst->height != src->height ||
+        dst->channels != src->channels || dst->format != src->format)
+        return false;
+    if (!fossil_image_color_linear_rows_supported(dst->format))
+        return false;
+    if (dst->format == FOSSIL_PIXEL_FORMAT_FLOAT32 ||
+        dst->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGB ||
+        dst->format == FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA)
+        return fossil_image_process_blend(dst, src, ratio);
+    if (!dst->data || !src->data)
+        return false;
+
+    ratio = fmaxf(0.0f, fminf(1.0f, ratio));
+
+    size_t row_samples = (size_t)dst->width * dst->channels;
+    size_t stride = (size_t)dst->width * fossil_image_bytes_per_pixel(dst->format);
+    float *rows = (float *)malloc(row_samples * 2 * sizeof(float));
+    if (!rows)
+        return false;
+    float *d = rows;
+    float *s = rows + row_samples;
+
+    for (uint32_t y = 0; y < dst->height; ++y) {
+        uint8_t *drow = dst->data + (size_t)y * stride;
+        fossil_image_color_decode_linear_row(dst->format, drow, d, dst->width);
+        fossil_image_color_decode_linear_row(src->format, src->data + (size_t)y * stride, s, src->width);
+        for (size_t i = 0; i < row_samples; ++i)
+            d[i] += (s[i] - d[i]) * ratio;
+        fossil_image_color_encode_linear_row(dst->format, d, drow, dst->width);
+    }
+
+    free(rows);
+    return true;
+}
+
 bool fossil_image_process_composite(
     fossil_image_t *dst,
     const fossil_image_t *overlay,
@@ -740,150 +1432,300 @@ bool fossil_image_process_composite(
     return true;
 }
 
-bool fossil_image_process_grayscale(fossil_image_t *image) {
-    if (!image)
-        return false;
+// ------------------------------------------------------
+// Luma kernels
+// ------------------------------------------------------
+
+/*
+ * BT.601 weights in Q16 (0.299, 0.587, 0.114). They sum to 65536, so white
+ * stays white, and the 16-bit worst case still fits in 32 bits. Each layout
+ * gets its own loop with a constant stride. The 8-bit kernels deinterleave
+ * explicitly: NEON with vld3/vld4, SSE2 with 32-bit pixel lanes split by
+ * masks and shifts (stride-3 rows load each pixel as a 32-bit word, since
+ * SSE2 has no byte shuffle). The products are formed exactly from the
+ * 16-bit low and high halves, so every path matches the scalar loop bit
+ * for bit. The 16-bit NEON kernels use vld3/vld4 as well; the remaining
+ * 16-bit and float loops are left to the compiler's vectorizer.
+ */
+#define LUMA_WR 19595u
+#define LUMA_WG 38470u
+#define LUMA_WB 7471u
+#define LUMA_ROUND 32768u
+
+#if defined(__SSE2__)
+/* Luma of eight pixels held as 32-bit lanes r | g << 8 | b << 16 in p0, p1. */
+static inline __m128i luma8_sse2(__m128i p0, __m128i p1) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i r = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+    const __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask),
+                                      _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+    const __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask),
+                                      _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+    const __m128i wr = _mm_set1_epi16((short)LUMA_WR);
+    const __m128i wg = _mm_set1_epi16((short)LUMA_WG);
+    const __m128i wb = _mm_set1_epi16((short)LUMA_WB);
+
+    // Full 32-bit products from the low and high 16-bit halves
+    __m128i rl = _mm_mullo_epi16(r, wr), rh = _mm_mulhi_epu16(r, wr);
+    __m128i gl = _mm_mullo_epi16(g, wg), gh = _mm_mulhi_epu16(g, wg);
+    __m128i bl = _mm_mullo_epi16(b, wb), bh = _mm_mulhi_epu16(b, wb);
+    const __m128i bias = _mm_set1_epi32((int)LUMA_ROUND);
+    __m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(rl, rh), _mm_unpacklo_epi16(gl, gh)),
+                               _mm_add_epi32(_mm_unpacklo_epi16(bl, bh), bias));
+    __m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_unpackhi_epi16(rl, rh), _mm_unpackhi_epi16(gl, gh)),
+                               _mm_add_epi32(_mm_unpackhi_epi16(bl, bh), bias));
+    lo = _mm_srli_epi32(lo, 16);
+    hi = _mm_srli_epi32(hi, 16);
+    return _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+}
 
-    size_t npixels = (size_t)image->width * image->height;
+static inline int32_t luma_load32(const uint8_t *p) {
+    int32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+#endif
 
-    switch (image->format) {
-        case FOSSIL_PIXEL_FORMAT_RGB24: {
-            if (!image->data)
-                return false;
-            uint8_t *new_data = (uint8_t *)calloc(npixels, 1);
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint8_t r = image->data[i * 3 + 0];
-                uint8_t g = image->data[i * 3 + 1];
-                uint8_t b = image->data[i * 3 + 2];
-                new_data[i] = (uint8_t)(0.299 * r + 0.587 * g + 0.114 * b);
-            }
-            free(image->data);
-            image->data = new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-            image->size = npixels;
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_RGBA32: {
-            if (!image->data)
-                return false;
-            uint8_t *new_data = (uint8_t *)calloc(npixels, 1);
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint8_t r = image->data[i * 4 + 0];
-                uint8_t g = image->data[i * 4 + 1];
-                uint8_t b = image->data[i * 4 + 2];
-                new_data[i] = (uint8_t)(0.299 * r + 0.587 * g + 0.114 * b);
-            }
-            free(image->data);
-            image->data = new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-            image->size = npixels;
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_RGB48: {
-            if (!image->data)
-                return false;
-            uint16_t *src = (uint16_t *)image->data;
-            uint16_t *new_data = (uint16_t *)calloc(npixels, sizeof(uint16_t));
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint16_t r = src[i * 3 + 0];
-                uint16_t g = src[i * 3 + 1];
-                uint16_t b = src[i * 3 + 2];
-                new_data[i] = (uint16_t)(0.299 * r + 0.587 * g + 0.114 * b);
-            }
-            free(image->data);
-            image->data = (uint8_t *)new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY16;
-            image->size = npixels * sizeof(uint16_t);
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_RGBA64: {
-            if (!image->data)
-                return false;
-            uint16_t *src = (uint16_t *)image->data;
-            uint16_t *new_data = (uint16_t *)calloc(npixels, sizeof(uint16_t));
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint16_t r = src[i * 4 + 0];
-                uint16_t g = src[i * 4 + 1];
-                uint16_t b = src[i * 4 + 2];
-                new_data[i] = (uint16_t)(0.299 * r + 0.587 * g + 0.114 * b);
-            }
-            free(image->data);
-            image->data = (uint8_t *)new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY16;
-            image->size = npixels * sizeof(uint16_t);
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB: {
-            if (!image->fdata)
-                return false;
-            float *new_fdata = (float *)calloc(npixels, sizeof(float));
-            if (!new_fdata)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = image->fdata[i * 3 + 0];
-                float g = image->fdata[i * 3 + 1];
-                float b = image->fdata[i * 3 + 2];
-                new_fdata[i] = 0.299f * r + 0.587f * g + 0.114f * b;
-            }
-            free(image->fdata);
-            image->fdata = new_fdata;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_FLOAT32;
-            image->size = npixels * sizeof(float);
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA: {
-            if (!image->fdata)
-                return false;
-            float *new_fdata = (float *)calloc(npixels, sizeof(float));
-            if (!new_fdata)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                float r = image->fdata[i * 4 + 0];
-                float g = image->fdata[i * 4 + 1];
-                float b = image->fdata[i * 4 + 2];
-                new_fdata[i] = 0.299f * r + 0.587f * g + 0.114f * b;
-            }
-            free(image->fdata);
-            image->fdata = new_fdata;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_FLOAT32;
-            image->size = npixels * sizeof(float);
-            break;
-        }
-        case FOSSIL_PIXEL_FORMAT_YUV24: {
-            if (!image->data)
-                return false;
-            uint8_t *new_data = (uint8_t *)calloc(npixels, 1);
-            if (!new_data)
-                return false;
-            for (size_t i = 0; i < npixels; ++i) {
-                uint8_t y = image->data[i * 3 + 0];
-                new_data[i] = y;
-            }
-            free(image->data);
-            image->data = new_data;
-            image->channels = 1;
-            image->format = FOSSIL_PIXEL_FORMAT_GRAY8;
-            image->size = npixels;
-            break;
-        }
+#if defined(__ARM_NEON)
+static inline uint16x8_t luma16_neon(uint16x8_t r, uint16x8_t g, uint16x8_t b) {
+    uint32x4_t lo = vdupq_n_u32(LUMA_ROUND), hi = vdupq_n_u32(LUMA_ROUND);
+    lo = vmlal_n_u16(lo, vget_low_u16(r), LUMA_WR);
+    hi = vmlal_n_u16(hi, vget_high_u16(r), LUMA_WR);
+    lo = vmlal_n_u16(lo, vget_low_u16(g), LUMA_WG);
+    hi = vmlal_n_u16(hi, vget_high_u16(g), LUMA_WG);
+    lo = vmlal_n_u16(lo, vget_low_u16(b), LUMA_WB);
+    hi = vmlal_n_u16(hi, vget_high_u16(b), LUMA_WB);
+    return vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+}
+
+static inline uint8x16_t luma8_neon(uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+    uint16x8_t lo = luma16_neon(vmovl_u8(vget_low_u8(r)), vmovl_u8(vget_low_u8(g)), vmovl_u8(vget_low_u8(b)));
+    uint16x8_t hi = luma16_neon(vmovl_u8(vget_high_u8(r)), vmovl_u8(vget_high_u8(g)), vmovl_u8(vget_high_u8(b)));
+    return vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+}
+#endif
+
+static void luma8_c3(const uint8_t *restrict src, uint8_t *restrict dst, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t px = vld3q_u8(src + i * 3);
+        vst1q_u8(dst + i, luma8_neon(px.val[0], px.val[1], px.val[2]));
+    }
+#elif defined(__SSE2__)
+    // Each pixel is read as four bytes, so the last one is left to the tail
+    for (; i + 9 <= n; i += 8) {
+        const uint8_t *p = src + i * 3;
+        __m128i p0 = _mm_set_epi32(luma_load32(p + 9), luma_load32(p + 6), luma_load32(p + 3), luma_load32(p));
+        __m128i p1 = _mm_set_epi32(luma_load32(p + 21), luma_load32(p + 18), luma_load32(p + 15), luma_load32(p + 12));
+        _mm_storel_epi64((__m128i *)(dst + i), luma8_sse2(p0, p1));
+    }
+#endif
+    for (; i < n; ++i) {
+        uint32_t r = src[i * 3], g = src[i * 3 + 1], b = src[i * 3 + 2];
+        dst[i] = (uint8_t)((r * LUMA_WR + g * LUMA_WG + b * LUMA_WB + LUMA_ROUND) >> 16);
+    }
+}
+
+static void luma8_c4(const uint8_t *restrict src, uint8_t *restrict dst, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x4_t px = vld4q_u8(src + i * 4);
+        vst1q_u8(dst + i, luma8_neon(px.val[0], px.val[1], px.val[2]));
+    }
+#elif defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i p0 = _mm_loadu_si128((const __m128i *)(src + i * 4));
+        __m128i p1 = _mm_loadu_si128((const __m128i *)(src + i * 4 + 16));
+        _mm_storel_epi64((__m128i *)(dst + i), luma8_sse2(p0, p1));
+    }
+#endif
+    for (; i < n; ++i) {
+        uint32_t r = src[i * 4], g = src[i * 4 + 1], b = src[i * 4 + 2];
+        dst[i] = (uint8_t)((r * LUMA_WR + g * LUMA_WG + b * LUMA_WB + LUMA_ROUND) >> 16);
+    }
+}
+
+static void luma16_c3(const uint16_t *restrict src, uint16_t *restrict dst, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8x3_t px = vld3q_u16(src + i * 3);
+        vst1q_u16(dst + i, luma16_neon(px.val[0], px.val[1], px.val[2]));
+    }
+#endif
+    for (; i < n; ++i) {
+        uint32_t r = src[i * 3], g = src[i * 3 + 1], b = src[i * 3 + 2];
+        dst[i] = (uint16_t)((r * LUMA_WR + g * LUMA_WG + b * LUMA_WB + LUMA_ROUND) >> 16);
+    }
+}
+
+static void luma16_c4(const uint16_t *restrict src, uint16_t *restrict dst, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8x4_t px = vld4q_u16(src + i * 4);
+        vst1q_u16(dst + i, luma16_neon(px.val[0], px.val[1], px.val[2]));
+    }
+#endif
+    for (; i < n; ++i) {
+        uint32_t r = src[i * 4], g = src[i * 4 + 1], b = src[i * 4 + 2];
+        dst[i] = (uint16_t)((r * LUMA_WR + g * LUMA_WG + b * LUMA_WB + LUMA_ROUND) >> 16);
+    }
+}
+
+static void lumaf_c3(const float *restrict src, float *restrict dst, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = 0.299f * src[i * 3] + 0.587f * src[i * 3 + 1] + 0.114f * src[i * 3 + 2];
+}
+
+static void lumaf_c4(const float *restrict src, float *restrict dst, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = 0.299f * src[i * 4] + 0.587f * src[i * 4 + 1] + 0.114f * src[i * 4 + 2];
+}
+
+void fossil_image_process_luma8_row(
+    const uint8_t *src,
+    uint8_t *dst,
+    size_t pixels,
+    size_t channels
+) {
+    if (channels == 4)
+        luma8_c4(src, dst, pixels);
+    else if (channels == 3)
+        luma8_c3(src, dst, pixels);
+}
+
+void fossil_image_process_luma16_row(
+    const uint16_t *src,
+    uint16_t *dst,
+    size_t pixels,
+    size_t channels
+) {
+    if (channels == 4)
+        luma16_c4(src, dst, pixels);
+    else if (channels == 3)
+        luma16_c3(src, dst, pixels);
+}
+
+static fossil_pixel_format_t gray_format_for(fossil_pixel_format_t format) {
+    switch (format) {
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGBA32:
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+            return FOSSIL_PIXEL_FORMAT_GRAY8;
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+            return FOSSIL_PIXEL_FORMAT_GRAY16;
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            return FOSSIL_PIXEL_FORMAT_FLOAT32;
         default:
-            // Already grayscale or unsupported format
+            return FOSSIL_PIXEL_FORMAT_NONE;
+    }
+}
+
+/*
+ * Convert a span of pixels. src and dst may be the same buffer: output
+ * element i never lies past input element i, and the span is converted in
+ * chunks through a stack buffer so the kernels can assume no aliasing.
+ */
+static void luma_span(
+    fossil_pixel_format_t format,
+    const void *src,
+    void *dst,
+    size_t pixels
+) {
+    enum { CHUNK = 1024 };
+    union {
+        uint8_t u8[CHUNK];
+        uint16_t u16[CHUNK];
+        float f32[CHUNK];
+    } tmp;
+
+    for (size_t i = 0; i < pixels; i += CHUNK) {
+        size_t n = pixels - i < CHUNK ? pixels - i : CHUNK;
+        switch (format) {
+            case FOSSIL_PIXEL_FORMAT_RGB24:
+                luma8_c3((const uint8_t *)src + i * 3, tmp.u8, n);
+                memcpy((uint8_t *)dst + i, tmp.u8, n);
+                break;
+            case FOSSIL_PIXEL_FORMAT_RGBA32:
+                luma8_c4((const uint8_t *)src + i * 4, tmp.u8, n);
+                memcpy((uint8_t *)dst + i, tmp.u8, n);
+                break;
+            case FOSSIL_PIXEL_FORMAT_YUV24:
+                // Y already is the luma channel
+                for (size_t k = 0; k < n; ++k)
+                    tmp.u8[k] = ((const uint8_t *)src)[(i + k) * 3];
+                memcpy((uint8_t *)dst + i, tmp.u8, n);
+                break;
+            case FOSSIL_PIXEL_FORMAT_RGB48:
+                luma16_c3((const uint16_t *)src + i * 3, tmp.u16, n);
+                memcpy((uint16_t *)dst + i, tmp.u16, n * sizeof(uint16_t));
+                break;
+            case FOSSIL_PIXEL_FORMAT_RGBA64:
+                luma16_c4((const uint16_t *)src + i * 4, tmp.u16, n);
+                memcpy((uint16_t *)dst + i, tmp.u16, n * sizeof(uint16_t));
+                break;
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+                lumaf_c3((const float *)src + i * 3, tmp.f32, n);
+                memcpy((float *)dst + i, tmp.f32, n * sizeof(float));
+                break;
+            case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+                lumaf_c4((const float *)src + i * 4, tmp.f32, n);
+                memcpy((float *)dst + i, tmp.f32, n * sizeof(float));
+                break;
+            default:
+                return;
+        }
+    }
+}
+
+bool fossil_image_process_grayscale(fossil_image_t *image) {
+    if (!image || !image->data)
+        return false;
+
+    fossil_pixel_format_t gray = gray_format_for(image->format);
+    if (gray == FOSSIL_PIXEL_FORMAT_NONE)
+        // Already grayscale or unsupported format
+        return false;
+
+    // Luma is packed into the front of an owned buffer with no allocation.
+    // A borrowed buffer is left intact and the result goes to a new one.
+    size_t npixels = (size_t)image->width * image->height;
+    if (image->owns_data) {
+        luma_span(image->format, image->data, image->data, npixels);
+    } else {
+        uint8_t *data = (uint8_t *)malloc(npixels * fossil_image_bytes_per_pixel(gray));
+        if (!data)
             return false;
+        luma_span(image->format, image->data, data, npixels);
+        image->data = data;
+        image->owns_data = true;
     }
+
+    image->format = gray;
+    image->channels = 1;
+    image->size = npixels * fossil_image_bytes_per_pixel(gray);
+    return true;
+}
+
+bool fossil_image_process_grayscale_into(
+    const fossil_image_t *src,
+    fossil_image_t *dst
+) {
+    if (!src || !dst || !src->data || !dst->data || src == dst)
+        return false;
+
+    fossil_pixel_format_t gray = gray_format_for(src->format);
+    if (gray == FOSSIL_PIXEL_FORMAT_NONE || dst->format != gray)
+        return false;
+    if (dst->width != src->width || dst->height != src->height)
+        return false;
+
+    luma_span(src->format, src->data, dst->data, (size_t)src->width * src->height);
     return true;
 }
 
@@ -977,81 +1819,586 @@ bool fossil_image_process_invert(fossil_image_t *image) {
     return true;
 }
 
-bool fossil_image_process_normalize(fossil_image_t *image) {
-    if (!image)
+// ------------------------------------------------------
+// Normalization
+// ------------------------------------------------------
+
+/*
+ * Normalization runs in two banded passes. The first builds one histogram per
+ * band and channel (integer formats) or a min/max per band and channel
+ * (float formats). The bands are merged, the stretch range is read off the
+ * cumulative counts, and the second pass applies a lookup table (integers)
+ * or a scale (floats) row by row.
+ */
+#define NORMALIZE_FLOAT_BINS 4096u
+#define NORMALIZE_MIN_SAMPLES 65536u
+
+typedef struct normalize_ctx {
+    fossil_image_t *image;
+    uint32_t channels;
+    uint32_t bins;
+    uint32_t *hist;
+    const uint16_t *lut;
+    float *fmin;
+    float *fmax;
+    const float *lo;
+    const float *scale;
+} normalize_ctx_t;
+
+static void normalize_hist_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    normalize_ctx_t *ctx = (normalize_ctx_t *)arg;
+    uint32_t c = ctx->channels;
+    size_t row = (size_t)ctx->image->width * c;
+    uint32_t *hist = ctx->hist + (size_t)band * c * ctx->bins;
+
+    if (ctx->bins == 256) {
+        for (uint32_t y = begin; y < end; ++y) {
+            const uint8_t *p = ctx->image->data + (size_t)y * row;
+            for (size_t i = 0; i < row; i += c)
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    hist[ch * 256 + p[i + ch]]++;
+        }
+    } else {
+        for (uint32_t y = begin; y < end; ++y) {
+            const uint16_t *p = (const uint16_t *)ctx->image->data + (size_t)y * row;
+            for (size_t i = 0; i < row; i += c)
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    hist[(size_t)ch * 65536 + p[i + ch]]++;
+        }
+    }
+}
+
+static void normalize_lut_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    normalize_ctx_t *ctx = (normalize_ctx_t *)arg;
+    uint32_t c = ctx->channels;
+    size_t row = (size_t)ctx->image->width * c;
+
+    if (ctx->bins == 256) {
+        for (uint32_t y = begin; y < end; ++y) {
+            uint8_t *p = ctx->image->data + (size_t)y * row;
+            for (size_t i = 0; i < row; i += c)
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    p[i + ch] = (uint8_t)ctx->lut[ch * 256 + p[i + ch]];
+        }
+    } else {
+        for (uint32_t y = begin; y < end; ++y) {
+            uint16_t *p = (uint16_t *)ctx->image->data + (size_t)y * row;
+            for (size_t i = 0; i < row; i += c)
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    p[i + ch] = ctx->lut[(size_t)ch * 65536 + p[i + ch]];
+        }
+    }
+}
+
+static void normalize_minmax_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    normalize_ctx_t *ctx = (normalize_ctx_t *)arg;
+    uint32_t c = ctx->channels;
+    size_t row = (size_t)ctx->image->width * c;
+    float *mn = ctx->fmin + (size_t)band * c;
+    float *mx = ctx->fmax + (size_t)band * c;
+    const float *first = ctx->image->fdata + (size_t)begin * row;
+    for (uint32_t ch = 0; ch < c; ++ch)
+        mn[ch] = mx[ch] = first[ch];
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const float *p = ctx->image->fdata + (size_t)y * row;
+        for (size_t i = 0; i < row; i += c) {
+            for (uint32_t ch = 0; ch < c; ++ch) {
+                float v = p[i + ch];
+                if (v < mn[ch]) mn[ch] = v;
+                if (v > mx[ch]) mx[ch] = v;
+            }
+        }
+    }
+}
+
+/* Float histogram over [lo[ch], lo[ch] + 1 / scale[ch]] per channel. */
+static void normalize_fhist_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    normalize_ctx_t *ctx = (normalize_ctx_t *)arg;
+    uint32_t c = ctx->channels;
+    size_t row = (size_t)ctx->image->width * c;
+    uint32_t *hist = ctx->hist + (size_t)band * c * NORMALIZE_FLOAT_BINS;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        const float *p = ctx->image->fdata + (size_t)y * row;
+        for (size_t i = 0; i < row; i += c) {
+            for (uint32_t ch = 0; ch < c; ++ch) {
+                float t = (p[i + ch] - ctx->lo[ch]) * ctx->scale[ch];
+                int64_t bin = (int64_t)(t * (float)NORMALIZE_FLOAT_BINS);
+                if (bin < 0) bin = 0;
+                if (bin >= (int64_t)NORMALIZE_FLOAT_BINS) bin = NORMALIZE_FLOAT_BINS - 1;
+                hist[ch * NORMALIZE_FLOAT_BINS + (uint32_t)bin]++;
+            }
+        }
+    }
+}
+
+static void normalize_scale_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    (void)band;
+    normalize_ctx_t *ctx = (normalize_ctx_t *)arg;
+    uint32_t c = ctx->channels;
+    size_t row = (size_t)ctx->image->width * c;
+
+    for (uint32_t y = begin; y < end; ++y) {
+        float *p = ctx->image->fdata + (size_t)y * row;
+        for (size_t i = 0; i < row; i += c) {
+            for (uint32_t ch = 0; ch < c; ++ch) {
+                // A constant channel is left as is, like the integer path
+                if (ctx->scale[ch] == 0.0f)
+                    continue;
+                float normalized = (p[i + ch] - ctx->lo[ch]) * ctx->scale[ch];
+                if (normalized < 0.0f) normalized = 0.0f;
+                if (normalized > 1.0f) normalized = 1.0f;
+                p[i + ch] = normalized;
+            }
+        }
+    }
+}
+
+/* Smallest bin whose cumulative count exceeds rank. */
+static uint32_t normalize_rank_bin(const uint32_t *hist, uint32_t bins, uint64_t rank) {
+    uint64_t acc = 0;
+    for (uint32_t v = 0; v < bins; ++v) {
+        acc += hist[v];
+        if (acc > rank)
+            return v;
+    }
+    return bins - 1;
+}
+
+/* Merge band histograms into band 0 and pool channels into channel 0. */
+static void normalize_merge(uint32_t *hist, uint32_t bands, uint32_t c, uint32_t bins, bool per_channel) {
+    size_t span = (size_t)c * bins;
+    for (uint32_t b = 1; b < bands; ++b) {
+        const uint32_t *src = hist + b * span;
+        for (size_t i = 0; i < span; ++i)
+            hist[i] += src[i];
+    }
+    if (!per_channel) {
+        for (uint32_t ch = 1; ch < c; ++ch)
+            for (uint32_t v = 0; v < bins; ++v)
+                hist[v] += hist[(size_t)ch * bins + v];
+    }
+}
+
+static bool normalize_integer(
+    fossil_image_t *image,
+    uint32_t bins,
+    float low_percent,
+    float high_percent,
+    bool per_channel
+) {
+    uint32_t c = image->channels;
+    uint32_t h = image->height;
+    uint32_t min_rows = NORMALIZE_MIN_SAMPLES / (image->width * c) + 1;
+    // Keep per-band 16-bit histograms to a few megabytes
+    if (bins > 256 && min_rows < h / 8)
+        min_rows = h / 8;
+    uint32_t bands = fossil_image_parallel_bands(h, min_rows);
+
+    uint32_t *hist = (uint32_t *)calloc((size_t)bands * c * bins, sizeof(uint32_t));
+    uint16_t *lut = (uint16_t *)malloc((size_t)c * bins * sizeof(uint16_t));
+    if (!hist || !lut) {
+        free(hist);
+        free(lut);
         return false;
+    }
 
-    size_t npixels = (size_t)image->width * image->height * image->channels;
+    normalize_ctx_t ctx = { 0 };
+    ctx.image = image;
+    ctx.channels = c;
+    ctx.bins = bins;
+    ctx.hist = hist;
+    ctx.lut = lut;
+    fossil_image_parallel_for_bands(bands, h, normalize_hist_band, &ctx);
+    normalize_merge(hist, bands, c, bins, per_channel);
+
+    uint64_t samples = (uint64_t)image->width * h * (per_channel ? 1 : c);
+    uint64_t lo_rank = (uint64_t)((double)low_percent / 100.0 * (double)(samples - 1));
+    uint64_t hi_rank = (uint64_t)ceil((double)high_percent / 100.0 * (double)(samples - 1));
+    float max_out = (float)(bins - 1);
+    bool changed = false;
+
+    for (uint32_t ch = 0; ch < c; ++ch) {
+        const uint32_t *ch_hist = hist + (per_channel ? (size_t)ch * bins : 0);
+        uint32_t min_val = normalize_rank_bin(ch_hist, bins, lo_rank);
+        uint32_t max_val = normalize_rank_bin(ch_hist, bins, hi_rank);
+        uint16_t *ch_lut = lut + (size_t)ch * bins;
+        if (max_val <= min_val) {
+            for (uint32_t v = 0; v < bins; ++v)
+                ch_lut[v] = (uint16_t)v;
+            continue;
+        }
+        changed = true;
+        float scale = max_out / (float)(max_val - min_val);
+        for (uint32_t v = 0; v < bins; ++v) {
+            float normalized = ((float)v - (float)min_val) * scale;
+            if (normalized < 0.0f) normalized = 0.0f;
+            if (normalized > max_out) normalized = max_out;
+            ch_lut[v] = (uint16_t)(normalized + 0.5f);
+        }
+    }
+
+    if (changed)
+        fossil_image_parallel_for(h, NORMALIZE_MIN_SAMPLES / (image->width * c) + 1,
+                                  normalize_lut_band, &ctx);
+    free(hist);
+    free(lut);
+    return true;
+}
+
+static bool normalize_float(
+    fossil_image_t *image,
+    float low_percent,
+    float high_percent,
+    bool per_channel
+) {
+    uint32_t c = image->channels;
+    uint32_t h = image->height;
+    uint32_t min_rows = NORMALIZE_MIN_SAMPLES / (image->width * c) + 1;
+    uint32_t bands = fossil_image_parallel_bands(h, min_rows);
+
+    float *ranges = (float *)malloc(((size_t)bands * 2 + 2) * c * sizeof(float));
+    if (!ranges)
+        return false;
+    normalize_ctx_t ctx = { 0 };
+    ctx.image = image;
+    ctx.channels = c;
+    ctx.fmin = ranges;
+    ctx.fmax = ranges + (size_t)bands * c;
+    float *lo = ranges + (size_t)bands * 2 * c;
+    float *scale = lo + c;
+    ctx.lo = lo;
+    ctx.scale = scale;
+
+    fossil_image_parallel_for_bands(bands, h, normalize_minmax_band, &ctx);
+    for (uint32_t b = 1; b < bands; ++b) {
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            if (ctx.fmin[b * c + ch] < ctx.fmin[ch]) ctx.fmin[ch] = ctx.fmin[b * c + ch];
+            if (ctx.fmax[b * c + ch] > ctx.fmax[ch]) ctx.fmax[ch] = ctx.fmax[b * c + ch];
+        }
+    }
+    if (!per_channel) {
+        for (uint32_t ch = 1; ch < c; ++ch) {
+            if (ctx.fmin[ch] < ctx.fmin[0]) ctx.fmin[0] = ctx.fmin[ch];
+            if (ctx.fmax[ch] > ctx.fmax[0]) ctx.fmax[0] = ctx.fmax[ch];
+        }
+        for (uint32_t ch = 1; ch < c; ++ch) {
+            ctx.fmin[ch] = ctx.fmin[0];
+            ctx.fmax[ch] = ctx.fmax[0];
+        }
+    }
+
+    bool changed = false;
+    for (uint32_t ch = 0; ch < c; ++ch) {
+        lo[ch] = ctx.fmin[ch];
+        float span = ctx.fmax[ch] - ctx.fmin[ch];
+        scale[ch] = span > 0.0f ? 1.0f / span : 0.0f;
+        if (span > 0.0f)
+            changed = true;
+    }
+    if (!changed) {
+        free(ranges);
+        return true;
+    }
+
+    // Percentile clipping refines the range from a histogram over [min, max]
+    if (low_percent > 0.0f || high_percent < 100.0f) {
+        uint32_t *hist = (uint32_t *)calloc((size_t)bands * c * NORMALIZE_FLOAT_BINS, sizeof(uint32_t));
+        if (!hist) {
+            free(ranges);
+            return false;
+        }
+        ctx.hist = hist;
+        fossil_image_parallel_for_bands(bands, h, normalize_fhist_band, &ctx);
+        normalize_merge(hist, bands, c, NORMALIZE_FLOAT_BINS, per_channel);
+
+        uint64_t samples = (uint64_t)image->width * h * (per_channel ? 1 : c);
+        uint64_t lo_rank = (uint64_t)((double)low_percent / 100.0 * (double)(samples - 1));
+        uint64_t hi_rank = (uint64_t)ceil((double)high_percent / 100.0 * (double)(samples - 1));
+        float new_lo[4], new_hi[4];
+        for (uint32_t ch = 0; ch < c && ch < 4; ++ch) {
+            const uint32_t *ch_hist = hist + (per_channel ? (size_t)ch * NORMALIZE_FLOAT_BINS : 0);
+            float width = 1.0f / (scale[ch] * (float)NORMALIZE_FLOAT_BINS);
+            new_lo[ch] = lo[ch] + width * (float)normalize_rank_bin(ch_hist, NORMALIZE_FLOAT_BINS, lo_rank);
+            new_hi[ch] = lo[ch] + width * (float)(normalize_rank_bin(ch_hist, NORMALIZE_FLOAT_BINS, hi_rank) + 1);
+        }
+        for (uint32_t ch = 0; ch < c && ch < 4; ++ch) {
+            if (scale[ch] == 0.0f)
+                continue;
+            lo[ch] = new_lo[ch];
+            scale[ch] = 1.0f / (new_hi[ch] - new_lo[ch]);
+        }
+        free(hist);
+    }
+
+    fossil_image_parallel_for(h, min_rows, normalize_scale_band, &ctx);
+    free(ranges);
+    return true;
+}
+
+bool fossil_image_process_normalize_range(
+    fossil_image_t *image,
+    float low_percent,
+    float high_percent,
+    bool per_channel
+) {
+    if (!image || !image->data || image->width == 0 || image->height == 0 || image->channels == 0)
+        return false;
+    if (!(low_percent >= 0.0f && low_percent < high_percent && high_percent <= 100.0f))
+        return false;
 
     switch (image->format) {
         case FOSSIL_PIXEL_FORMAT_GRAY8:
         case FOSSIL_PIXEL_FORMAT_RGB24:
         case FOSSIL_PIXEL_FORMAT_RGBA32:
         case FOSSIL_PIXEL_FORMAT_INDEXED8:
-        case FOSSIL_PIXEL_FORMAT_YUV24: {
-            if (!image->data)
-                return false;
-            uint8_t min_val = 255, max_val = 0;
-            for (size_t i = 0; i < npixels; ++i) {
-                if (image->data[i] < min_val) min_val = image->data[i];
-                if (image->data[i] > max_val) max_val = image->data[i];
-            }
-            if (max_val == min_val)
-                return true;
-            float scale = 255.0f / (float)(max_val - min_val);
-            for (size_t i = 0; i < npixels; ++i) {
-                float normalized = ((float)image->data[i] - (float)min_val) * scale;
-                if (normalized < 0.0f) normalized = 0.0f;
-                if (normalized > 255.0f) normalized = 255.0f;
-                image->data[i] = (uint8_t)(normalized + 0.5f);
-            }
-            break;
-        }
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+            return normalize_integer(image, 256, low_percent, high_percent, per_channel);
         case FOSSIL_PIXEL_FORMAT_GRAY16:
         case FOSSIL_PIXEL_FORMAT_RGB48:
-        case FOSSIL_PIXEL_FORMAT_RGBA64: {
-            if (!image->data)
-                return false;
-            uint16_t *data16 = (uint16_t *)image->data;
-            uint16_t min_val = 65535, max_val = 0;
-            for (size_t i = 0; i < npixels; ++i) {
-                if (data16[i] < min_val) min_val = data16[i];
-                if (data16[i] > max_val) max_val = data16[i];
-            }
-            if (max_val == min_val)
-                return true;
-            float scale = 65535.0f / (float)(max_val - min_val);
-            for (size_t i = 0; i < npixels; ++i) {
-                float normalized = ((float)data16[i] - (float)min_val) * scale;
-                if (normalized < 0.0f) normalized = 0.0f;
-                if (normalized > 65535.0f) normalized = 65535.0f;
-                data16[i] = (uint16_t)(normalized + 0.5f);
-            }
-            break;
-        }
+        case FOSSIL_PIXEL_FORMAT_RGBA64:
+            return normalize_integer(image, 65536, low_percent, high_percent, per_channel);
         case FOSSIL_PIXEL_FORMAT_FLOAT32:
         case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
-        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA: {
-            if (!image->fdata)
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGBA:
+            if (image->channels > 4)
                 return false;
-            float min_val = image->fdata[0], max_val = image->fdata[0];
-            for (size_t i = 1; i < npixels; ++i) {
-                if (image->fdata[i] < min_val) min_val = image->fdata[i];
-                if (image->fdata[i] > max_val) max_val = image->fdata[i];
+            return normalize_float(image, low_percent, high_percent, per_channel);
+        default:
+            return false;
+    }
+}
+
+bool fossil_image_process_normalize(fossil_image_t *image) {
+    return fossil_image_process_normalize_range(image, 0.0f, 100.0f, false);
+}
+
+// ------------------------------------------------------
+// Pyramids
+// ------------------------------------------------------
+
+/*
+ * Every level halves the previous one, rounding up so that no source pixel
+ * is dropped; reads past the edge are clamped. The box filter averages 2x2
+ * blocks. The Gaussian filter runs the [1 4 6 4 1] binomial down five source
+ * rows into an accumulator row and then across it at every other column,
+ * so only the kept samples are ever computed.
+ */
+#define PYRAMID_ALIGN 64u
+#define PYRAMID_MIN_ROWS 8u
+
+typedef struct pyramid_ctx {
+    const fossil_image_t *src;
+    fossil_image_t *dst;
+    fossil_pyramid_filter_t filter;
+    size_t sample_size;
+    void *scratch;                     // per band: one source row of uint32_t or float
+    size_t scratch_row;                // samples per scratch row
+} pyramid_ctx_t;
+
+static inline uint32_t pyramid_clamp(int64_t v, uint32_t n) {
+    return v < 0 ? 0 : v >= (int64_t)n ? n - 1 : (uint32_t)v;
+}
+
+static void pyramid_box_row(const pyramid_ctx_t *p, uint32_t oy) {
+    const fossil_image_t *s = p->src;
+    fossil_image_t *d = p->dst;
+    const uint32_t c = s->channels, sw = s->width;
+    const size_t r0 = (size_t)2 * oy * sw * c;
+    const size_t r1 = (size_t)pyramid_clamp((int64_t)2 * oy + 1, s->height) * sw * c;
+    const size_t out = (size_t)oy * d->width * c;
+
+    for (uint32_t ox = 0; ox < d->width; ++ox) {
+        const size_t x0 = (size_t)2 * ox * c;
+        const size_t x1 = (size_t)pyramid_clamp((int64_t)2 * ox + 1, sw) * c;
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            switch (p->sample_size) {
+                case 1: {
+                    const uint8_t *a = s->data;
+                    d->data[out + (size_t)ox * c + ch] =
+                        (uint8_t)((a[r0 + x0 + ch] + a[r0 + x1 + ch] + a[r1 + x0 + ch] + a[r1 + x1 + ch] + 2u) >> 2);
+                    break;
+                }
+                case 2: {
+                    const uint16_t *a = (const uint16_t *)s->data;
+                    ((uint16_t *)d->data)[out + (size_t)ox * c + ch] =
+                        (uint16_t)(((uint32_t)a[r0 + x0 + ch] + a[r0 + x1 + ch] + a[r1 + x0 + ch] + a[r1 + x1 + ch] + 2u) >> 2);
+                    break;
+                }
+                default: {
+                    const float *a = s->fdata;
+                    d->fdata[out + (size_t)ox * c + ch] =
+                        0.25f * (a[r0 + x0 + ch] + a[r0 + x1 + ch] + a[r1 + x0 + ch] + a[r1 + x1 + ch]);
+                    break;
+                }
             }
-            if (max_val == min_val)
-                return true;
-            float scale = 1.0f / (max_val - min_val);
-            for (size_t i = 0; i < npixels; ++i) {
-                float normalized = (image->fdata[i] - min_val) * scale;
-                if (normalized < 0.0f) normalized = 0.0f;
-                if (normalized > 1.0f) normalized = 1.0f;
-                image->fdata[i] = normalized;
+        }
+    }
+}
+
+static void pyramid_gaussian_row(const pyramid_ctx_t *p, uint32_t oy, void *scratch) {
+    static const uint32_t taps[5] = { 1, 4, 6, 4, 1 };
+    const fossil_image_t *s = p->src;
+    fossil_image_t *d = p->dst;
+    const uint32_t c = s->channels, sw = s->width;
+    const size_t row = (size_t)sw * c;
+    size_t rows[5];
+    for (int k = 0; k < 5; ++k)
+        rows[k] = (size_t)pyramid_clamp((int64_t)2 * oy + k - 2, s->height) * row;
+
+    // Vertical taps over the whole source row
+    if (p->sample_size == 4) {
+        float *acc = (float *)scratch;
+        const float *a = s->fdata;
+        for (size_t i = 0; i < row; ++i)
+            acc[i] = a[rows[0] + i] + 4.0f * a[rows[1] + i] + 6.0f * a[rows[2] + i] +
+                     4.0f * a[rows[3] + i] + a[rows[4] + i];
+    } else if (p->sample_size == 2) {
+        uint32_t *acc = (uint32_t *)scratch;
+        const uint16_t *a = (const uint16_t *)s->data;
+        for (size_t i = 0; i < row; ++i)
+            acc[i] = a[rows[0] + i] + 4u * a[rows[1] + i] + 6u * a[rows[2] + i] + 4u * a[rows[3] + i] + a[rows[4] + i];
+    } else {
+        uint32_t *acc = (uint32_t *)scratch;
+        const uint8_t *a = s->data;
+        for (size_t i = 0; i < row; ++i)
+            acc[i] = a[rows[0] + i] + 4u * a[rows[1] + i] + 6u * a[rows[2] + i] + 4u * a[rows[3] + i] + a[rows[4] + i];
+    }
+
+    // Horizontal taps at the even columns only
+    const size_t out = (size_t)oy * d->width * c;
+    for (uint32_t ox = 0; ox < d->width; ++ox) {
+        size_t cols[5];
+        for (int k = 0; k < 5; ++k)
+            cols[k] = (size_t)pyramid_clamp((int64_t)2 * ox + k - 2, sw) * c;
+        for (uint32_t ch = 0; ch < c; ++ch) {
+            if (p->sample_size == 4) {
+                const float *acc = (const float *)scratch;
+                float sum = 0.0f;
+                for (int k = 0; k < 5; ++k)
+                    sum += (float)taps[k] * acc[cols[k] + ch];
+                d->fdata[out + (size_t)ox * c + ch] = sum * (1.0f / 256.0f);
+            } else {
+                const uint32_t *acc = (const uint32_t *)scratch;
+                uint32_t sum = 128;
+                for (int k = 0; k < 5; ++k)
+                    sum += taps[k] * acc[cols[k] + ch];
+                if (p->sample_size == 2)
+                    ((uint16_t *)d->data)[out + (size_t)ox * c + ch] = (uint16_t)(sum >> 8);
+                else
+                    d->data[out + (size_t)ox * c + ch] = (uint8_t)(sum >> 8);
             }
-            break;
         }
-        default:
+    }
+}
+
+static void pyramid_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    pyramid_ctx_t *p = (pyramid_ctx_t *)arg;
+    void *scratch = (uint8_t *)p->scratch + (size_t)band * p->scratch_row * sizeof(uint32_t);
+    for (uint32_t y = begin; y < end; ++y) {
+        if (p->filter == FOSSIL_PYRAMID_GAUSSIAN)
+            pyramid_gaussian_row(p, y, scratch);
+        else
+            pyramid_box_row(p, y);
+    }
+}
+
+bool fossil_image_process_pyramid_build(
+    const fossil_image_t *src,
+    fossil_pyramid_filter_t filter,
+    uint32_t max_levels,
+    fossil_image_pyramid_t *out
+) {
+    if (!out)
+        return false;
+    out->levels = NULL;
+    out->count = 0;
+    out->size = 0;
+    if (!src || !src->data || src->width == 0 || src->height == 0 || src->channels == 0)
+        return false;
+    if (filter != FOSSIL_PYRAMID_BOX && filter != FOSSIL_PYRAMID_GAUSSIAN)
+        return false;
+    if (src->format == FOSSIL_PIXEL_FORMAT_INDEXED8)
+        return false;
+    const size_t bpp = fossil_image_bytes_per_pixel(src->format);
+    if (bpp == 0 || src->size < (size_t)src->width * src->height * bpp)
+        return false;
+
+    // Lay out the headers and every level in one block
+    uint32_t count = 1;
+    for (uint32_t w = src->width, h = src->height; (w > 1 || h > 1) && (max_levels == 0 || count < max_levels); ++count) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    size_t offset = ((size_t)count * sizeof(fossil_image_t) + PYRAMID_ALIGN - 1) & ~(size_t)(PYRAMID_ALIGN - 1);
+    size_t offsets[33];                 // at most 33 halvings of a 32-bit size
+    for (uint32_t i = 0, w = src->width, h = src->height; i < count; ++i) {
+        offsets[i] = offset;
+        offset += ((size_t)w * h * bpp + PYRAMID_ALIGN - 1) & ~(size_t)(PYRAMID_ALIGN - 1);
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    uint8_t *block = (uint8_t *)malloc(offset);
+    if (!block)
+        return false;
+
+    fossil_image_t *levels = (fossil_image_t *)block;
+    for (uint32_t i = 0; i < count; ++i) {
+        fossil_image_t *level = &levels[i];
+        *level = *src;
+        level->width = i == 0 ? src->width : (levels[i - 1].width + 1) / 2;
+        level->height = i == 0 ? src->height : (levels[i - 1].height + 1) / 2;
+        level->data = block + offsets[i];
+        level->size = (size_t)level->width * level->height * bpp;
+        level->owns_data = false;
+        level->palette = NULL;
+        level->palette_size = 0;
+        level->userdata = NULL;
+    }
+    memcpy(levels[0].data, src->data, levels[0].size);
+
+    pyramid_ctx_t p;
+    p.filter = filter;
+    p.sample_size = bpp / src->channels;
+    p.scratch_row = (size_t)src->width * src->channels;
+    p.scratch = NULL;
+    // Levels only shrink, so the band count of level 1 bounds every level
+    const uint32_t bands = count > 1 ? fossil_image_parallel_bands(levels[1].height, PYRAMID_MIN_ROWS) : 1;
+    if (filter == FOSSIL_PYRAMID_GAUSSIAN && count > 1) {
+        p.scratch = malloc((size_t)bands * p.scratch_row * sizeof(uint32_t));
+        if (!p.scratch) {
+            free(block);
             return false;
+        }
     }
+
+    bool ok = true;
+    for (uint32_t i = 1; ok && i < count; ++i) {
+        p.src = &levels[i - 1];
+        p.dst = &levels[i];
+        uint32_t level_bands = fossil_image_parallel_bands(p.dst->height, PYRAMID_MIN_ROWS);
+        ok = fossil_image_parallel_for_bands(level_bands < bands ? level_bands : bands,
+                                             p.dst->height, pyramid_band, &p);
+    }
+    free(p.scratch);
+    if (!ok) {
+        free(block);
+        return false;
+    }
+
+    out->levels = levels;
+    out->count = count;
+    out->size = offset;
     return true;
 }
+
+void fossil_image_process_pyramid_free(fossil_image_pyramid_t *pyramid) {
+    if (!pyramid)
+        return;
+    free(pyramid->levels);
+    pyramid->levels = NULL;
+    pyramid->count = 0;
+    pyramid->size = 0;
+}
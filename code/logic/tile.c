@@ -0,0 +1,458 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/image/tile.h"
+#include "fossil/image/parallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ======================================================
+// Fossil Image — Tile Sub-Library Implementation
+// ======================================================
+
+/* Tiles per parallel work item; one 64x64 tile is only a few microseconds of work. */
+#define TILE_MIN_TILES 8
+
+static inline uint8_t *tile_pixel(const fossil_image_tiled_t *tiled, uint32_t x, uint32_t y) {
+    uint32_t ts = tiled->tile_size;
+    size_t bpp = tiled->tile_stride / ts;
+    size_t index = (size_t)(y / ts) * tiled->tiles_x + x / ts;
+    return tiled->data + index * tiled->tile_bytes
+         + (size_t)(y % ts) * tiled->tile_stride + (size_t)(x % ts) * bpp;
+}
+
+bool fossil_image_tile_geometry(
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+) {
+    if (!out || width == 0 || height == 0)
+        return false;
+    if (tile_size == 0)
+        tile_size = FOSSIL_IMAGE_TILE_SIZE;
+    if (tile_size < 8 || tile_size > 4096 || (tile_size & (tile_size - 1)) != 0)
+        return false;
+    size_t bpp = fossil_image_bytes_per_pixel(format);
+    if (bpp == 0)
+        return false;
+
+    fossil_image_tiled_t t;
+    memset(&t, 0, sizeof(t));
+    t.width = width;
+    t.height = height;
+    t.format = format;
+    t.tile_size = tile_size;
+    t.tiles_x = (width + tile_size - 1) / tile_size;
+    t.tiles_y = (height + tile_size - 1) / tile_size;
+    t.tile_stride = (size_t)tile_size * bpp;
+    t.tile_bytes = t.tile_stride * tile_size;
+
+    size_t tiles = (size_t)t.tiles_x * t.tiles_y;
+    if (tiles > SIZE_MAX / t.tile_bytes)
+        return false;
+    t.size = tiles * t.tile_bytes;
+
+    switch (format) {
+        case FOSSIL_PIXEL_FORMAT_GRAY8:
+        case FOSSIL_PIXEL_FORMAT_GRAY16:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32:
+        case FOSSIL_PIXEL_FORMAT_INDEXED8:
+            t.channels = 1;
+            break;
+        case FOSSIL_PIXEL_FORMAT_RGB24:
+        case FOSSIL_PIXEL_FORMAT_RGB48:
+        case FOSSIL_PIXEL_FORMAT_FLOAT32_RGB:
+        case FOSSIL_PIXEL_FORMAT_YUV24:
+            t.channels = 3;
+            break;
+        default:
+            t.channels = 4;
+            break;
+    }
+    *out = t;
+    return true;
+}
+
+bool fossil_image_tile_create(
+    uint32_t width,
+    uint32_t height,
+    fossil_pixel_format_t format,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+) {
+    fossil_image_tiled_t t;
+    if (!out || !fossil_image_tile_geometry(width, height, format, tile_size, &t))
+        return false;
+    t.data = (uint8_t *)calloc(1, t.size);
+    if (!t.data)
+        return false;
+    *out = t;
+    return true;
+}
+
+void fossil_image_tile_free(fossil_image_tiled_t *tiled) {
+    if (!tiled)
+        return;
+    free(tiled->data);
+    tiled->data = NULL;
+    tiled->size = 0;
+}
+
+bool fossil_image_tile_get(
+    const fossil_image_tiled_t *tiled,
+    uint32_t tx,
+    uint32_t ty,
+    fossil_image_tile_t *tile
+) {
+    if (!tiled || !tiled->data || !tile || tx >= tiled->tiles_x || ty >= tiled->tiles_y)
+        return false;
+    uint32_t ts = tiled->tile_size;
+    tile->tx = tx;
+    tile->ty = ty;
+    tile->x = tx * ts;
+    tile->y = ty * ts;
+    tile->width = tiled->width - tile->x < ts ? tiled->width - tile->x : ts;
+    tile->height = tiled->height - tile->y < ts ? tiled->height - tile->y : ts;
+    tile->data = tiled->data + ((size_t)ty * tiled->tiles_x + tx) * tiled->tile_bytes;
+    tile->stride = tiled->tile_stride;
+    return true;
+}
+
+void fossil_image_tile_iter_begin(const fossil_image_tiled_t *tiled, fossil_image_tile_iter_t *iter) {
+    if (!iter)
+        return;
+    memset(iter, 0, sizeof(*iter));
+    iter->image = tiled;
+}
+
+bool fossil_image_tile_iter_next(fossil_image_tile_iter_t *iter) {
+    if (!iter || !iter->image || iter->image->tiles_x == 0)
+        return false;
+    const fossil_image_tiled_t *tiled = iter->image;
+    if ((size_t)iter->next >= (size_t)tiled->tiles_x * tiled->tiles_y)
+        return false;
+    uint32_t index = iter->next++;
+    return fossil_image_tile_get(tiled, index % tiled->tiles_x, index / tiled->tiles_x, &iter->tile);
+}
+
+// ------------------------------------------------------
+// Layout conversion
+// ------------------------------------------------------
+
+/*
+ * Conversions work one tile row at a time: the tile_size image rows it
+ * covers are read (or written) sequentially while the tiles_x destination
+ * tiles, tile_size * tile_stride bytes in total, stay cache resident.
+ */
+typedef struct tile_convert_ctx {
+    const fossil_image_tiled_t *tiled;
+    uint8_t *rows;
+    size_t row_stride;
+    bool to_tiles;
+} tile_convert_ctx_t;
+
+static void tile_convert_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const tile_convert_ctx_t *ctx = (const tile_convert_ctx_t *)arg;
+    const fossil_image_tiled_t *tiled = ctx->tiled;
+    size_t bpp = tiled->tile_stride / tiled->tile_size;
+    (void)band;
+
+    for (uint32_t ty = begin; ty < end; ++ty) {
+        for (uint32_t tx = 0; tx < tiled->tiles_x; ++tx) {
+            fossil_image_tile_t tile;
+            fossil_image_tile_get(tiled, tx, ty, &tile);
+            size_t bytes = (size_t)tile.width * bpp;
+            uint8_t *row = ctx->rows + (size_t)tile.y * ctx->row_stride + (size_t)tile.x * bpp;
+            for (uint32_t r = 0; r < tile.height; ++r) {
+                uint8_t *t = tile.data + (size_t)r * tile.stride;
+                if (ctx->to_tiles)
+                    memcpy(t, row, bytes);
+                else
+                    memcpy(row, t, bytes);
+                row += ctx->row_stride;
+            }
+        }
+    }
+}
+
+bool fossil_image_tile_from_image(
+    const fossil_image_t *src,
+    uint32_t tile_size,
+    fossil_image_tiled_t *out
+) {
+    if (!src || !src->data || !out)
+        return false;
+    fossil_image_tiled_t t;
+    if (!fossil_image_tile_create(src->width, src->height, src->format, tile_size, &t))
+        return false;
+    t.channels = src->channels;
+
+    tile_convert_ctx_t ctx;
+    ctx.tiled = &t;
+    ctx.rows = src->data;
+    ctx.row_stride = (size_t)src->width * fossil_image_bytes_per_pixel(src->format);
+    ctx.to_tiles = true;
+    if (!fossil_image_parallel_for(t.tiles_y, 1, tile_convert_band, &ctx)) {
+        fossil_image_tile_free(&t);
+        return false;
+    }
+    *out = t;
+    return true;
+}
+
+bool fossil_image_tile_to_image(const fossil_image_tiled_t *src, fossil_image_t *dst) {
+    if (!src || !src->data || !dst || !dst->data)
+        return false;
+    if (dst->width != src->width || dst->height != src->height || dst->format != src->format)
+        return false;
+
+    tile_convert_ctx_t ctx;
+    ctx.tiled = src;
+    ctx.rows = dst->data;
+    ctx.row_stride = (size_t)dst->width * fossil_image_bytes_per_pixel(dst->format);
+    ctx.to_tiles = false;
+    return fossil_image_parallel_for(src->tiles_y, 1, tile_convert_band, &ctx);
+}
+
+// ------------------------------------------------------
+// Region access
+// ------------------------------------------------------
+
+bool fossil_image_tile_read_runs(
+    const fossil_image_tiled_t *geometry,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride,
+    fossil_image_tile_run_fn fetch,
+    void *ctx
+) {
+    if (!geometry || !dst || !fetch || geometry->tile_size == 0)
+        return false;
+    uint32_t ts = geometry->tile_size;
+    size_t bpp = geometry->tile_stride / ts;
+    int64_t w = geometry->width;
+    int64_t h = geometry->height;
+
+    // Columns split into a left edge run, the in-image span and a right edge run
+    int64_t x0 = x;
+    int64_t x1 = x0 + width;
+    int64_t in0 = x0 < 0 ? 0 : (x0 > w ? w : x0);
+    int64_t in1 = x1 < 0 ? 0 : (x1 > w ? w : x1);
+    if (in1 < in0)
+        in1 = in0;
+    uint32_t left = (uint32_t)((x0 < 0 ? (x1 < 0 ? x1 : 0) : x0) - x0);
+    uint32_t span = (uint32_t)(in1 - in0);
+    uint32_t right = width - left - span;
+
+    for (uint32_t r = 0; r < height; ++r) {
+        int64_t sy = (int64_t)y + r;
+        sy = sy < 0 ? 0 : (sy >= h ? h - 1 : sy);
+        uint8_t *d = dst + (size_t)r * dst_stride;
+
+        if (left) {
+            if (!fetch(ctx, 0, (uint32_t)sy, 1, d))
+                return false;
+            for (uint32_t i = 1; i < left; ++i)
+                memcpy(d + (size_t)i * bpp, d, bpp);
+            d += (size_t)left * bpp;
+        }
+        for (uint32_t sx = (uint32_t)in0; sx < (uint32_t)in1;) {
+            uint32_t run = ts - sx % ts;
+            if (run > (uint32_t)in1 - sx)
+                run = (uint32_t)in1 - sx;
+            if (!fetch(ctx, sx, (uint32_t)sy, run, d))
+                return false;
+            d += (size_t)run * bpp;
+            sx += run;
+        }
+        if (right) {
+            if (!fetch(ctx, (uint32_t)(w - 1), (uint32_t)sy, 1, d))
+                return false;
+            for (uint32_t i = 1; i < right; ++i)
+                memcpy(d + (size_t)i * bpp, d, bpp);
+        }
+    }
+    return true;
+}
+
+static bool tile_fetch_run(void *ctx, uint32_t x, uint32_t y, uint32_t count, uint8_t *dst) {
+    const fossil_image_tiled_t *tiled = (const fossil_image_tiled_t *)ctx;
+    memcpy(dst, tile_pixel(tiled, x, y), (size_t)count * (tiled->tile_stride / tiled->tile_size));
+    return true;
+}
+
+bool fossil_image_tile_read_region(
+    const fossil_image_tiled_t *tiled,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t *dst,
+    size_t dst_stride
+) {
+    if (!tiled || !tiled->data)
+        return false;
+    return fossil_image_tile_read_runs(tiled, x, y, width, height, dst, dst_stride,
+                                       tile_fetch_run, (void *)tiled);
+}
+
+bool fossil_image_tile_write_region(
+    fossil_image_tiled_t *tiled,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    const uint8_t *src,
+    size_t src_stride
+) {
+    if (!tiled || !tiled->data || !src)
+        return false;
+    if (x > tiled->width || width > tiled->width - x || y > tiled->height || height > tiled->height - y)
+        return false;
+    uint32_t ts = tiled->tile_size;
+    size_t bpp = tiled->tile_stride / ts;
+
+    for (uint32_t r = 0; r < height; ++r) {
+        const uint8_t *s = src + (size_t)r * src_stride;
+        for (uint32_t sx = x; sx < x + width;) {
+            uint32_t run = ts - sx % ts;
+            if (run > x + width - sx)
+                run = x + width - sx;
+            memcpy(tile_pixel(tiled, sx, y + r), s, (size_t)run * bpp);
+            s += (size_t)run * bpp;
+            sx += run;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------
+// Tile-parallel kernels
+// ------------------------------------------------------
+
+typedef struct tile_each_ctx {
+    const fossil_image_tiled_t *tiled;
+    fossil_image_tile_fn fn;
+    void *ctx;
+} tile_each_ctx_t;
+
+static void tile_each_band(void *arg, uint32_t begin, uint32_t end, uint32_t band) {
+    const tile_each_ctx_t *each = (const tile_each_ctx_t *)arg;
+    uint32_t tiles_x = each->tiled->tiles_x;
+    for (uint32_t i = begin; i < end; ++i) {
+        fossil_image_tile_t tile;
+        fossil_image_tile_get(each->tiled, i % tiles_x, i / tiles_x, &tile);
+        each->fn(each->ctx, &tile, band);
+    }
+}
+
+bool fossil_image_tile_for_each(const fossil_image_tiled_t *tiled, fossil_image_tile_fn fn, void *ctx) {
+    if (!tiled || !tiled->data || !fn)
+        return false;
+    size_t count = (size_t)tiled->tiles_x * tiled->tiles_y;
+    if (count > UINT32_MAX)
+        return false;
+
+    tile_each_ctx_t each;
+    each.tiled = tiled;
+    each.fn = fn;
+    each.ctx = ctx;
+    return fossil_image_parallel_for((uint32_t)count, TILE_MIN_TILES, tile_each_band, &each);
+}
+
+/*
+ * Square in-tile transpose. Pixel sizes are compile-time constants in each
+ * instance so the per-pixel memcpy lowers to a single load and store.
+ */
+#define TILE_DEFINE_TRANSPOSE(N)                                                \
+static void tile_transpose_##N(const uint8_t *src, uint8_t *dst, uint32_t n, size_t stride) { \
+    for (uint32_t i = 0; i < n; ++i) {                                          \
+        const uint8_t *s = src + (size_t)i * stride;                            \
+        uint8_t *d = dst + (size_t)i * N;                                       \
+        for (uint32_t j = 0; j < n; ++j)                                        \
+            memcpy(d + (size_t)j * stride, s + (size_t)j * N, N);               \
+    }                                                                           \
+}
+
+TILE_DEFINE_TRANSPOSE(1)
+TILE_DEFINE_TRANSPOSE(2)
+TILE_DEFINE_TRANSPOSE(3)
+TILE_DEFINE_TRANSPOSE(4)
+TILE_DEFINE_TRANSPOSE(6)
+TILE_DEFINE_TRANSPOSE(8)
+TILE_DEFINE_TRANSPOSE(12)
+TILE_DEFINE_TRANSPOSE(16)
+
+typedef void (*tile_transpose_fn)(const uint8_t *src, uint8_t *dst, uint32_t n, size_t stride);
+
+typedef struct tile_transpose_ctx {
+    const fossil_image_tiled_t *src;
+    tile_transpose_fn kernel;
+} tile_transpose_ctx_t;
+
+static void tile_transpose_each(void *arg, const fossil_image_tile_t *tile, uint32_t band) {
+    const tile_transpose_ctx_t *t = (const tile_transpose_ctx_t *)arg;
+    fossil_image_tile_t from;
+    (void)band;
+    // Output tile (tx, ty) is the transpose of source tile (ty, tx)
+    if (!fossil_image_tile_get(t->src, tile->ty, tile->tx, &from))
+        return;
+    t->kernel(from.data, tile->data, t->src->tile_size, tile->stride);
+}
+
+bool fossil_image_tile_transpose(const fossil_image_tiled_t *src, fossil_image_tiled_t *out) {
+    if (!src || !src->data || !out)
+        return false;
+
+    tile_transpose_ctx_t ctx;
+    ctx.src = src;
+    switch (src->tile_stride / src->tile_size) {
+        case 1: ctx.kernel = tile_transpose_1; break;
+        case 2: ctx.kernel = tile_transpose_2; break;
+        case 3: ctx.kernel = tile_transpose_3; break;
+        case 4: ctx.kernel = tile_transpose_4; break;
+        case 6: ctx.kernel = tile_transpose_6; break;
+        case 8: ctx.kernel = tile_transpose_8; break;
+        case 12: ctx.kernel = tile_transpose_12; break;
+        case 16: ctx.kernel = tile_transpose_16; break;
+        default: return false;
+    }
+
+    fossil_image_tiled_t t;
+    if (!fossil_image_tile_create(src->height, src->width, src->format, src->tile_size, &t))
+        return false;
+    t.channels = src->channels;
+    // Padding transposes onto padding, so every output tile is fully written
+    if (!fossil_image_tile_for_each(&t, tile_transpose_each, &ctx)) {
+        fossil_image_tile_free(&t);
+        return false;
+    }
+    *out = t;
+    return true;
+}
@@ -123,6 +123,299 @@ FOSSIL_TEST(c_test_image_analyze_entropy_basic) {
 }
 
 
+FOSSIL_TEST(c_test_image_analyze_match_template_finds_patch) {
+    fossil_image_t *img = fossil_image_process_create(32, 24, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *templ = fossil_image_process_create(5, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    ASSUME_NOT_CNULL(templ);
+    for (uint32_t i = 0; i < 32 * 24; ++i)
+        img->data[i] = (uint8_t)((i * 2654435761u) >> 24);
+    for (uint32_t y = 0; y < 4; ++y)
+        for (uint32_t x = 0; x < 5; ++x)
+            templ->data[y * 5 + x] = img->data[(y + 9) * 32 + x + 13];
+    fossil_image_t scores = {0};
+    fossil_image_match_t peaks[3];
+    uint32_t count = 0;
+    bool ok = fossil_image_analyze_match_template(img, templ, &scores, peaks, 3, &count);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(scores.width, 28);
+    ASSUME_ITS_EQUAL_I32(scores.height, 21);
+    ASSUME_ITS_TRUE(count > 0);
+    ASSUME_ITS_EQUAL_I32(peaks[0].x, 13);
+    ASSUME_ITS_EQUAL_I32(peaks[0].y, 9);
+    ASSUME_ITS_EQUAL_F64(peaks[0].score, 1.0, 1e-4);
+    ASSUME_ITS_EQUAL_F64(scores.fdata[9 * 28 + 13], 1.0, 1e-4);
+    free(scores.data);
+    fossil_image_process_destroy(templ);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_match_template_invalid) {
+    fossil_image_t *img = fossil_image_process_create(4, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *templ = fossil_image_process_create(2, 2, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    ASSUME_NOT_CNULL(templ);
+    fossil_image_t scores = {0};
+    // A flat template correlates with nothing and scores 0 everywhere
+    ASSUME_ITS_TRUE(fossil_image_analyze_match_template(img, templ, &scores, NULL, 0, NULL));
+    ASSUME_ITS_EQUAL_I32(scores.width, 3);
+    ASSUME_ITS_EQUAL_I32(scores.height, 3);
+    for (uint32_t i = 0; i < 9; ++i)
+        ASSUME_ITS_TRUE(scores.fdata[i] == 0.0f);
+    // A template larger than the image is rejected
+    ASSUME_ITS_FALSE(fossil_image_analyze_match_template(templ, img, &scores, NULL, 0, NULL));
+    free(scores.data);
+    fossil_image_process_destroy(templ);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_gradient_ramp) {
+    fossil_image_t *img = fossil_image_process_create(12, 5, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t y = 0; y < 5; ++y)
+        for (uint32_t x = 0; x < 12; ++x)
+            img->data[y * 12 + x] = (uint8_t)(x * 10);
+    int16_t gx[60];
+    int16_t gy[60];
+    fossil_image_t mag = {0};
+    fossil_image_t angle = {0};
+    bool ok = fossil_image_analyze_gradient(img, FOSSIL_GRADIENT_SCHARR, FOSSIL_GRADIENT_L1,
+                                            gx, gy, &mag, &angle);
+    ASSUME_ITS_TRUE(ok);
+    // Interior: (3 + 10 + 3) * 20; border columns see a single step
+    ASSUME_ITS_EQUAL_I32(gx[2 * 12 + 5], 320);
+    ASSUME_ITS_EQUAL_I32(gx[2 * 12 + 0], 160);
+    ASSUME_ITS_EQUAL_I32(gy[2 * 12 + 5], 0);
+    ASSUME_ITS_EQUAL_I32(((uint16_t *)mag.data)[2 * 12 + 5], 320);
+    ASSUME_ITS_EQUAL_I32(mag.format, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_ITS_EQUAL_F64(angle.fdata[2 * 12 + 5], 0.0, 1e-6);
+    ASSUME_ITS_FALSE(fossil_image_analyze_gradient(img, FOSSIL_GRADIENT_SOBEL, FOSSIL_GRADIENT_L2,
+                                                   NULL, NULL, NULL, NULL));
+    free(mag.data);
+    free(angle.data);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_edge_sobel_reuses_dst) {
+    fossil_image_t *img = fossil_image_process_create(8, 8, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 8 * 8 * 3; ++i)
+        img->data[i] = (uint8_t)(((i / 3) % 8) < 4 ? 0 : 200);
+    fossil_image_t dst = {0};
+    ASSUME_ITS_TRUE(fossil_image_analyze_edge_sobel(img, &dst));
+    uint8_t *first = dst.data;
+    ASSUME_ITS_TRUE(fossil_image_analyze_edge_sobel(img, &dst));
+    ASSUME_ITS_TRUE(dst.data == first);
+    ASSUME_ITS_EQUAL_I32(dst.data[3 * 8 + 3], 255);
+    ASSUME_ITS_EQUAL_I32(dst.data[3 * 8 + 1], 0);
+    ASSUME_ITS_EQUAL_I32(dst.data[3 * 8 + 0], 0);
+    free(dst.data);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_canny_step) {
+    fossil_image_t *img = fossil_image_process_create(16, 12, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t y = 0; y < 12; ++y)
+        for (uint32_t x = 0; x < 16; ++x)
+            img->data[y * 16 + x] = (uint8_t)(x < 8 ? 20 : 220);
+    fossil_image_t edges = {0};
+    bool ok = fossil_image_analyze_canny(img, &edges, 50.0f, 150.0f);
+    ASSUME_ITS_TRUE(ok);
+    // One-pixel-wide vertical edge at the step; borders are never edges
+    for (uint32_t y = 1; y < 11; ++y) {
+        ASSUME_ITS_EQUAL_I32(edges.data[y * 16 + 7], 255);
+        ASSUME_ITS_EQUAL_I32(edges.data[y * 16 + 8], 0);
+        ASSUME_ITS_EQUAL_I32(edges.data[y * 16 + 3], 0);
+    }
+    ASSUME_ITS_EQUAL_I32(edges.data[7], 0);
+    ok = fossil_image_analyze_canny(img, &edges, 0.0f, 0.0f);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(edges.data[5 * 16 + 7], 255);
+    ASSUME_ITS_FALSE(fossil_image_analyze_canny(img, &edges, 200.0f, 100.0f));
+    free(edges.data);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_components_connectivity) {
+    // Two diagonal pixels plus a 2x2 block
+    static const uint8_t mask[5 * 4] = {
+        255, 0,   0, 0,   0,
+        0,   255, 0, 255, 255,
+        0,   0,   0, 255, 255,
+        0,   0,   0, 0,   0
+    };
+    fossil_image_t *img = fossil_image_process_create(5, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 20; ++i)
+        img->data[i] = mask[i];
+    uint32_t labels[20];
+    fossil_image_component_t stats[4];
+    uint32_t count = 0;
+    ASSUME_ITS_TRUE(fossil_image_analyze_components(img, FOSSIL_CONNECTIVITY_4, labels, stats, 4, &count));
+    ASSUME_ITS_EQUAL_I32(count, 3);
+    ASSUME_ITS_EQUAL_I32(labels[0], 1);
+    ASSUME_ITS_EQUAL_I32(labels[6], 2);
+    ASSUME_ITS_EQUAL_I32(labels[14], 3);
+    ASSUME_ITS_EQUAL_I32(stats[2].area, 4);
+    ASSUME_ITS_EQUAL_I32(stats[2].left, 3);
+    ASSUME_ITS_EQUAL_I32(stats[2].bottom, 2);
+    ASSUME_ITS_EQUAL_F64(stats[2].centroid_x, 3.5, 1e-9);
+    ASSUME_ITS_EQUAL_F64(stats[2].centroid_y, 1.5, 1e-9);
+    ASSUME_ITS_TRUE(fossil_image_analyze_components(img, FOSSIL_CONNECTIVITY_8, labels, stats, 1, &count));
+    ASSUME_ITS_EQUAL_I32(count, 2);
+    ASSUME_ITS_EQUAL_I32(labels[6], 1);
+    ASSUME_ITS_EQUAL_I32(stats[0].area, 2);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_components_across_bands) {
+    // A U shape whose arms only meet at the bottom, split over several bands
+    fossil_image_t *img = fossil_image_process_create(9, 200, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t y = 0; y < 200; ++y)
+        for (uint32_t x = 0; x < 9; ++x)
+            img->data[y * 9 + x] = (uint8_t)((x == 1 || x == 7 || y == 199) ? 255 : 0);
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(4);
+    uint32_t count = 0;
+    fossil_image_component_t stats[2];
+    bool ok = fossil_image_analyze_components(img, FOSSIL_CONNECTIVITY_4, NULL, stats, 2, &count);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(count, 1);
+    ASSUME_ITS_EQUAL_I32(stats[0].area, 199 * 2 + 9);
+    ASSUME_ITS_EQUAL_I32(stats[0].top, 0);
+    ASSUME_ITS_EQUAL_I32(stats[0].right, 8);
+    fossil_image_process_destroy(img);
+}
+
+FOSSIL_TEST(c_test_image_analyze_distance_transform_point) {
+    fossil_image_t *mask = fossil_image_process_create(7, 5, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(mask);
+    for (uint32_t i = 0; i < 35; ++i)
+        mask->data[i] = 255;
+    mask->data[2 * 7 + 1] = 0;
+    fossil_image_t dist = {0};
+    ASSUME_ITS_TRUE(fossil_image_analyze_distance_transform(mask, &dist, FOSSIL_PIXEL_FORMAT_FLOAT32));
+    ASSUME_ITS_EQUAL_F64(dist.fdata[2 * 7 + 1], 0.0, 1e-6);
+    ASSUME_ITS_EQUAL_F64(dist.fdata[2 * 7 + 6], 5.0, 1e-6);
+    ASSUME_ITS_EQUAL_F64(dist.fdata[0 * 7 + 4], 3.605551, 1e-5);
+    ASSUME_ITS_TRUE(fossil_image_analyze_distance_transform(mask, &dist, FOSSIL_PIXEL_FORMAT_GRAY16));
+    ASSUME_ITS_EQUAL_I32(dist.format, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_ITS_EQUAL_I32(((uint16_t *)dist.data)[0 * 7 + 4], 4);
+    ASSUME_ITS_FALSE(fossil_image_analyze_distance_transform(mask, &dist, FOSSIL_PIXEL_FORMAT_RGB24));
+    free(dist.data);
+    fossil_image_process_destroy(mask);
+}
+
+FOSSIL_TEST(c_test_image_analyze_distance_transform_no_background) {
+    fossil_image_t *mask = fossil_image_process_create(3, 3, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(mask);
+    for (uint32_t i = 0; i < 9; ++i)
+        mask->data[i] = 1;
+    fossil_image_t dist = {0};
+    ASSUME_ITS_TRUE(fossil_image_analyze_distance_transform(mask, &dist, FOSSIL_PIXEL_FORMAT_GRAY16));
+    ASSUME_ITS_EQUAL_I32(((uint16_t *)dist.data)[4], 65535);
+    free(dist.data);
+    fossil_image_process_destroy(mask);
+}
+
+FOSSIL_TEST(c_test_image_analyze_hash_brightness_invariant) {
+    fossil_image_t *a = fossil_image_process_create(64, 48, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *b = fossil_image_process_create(64, 48, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    for (uint32_t y = 0; y < 48; ++y) {
+        for (uint32_t x = 0; x < 64; ++x) {
+            a->data[y * 64 + x] = (uint8_t)(((x / 4 + (y / 4) * 16) * 2654435761u >> 24) % 200);
+            b->data[y * 64 + x] = (uint8_t)(a->data[y * 64 + x] + 40);
+        }
+    }
+    uint64_t ha = 0, hb = 0;
+    ASSUME_ITS_TRUE(fossil_image_analyze_hash(a, FOSSIL_HASH_AVERAGE, &ha));
+    ASSUME_ITS_TRUE(fossil_image_analyze_hash(b, FOSSIL_HASH_AVERAGE, &hb));
+    ASSUME_ITS_EQUAL_I32(fossil_image_analyze_hash_distance(ha, hb), 0);
+    ASSUME_ITS_TRUE(fossil_image_analyze_hash(a, FOSSIL_HASH_PERCEPTUAL, &ha));
+    ASSUME_ITS_TRUE(fossil_image_analyze_hash(b, FOSSIL_HASH_PERCEPTUAL, &hb));
+    ASSUME_ITS_TRUE(fossil_image_analyze_hash_distance(ha, hb) <= 2);
+    fossil_image_process_destroy(a);
+    fossil_image_process_destroy(b);
+}
+
+FOSSIL_TEST(c_test_image_analyze_hash_batch_and_search) {
+    fossil_image_t *imgs[5];
+    for (uint32_t i = 0; i < 5; ++i) {
+        imgs[i] = fossil_image_process_create(40 + i * 7, 30, FOSSIL_PIXEL_FORMAT_RGB24);
+        ASSUME_NOT_CNULL(imgs[i]);
+        for (size_t k = 0; k < imgs[i]->size; ++k)
+            imgs[i]->data[k] = (uint8_t)((k * (i + 3) * 2654435761u) >> 24);
+    }
+    uint64_t hashes[5];
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    bool ok = fossil_image_analyze_hash_batch((const fossil_image_t *const *)imgs, 5, FOSSIL_HASH_DIFFERENCE, hashes);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    for (uint32_t i = 0; i < 5; ++i) {
+        uint64_t single = 0;
+        ASSUME_ITS_TRUE(fossil_image_analyze_hash(imgs[i], FOSSIL_HASH_DIFFERENCE, &single));
+        ASSUME_ITS_TRUE(single == hashes[i]);
+    }
+    size_t found[5];
+    size_t n = fossil_image_analyze_hash_search(hashes, 5, hashes[3], 0, found, 5);
+    ASSUME_ITS_TRUE(n >= 1);
+    ASSUME_ITS_TRUE(found[0] <= 3);
+    n = fossil_image_analyze_hash_search(hashes, 5, hashes[3], 64, found, 2);
+    ASSUME_ITS_EQUAL_I32((int32_t)n, 5);
+    ASSUME_ITS_EQUAL_I32((int32_t)found[1], 1);
+    for (uint32_t i = 0; i < 5; ++i)
+        fossil_image_process_destroy(imgs[i]);
+}
+
+FOSSIL_TEST(c_test_image_analyze_psnr_known_error) {
+    fossil_image_t *a = fossil_image_process_create(10, 10, FOSSIL_PIXEL_FORMAT_GRAY16);
+    fossil_image_t *b = fossil_image_process_create(10, 10, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    ((uint16_t *)b->data)[42] = 1000;
+    double mse = 0.0, psnr = 0.0;
+    ASSUME_ITS_TRUE(fossil_image_analyze_mse(a, b, &mse));
+    ASSUME_ITS_EQUAL_F64(mse, 10000.0, 1e-9);
+    ASSUME_ITS_TRUE(fossil_image_analyze_psnr(a, b, &psnr));
+    ASSUME_ITS_EQUAL_F64(psnr, 10.0 * log10(65535.0 * 65535.0 / 10000.0), 1e-9);
+    ASSUME_ITS_TRUE(fossil_image_analyze_psnr(a, a, &psnr));
+    ASSUME_ITS_TRUE(isinf(psnr));
+    fossil_image_process_destroy(a);
+    fossil_image_process_destroy(b);
+}
+
+FOSSIL_TEST(c_test_image_analyze_ssim_identical_and_noisy) {
+    fossil_image_t *a = fossil_image_process_create(200, 200, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *b = fossil_image_process_create(200, 200, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    for (size_t i = 0; i < a->size; ++i) {
+        a->data[i] = (uint8_t)((i / 3 % 200) + (i / 600) % 50);
+        b->data[i] = (uint8_t)(a->data[i] + ((i * 2654435761u) >> 28));
+    }
+    double same = 0.0, noisy = 0.0, ms_same = 0.0, ms_noisy = 0.0;
+    fossil_image_t map = {0};
+    ASSUME_ITS_TRUE(fossil_image_analyze_ssim(a, a, FOSSIL_SSIM_GAUSSIAN, &same, &map));
+    ASSUME_ITS_EQUAL_F64(same, 1.0, 1e-6);
+    ASSUME_ITS_EQUAL_I32(map.width, 190);
+    ASSUME_ITS_EQUAL_I32(map.height, 190);
+    ASSUME_ITS_TRUE(fossil_image_analyze_ssim(a, b, FOSSIL_SSIM_BOX, &noisy, NULL));
+    ASSUME_ITS_TRUE(noisy > 0.0 && noisy < 0.99);
+    ASSUME_ITS_TRUE(fossil_image_analyze_ms_ssim(a, a, &ms_same));
+    ASSUME_ITS_EQUAL_F64(ms_same, 1.0, 1e-6);
+    ASSUME_ITS_TRUE(fossil_image_analyze_ms_ssim(a, b, &ms_noisy));
+    ASSUME_ITS_TRUE(ms_noisy < 1.0);
+    free(map.data);
+    fossil_image_process_destroy(a);
+    fossil_image_process_destroy(b);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -133,6 +426,19 @@ FOSSIL_TEST_GROUP(c_image_analyze_tests) {
     FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_contrast_basic);
     FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_edge_sobel_basic);
     FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_entropy_basic);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_match_template_finds_patch);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_match_template_invalid);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_gradient_ramp);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_edge_sobel_reuses_dst);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_canny_step);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_components_connectivity);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_components_across_bands);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_distance_transform_point);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_distance_transform_no_background);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_hash_brightness_invariant);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_hash_batch_and_search);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_psnr_known_error);
+    FOSSIL_TEST_ADD(c_image_analyze_fixture, c_test_image_analyze_ssim_identical_and_noisy);
 
     FOSSIL_TEST_REGISTER(c_image_analyze_fixture);
 } // end of tests
@@ -173,6 +173,202 @@ FOSSIL_TEST(cpp_test_image_color_to_grayscale_already_gray) {
     fossil::image::Process::destroy(img);
 }
 
+FOSSIL_TEST(cpp_test_image_color_hsv_adjust_hue_rotation_exact) {
+    fossil_image_t *img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_RGB48);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *px = (uint16_t *)img->data;
+    px[0] = 65535; px[1] = 0; px[2] = 0;         // Red
+    px[3] = 30000; px[4] = 30000; px[5] = 30000; // Gray
+    bool ok = fossil::image::Color::hsv_adjust(img, -120.0f, 1.0f, 1.0f);
+    ASSUME_ITS_TRUE(ok);
+    // Red rotates onto blue; gray lies on the rotation axis
+    ASSUME_ITS_EQUAL_I32(px[0], 0);
+    ASSUME_ITS_EQUAL_I32(px[1], 0);
+    ASSUME_ITS_EQUAL_I32(px[2], 65535);
+    ASSUME_ITS_EQUAL_I32(px[3], 30000);
+    ASSUME_ITS_EQUAL_I32(px[5], 30000);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_hsv_adjust_value_scale) {
+    fossil_image_t *img = fossil::image::Process::create(5, 1, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    for (int i = 0; i < 5; ++i) {
+        img->data[i * 3 + 0] = 200;
+        img->data[i * 3 + 1] = 100;
+        img->data[i * 3 + 2] = 50;
+    }
+    bool ok = fossil::image::Color::hsv_adjust(img, 0.0f, 1.0f, 0.5f);
+    ASSUME_ITS_TRUE(ok);
+    // Halving value halves every channel and keeps hue and saturation
+    for (int i = 0; i < 5; ++i) {
+        ASSUME_ITS_EQUAL_I32(img->data[i * 3 + 0], 100);
+        ASSUME_ITS_EQUAL_I32(img->data[i * 3 + 1], 50);
+        ASSUME_ITS_EQUAL_I32(img->data[i * 3 + 2], 25);
+    }
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_hsv_adjust_hue_continuous) {
+    fossil_image_t *a = fossil::image::Process::create(64, 1, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *b = fossil::image::Process::create(64, 1, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    for (int i = 0; i < 64 * 3; ++i)
+        a->data[i] = b->data[i] = static_cast<uint8_t>(i * 37 + 11);
+    // A pure hue shift must agree with a barely different saturation
+    ASSUME_ITS_TRUE(fossil::image::Color::hsv_adjust(a, 75.0f, 1.0f, 1.0f));
+    ASSUME_ITS_TRUE(fossil::image::Color::hsv_adjust(b, 75.0f, 0.9999f, 1.0f));
+    for (int i = 0; i < 64 * 3; ++i) {
+        int d = a->data[i] - b->data[i];
+        ASSUME_ITS_TRUE(d >= -1 && d <= 1);
+    }
+    fossil::image::Process::destroy(a);
+    fossil::image::Process::destroy(b);
+}
+
+FOSSIL_TEST(cpp_test_image_color_hsv_adjust_u8_matches_float) {
+    fossil_image_t *a = fossil::image::Process::create(64, 1, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *b = fossil::image::Process::create(64, 1, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    for (int i = 0; i < 64 * 3; ++i) {
+        a->data[i] = static_cast<uint8_t>(i * 37 + 11);
+        b->fdata[i] = a->data[i] / 255.0f;
+    }
+    // The table-driven 8-bit path agrees with the float kernel to one step
+    ASSUME_ITS_TRUE(fossil::image::Color::hsv_adjust(a, -40.0f, 1.3f, 0.8f));
+    ASSUME_ITS_TRUE(fossil::image::Color::hsv_adjust(b, -40.0f, 1.3f, 0.8f));
+    for (int i = 0; i < 64 * 3; ++i) {
+        int d = a->data[i] - static_cast<int>(b->fdata[i] * 255.0f + 0.5f);
+        ASSUME_ITS_TRUE(d >= -1 && d <= 1);
+    }
+    fossil::image::Process::destroy(a);
+    fossil::image::Process::destroy(b);
+}
+
+FOSSIL_TEST(cpp_test_image_color_gamma_16bit_full_range) {
+    fossil_image_t *img = fossil::image::Process::create(2, 2, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *px = (uint16_t *)img->data;
+    px[0] = 0; px[1] = 16384; px[2] = 32768; px[3] = 65535;
+    bool ok = fossil::image::Color::gamma(img, 2.0f);
+    ASSUME_ITS_TRUE(ok);
+    // Values must no longer be clamped to the 8-bit range
+    ASSUME_ITS_EQUAL_I32(px[0], 0);
+    ASSUME_ITS_EQUAL_I32(px[1], 32768);
+    ASSUME_ITS_EQUAL_I32(px[2], 46341);
+    ASSUME_ITS_EQUAL_I32(px[3], 65535);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_gamma_16bit_cached) {
+    fossil_image_t *a = fossil::image::Process::create(1, 1, FOSSIL_PIXEL_FORMAT_RGB48);
+    fossil_image_t *b = fossil::image::Process::create(1, 1, FOSSIL_PIXEL_FORMAT_RGB48);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    uint16_t *pa = (uint16_t *)a->data;
+    uint16_t *pb = (uint16_t *)b->data;
+    pa[0] = pb[0] = 1000; pa[1] = pb[1] = 20000; pa[2] = pb[2] = 60000;
+    ASSUME_ITS_TRUE(fossil::image::Color::gamma(a, 0.5f));
+    ASSUME_ITS_TRUE(fossil::image::Color::gamma(b, 0.5f));
+    ASSUME_ITS_EQUAL_I32(pa[0], pb[0]);
+    ASSUME_ITS_EQUAL_I32(pa[1], pb[1]);
+    ASSUME_ITS_EQUAL_I32(pa[2], pb[2]);
+    ASSUME_ITS_EQUAL_I32(pa[0], 15);
+    fossil::image::Color::gamma_cache_clear();
+    fossil::image::Process::destroy(a);
+    fossil::image::Process::destroy(b);
+}
+
+FOSSIL_TEST(cpp_test_image_color_srgb_linear_roundtrip) {
+    fossil_image_t *img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    img->data[0] = 0; img->data[1] = 128; img->data[2] = 255;
+    img->data[3] = 10; img->data[4] = 200; img->data[5] = 64;
+    ASSUME_ITS_TRUE(fossil::image::Color::srgb_to_linear(img));
+    ASSUME_ITS_EQUAL_I32(img->format, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_ITS_EQUAL_F64(img->fdata[1], 0.2158605, 1e-6);
+    ASSUME_ITS_EQUAL_F64(img->fdata[2], 1.0, 1e-6);
+    ASSUME_ITS_TRUE(fossil::image::Color::linear_to_srgb(img, FOSSIL_PIXEL_FORMAT_RGB24));
+    ASSUME_ITS_EQUAL_I32(img->data[1], 128);
+    ASSUME_ITS_EQUAL_I32(img->data[3], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[5], 64);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_linear_to_srgb_channel_mismatch) {
+    fossil_image_t *img = fossil::image::Process::create(1, 1, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_NOT_CNULL(img);
+    bool ok = fossil::image::Color::linear_to_srgb(img, FOSSIL_PIXEL_FORMAT_RGBA32);
+    ASSUME_ITS_FALSE(ok);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_quantize_two_colors) {
+    fossil_image_t *img = fossil::image::Process::create(4, 2, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    for (int i = 0; i < 8; ++i) {
+        bool red = (i % 2) == 0;
+        img->data[i * 3 + 0] = red ? 220 : 10;
+        img->data[i * 3 + 1] = red ? 30 : 40;
+        img->data[i * 3 + 2] = red ? 20 : 200;
+    }
+    bool ok = fossil::image::Color::quantize(img, 16, FOSSIL_DITHER_NONE);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->format, FOSSIL_PIXEL_FORMAT_INDEXED8);
+    ASSUME_ITS_EQUAL_I32(img->palette_size, 2);
+    ASSUME_NOT_CNULL(img->palette);
+    // Only two colours exist, so the palette reproduces them exactly
+    uint8_t *red = img->palette + img->data[0] * 3;
+    uint8_t *blue = img->palette + img->data[1] * 3;
+    ASSUME_ITS_EQUAL_I32(red[0], 220);
+    ASSUME_ITS_EQUAL_I32(blue[2], 200);
+    ASSUME_ITS_EQUAL_I32(img->data[2], img->data[0]);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_map_palette_dithered) {
+    fossil_image_t *img = fossil::image::Process::create(8, 8, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    memset(img->data, 128, img->size);
+    const uint8_t palette[6] = { 0, 0, 0, 255, 255, 255 };
+    bool ok = fossil::image::Color::map_palette(img, palette, 2, FOSSIL_DITHER_FLOYD_STEINBERG);
+    ASSUME_ITS_TRUE(ok);
+    // Mid gray diffuses into a roughly even mix of black and white
+    int white = 0;
+    for (int i = 0; i < 64; ++i)
+        white += img->data[i];
+    ASSUME_ITS_TRUE(white >= 24 && white <= 40);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_color_brightness_tiled_matches) {
+    fossil_image_t *ref = fossil::image::Process::create(70, 41, FOSSIL_PIXEL_FORMAT_GRAY16);
+    fossil_image_t *back = fossil::image::Process::create(70, 41, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(ref);
+    ASSUME_NOT_CNULL(back);
+    uint16_t *px = reinterpret_cast<uint16_t *>(ref->data);
+    for (size_t i = 0; i < 70 * 41; ++i)
+        px[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+
+    fossil_image_tiled_t tiled;
+    ASSUME_ITS_TRUE(fossil::image::Tile::from_image(ref, 32, &tiled));
+    ASSUME_ITS_TRUE(fossil::image::Color::brightness_tiled(&tiled, 700));
+    ASSUME_ITS_TRUE(fossil::image::Color::brightness(ref, 700));
+    ASSUME_ITS_TRUE(fossil::image::Tile::to_image(&tiled, back));
+    ASSUME_ITS_TRUE(memcmp(back->data, ref->data, ref->size) == 0);
+
+    // Padding past the right edge of the last tile stays zero
+    fossil_image_tile_t last;
+    ASSUME_ITS_TRUE(fossil::image::Tile::get(&tiled, tiled.tiles_x - 1, 0, &last));
+    const uint16_t *pad = reinterpret_cast<const uint16_t *>(last.data);
+    ASSUME_ITS_EQUAL_I32(pad[last.width], 0);
+    fossil::image::Tile::free(&tiled);
+    fossil::image::Process::destroy(back);
+    fossil::image::Process::destroy(ref);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -189,6 +385,17 @@ FOSSIL_TEST_GROUP(cpp_image_color_tests) {
     FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_channel_swap_invalid);
     FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_to_grayscale_basic);
     FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_to_grayscale_already_gray);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_hsv_adjust_hue_rotation_exact);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_hsv_adjust_value_scale);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_hsv_adjust_hue_continuous);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_hsv_adjust_u8_matches_float);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_gamma_16bit_full_range);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_gamma_16bit_cached);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_srgb_linear_roundtrip);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_linear_to_srgb_channel_mismatch);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_quantize_two_colors);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_map_palette_dithered);
+    FOSSIL_TEST_ADD(cpp_image_color_fixture, cpp_test_image_color_brightness_tiled_matches);
 
     FOSSIL_TEST_REGISTER(cpp_image_color_fixture);
 } // end of tests
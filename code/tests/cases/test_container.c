@@ -0,0 +1,297 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_image_container_fixture);
+
+FOSSIL_SETUP(c_image_container_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_image_container_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+/* Read a whole file; the caller frees the buffer. */
+static uint8_t *c_container_slurp(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (uint8_t *)(malloc((size_t)(n)));
+    if (buf && fread(buf, 1, (size_t)(n), f) != (size_t)(n)) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *size = (size_t)(n);
+    return buf;
+}
+
+static void c_container_spill(const char *path, const uint8_t *data, size_t size) {
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        fwrite(data, 1, size, f);
+        fclose(f);
+    }
+}
+
+/* True when the file either fails to open or fails to decode. */
+static bool c_container_rejected(const char *path) {
+    fossil_image_container_t *container = fossil_image_container_open(path);
+    if (!container)
+        return true;
+    fossil_image_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    bool ok = fossil_image_container_read_image(container, &loaded);
+    fossil_image_container_close(container);
+    free(loaded.data);
+    free(loaded.palette);
+    return !ok;
+}
+
+FOSSIL_TEST(c_test_image_container_round_trip_with_metadata) {
+    const char *path = "c_test_image_container_round_trip.fic";
+    fossil_image_t *image = fossil_image_process_create(70, 45, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(image);
+    for (uint32_t y = 0; y < 45; ++y)
+        for (uint32_t x = 0; x < 70; ++x)
+            for (uint32_t c = 0; c < 3; ++c)
+                image->data[(y * 70 + x) * 3 + c] = (uint8_t)(x * 3 + y * 2 + c * 40);
+    strcpy(image->name, "gradient");
+    strcpy(image->software, "fossil");
+    image->dpi_x = 300.0;
+    image->exposure = -1.5;
+    image->is_ai_generated = true;
+
+    ASSUME_ITS_FALSE(fossil_image_container_save(path, image, 12, FOSSIL_IMAGE_CODEC_LZ));
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    bool ok = fossil_image_container_save(path, image, 16, FOSSIL_IMAGE_CODEC_LZ);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+
+    // Smooth content compresses well below the raw size
+    fossil_image_container_t *container = fossil_image_container_open(path);
+    ASSUME_NOT_CNULL(container);
+    fossil_image_container_info_t info;
+    ASSUME_ITS_TRUE(fossil_image_container_info(container, &info));
+    ASSUME_ITS_EQUAL_I32(info.tiles_x, 5);
+    ASSUME_ITS_EQUAL_I32(info.tiles_y, 3);
+    ASSUME_ITS_TRUE(info.stored_bytes < image->size / 4);
+    fossil_image_container_close(container);
+
+    fossil_image_t loaded = {0};
+    ok = fossil_image_io_load(path, "fic", &loaded);
+    remove(path);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(loaded.width, 70);
+    ASSUME_ITS_EQUAL_I32(loaded.format, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_ITS_TRUE(memcmp(loaded.data, image->data, image->size) == 0);
+    ASSUME_ITS_TRUE(strcmp(loaded.name, "gradient") == 0);
+    ASSUME_ITS_TRUE(strcmp(loaded.software, "fossil") == 0);
+    ASSUME_ITS_EQUAL_F64(loaded.dpi_x, 300.0, 1e-9);
+    ASSUME_ITS_EQUAL_F64(loaded.exposure, -1.5, 1e-9);
+    ASSUME_ITS_TRUE(loaded.is_ai_generated);
+    free(loaded.data);
+    fossil_image_process_destroy(image);
+}
+
+FOSSIL_TEST(c_test_image_container_region_reads) {
+    const char *path = "c_test_image_container_region.fic";
+    fossil_image_t *image = fossil_image_process_create(37, 29, FOSSIL_PIXEL_FORMAT_INDEXED8);
+    ASSUME_NOT_CNULL(image);
+    for (size_t i = 0; i < image->size; ++i)
+        image->data[i] = (uint8_t)(i * 7 % 5);
+    image->palette = (uint8_t *)malloc(5 * 3);
+    ASSUME_NOT_CNULL(image->palette);
+    for (uint32_t i = 0; i < 5 * 3; ++i)
+        image->palette[i] = (uint8_t)(i * 17);
+    image->palette_size = 5;
+    ASSUME_ITS_TRUE(fossil_image_container_save(path, image, 8, FOSSIL_IMAGE_CODEC_STORED));
+
+    fossil_image_container_t *container = fossil_image_container_open(path);
+    ASSUME_NOT_CNULL(container);
+
+    // A window straddling four tiles decodes only those tiles
+    uint8_t window[10 * 6];
+    ASSUME_ITS_TRUE(fossil_image_container_read_region(container, 5, 6, 10, 6, window, 10));
+    for (uint32_t y = 0; y < 6; ++y)
+        ASSUME_ITS_TRUE(memcmp(window + y * 10, image->data + (6 + y) * 37 + 5, 10) == 0);
+    ASSUME_ITS_FALSE(fossil_image_container_read_region(container, 30, 0, 8, 1, window, 10));
+
+    fossil_image_t loaded = {0};
+    ASSUME_ITS_TRUE(fossil_image_container_read_image(container, &loaded));
+    ASSUME_ITS_EQUAL_I32(loaded.palette_size, 5);
+    ASSUME_NOT_CNULL(loaded.palette);
+    ASSUME_ITS_EQUAL_I32(loaded.palette[14], 14 * 17);
+    ASSUME_ITS_TRUE(memcmp(loaded.data, image->data, image->size) == 0);
+    fossil_image_container_close(container);
+    remove(path);
+
+    // Files in other formats are rejected
+    ASSUME_ITS_TRUE(fossil_image_io_save(path, "raw", image));
+    ASSUME_ITS_TRUE(fossil_image_container_open(path) == NULL);
+    remove(path);
+
+    free(loaded.data);
+    free(loaded.palette);
+    fossil_image_process_destroy(image);
+}
+
+FOSSIL_TEST(c_test_image_container_truncated_file) {
+    const char *path = "c_test_image_container_truncated.fic";
+    const char *cut = "c_test_image_container_truncated_cut.fic";
+    fossil_image_t *image = fossil_image_process_create(40, 30, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(image);
+    for (size_t i = 0; i < image->size; ++i)
+        image->data[i] = (uint8_t)(i * 5 % 97);
+    ASSUME_ITS_TRUE(fossil_image_container_save(path, image, 8, FOSSIL_IMAGE_CODEC_LZ));
+    size_t size = 0;
+    uint8_t *file = c_container_slurp(path, &size);
+    ASSUME_NOT_CNULL(file);
+
+    // Cut inside the header, the metadata, the index, a payload and the last byte
+    const size_t lengths[5] = { 10, 63, 200, size / 2, size - 1 };
+    for (int i = 0; i < 5; ++i) {
+        c_container_spill(cut, file, lengths[i]);
+        ASSUME_ITS_TRUE(c_container_rejected(cut));
+    }
+    c_container_spill(cut, file, 63);
+    ASSUME_ITS_TRUE(fossil_image_container_open(cut) == NULL);
+
+    remove(cut);
+    remove(path);
+    free(file);
+    fossil_image_process_destroy(image);
+}
+
+FOSSIL_TEST(c_test_image_container_bit_flips) {
+    const char *path = "c_test_image_container_flips.fic";
+    const char *bad = "c_test_image_container_flips_bad.fic";
+    const fossil_image_codec_t codecs[2] = { FOSSIL_IMAGE_CODEC_STORED, FOSSIL_IMAGE_CODEC_LZ };
+    fossil_image_t *image = fossil_image_process_create(20, 12, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(image);
+    uint16_t *px = (uint16_t *)(image->data);
+    for (size_t i = 0; i < 20 * 12; ++i)
+        px[i] = (uint16_t)(i * 40503u);
+
+    for (int k = 0; k < 2; ++k) {
+        ASSUME_ITS_TRUE(fossil_image_container_save(path, image, 8, codecs[k]));
+        fossil_image_container_t *container = fossil_image_container_open(path);
+        ASSUME_NOT_CNULL(container);
+        fossil_image_container_info_t info;
+        ASSUME_ITS_TRUE(fossil_image_container_info(container, &info));
+        fossil_image_container_close(container);
+        size_t size = 0;
+        uint8_t *file = c_container_slurp(path, &size);
+        ASSUME_NOT_CNULL(file);
+        ASSUME_ITS_FALSE(c_container_rejected(path));
+
+        // Any single flipped bit in the payloads is caught by the tile checksums
+        size_t payload = size - (size_t)(info.stored_bytes);
+        for (size_t at = payload; at < size; at += 37) {
+            file[at] ^= (uint8_t)(1u << (at % 8));
+            c_container_spill(bad, file, size);
+            file[at] ^= (uint8_t)(1u << (at % 8));
+            ASSUME_ITS_TRUE(c_container_rejected(bad));
+        }
+
+        // So is an unknown codec in the index
+        file[payload - 20 + 12] = 0x7F;
+        c_container_spill(bad, file, size);
+        ASSUME_ITS_TRUE(c_container_rejected(bad));
+        free(file);
+    }
+
+    remove(bad);
+    remove(path);
+    fossil_image_process_destroy(image);
+}
+
+FOSSIL_TEST(c_test_image_container_wide_samples) {
+    const char *path = "c_test_image_container_wide.fic";
+    fossil_image_t *gray = fossil_image_process_create(2, 1, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(gray);
+    uint16_t *px = (uint16_t *)(gray->data);
+    px[0] = 0x1234;
+    px[1] = 0xABCD;
+    ASSUME_ITS_TRUE(fossil_image_container_save(path, gray, 8, FOSSIL_IMAGE_CODEC_STORED));
+
+    // 16-bit samples are little-endian on disk whatever the host order
+    size_t size = 0;
+    uint8_t *file = c_container_slurp(path, &size);
+    ASSUME_NOT_CNULL(file);
+    ASSUME_ITS_EQUAL_I32(file[size - 4], 0x34);
+    ASSUME_ITS_EQUAL_I32(file[size - 3], 0x12);
+    ASSUME_ITS_EQUAL_I32(file[size - 2], 0xCD);
+    ASSUME_ITS_EQUAL_I32(file[size - 1], 0xAB);
+    free(file);
+
+    // Float samples round-trip bit for bit
+    fossil_image_t *image = fossil_image_process_create(19, 11, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_NOT_CNULL(image);
+    for (size_t i = 0; i < 19 * 11 * 3; ++i)
+        image->fdata[i] = (float)(i) * 0.25f - 40.0f;
+    ASSUME_ITS_TRUE(fossil_image_container_save(path, image, 8, FOSSIL_IMAGE_CODEC_LZ));
+    fossil_image_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    ASSUME_ITS_TRUE(fossil_image_container_load(path, &loaded));
+    ASSUME_NOT_CNULL(loaded.fdata);
+    ASSUME_ITS_TRUE(memcmp(loaded.fdata, image->fdata, image->size) == 0);
+    free(loaded.fdata);
+    remove(path);
+
+    fossil_image_process_destroy(image);
+    fossil_image_process_destroy(gray);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_image_container_tests) {
+    FOSSIL_TEST_ADD(c_image_container_fixture, c_test_image_container_round_trip_with_metadata);
+    FOSSIL_TEST_ADD(c_image_container_fixture, c_test_image_container_region_reads);
+    FOSSIL_TEST_ADD(c_image_container_fixture, c_test_image_container_truncated_file);
+    FOSSIL_TEST_ADD(c_image_container_fixture, c_test_image_container_bit_flips);
+    FOSSIL_TEST_ADD(c_image_container_fixture, c_test_image_container_wide_samples);
+
+    FOSSIL_TEST_REGISTER(c_image_container_fixture);
+} // end of tests
@@ -0,0 +1,176 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_image_disk_fixture);
+
+FOSSIL_SETUP(c_image_disk_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_image_disk_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_test_image_disk_round_trip_and_cache) {
+    const char *path = "c_test_image_disk_round_trip.fid";
+    fossil_image_t *image = fossil_image_process_create(50, 37, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *back = fossil_image_process_create(50, 37, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(image);
+    ASSUME_NOT_CNULL(back);
+    for (size_t i = 0; i < image->size; ++i)
+        image->data[i] = (uint8_t)(i * 13 % 251);
+
+    // A one-byte budget still keeps a few 8x8 tiles, forcing evictions
+    fossil_image_disk_t *disk = fossil_image_disk_create(path, 50, 37, FOSSIL_PIXEL_FORMAT_RGB24, 8, 1);
+    ASSUME_NOT_CNULL(disk);
+    ASSUME_ITS_TRUE(fossil_image_disk_write_region(disk, 0, 0, 50, 37, image->data, 50 * 3));
+    ASSUME_ITS_FALSE(fossil_image_disk_write_region(disk, 45, 0, 6, 1, image->data, 50 * 3));
+
+    fossil_image_disk_info_t info;
+    ASSUME_ITS_TRUE(fossil_image_disk_info(disk, &info));
+    ASSUME_ITS_EQUAL_I32(info.cache_bytes, 4 * 8 * 8 * 3);
+    ASSUME_ITS_TRUE(info.writebacks > 0);
+    ASSUME_ITS_TRUE(fossil_image_disk_close(disk));
+
+    disk = fossil_image_disk_open(path, 0);
+    ASSUME_NOT_CNULL(disk);
+    ASSUME_ITS_TRUE(fossil_image_disk_info(disk, &info));
+    ASSUME_ITS_EQUAL_I32(info.width, 50);
+    ASSUME_ITS_EQUAL_I32(info.height, 37);
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(disk, 0, 0, 50, 37, back->data, 50 * 3));
+    ASSUME_ITS_TRUE(memcmp(back->data, image->data, image->size) == 0);
+
+    // Reads past the bottom-right corner repeat the corner pixel
+    uint8_t corner[2 * 2 * 3];
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(disk, 49, 36, 2, 2, corner, 2 * 3));
+    ASSUME_ITS_TRUE(memcmp(corner + 9, image->data + image->size - 3, 3) == 0);
+
+    // Edge handling matches the in-memory tiled reader
+    fossil_image_tiled_t tiled;
+    uint8_t from_disk[60 * 4 * 3];
+    uint8_t from_tiles[60 * 4 * 3];
+    ASSUME_ITS_TRUE(fossil_image_tile_from_image(image, 8, &tiled));
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(disk, -5, 34, 60, 4, from_disk, 60 * 3));
+    ASSUME_ITS_TRUE(fossil_image_tile_read_region(&tiled, -5, 34, 60, 4, from_tiles, 60 * 3));
+    ASSUME_ITS_TRUE(memcmp(from_disk, from_tiles, sizeof(from_disk)) == 0);
+    fossil_image_tile_free(&tiled);
+    ASSUME_ITS_TRUE(fossil_image_disk_close(disk));
+    remove(path);
+
+    ASSUME_ITS_TRUE(fossil_image_disk_open(path, 0) == NULL);
+    fossil_image_process_destroy(image);
+    fossil_image_process_destroy(back);
+}
+
+FOSSIL_TEST(c_test_image_disk_streaming_matches_memory) {
+    const char *src_path = "c_test_image_disk_stream_src.fid";
+    const char *dst_path = "c_test_image_disk_stream_dst.fid";
+    fossil_image_t *image = fossil_image_process_create(90, 75, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *small = fossil_image_process_create(40, 33, FOSSIL_PIXEL_FORMAT_GRAY8);
+    uint8_t *back = (uint8_t *)malloc(90 * 75);
+    ASSUME_NOT_CNULL(image);
+    ASSUME_NOT_CNULL(small);
+    ASSUME_NOT_CNULL(back);
+    for (size_t i = 0; i < image->size; ++i)
+        image->data[i] = (uint8_t)(i * 31 % 253);
+
+    fossil_image_disk_t *src = fossil_image_disk_create(src_path, 90, 75, FOSSIL_PIXEL_FORMAT_GRAY8, 8, 1);
+    fossil_image_disk_t *dst = fossil_image_disk_create(dst_path, 40, 33, FOSSIL_PIXEL_FORMAT_GRAY8, 8, 1);
+    ASSUME_NOT_CNULL(src);
+    ASSUME_NOT_CNULL(dst);
+    ASSUME_ITS_TRUE(fossil_image_disk_write_region(src, 0, 0, 90, 75, image->data, 90));
+
+    uint32_t hist[256];
+    uint64_t disk_hist[256];
+    ASSUME_ITS_TRUE(fossil_image_analyze_histogram(image, hist));
+    ASSUME_ITS_TRUE(fossil_image_disk_histogram(src, disk_hist));
+    ASSUME_ITS_EQUAL_I32(disk_hist[0], hist[0]);
+    ASSUME_ITS_EQUAL_I32(disk_hist[200], hist[200]);
+
+    ASSUME_ITS_TRUE(fossil_image_process_resize_into(image, small, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(fossil_image_disk_resize(src, dst, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(dst, 0, 0, 40, 33, back, 40));
+    ASSUME_ITS_TRUE(memcmp(back, small->data, small->size) == 0);
+
+    // Blocks overlap by the pipeline halo, so the seams match the in-memory result
+    fossil_image_pipeline_t *pipeline = fossil_image_pipeline_create();
+    ASSUME_NOT_CNULL(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_blur(pipeline, 2.0f));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_brightness(pipeline, 12));
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_halo(pipeline), 2);
+    ASSUME_ITS_FALSE(fossil_image_disk_pipeline(src, src, pipeline));
+
+    fossil_image_disk_t *out = fossil_image_disk_create(dst_path, 90, 75, FOSSIL_PIXEL_FORMAT_GRAY8, 8, 1);
+    ASSUME_NOT_CNULL(out);
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    bool ok = fossil_image_disk_pipeline(src, out, pipeline) && fossil_image_pipeline_execute(pipeline, image);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(out, 0, 0, 90, 75, back, 90));
+    ASSUME_ITS_TRUE(memcmp(back, image->data, image->size) == 0);
+
+    // A resize would change the block geometry, so it is refused up front
+    ASSUME_ITS_FALSE(fossil_image_pipeline_has_resize(pipeline));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_resize(pipeline, 45, 37, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_has_resize(pipeline));
+    ASSUME_ITS_FALSE(fossil_image_disk_pipeline(src, out, pipeline));
+    ASSUME_ITS_TRUE(fossil_image_disk_read_region(out, 0, 0, 90, 75, back, 90));
+    ASSUME_ITS_TRUE(memcmp(back, image->data, image->size) == 0);
+
+    fossil_image_pipeline_destroy(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_disk_close(out));
+    ASSUME_ITS_TRUE(fossil_image_disk_close(dst));
+    ASSUME_ITS_TRUE(fossil_image_disk_close(src));
+    remove(src_path);
+    remove(dst_path);
+    free(back);
+    fossil_image_process_destroy(image);
+    fossil_image_process_destroy(small);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_image_disk_tests) {
+    FOSSIL_TEST_ADD(c_image_disk_fixture, c_test_image_disk_round_trip_and_cache);
+    FOSSIL_TEST_ADD(c_image_disk_fixture, c_test_image_disk_streaming_matches_memory);
+
+    FOSSIL_TEST_REGISTER(c_image_disk_fixture);
+} // end of tests
@@ -0,0 +1,100 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_image_fft_fixture);
+
+FOSSIL_SETUP(cpp_image_fft_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_image_fft_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_test_image_fft_good_size) {
+    ASSUME_ITS_EQUAL_I32(static_cast<int32_t>(fossil::image::Fft::good_size(7)), 8);
+    ASSUME_ITS_EQUAL_I32(static_cast<int32_t>(fossil::image::Fft::good_size(64)), 64);
+    ASSUME_ITS_EQUAL_I32(static_cast<int32_t>(fossil::image::Fft::good_size(1025)), 1080);
+}
+
+FOSSIL_TEST(cpp_test_image_fft_1d_impulse_round_trip) {
+    fossil_image_complex_t data[12];
+    for (uint32_t i = 0; i < 12; ++i) {
+        data[i].re = (i == 0) ? 1.0f : 0.0f;
+        data[i].im = 0.0f;
+    }
+    ASSUME_ITS_TRUE(fossil::image::Fft::transform(data, 12, false));
+    for (uint32_t i = 0; i < 12; ++i) {
+        ASSUME_ITS_EQUAL_F64(data[i].re, 1.0, 1e-5);
+        ASSUME_ITS_EQUAL_F64(data[i].im, 0.0, 1e-5);
+    }
+    ASSUME_ITS_TRUE(fossil::image::Fft::transform(data, 12, true));
+    ASSUME_ITS_EQUAL_F64(data[0].re, 1.0, 1e-5);
+    for (uint32_t i = 1; i < 12; ++i)
+        ASSUME_ITS_EQUAL_F64(data[i].re, 0.0, 1e-5);
+    fossil::image::Fft::cache_clear();
+}
+
+FOSSIL_TEST(cpp_test_image_fft_2d_real_round_trip) {
+    float src[10 * 6];
+    float back[10 * 6];
+    fossil_image_complex_t spectrum[(10 / 2 + 1) * 6];
+    double sum = 0.0;
+    for (uint32_t i = 0; i < 60; ++i) {
+        src[i] = static_cast<float>((i * 37) % 11);
+        sum += src[i];
+    }
+    ASSUME_ITS_TRUE(fossil::image::Fft::forward_2d_real(src, 10, 6, spectrum));
+    ASSUME_ITS_EQUAL_F64(spectrum[0].re, sum, 1e-3);
+    ASSUME_ITS_TRUE(fossil::image::Fft::inverse_2d_real(spectrum, 10, 6, back));
+    for (uint32_t i = 0; i < 60; ++i)
+        ASSUME_ITS_EQUAL_F64(back[i], src[i], 1e-4);
+    ASSUME_ITS_FALSE(fossil::image::Fft::forward_2d_real(src, 9, 6, spectrum));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_image_fft_tests) {
+    FOSSIL_TEST_ADD(cpp_image_fft_fixture, cpp_test_image_fft_good_size);
+    FOSSIL_TEST_ADD(cpp_image_fft_fixture, cpp_test_image_fft_1d_impulse_round_trip);
+    FOSSIL_TEST_ADD(cpp_image_fft_fixture, cpp_test_image_fft_2d_real_round_trip);
+
+    FOSSIL_TEST_REGISTER(cpp_image_fft_fixture);
+} // end of tests
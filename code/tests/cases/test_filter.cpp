@@ -135,6 +135,274 @@ FOSSIL_TEST(cpp_test_image_filter_emboss_null_image) {
     ASSUME_ITS_FALSE(ok);
 }
 
+FOSSIL_TEST(cpp_test_image_filter_blur_linear_uniform) {
+    fossil_image_t *img = fossil::image::Process::create(5, 4, FOSSIL_PIXEL_FORMAT_RGB48);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *px = (uint16_t *)img->data;
+    for (size_t i = 0; i < (size_t)5 * 4 * 3; ++i)
+        px[i] = 40000;
+    bool ok = fossil::image::Filter::blur_linear(img, 2.0f);
+    ASSUME_ITS_TRUE(ok);
+    // A flat field stays flat, edges included
+    ASSUME_ITS_EQUAL_I32(px[0], 40000);
+    ASSUME_ITS_EQUAL_I32(px[(size_t)5 * 4 * 3 - 1], 40000);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_blur_linear_unsupported) {
+    fossil_image_t *img = fossil::image::Process::create(4, 4, FOSSIL_PIXEL_FORMAT_YUV24);
+    ASSUME_NOT_CNULL(img);
+    bool ok = fossil::image::Filter::blur_linear(img, 1.0f);
+    ASSUME_ITS_FALSE(ok);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_median_removes_impulse) {
+    fossil_image_t *img = fossil::image::Process::create(5, 5, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    for (size_t i = 0; i < img->size; ++i)
+        img->data[i] = 40;
+    img->data[(2 * 5 + 2) * 3 + 1] = 255;
+    bool ok = fossil::image::Filter::median(img, 1);
+    ASSUME_ITS_TRUE(ok);
+    for (size_t i = 0; i < img->size; ++i)
+        ASSUME_ITS_EQUAL_I32(img->data[i], 40);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_median_16bit_window) {
+    fossil_image_t *img = fossil::image::Process::create(3, 3, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *p = reinterpret_cast<uint16_t *>(img->data);
+    for (uint16_t i = 0; i < 9; ++i)
+        p[i] = (uint16_t)(1000 * (i + 1));
+    bool ok = fossil::image::Filter::median(img, 1);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(p[4], 5000);
+    ASSUME_ITS_EQUAL_I32(p[0], 2000);
+    ASSUME_ITS_FALSE(fossil::image::Filter::median(img, 128));
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_morphology_erode_dilate) {
+    fossil_image_t *img = fossil::image::Process::create(5, 5, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (size_t i = 0; i < img->size; ++i)
+        img->data[i] = 100;
+    img->data[12] = 10;
+    bool ok = fossil::image::Filter::morphology(img, FOSSIL_MORPH_ERODE, 1, 1);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->data[6], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[18], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 100);
+    ok = fossil::image::Filter::morphology(img, FOSSIL_MORPH_DILATE, 1, 1);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->data[12], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[6], 100);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_morphology_binary_open) {
+    fossil_image_t *img = fossil::image::Process::create(80, 3, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (size_t i = 0; i < img->size; ++i)
+        img->data[i] = 0;
+    for (uint32_t x = 60; x < 75; ++x)
+        img->data[80 + x] = 255;
+    img->data[80 + 10] = 255;
+    bool ok = fossil::image::Filter::morphology(img, FOSSIL_MORPH_OPEN, 2, 0);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 10], 0);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 60], 255);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 74], 255);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 75], 0);
+    ok = fossil::image::Filter::morphology(img, FOSSIL_MORPH_GRADIENT, 1, 0);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 59], 255);
+    ASSUME_ITS_EQUAL_I32(img->data[80 + 66], 0);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_bilateral_preserves_edge) {
+    fossil_image_t *img = fossil::image::Process::create(40, 20, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t y = 0; y < 20; ++y)
+        for (uint32_t x = 0; x < 40; ++x)
+            img->data[y * 40 + x] = (uint8_t)((x < 20 ? 50 : 200) + ((x + y) % 2 ? 8 : -8));
+    bool ok = fossil::image::Filter::bilateral(img, 3.0f, 0.1f);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(img->data[10 * 40 + 10] >= 46 && img->data[10 * 40 + 10] <= 54);
+    ASSUME_ITS_TRUE(img->data[10 * 40 + 11] >= 46 && img->data[10 * 40 + 11] <= 54);
+    ASSUME_ITS_TRUE(img->data[10 * 40 + 19] < 70);
+    ASSUME_ITS_TRUE(img->data[10 * 40 + 20] > 180);
+    ASSUME_ITS_FALSE(fossil::image::Filter::bilateral(img, 0.5f, 0.1f));
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_unsharp_mask_step) {
+    fossil_image_t *img = fossil::image::Process::create(16, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t y = 0; y < 4; ++y)
+        for (uint32_t x = 0; x < 16; ++x)
+            img->data[y * 16 + x] = x < 8 ? 80 : 160;
+    bool ok = fossil::image::Filter::unsharp_mask(img, 1.0f, 1.0f, 0.0f);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(img->data[16 + 7] < 80);
+    ASSUME_ITS_TRUE(img->data[16 + 8] > 160);
+    ASSUME_ITS_EQUAL_I32(img->data[16 + 0], 80);
+    ASSUME_ITS_EQUAL_I32(img->data[16 + 15], 160);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_unsharp_mask_threshold) {
+    fossil_image_t *img = fossil::image::Process::create(16, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 64; ++i)
+        img->data[i] = (uint8_t)(100 + (i % 2) * 4);
+    bool ok = fossil::image::Filter::unsharp_mask(img, 1.0f, 2.0f, 0.1f);
+    ASSUME_ITS_TRUE(ok);
+    for (uint32_t i = 0; i < 64; ++i)
+        ASSUME_ITS_EQUAL_I32(img->data[i], 100 + (i % 2) * 4);
+    ASSUME_ITS_FALSE(fossil::image::Filter::unsharp_mask(img, 0.0f, 1.0f, 0.0f));
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_high_pass_flat) {
+    fossil_image_t *img = fossil::image::Process::create(8, 8, FOSSIL_PIXEL_FORMAT_FLOAT32);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 64; ++i)
+        img->fdata[i] = 0.3f;
+    bool ok = fossil::image::Filter::high_pass(img, 2.0f);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_F64(img->fdata[27], 0.5, 1e-5);
+    fossil::image::Process::destroy(img);
+}
+
+// Naive convolution with edge clamping, centered at ((kw - 1) / 2, (kh - 1) / 2)
+static float cpp_filter_reference(const float *src, int w, int h, const float *kernel,
+                                  int kw, int kh, int x, int y) {
+    float sum = 0.0f;
+    for (int j = 0; j < kh; ++j) {
+        for (int i = 0; i < kw; ++i) {
+            int sx = x + (kw - 1) / 2 - i;
+            int sy = y + (kh - 1) / 2 - j;
+            sx = sx < 0 ? 0 : sx >= w ? w - 1 : sx;
+            sy = sy < 0 ? 0 : sy >= h ? h - 1 : sy;
+            sum += kernel[j * kw + i] * src[sy * w + sx];
+        }
+    }
+    return sum;
+}
+
+FOSSIL_TEST(cpp_test_image_filter_convolve_even_kernels) {
+    const int sizes[2][2] = { { 4, 4 }, { 2, 3 } };
+    const fossil_conv_method_t methods[2] = { FOSSIL_CONV_DIRECT, FOSSIL_CONV_FFT };
+    float src[19 * 13];
+    float kernel[16];
+    for (uint32_t i = 0; i < 19 * 13; ++i)
+        src[i] = static_cast<float>((i * 37) % 23);
+    for (uint32_t i = 0; i < 16; ++i)
+        kernel[i] = static_cast<float>(i * 7 % 5) - 1.0f;
+    for (int s = 0; s < 2; ++s) {
+        for (int m = 0; m < 2; ++m) {
+            fossil_image_t *img = fossil::image::Process::create(19, 13, FOSSIL_PIXEL_FORMAT_FLOAT32);
+            ASSUME_NOT_CNULL(img);
+            memcpy(img->fdata, src, sizeof(src));
+            ASSUME_ITS_TRUE(fossil::image::Filter::convolve(img, kernel, static_cast<uint32_t>(sizes[s][0]),
+                                                            static_cast<uint32_t>(sizes[s][1]), methods[m]));
+            for (int y = 0; y < 13; ++y) {
+                for (int x = 0; x < 19; ++x) {
+                    float expect = cpp_filter_reference(src, 19, 13, kernel, sizes[s][0], sizes[s][1], x, y);
+                    ASSUME_ITS_EQUAL_F64(img->fdata[y * 19 + x], expect, 1e-3);
+                }
+            }
+            fossil::image::Process::destroy(img);
+        }
+    }
+}
+
+FOSSIL_TEST(cpp_test_image_filter_convolve_direct_matches_fft) {
+    fossil_image_t *a = fossil::image::Process::create(23, 17, FOSSIL_PIXEL_FORMAT_FLOAT32);
+    fossil_image_t *b = fossil::image::Process::create(23, 17, FOSSIL_PIXEL_FORMAT_FLOAT32);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    float kernel[5 * 3];
+    for (uint32_t i = 0; i < 15; ++i)
+        kernel[i] = static_cast<float>(i % 4) - 1.5f;
+    for (uint32_t i = 0; i < 23 * 17; ++i)
+        a->fdata[i] = b->fdata[i] = static_cast<float>((i * 29) % 13);
+    ASSUME_ITS_TRUE(fossil::image::Filter::convolve(a, kernel, 5, 3, FOSSIL_CONV_DIRECT));
+    ASSUME_ITS_TRUE(fossil::image::Filter::convolve(b, kernel, 5, 3, FOSSIL_CONV_FFT));
+    for (uint32_t i = 0; i < 23 * 17; ++i)
+        ASSUME_ITS_EQUAL_F64(a->fdata[i], b->fdata[i], 1e-3);
+    fossil::image::Process::destroy(a);
+    fossil::image::Process::destroy(b);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_correlate_shift) {
+    fossil_image_t *img = fossil::image::Process::create(6, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 6; ++i)
+        img->data[i] = static_cast<uint8_t>(i * 10);
+    // Taps right of the anchor read the right neighbour; convolution mirrors that
+    const float kernel[3] = { 0.0f, 0.0f, 1.0f };
+    ASSUME_ITS_TRUE(fossil::image::Filter::correlate(img, kernel, 3, 1, FOSSIL_CONV_AUTO));
+    ASSUME_ITS_EQUAL_I32(img->data[0], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[5], 50);
+    ASSUME_ITS_TRUE(fossil::image::Filter::convolve(img, kernel, 3, 1, FOSSIL_CONV_AUTO));
+    ASSUME_ITS_EQUAL_I32(img->data[1], 10);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 10);
+    ASSUME_ITS_FALSE(fossil::image::Filter::convolve(img, kernel, 0, 1, FOSSIL_CONV_AUTO));
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_filter_convolve3x3_tiled_matches) {
+    static const float kernel[3][3] = {
+        { 0, -1,  0},
+        {-1,  5, -1},
+        { 0, -1,  0}
+    };
+    const fossil_pixel_format_t formats[3] = {
+        FOSSIL_PIXEL_FORMAT_RGB24, FOSSIL_PIXEL_FORMAT_GRAY16, FOSSIL_PIXEL_FORMAT_FLOAT32
+    };
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    for (int f = 0; f < 3; ++f) {
+        fossil_image_t *ref = fossil::image::Process::create(75, 37, formats[f]);
+        fossil_image_t *back = fossil::image::Process::create(75, 37, formats[f]);
+        ASSUME_NOT_CNULL(ref);
+        ASSUME_NOT_CNULL(back);
+        uint8_t *bytes = ref->fdata ? reinterpret_cast<uint8_t *>(ref->fdata) : ref->data;
+        if (ref->fdata) {
+            for (size_t i = 0; i < ref->size / sizeof(float); ++i)
+                ref->fdata[i] = static_cast<float>(i * 7 % 19) / 19.0f;
+        } else {
+            for (size_t i = 0; i < ref->size; ++i)
+                ref->data[i] = static_cast<uint8_t>(i * 131 % 251);
+        }
+
+        fossil_image_tiled_t src;
+        fossil_image_tiled_t out;
+        ASSUME_ITS_TRUE(fossil::image::Tile::from_image(ref, 16, &src));
+        ASSUME_ITS_TRUE(fossil::image::Filter::convolve3x3_tiled(&src, &out, kernel, 1.0f, 0.0f));
+        ASSUME_ITS_TRUE(fossil::image::Filter::convolve3x3(ref, kernel, 1.0f, 0.0f));
+        ASSUME_ITS_TRUE(fossil::image::Tile::to_image(&out, back));
+        uint8_t *result = back->fdata ? reinterpret_cast<uint8_t *>(back->fdata) : back->data;
+        ASSUME_ITS_TRUE(memcmp(result, bytes, ref->size) == 0);
+        fossil::image::Tile::free(&out);
+        fossil::image::Tile::free(&src);
+        fossil::image::Process::destroy(back);
+        fossil::image::Process::destroy(ref);
+    }
+    fossil_image_parallel_set_threads(saved);
+
+    fossil_image_tiled_t tiny;
+    fossil_image_tiled_t unused;
+    ASSUME_ITS_TRUE(fossil::image::Tile::create(2, 8, FOSSIL_PIXEL_FORMAT_GRAY8, 8, &tiny));
+    ASSUME_ITS_FALSE(fossil::image::Filter::convolve3x3_tiled(&tiny, &unused, kernel, 1.0f, 0.0f));
+    fossil::image::Tile::free(&tiny);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -150,6 +418,20 @@ FOSSIL_TEST_GROUP(cpp_image_filter_tests) {
     FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_sharpen_null_image);
     FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_edge_null_image);
     FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_emboss_null_image);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_blur_linear_uniform);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_blur_linear_unsupported);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_median_removes_impulse);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_median_16bit_window);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_morphology_erode_dilate);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_morphology_binary_open);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_bilateral_preserves_edge);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_unsharp_mask_step);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_unsharp_mask_threshold);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_high_pass_flat);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_convolve_direct_matches_fft);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_convolve_even_kernels);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_correlate_shift);
+    FOSSIL_TEST_ADD(cpp_image_filter_fixture, cpp_test_image_filter_convolve3x3_tiled_matches);
 
     FOSSIL_TEST_REGISTER(cpp_image_filter_fixture);
 } // end of tests
@@ -180,6 +180,83 @@ FOSSIL_TEST(cpp_test_image_io_generate_radial_gray8) {
     if (img.data) free(img.data);
 }
 
+FOSSIL_TEST(cpp_test_image_io_indexed8_palette_roundtrip) {
+    fossil_image_t *src = fossil::image::Process::create(2, 2, FOSSIL_PIXEL_FORMAT_INDEXED8);
+    ASSUME_NOT_CNULL(src);
+    src->data[0] = 0; src->data[1] = 1; src->data[2] = 1; src->data[3] = 0;
+    src->palette = (uint8_t *)malloc(6);
+    src->palette[0] = 10; src->palette[1] = 20; src->palette[2] = 30;
+    src->palette[3] = 40; src->palette[4] = 50; src->palette[5] = 60;
+    src->palette_size = 2;
+    ASSUME_ITS_TRUE(fossil::image::Io::save("test_palette.idx", "indexed8", src));
+
+    fossil_image_t img = {0};
+    bool ok = fossil::image::Io::load("test_palette.idx", "indexed8", &img);
+    remove("test_palette.idx");
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img.palette_size, 2);
+    ASSUME_NOT_CNULL(img.palette);
+    ASSUME_ITS_EQUAL_I32(img.palette[5], 60);
+    ASSUME_ITS_EQUAL_I32(img.data[1], 1);
+    free(img.data);
+    free(img.palette);
+    fossil::image::Process::destroy(src);
+}
+
+FOSSIL_TEST(cpp_test_image_io_raw_keeps_format) {
+    fossil_image_t *src = fossil::image::Process::create(3, 2, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(src);
+    src->data[0] = 0x34; src->data[1] = 0x12; src->data[11] = 0xAB;
+    ASSUME_ITS_TRUE(fossil::image::Io::save("test_raw16.raw", "raw", src));
+
+    fossil_image_t img = {0};
+    bool ok = fossil::image::Io::load("test_raw16.raw", "raw", &img);
+    remove("test_raw16.raw");
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img.format, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_ITS_EQUAL_I32(img.size, 12);
+    ASSUME_ITS_EQUAL_I32(img.data[1], 0x12);
+    ASSUME_ITS_EQUAL_I32(img.data[11], 0xAB);
+    free(img.data);
+    fossil::image::Process::destroy(src);
+}
+
+FOSSIL_TEST(cpp_test_image_io_raw_rejects_oversized_header) {
+    // 2^31 x 2^31 pixels of 8 bytes wraps size_t to zero
+    const uint32_t hdr[3] = {0x80000000u, 0x80000000u, 4};
+    const fossil_pixel_format_t format = FOSSIL_PIXEL_FORMAT_RGBA64;
+    FILE *f = fopen("test_corrupt.raw", "wb");
+    ASSUME_NOT_CNULL(f);
+    fwrite(hdr, sizeof(hdr), 1, f);
+    fwrite(&format, sizeof(format), 1, f);
+    fclose(f);
+
+    fossil_image_t img = {0};
+    bool ok = fossil::image::Io::load("test_corrupt.raw", "raw", &img);
+    remove("test_corrupt.raw");
+    ASSUME_ITS_FALSE(ok);
+    ASSUME_ITS_TRUE(img.data == nullptr);
+}
+
+FOSSIL_TEST(cpp_test_image_io_load_into_dirty_struct) {
+    fossil_image_t *src = fossil::image::Process::create(4, 3, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(src);
+    src->data[5] = 77;
+    ASSUME_ITS_TRUE(fossil::image::Io::save("test_dirty.gray", "gray8", src));
+
+    fossil_image_t *img = static_cast<fossil_image_t *>(malloc(sizeof(fossil_image_t)));
+    ASSUME_NOT_CNULL(img);
+    memset(img, 0xAB, sizeof(*img));
+    bool ok = fossil::image::Io::load("test_dirty.gray", "gray8", img);
+    remove("test_dirty.gray");
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(img->palette == nullptr);
+    ASSUME_ITS_EQUAL_I32(img->palette_size, 0);
+    ASSUME_ITS_EQUAL_I32(img->data[5], 77);
+    fossil::image::Process::destroy(img);
+    fossil::image::Process::destroy(src);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -197,6 +274,10 @@ FOSSIL_TEST_GROUP(cpp_image_io_tests) {
     FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_generate_stripes_rgb24);
     FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_generate_vstripes_rgb24);
     FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_generate_radial_gray8);
+    FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_indexed8_palette_roundtrip);
+    FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_raw_keeps_format);
+    FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_raw_rejects_oversized_header);
+    FOSSIL_TEST_ADD(cpp_image_io_fixture, cpp_test_image_io_load_into_dirty_struct);
 
     FOSSIL_TEST_REGISTER(cpp_image_io_fixture);
 } // end of tests
@@ -0,0 +1,138 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_image_parallel_fixture);
+
+FOSSIL_SETUP(c_image_parallel_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_image_parallel_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+typedef struct {
+    uint8_t hits[1000];
+    uint8_t band_of[1000];
+} parallel_test_ctx_t;
+
+static void parallel_test_mark(void *ctx, uint32_t begin, uint32_t end, uint32_t band) {
+    parallel_test_ctx_t *t = (parallel_test_ctx_t *)ctx;
+    (void)band;
+    for (uint32_t i = begin; i < end; ++i)
+        t->hits[i]++;
+}
+
+static void parallel_test_band(void *ctx, uint32_t begin, uint32_t end, uint32_t band) {
+    parallel_test_ctx_t *t = (parallel_test_ctx_t *)ctx;
+    for (uint32_t i = begin; i < end; ++i)
+        t->band_of[i] = (uint8_t)band;
+}
+
+static void parallel_test_count(void *ctx, uint32_t begin, uint32_t end, uint32_t band) {
+    uint8_t *hits = (uint8_t *)ctx;
+    (void)band;
+    for (uint32_t i = begin; i < end; ++i)
+        hits[i]++;
+}
+
+static void parallel_test_nested(void *ctx, uint32_t begin, uint32_t end, uint32_t band) {
+    parallel_test_ctx_t *t = (parallel_test_ctx_t *)ctx;
+    (void)band;
+    // Each outer item counts its own ten-item slice through an inner loop
+    for (uint32_t i = begin; i < end; ++i)
+        fossil_image_parallel_for(10, 1, parallel_test_count, t->hits + i * 10);
+}
+
+FOSSIL_TEST(c_test_image_parallel_for_covers_range) {
+    parallel_test_ctx_t ctx = { { 0 }, { 0 } };
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(4);
+    bool ok = fossil_image_parallel_for(1000, 1, parallel_test_mark, &ctx);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    for (uint32_t i = 0; i < 1000; ++i)
+        ASSUME_ITS_EQUAL_I32(ctx.hits[i], 1);
+}
+
+FOSSIL_TEST(c_test_image_parallel_for_bands_fixed_count) {
+    parallel_test_ctx_t ctx = { { 0 }, { 0 } };
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(2);
+    // Six bands run even though only two threads are configured
+    bool ok = fossil_image_parallel_for_bands(6, 1000, parallel_test_band, &ctx);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    for (uint32_t b = 0; b < 6; ++b)
+        for (uint32_t i = 1000 * b / 6; i < 1000 * (b + 1) / 6; ++i)
+            ASSUME_ITS_EQUAL_I32(ctx.band_of[i], (int32_t)b);
+}
+
+FOSSIL_TEST(c_test_image_parallel_for_nested) {
+    parallel_test_ctx_t ctx = { { 0 }, { 0 } };
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(4);
+    bool ok = fossil_image_parallel_for(100, 1, parallel_test_nested, &ctx);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    for (uint32_t i = 0; i < 1000; ++i)
+        ASSUME_ITS_EQUAL_I32(ctx.hits[i], 1);
+}
+
+FOSSIL_TEST(c_test_image_parallel_bands_limits) {
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(8);
+    ASSUME_ITS_EQUAL_I32(fossil_image_parallel_bands(100, 50), 2);
+    ASSUME_ITS_EQUAL_I32(fossil_image_parallel_bands(10, 50), 1);
+    fossil_image_parallel_set_threads(1);
+    ASSUME_ITS_EQUAL_I32(fossil_image_parallel_bands(1000, 1), 1);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_FALSE(fossil_image_parallel_for(10, 1, NULL, NULL));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_image_parallel_tests) {
+    FOSSIL_TEST_ADD(c_image_parallel_fixture, c_test_image_parallel_for_covers_range);
+    FOSSIL_TEST_ADD(c_image_parallel_fixture, c_test_image_parallel_bands_limits);
+    FOSSIL_TEST_ADD(c_image_parallel_fixture, c_test_image_parallel_for_bands_fixed_count);
+    FOSSIL_TEST_ADD(c_image_parallel_fixture, c_test_image_parallel_for_nested);
+
+    FOSSIL_TEST_REGISTER(c_image_parallel_fixture);
+} // end of tests
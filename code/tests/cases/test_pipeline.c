@@ -0,0 +1,207 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_image_pipeline_fixture);
+
+FOSSIL_SETUP(c_image_pipeline_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_image_pipeline_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_test_image_pipeline_fuses_point_ops) {
+    fossil_image_t *fused = fossil_image_process_create(7, 5, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *ref = fossil_image_process_create(7, 5, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(fused);
+    ASSUME_NOT_CNULL(ref);
+    for (size_t i = 0; i < fused->size; ++i)
+        fused->data[i] = ref->data[i] = (uint8_t)(i * 37 % 256);
+
+    fossil_image_pipeline_t *pipeline = fossil_image_pipeline_create();
+    ASSUME_NOT_CNULL(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_brightness(pipeline, 12));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_contrast(pipeline, 1.4f));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_gamma(pipeline, 2.2f));
+    ASSUME_ITS_FALSE(fossil_image_pipeline_gamma(pipeline, 0.0f));
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_op_count(pipeline), 3);
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_stage_count(pipeline), 1);
+
+    ASSUME_ITS_TRUE(fossil_image_pipeline_execute(pipeline, fused));
+    fossil_image_color_brightness(ref, 12);
+    fossil_image_color_contrast(ref, 1.4f);
+    fossil_image_color_gamma(ref, 2.2f);
+    ASSUME_ITS_TRUE(memcmp(fused->data, ref->data, ref->size) == 0);
+
+    fossil_image_pipeline_destroy(pipeline);
+    fossil_image_process_destroy(fused);
+    fossil_image_process_destroy(ref);
+}
+
+FOSSIL_TEST(c_test_image_pipeline_streams_neighbourhood_ops) {
+    fossil_image_t *fused = fossil_image_process_create(37, 29, FOSSIL_PIXEL_FORMAT_GRAY16);
+    fossil_image_t *ref = fossil_image_process_create(37, 29, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(fused);
+    ASSUME_NOT_CNULL(ref);
+    uint16_t *a = (uint16_t *)fused->data;
+    uint16_t *b = (uint16_t *)ref->data;
+    for (size_t i = 0; i < 37 * 29; ++i)
+        a[i] = b[i] = (uint16_t)(i * 2654435761u >> 16);
+
+    fossil_image_pipeline_t *pipeline = fossil_image_pipeline_create();
+    ASSUME_NOT_CNULL(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_brightness(pipeline, -300));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_blur(pipeline, 2.0f));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_sharpen(pipeline));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_gamma(pipeline, 1.8f));
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_stage_count(pipeline), 5);
+
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    bool ok = fossil_image_pipeline_execute(pipeline, fused);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+
+    fossil_image_color_brightness(ref, -300);
+    fossil_image_filter_blur(ref, 2.0f);
+    fossil_image_filter_sharpen(ref);
+    fossil_image_color_gamma(ref, 1.8f);
+    ASSUME_ITS_TRUE(memcmp(fused->data, ref->data, ref->size) == 0);
+
+    fossil_image_t *tiny = fossil_image_process_create(2, 2, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(tiny);
+    ASSUME_ITS_FALSE(fossil_image_pipeline_execute(pipeline, tiny));
+    fossil_image_process_destroy(tiny);
+
+    fossil_image_pipeline_destroy(pipeline);
+    fossil_image_process_destroy(fused);
+    fossil_image_process_destroy(ref);
+}
+
+FOSSIL_TEST(c_test_image_pipeline_terminal_resize) {
+    fossil_image_t *fused = fossil_image_process_create(23, 17, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *ref = fossil_image_process_create(23, 17, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(fused);
+    ASSUME_NOT_CNULL(ref);
+    for (size_t i = 0; i < fused->size; ++i)
+        fused->data[i] = ref->data[i] = (uint8_t)(i * 53 % 251);
+
+    fossil_image_pipeline_t *pipeline = fossil_image_pipeline_create();
+    ASSUME_NOT_CNULL(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_brightness(pipeline, 9));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_blur(pipeline, 1.0f));
+    ASSUME_ITS_FALSE(fossil_image_pipeline_resize(pipeline, 0, 5, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_resize(pipeline, 10, 7, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_FALSE(fossil_image_pipeline_resize(pipeline, 10, 7, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_FALSE(fossil_image_pipeline_gamma(pipeline, 2.0f));
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_op_count(pipeline), 3);
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_stage_count(pipeline), 3);
+
+    ASSUME_ITS_TRUE(fossil_image_pipeline_execute(pipeline, fused));
+    fossil_image_color_brightness(ref, 9);
+    fossil_image_filter_blur(ref, 1.0f);
+    ASSUME_ITS_TRUE(fossil_image_process_resize(ref, 10, 7, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_EQUAL_I32(fused->width, 10);
+    ASSUME_ITS_EQUAL_I32(fused->height, 7);
+    ASSUME_ITS_EQUAL_I32(fused->size, ref->size);
+    ASSUME_ITS_TRUE(memcmp(fused->data, ref->data, ref->size) == 0);
+
+    // Rejected before any pixel changes
+    fossil_image_t *indexed = fossil_image_process_create(8, 8, FOSSIL_PIXEL_FORMAT_INDEXED8);
+    ASSUME_NOT_CNULL(indexed);
+    indexed->data[0] = 7;
+    ASSUME_ITS_FALSE(fossil_image_pipeline_execute(pipeline, indexed));
+    ASSUME_ITS_EQUAL_I32(indexed->width, 8);
+    ASSUME_ITS_EQUAL_I32(indexed->data[0], 7);
+    fossil_image_process_destroy(indexed);
+
+    fossil_image_pipeline_clear(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_gamma(pipeline, 2.0f));
+    ASSUME_ITS_EQUAL_I32(fossil_image_pipeline_op_count(pipeline), 1);
+
+    fossil_image_pipeline_destroy(pipeline);
+    fossil_image_process_destroy(fused);
+    fossil_image_process_destroy(ref);
+}
+
+FOSSIL_TEST(c_test_image_pipeline_float_images) {
+    fossil_image_t *fused = fossil_image_process_create(9, 6, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    fossil_image_t *ref = fossil_image_process_create(9, 6, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_NOT_CNULL(fused);
+    ASSUME_NOT_CNULL(ref);
+    size_t samples = fused->size / sizeof(float);
+    for (size_t i = 0; i < samples; ++i)
+        fused->fdata[i] = ref->fdata[i] = (float)(i % 13) / 13.0f;
+
+    fossil_image_pipeline_t *pipeline = fossil_image_pipeline_create();
+    ASSUME_NOT_CNULL(pipeline);
+    ASSUME_ITS_TRUE(fossil_image_pipeline_contrast(pipeline, 1.5f));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_sharpen(pipeline));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_brightness(pipeline, 1));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_execute(pipeline, fused));
+    fossil_image_color_contrast(ref, 1.5f);
+    fossil_image_filter_sharpen(ref);
+    fossil_image_color_brightness(ref, 1);
+    ASSUME_ITS_TRUE(memcmp(fused->fdata, ref->fdata, ref->size) == 0);
+
+    ASSUME_ITS_TRUE(fossil_image_pipeline_resize(pipeline, 4, 3, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(fossil_image_pipeline_execute(pipeline, fused));
+    fossil_image_color_contrast(ref, 1.5f);
+    fossil_image_filter_sharpen(ref);
+    fossil_image_color_brightness(ref, 1);
+    ASSUME_ITS_TRUE(fossil_image_process_resize(ref, 4, 3, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_TRUE(memcmp(fused->fdata, ref->fdata, ref->size) == 0);
+
+    fossil_image_pipeline_destroy(pipeline);
+    fossil_image_process_destroy(fused);
+    fossil_image_process_destroy(ref);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_image_pipeline_tests) {
+    FOSSIL_TEST_ADD(c_image_pipeline_fixture, c_test_image_pipeline_fuses_point_ops);
+    FOSSIL_TEST_ADD(c_image_pipeline_fixture, c_test_image_pipeline_streams_neighbourhood_ops);
+    FOSSIL_TEST_ADD(c_image_pipeline_fixture, c_test_image_pipeline_terminal_resize);
+    FOSSIL_TEST_ADD(c_image_pipeline_fixture, c_test_image_pipeline_float_images);
+
+    FOSSIL_TEST_REGISTER(c_image_pipeline_fixture);
+} // end of tests
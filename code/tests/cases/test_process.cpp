@@ -220,6 +220,287 @@ FOSSIL_TEST(cpp_test_image_process_normalize_basic) {
     fossil::image::Process::destroy(img);
 }
 
+FOSSIL_TEST(cpp_test_image_process_blend_linear_basic) {
+    fossil_image_t *img1 = fossil::image::Process::create(2, 2, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *img2 = fossil::image::Process::create(2, 2, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_ITS_TRUE(img1 && img2);
+    memset(img1->data, 0, img1->size);
+    memset(img2->data, 255, img2->size);
+    bool ok = fossil::image::Process::blend_linear(img1, img2, 0.5f);
+    ASSUME_ITS_TRUE(ok);
+    // Half of the light of white encodes brighter than the gamma midpoint
+    ASSUME_ITS_EQUAL_I32(img1->data[0], 188);
+    fossil::image::Process::destroy(img1);
+    fossil::image::Process::destroy(img2);
+}
+
+FOSSIL_TEST(cpp_test_image_process_resize_linear_upscale) {
+    fossil_image_t *img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    img->data[0] = 0;
+    img->data[1] = 255;
+    bool ok = fossil::image::Process::resize_linear(img, 4, 1, FOSSIL_INTERP_LINEAR);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->width, 4);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 0);
+    ASSUME_ITS_EQUAL_I32(img->data[1], 188);
+    ASSUME_ITS_EQUAL_I32(img->data[2], 255);
+    fossil::image::Process::destroy(img);
+
+    // Area averages in linear light too: half black, half white is ~188, not 128
+    img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    img->data[0] = 0;
+    img->data[1] = 255;
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_linear(img, 1, 1, FOSSIL_INTERP_AREA));
+    ASSUME_ITS_EQUAL_I32(img->width, 1);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 188);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_grayscale_fixed_point) {
+    fossil_image_t *img = fossil::image::Process::create(4, 1, FOSSIL_PIXEL_FORMAT_RGBA32);
+    ASSUME_NOT_CNULL(img);
+    const uint8_t px[16] = {
+        255, 0, 0, 255,   0, 255, 0, 255,   0, 0, 255, 255,   255, 255, 255, 0
+    };
+    memcpy(img->data, px, sizeof(px));
+    uint8_t *buffer = img->data;
+    bool ok = fossil::image::Process::grayscale(img);
+    ASSUME_ITS_TRUE(ok);
+    // Converted in place, BT.601 weights with rounding
+    ASSUME_ITS_TRUE(img->data == buffer);
+    ASSUME_ITS_EQUAL_I32(img->size, 4);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 76);
+    ASSUME_ITS_EQUAL_I32(img->data[1], 150);
+    ASSUME_ITS_EQUAL_I32(img->data[2], 29);
+    ASSUME_ITS_EQUAL_I32(img->data[3], 255);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_grayscale_into_reuse) {
+    fossil_image_t *src = fossil::image::Process::create(3, 1, FOSSIL_PIXEL_FORMAT_RGB48);
+    fossil_image_t *dst = fossil::image::Process::create(3, 1, FOSSIL_PIXEL_FORMAT_GRAY16);
+    fossil_image_t *bad = fossil::image::Process::create(3, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_ITS_TRUE(src && dst && bad);
+    uint16_t *s = (uint16_t *)src->data;
+    for (int i = 0; i < 9; ++i)
+        s[i] = 65535;
+    ASSUME_ITS_TRUE(fossil::image::Process::grayscale_into(src, dst));
+    ASSUME_ITS_EQUAL_I32(((uint16_t *)dst->data)[2], 65535);
+    // Source untouched, mismatched depth rejected
+    ASSUME_ITS_EQUAL_I32(src->format, FOSSIL_PIXEL_FORMAT_RGB48);
+    ASSUME_ITS_FALSE(fossil::image::Process::grayscale_into(src, bad));
+    fossil::image::Process::destroy(src);
+    fossil::image::Process::destroy(dst);
+    fossil::image::Process::destroy(bad);
+}
+
+FOSSIL_TEST(cpp_test_image_process_grayscale_borrowed_buffer) {
+    uint8_t pixels[3 * 3] = { 255, 255, 255, 0, 0, 0, 10, 20, 30 };
+    fossil_image_t view = {};
+    view.width = 3;
+    view.height = 1;
+    view.channels = 3;
+    view.format = FOSSIL_PIXEL_FORMAT_RGB24;
+    view.data = pixels;
+    view.size = sizeof(pixels);
+    view.owns_data = false;
+    ASSUME_ITS_TRUE(fossil::image::Process::grayscale(&view));
+    // The caller's pixels are left intact; the result lives in an owned buffer
+    ASSUME_ITS_TRUE(view.data != pixels);
+    ASSUME_ITS_TRUE(view.owns_data);
+    ASSUME_ITS_EQUAL_I32(pixels[0], 255);
+    ASSUME_ITS_EQUAL_I32(pixels[3], 0);
+    ASSUME_ITS_EQUAL_I32(view.data[0], 255);
+    ASSUME_ITS_EQUAL_I32(view.data[1], 0);
+    free(view.data);
+}
+
+FOSSIL_TEST(cpp_test_image_process_normalize_percentile_clips_outliers) {
+    fossil_image_t *img = fossil::image::Process::create(10, 10, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(img);
+    for (uint32_t i = 0; i < 100; ++i)
+        img->data[i] = (uint8_t)(100 + i % 50);
+    img->data[0] = 0;
+    img->data[99] = 255;
+    bool ok = fossil::image::Process::normalize_range(img, 2.0f, 98.0f, false);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(img->data[0], 0);
+    ASSUME_ITS_EQUAL_I32(img->data[99], 255);
+    ASSUME_ITS_EQUAL_I32(img->data[50], 0);
+    ASSUME_ITS_EQUAL_I32(img->data[49], 255);
+    ASSUME_ITS_FALSE(fossil::image::Process::normalize_range(img, 50.0f, 10.0f, false));
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_normalize_per_channel) {
+    fossil_image_t *img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_RGB48);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *p = reinterpret_cast<uint16_t *>(img->data);
+    p[0] = 1000; p[1] = 20000; p[2] = 500;
+    p[3] = 2000; p[4] = 40000; p[5] = 500;
+    bool ok = fossil::image::Process::normalize_range(img, 0.0f, 100.0f, true);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(p[0], 0);
+    ASSUME_ITS_EQUAL_I32(p[3], 65535);
+    ASSUME_ITS_EQUAL_I32(p[1], 0);
+    ASSUME_ITS_EQUAL_I32(p[4], 65535);
+    ASSUME_ITS_EQUAL_I32(p[2], 500);
+    ASSUME_ITS_EQUAL_I32(p[5], 500);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_normalize_float_flat_channel) {
+    fossil_image_t *img = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_FLOAT32_RGB);
+    ASSUME_NOT_CNULL(img);
+    float *p = img->fdata;
+    p[0] = 0.2f; p[1] = 0.7f; p[2] = 0.5f;
+    p[3] = 0.6f; p[4] = 0.7f; p[5] = 0.5f;
+    bool ok = fossil::image::Process::normalize_range(img, 0.0f, 100.0f, true);
+    ASSUME_ITS_TRUE(ok);
+    // Red is stretched; the constant green and blue channels keep their values
+    ASSUME_ITS_TRUE(p[0] == 0.0f);
+    ASSUME_ITS_TRUE(p[3] == 1.0f);
+    ASSUME_ITS_TRUE(p[1] == 0.7f && p[4] == 0.7f);
+    ASSUME_ITS_TRUE(p[2] == 0.5f && p[5] == 0.5f);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_pyramid_levels) {
+    fossil_image_t *img = fossil::image::Process::create(13, 6, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(img);
+    for (size_t i = 0; i < img->size; ++i)
+        img->data[i] = 100;
+    fossil_image_pyramid_t pyr;
+    ASSUME_ITS_TRUE(fossil::image::Process::pyramid_build(img, FOSSIL_PYRAMID_GAUSSIAN, 0, &pyr));
+    ASSUME_ITS_EQUAL_I32(pyr.count, 5);
+    ASSUME_ITS_EQUAL_I32(pyr.levels[1].width, 7);
+    ASSUME_ITS_EQUAL_I32(pyr.levels[1].height, 3);
+    ASSUME_ITS_EQUAL_I32(pyr.levels[4].width, 1);
+    ASSUME_ITS_EQUAL_I32(pyr.levels[4].height, 1);
+    ASSUME_ITS_FALSE(pyr.levels[2].owns_data);
+    ASSUME_ITS_EQUAL_I32(pyr.levels[3].data[1], 100);
+    fossil::image::Process::pyramid_free(&pyr);
+    ASSUME_ITS_TRUE(pyr.levels == nullptr);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_pyramid_box_average) {
+    fossil_image_t *img = fossil::image::Process::create(4, 2, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(img);
+    const uint16_t values[8] = { 0, 400, 800, 800, 400, 800, 800, 800 };
+    memcpy(img->data, values, sizeof(values));
+    fossil_image_pyramid_t pyr;
+    ASSUME_ITS_TRUE(fossil::image::Process::pyramid_build(img, FOSSIL_PYRAMID_BOX, 2, &pyr));
+    ASSUME_ITS_EQUAL_I32(pyr.count, 2);
+    ASSUME_ITS_EQUAL_I32(reinterpret_cast<uint16_t *>(pyr.levels[1].data)[0], 400);
+    ASSUME_ITS_EQUAL_I32(reinterpret_cast<uint16_t *>(pyr.levels[1].data)[1], 800);
+    fossil::image::Process::pyramid_free(&pyr);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_downscale_box_average) {
+    fossil_image_t *img = fossil::image::Process::create(8, 2, FOSSIL_PIXEL_FORMAT_RGBA32);
+    ASSUME_NOT_CNULL(img);
+    for (size_t i = 0; i < img->size; ++i)
+        img->data[i] = static_cast<uint8_t>((i % 8 < 4) ? 10 : 21);
+    ASSUME_ITS_TRUE(fossil::image::Process::downscale(img, 2));
+    ASSUME_ITS_EQUAL_I32(img->width, 4);
+    ASSUME_ITS_EQUAL_I32(img->height, 1);
+    for (size_t i = 0; i < img->size; ++i)
+        ASSUME_ITS_EQUAL_I32(img->data[i], 16);
+    fossil::image::Process::destroy(img);
+}
+
+FOSSIL_TEST(cpp_test_image_process_resize_area_fractional) {
+    fossil_image_t *img = fossil::image::Process::create(3, 1, FOSSIL_PIXEL_FORMAT_GRAY16);
+    ASSUME_NOT_CNULL(img);
+    uint16_t *p = reinterpret_cast<uint16_t *>(img->data);
+    p[0] = 0;
+    p[1] = 3000;
+    p[2] = 6000;
+    ASSUME_ITS_TRUE(fossil::image::Process::resize(img, 2, 1, FOSSIL_INTERP_AREA));
+    p = reinterpret_cast<uint16_t *>(img->data);
+    ASSUME_ITS_EQUAL_I32(p[0], 1000);
+    ASSUME_ITS_EQUAL_I32(p[1], 5000);
+    fossil::image::Process::destroy(img);
+
+    fossil_image_t *indexed = fossil::image::Process::create(4, 4, FOSSIL_PIXEL_FORMAT_INDEXED8);
+    ASSUME_NOT_CNULL(indexed);
+    ASSUME_ITS_FALSE(fossil::image::Process::downscale(indexed, 2));
+    fossil::image::Process::destroy(indexed);
+}
+
+FOSSIL_TEST(cpp_test_image_process_resize_into_keeps_source) {
+    fossil_image_t *src = fossil::image::Process::create(6, 4, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *dst = fossil::image::Process::create(3, 2, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(src);
+    ASSUME_NOT_CNULL(dst);
+    memset(src->data, 90, src->size);
+    uint8_t *buffer = dst->data;
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into(src, dst, FOSSIL_INTERP_LANCZOS));
+    ASSUME_ITS_TRUE(dst->data == buffer);
+    ASSUME_ITS_EQUAL_I32(src->width, 6);
+    for (size_t i = 0; i < dst->size; ++i)
+        ASSUME_ITS_EQUAL_I32(dst->data[i], 90);
+    fossil_image_t *gray = fossil::image::Process::create(3, 2, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(gray);
+    ASSUME_ITS_FALSE(fossil::image::Process::resize_into(src, gray, FOSSIL_INTERP_LINEAR));
+    fossil::image::Process::destroy(gray);
+    fossil::image::Process::destroy(src);
+    fossil::image::Process::destroy(dst);
+}
+
+FOSSIL_TEST(cpp_test_image_process_resize_linear_and_cubic_fallback) {
+    fossil_image_t *src = fossil::image::Process::create(2, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *dst = fossil::image::Process::create(4, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *ref = fossil::image::Process::create(4, 1, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(src);
+    ASSUME_NOT_CNULL(dst);
+    ASSUME_NOT_CNULL(ref);
+    src->data[0] = 0;
+    src->data[1] = 255;
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into(src, dst, FOSSIL_INTERP_LINEAR));
+    ASSUME_ITS_EQUAL_I32(dst->data[0], 0);
+    ASSUME_ITS_EQUAL_I32(dst->data[1], 128);
+    ASSUME_ITS_EQUAL_I32(dst->data[2], 255);
+    ASSUME_ITS_EQUAL_I32(dst->data[3], 255);
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into(src, ref, FOSSIL_INTERP_NEAREST));
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into(src, dst, FOSSIL_INTERP_CUBIC));
+    ASSUME_ITS_TRUE(memcmp(dst->data, ref->data, ref->size) == 0);
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into(src, dst, FOSSIL_INTERP_LANCZOS));
+    ASSUME_ITS_TRUE(memcmp(dst->data, ref->data, ref->size) == 0);
+    fossil::image::Process::destroy(ref);
+    fossil::image::Process::destroy(dst);
+    fossil::image::Process::destroy(src);
+}
+
+FOSSIL_TEST(cpp_test_image_process_resize_plan_contact_sheet) {
+    fossil_image_t *src = fossil::image::Process::create(8, 8, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *sheet = fossil::image::Process::create(8, 4, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(src);
+    ASSUME_NOT_CNULL(sheet);
+    fossil_image_resize_plan_t *plan = fossil::image::Process::resize_plan_create(8, 8, 2, 2, FOSSIL_INTERP_AREA);
+    ASSUME_NOT_CNULL(plan);
+    for (uint32_t cell = 0; cell < 4; ++cell) {
+        memset(src->data, static_cast<int>(cell * 50 + 10), src->size);
+        ASSUME_ITS_TRUE(fossil::image::Process::resize_plan_execute(plan, src, sheet, cell * 2, 1));
+    }
+    ASSUME_ITS_FALSE(fossil::image::Process::resize_plan_execute(plan, src, sheet, 7, 0));
+    fossil::image::Process::resize_plan_destroy(plan);
+    for (uint32_t x = 0; x < 8; ++x) {
+        ASSUME_ITS_EQUAL_I32(sheet->data[x], 0);
+        ASSUME_ITS_EQUAL_I32(sheet->data[8 + x], (x / 2) * 50 + 10);
+        ASSUME_ITS_EQUAL_I32(sheet->data[16 + x], (x / 2) * 50 + 10);
+        ASSUME_ITS_EQUAL_I32(sheet->data[24 + x], 0);
+    }
+    ASSUME_ITS_TRUE(fossil::image::Process::resize_into_region(src, sheet, 6, 0, 2, 4, FOSSIL_INTERP_NEAREST));
+    ASSUME_ITS_EQUAL_I32(sheet->data[31], 160);
+    fossil::image::Process::destroy(src);
+    fossil::image::Process::destroy(sheet);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -242,6 +523,21 @@ FOSSIL_TEST_GROUP(cpp_image_process_tests) {
     FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_threshold_basic);
     FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_invert_basic);
     FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_normalize_basic);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_blend_linear_basic);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_resize_linear_upscale);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_grayscale_fixed_point);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_grayscale_into_reuse);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_grayscale_borrowed_buffer);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_normalize_percentile_clips_outliers);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_normalize_per_channel);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_normalize_float_flat_channel);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_pyramid_levels);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_pyramid_box_average);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_downscale_box_average);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_resize_area_fractional);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_resize_into_keeps_source);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_resize_linear_and_cubic_fallback);
+    FOSSIL_TEST_ADD(cpp_image_process_fixture, cpp_test_image_process_resize_plan_contact_sheet);
 
     FOSSIL_TEST_REGISTER(cpp_image_process_fixture);
 } // end of tests
@@ -0,0 +1,174 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/image/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_image_tile_fixture);
+
+FOSSIL_SETUP(c_image_tile_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_image_tile_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Sort
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+/* Run fetcher for read_runs that also checks no run crosses a tile edge. */
+static bool c_tile_fetch(void *ctx, uint32_t x, uint32_t y, uint32_t count, uint8_t *dst) {
+    const fossil_image_tiled_t *tiled = (const fossil_image_tiled_t *)(ctx);
+    if (x / tiled->tile_size != (x + count - 1) / tiled->tile_size)
+        return false;
+    return fossil_image_tile_read_region(tiled, (int32_t)(x), (int32_t)(y), count, 1, dst, count * 3);
+}
+
+FOSSIL_TEST(c_test_image_tile_round_trip_and_iterate) {
+    fossil_image_t *image = fossil_image_process_create(21, 10, FOSSIL_PIXEL_FORMAT_RGB24);
+    fossil_image_t *back = fossil_image_process_create(21, 10, FOSSIL_PIXEL_FORMAT_RGB24);
+    ASSUME_NOT_CNULL(image);
+    ASSUME_NOT_CNULL(back);
+    for (size_t i = 0; i < image->size; ++i)
+        image->data[i] = (uint8_t)(i * 7 % 251);
+
+    fossil_image_tiled_t tiled;
+    ASSUME_ITS_FALSE(fossil_image_tile_from_image(image, 12, &tiled));
+    ASSUME_ITS_TRUE(fossil_image_tile_from_image(image, 8, &tiled));
+    ASSUME_ITS_EQUAL_I32(tiled.tiles_x, 3);
+    ASSUME_ITS_EQUAL_I32(tiled.tiles_y, 2);
+
+    fossil_image_tile_iter_t iter;
+    uint32_t tiles = 0;
+    size_t pixels = 0;
+    fossil_image_tile_iter_begin(&tiled, &iter);
+    while (fossil_image_tile_iter_next(&iter)) {
+        tiles++;
+        pixels += (size_t)iter.tile.width * iter.tile.height;
+    }
+    ASSUME_ITS_EQUAL_I32(tiles, 6);
+    ASSUME_ITS_EQUAL_I32((int32_t)pixels, 21 * 10);
+
+    // Last tile holds pixels (16..20, 8..9)
+    fossil_image_tile_t tile;
+    ASSUME_ITS_TRUE(fossil_image_tile_get(&tiled, 2, 1, &tile));
+    ASSUME_ITS_EQUAL_I32(tile.width, 5);
+    ASSUME_ITS_EQUAL_I32(tile.height, 2);
+    ASSUME_ITS_EQUAL_I32(tile.data[0], image->data[(8 * 21 + 16) * 3]);
+
+    ASSUME_ITS_TRUE(fossil_image_tile_to_image(&tiled, back));
+    ASSUME_ITS_TRUE(memcmp(back->data, image->data, image->size) == 0);
+
+    fossil_image_tile_free(&tiled);
+    fossil_image_process_destroy(image);
+    fossil_image_process_destroy(back);
+}
+
+FOSSIL_TEST(c_test_image_tile_region_and_transpose) {
+    fossil_image_t *image = fossil_image_process_create(19, 13, FOSSIL_PIXEL_FORMAT_GRAY8);
+    fossil_image_t *flipped = fossil_image_process_create(13, 19, FOSSIL_PIXEL_FORMAT_GRAY8);
+    ASSUME_NOT_CNULL(image);
+    ASSUME_NOT_CNULL(flipped);
+    for (uint32_t y = 0; y < 13; ++y)
+        for (uint32_t x = 0; x < 19; ++x)
+            image->data[y * 19 + x] = (uint8_t)(y * 19 + x);
+
+    fossil_image_tiled_t tiled;
+    ASSUME_ITS_TRUE(fossil_image_tile_from_image(image, 8, &tiled));
+
+    // A 3x3 window around the top-left corner repeats the edge pixels
+    uint8_t halo[9];
+    ASSUME_ITS_TRUE(fossil_image_tile_read_region(&tiled, -1, -1, 3, 3, halo, 3));
+    ASSUME_ITS_EQUAL_I32(halo[0], 0);
+    ASSUME_ITS_EQUAL_I32(halo[2], 1);
+    ASSUME_ITS_EQUAL_I32(halo[8], 20);
+
+    uint8_t patch[4] = {200, 201, 202, 203};
+    ASSUME_ITS_TRUE(fossil_image_tile_write_region(&tiled, 7, 7, 2, 2, patch, 2));
+    ASSUME_ITS_FALSE(fossil_image_tile_write_region(&tiled, 18, 0, 2, 1, patch, 2));
+
+    fossil_image_tiled_t transposed;
+    uint32_t saved = fossil_image_parallel_get_threads();
+    fossil_image_parallel_set_threads(3);
+    bool ok = fossil_image_tile_transpose(&tiled, &transposed);
+    fossil_image_parallel_set_threads(saved);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_EQUAL_I32(transposed.width, 13);
+    ASSUME_ITS_EQUAL_I32(transposed.height, 19);
+    ASSUME_ITS_TRUE(fossil_image_tile_to_image(&transposed, flipped));
+    ASSUME_ITS_EQUAL_I32(flipped->data[5 * 13 + 2], 2 * 19 + 5);
+    ASSUME_ITS_EQUAL_I32(flipped->data[8 * 13 + 7], 201);
+    ASSUME_ITS_EQUAL_I32(flipped->data[7 * 13 + 8], 202);
+
+    fossil_image_tile_free(&transposed);
+    fossil_image_tile_free(&tiled);
+    fossil_image_process_destroy(image);
+    fossil_image_process_destroy(flipped);
+}
+
+FOSSIL_TEST(c_test_image_tile_geometry_and_read_runs) {
+    fossil_image_tiled_t layout;
+    fossil_image_tiled_t tiled;
+    ASSUME_ITS_FALSE(fossil_image_tile_geometry(21, 13, FOSSIL_PIXEL_FORMAT_RGB24, 12, &layout));
+    ASSUME_ITS_FALSE(fossil_image_tile_geometry(0, 13, FOSSIL_PIXEL_FORMAT_RGB24, 8, &layout));
+    ASSUME_ITS_TRUE(fossil_image_tile_geometry(21, 13, FOSSIL_PIXEL_FORMAT_RGB24, 8, &layout));
+    ASSUME_ITS_TRUE(fossil_image_tile_create(21, 13, FOSSIL_PIXEL_FORMAT_RGB24, 8, &tiled));
+    ASSUME_ITS_TRUE(layout.data == NULL);
+    ASSUME_ITS_EQUAL_I32(layout.tiles_x, tiled.tiles_x);
+    ASSUME_ITS_EQUAL_I32(layout.tiles_y, tiled.tiles_y);
+    ASSUME_ITS_EQUAL_I32(layout.channels, tiled.channels);
+    ASSUME_ITS_EQUAL_I32(layout.tile_bytes, tiled.tile_bytes);
+    ASSUME_ITS_EQUAL_I32(layout.size, tiled.size);
+    for (size_t i = 0; i < tiled.size; ++i)
+        tiled.data[i] = (uint8_t)(i * 11 % 253);
+
+    // Runs stay inside one tile and assemble the same clamped rectangle
+    uint8_t direct[30 * 20 * 3];
+    uint8_t runs[30 * 20 * 3];
+    ASSUME_ITS_TRUE(fossil_image_tile_read_region(&tiled, -4, -3, 30, 20, direct, 30 * 3));
+    ASSUME_ITS_TRUE(fossil_image_tile_read_runs(&layout, -4, -3, 30, 20, runs, 30 * 3, c_tile_fetch, &tiled));
+    ASSUME_ITS_TRUE(memcmp(direct, runs, sizeof(direct)) == 0);
+    fossil_image_tile_free(&tiled);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_image_tile_tests) {
+    FOSSIL_TEST_ADD(c_image_tile_fixture, c_test_image_tile_round_trip_and_iterate);
+    FOSSIL_TEST_ADD(c_image_tile_fixture, c_test_image_tile_region_and_transpose);
+    FOSSIL_TEST_ADD(c_image_tile_fixture, c_test_image_tile_geometry_and_read_runs);
+
+    FOSSIL_TEST_REGISTER(c_image_tile_fixture);
+} // end of tests